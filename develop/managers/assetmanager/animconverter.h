@@ -18,6 +18,7 @@ class AnimConverter : public AssetConverter {
 
     ReturnCode convertFile(AssetConverterSettings *s) Q_DECL_OVERRIDE;
     AssetConverterSettings *createSettings() const Q_DECL_OVERRIDE;
+    bool isThreadSafe() const Q_DECL_OVERRIDE { return true; }
 
     QString templatePath() const Q_DECL_OVERRIDE { return ":/Templates/Animation.anim"; }
 
@@ -6,6 +6,12 @@
 #include <QUuid>
 #include <QDebug>
 #include <QMessageBox>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QCryptographicHash>
 
 #include <QPainter>
 #include <QDomDocument>
@@ -39,6 +45,7 @@
 
 #include <editor/projectmanager.h>
 #include <editor/pluginmanager.h>
+#include <editor/settingsmanager.h>
 
 #include "log.h"
 
@@ -54,6 +61,11 @@ namespace {
     const char *gEntry(".entry");
     const char *gCompany(".company");
     const char *gProject(".project");
+
+    const char *gStamps("stamps");
+
+    const char *gSharedCache("Asset_Manager/Shared_Cache_Path");
+    const char *gManifest("manifest");
 };
 
 AssetManager *AssetManager::m_instance = nullptr;
@@ -64,10 +76,46 @@ bool typeLessThan(AssetConverterSettings *left, AssetConverterSettings *right) {
     return left->type() < right->type();
 }
 
+class ImportJob : public QRunnable {
+public:
+    ImportJob(AssetManager *manager, AssetConverter *converter, AssetConverterSettings *settings, const QString &cache, bool force) :
+            m_manager(manager),
+            m_converter(converter),
+            m_settings(settings),
+            m_cache(cache),
+            m_force(force) {
+
+    }
+
+    void run() Q_DECL_OVERRIDE {
+        bool prepared = false;
+        uint8_t result = AssetManager::importFile(m_converter, m_settings, m_cache, m_force, prepared);
+
+        QMutexLocker locker(&m_manager->m_resultsLock);
+        if(prepared) {
+            m_manager->m_preparedImports.push_back(m_settings);
+        } else {
+            m_manager->m_importResults.push_back(qMakePair(m_settings, result));
+        }
+    }
+
+private:
+    AssetManager *m_manager;
+    AssetConverter *m_converter;
+    AssetConverterSettings *m_settings;
+
+    QString m_cache;
+
+    bool m_force;
+};
+
 AssetManager::AssetManager() :
         m_indices(Engine::resourceSystem()->indices()),
         m_dirWatcher(new QFileSystemWatcher(this)),
         m_fileWatcher(new QFileSystemWatcher(this)),
+        m_threadPool(new QThreadPool(this)),
+        m_importCount(0),
+        m_importProgress(0),
         m_projectManager(ProjectManager::instance()),
         m_timer(new QTimer(this)) {
 
@@ -79,6 +127,8 @@ AssetManager::AssetManager() :
 }
 
 AssetManager::~AssetManager() {
+    m_threadPool->waitForDone();
+
     delete m_dirWatcher;
     delete m_fileWatcher;
 
@@ -110,6 +160,8 @@ void AssetManager::init() {
     registerConverter(new MapConverter);
     registerConverter(new ControlScehemeConverter);
 
+    SettingsManager::instance()->registerProperty(gSharedCache, QVariant::fromValue(QFileInfo()));
+
     for(auto &it : PluginManager::instance()->extensions("converter")) {
         AssetConverter *converter = reinterpret_cast<AssetConverter *>(PluginManager::instance()->getPluginObject(it));
         if(converter) {
@@ -154,6 +206,8 @@ void AssetManager::rescan(bool force) {
 
     force |= !target.isEmpty() || !info.exists();
 
+    loadStamps();
+
     if(target.isEmpty()) {
         connect(m_dirWatcher, SIGNAL(directoryChanged(QString)), this, SIGNAL(directoryChanged(QString)));
         connect(m_dirWatcher, SIGNAL(directoryChanged(QString)), this, SLOT(onDirectoryChanged(QString)));
@@ -214,8 +268,15 @@ bool AssetManager::pushToImport(AssetConverterSettings *settings) {
 }
 
 void AssetManager::reimport() {
+    // Lower types are started first, the order between the assets is defined by the recorded dependencies
     std::sort(m_importQueue.begin(), m_importQueue.end(), typeLessThan);
-    emit importStarted(m_importQueue.size(), tr("Importing resources"));
+    if(!m_timer->isActive()) {
+        m_importProgress = 0;
+    }
+    m_importCount = m_importProgress + m_activeImports.size() + m_importQueue.size() + m_deferredImports.size();
+
+    emit importStarted(m_importCount, tr("Importing resources"));
+    emit importProgress(m_importProgress, m_importCount);
     m_timer->start(10);
 }
 
@@ -482,6 +543,10 @@ AssetConverterSettings *AssetManager::fetchSettings(const QFileInfo &source) {
     if(!settings->loadSettings()) {
         settings->setDestination( qPrintable(QUuid::createUuid().toString()) );
     }
+    QJsonArray stamp = m_stamps.value(path).toArray();
+    if(stamp.size() == 3 && stamp.at(2).toString() == settings->hash()) {
+        settings->setSourceStamp(qint64(stamp.at(0).toDouble()), qint64(stamp.at(1).toDouble()));
+    }
     settings->setAbsoluteDestination(qPrintable(ProjectManager::instance()->importPath() + "/" + settings->destination()));
 
     m_converterSettings[path] = settings;
@@ -639,9 +704,7 @@ void AssetManager::dumpBundle() {
 }
 
 void AssetManager::onPerform() {
-    if(!m_importQueue.isEmpty()) {
-        convert(m_importQueue.takeFirst());
-    } else {
+    if(!processStage()) {
         for(CodeBuilder *it : qAsConst(m_builders)) {
             it->rescanSources(ProjectManager::instance()->contentPath());
             if(!it->isEmpty()) {
@@ -653,6 +716,7 @@ void AssetManager::onPerform() {
         }
 
         cleanupBundle();
+        saveStamps();
 
         if(isOutdated()) {
             for(CodeBuilder *it : qAsConst(m_builders)) {
@@ -676,6 +740,9 @@ void AssetManager::onFileChanged(const QString &path, bool force) {
         AssetConverterSettings *settings = fetchSettings(info);
 
         if(force || settings->isOutdated()) {
+            if(force) {
+                m_forcedImports.insert(settings);
+            }
             pushToImport(settings);
         } else {
             if(!settings->isCode()) {
@@ -688,6 +755,14 @@ void AssetManager::onFileChanged(const QString &path, bool force) {
                 }
             }
         }
+
+        // Assets produced from this file must be converted again as well, the running imports record their dependencies right now
+        QString source = info.absoluteFilePath();
+        for(AssetConverterSettings *it : qAsConst(m_converterSettings)) {
+            if(it != settings && !m_activeImports.contains(it) && it->dependencies().contains(source) && !m_importQueue.contains(it) && it->isOutdated()) {
+                pushToImport(it);
+            }
+        }
     }
 }
 
@@ -769,53 +844,344 @@ AssetConverter *AssetManager::getConverter(AssetConverterSettings *settings) {
 }
 
 
+bool AssetManager::processStage() {
+    QList<QPair<AssetConverterSettings *, uint8_t>> results;
+    {
+        QMutexLocker locker(&m_resultsLock);
+        results.swap(m_importResults);
+        m_stageQueue.append(m_preparedImports);
+        m_preparedImports.clear();
+    }
+    for(auto &it : results) {
+        finishImport(it.first, it.second);
+    }
+
+    // The engine part of the conversion runs on the main thread, one asset per tick
+    if(!m_stageQueue.isEmpty()) {
+        convert(m_stageQueue.takeFirst());
+    }
+
+    startImports();
+
+    if(m_importQueue.isEmpty() && m_activeImports.isEmpty()) {
+        m_retriedImports.clear();
+        return false;
+    }
+    return true;
+}
+/*!
+    Starts the queued imports which don't wait for other assets.
+    An asset waits while any of the files recorded with AssetConverterSettings::addDependency() is queued or being imported.
+    The rest of the assets are imported in parallel in the order of the queue.
+*/
+void AssetManager::startImports() {
+    if(m_importQueue.isEmpty() && m_activeImports.isEmpty()) {
+        // Failed imports are repeated once the assets they might depend on are imported
+        m_importQueue.swap(m_deferredImports);
+    }
+
+    QSet<QString> busy;
+    for(AssetConverterSettings *it : qAsConst(m_importQueue)) {
+        busy.insert(QFileInfo(it->source()).absoluteFilePath());
+    }
+    for(AssetConverterSettings *it : qAsConst(m_activeImports)) {
+        busy.insert(QFileInfo(it->source()).absoluteFilePath());
+    }
+
+    QList<AssetConverterSettings *> ready;
+    QSet<AssetConverterSettings *> queued;
+    for(auto it = m_importQueue.begin(); it != m_importQueue.end();) {
+        AssetConverterSettings *settings = *it;
+        if(queued.contains(settings)) {
+            it = m_importQueue.erase(it);
+            m_importProgress++;
+            continue;
+        }
+        queued.insert(settings);
+
+        // The asset changed during the conversion is imported again once the current import is finished
+        bool wait = m_activeImports.contains(settings);
+        if(!wait) {
+            QString source = QFileInfo(settings->source()).absoluteFilePath();
+            for(const QString &dependency : settings->dependencies()) {
+                if(dependency != source && busy.contains(dependency)) {
+                    wait = true;
+                    break;
+                }
+            }
+        }
+
+        if(wait) {
+            ++it;
+        } else {
+            ready.push_back(settings);
+            it = m_importQueue.erase(it);
+        }
+    }
+    // Assets which depend on each other are imported in the order of the queue
+    if(ready.isEmpty() && m_activeImports.isEmpty() && !m_importQueue.isEmpty()) {
+        ready.push_back(m_importQueue.takeFirst());
+    }
+
+    QString cache = sharedCachePath();
+    for(AssetConverterSettings *settings : ready) {
+        AssetConverter *converter = getConverter(settings);
+        if(converter) {
+            m_activeImports.insert(settings);
+            m_threadPool->start(new ImportJob(this, converter, settings, cache, m_forcedImports.remove(settings)));
+        } else {
+            convertFinished(settings, AssetConverter::Unsupported);
+        }
+    }
+}
+
+void AssetManager::finishImport(AssetConverterSettings *settings, uint8_t result) {
+    m_activeImports.remove(settings);
+    // The dependencies are unknown until the first conversion, the asset can fail because the referenced one isn't imported yet
+    if(result == AssetConverter::InternalError && !m_retriedImports.contains(settings) &&
+       !(m_importQueue.isEmpty() && m_activeImports.isEmpty())) {
+        m_retriedImports.insert(settings);
+        m_deferredImports.push_back(settings);
+        return;
+    }
+    convertFinished(settings, result);
+}
+
 void AssetManager::convert(AssetConverterSettings *settings) {
-    QFileInfo info(settings->source());
-    QString format = info.completeSuffix().toLower();
+    uint8_t result = AssetConverter::Unsupported;
 
-    auto it = m_converters.find(format);
-    if(it != m_converters.end()) {
-        uint8_t result = it.value()->convertFile(settings);
-        switch(result) {
-            case AssetConverter::Success: {
-                Log(Log::INF) << "Converting:" << qPrintable(settings->source());
+    AssetConverter *converter = getConverter(settings);
+    if(converter) {
+        result = convertFile(converter, settings, sharedCachePath());
+    }
+    finishImport(settings, result);
+}
 
-                QString guid = settings->destination();
-                QString type = settings->typeName();
-                QString source = settings->source();
-                registerAsset(source, guid, type);
+QString AssetManager::sharedCachePath() const {
+    return SettingsManager::instance()->value(gSharedCache).value<QFileInfo>().filePath();
+}
 
-                for(const QString &it : settings->subKeys()) {
-                    QString value = settings->subItem(it);
-                    QString type = settings->subTypeName(it);
-                    QString path = source + "/" + it;
+QString AssetManager::artifactsPath(const QString &cache, AssetConverter *converter, AssetConverterSettings *settings) {
+    if(!cache.isEmpty() && !settings->isCode()) {
+        QString key = settings->artifactKey();
+        if(!key.isEmpty()) {
+            // The format version of the converter is a part of the artifact key, the repository revision isn't used to keep the cache between commits
+            QCryptographicHash crypto(QCryptographicHash::Sha1);
+            crypto.addData(key.toLatin1());
+            crypto.addData(converter->metaObject()->className());
+            key = crypto.result().toHex();
+
+            return cache + "/" + key.left(2) + "/" + key;
+        }
+    }
+    return QString();
+}
 
-                    registerAsset(path, value, type);
+/*!
+    Imports the asset with \a settings on an import thread.
+    The artifacts are taken from the shared \a cache unless the import is \a force.
+    Converters which are not thread safe only prepare the asset, \a prepared is set to true in this case and the conversion must be finished by convertFile() on the main thread.
+*/
+uint8_t AssetManager::importFile(AssetConverter *converter, AssetConverterSettings *settings, const QString &cache, bool force, bool &prepared) {
+    // Forced imports must produce the artifacts from scratch
+    if(!force) {
+        QString artifacts = artifactsPath(cache, converter, settings);
+        if(!artifacts.isEmpty() && fetchArtifacts(settings, artifacts)) {
+            return AssetConverter::Success;
+        }
+    }
 
-                    if(QFileInfo::exists(m_projectManager->importPath() + "/" + value)) {
-                        Object *res = Engine::loadResource(value.toStdString());
-                        Engine::resourceSystem()->reloadResource(static_cast<Resource *>(res), true);
-                        emit imported(path, type);
-                    }
+    settings->clearDependencies();
+    if(converter->isThreadSafe()) {
+        return convertFile(converter, settings, cache);
+    }
+
+    uint8_t result = converter->prepareFile(settings);
+    prepared = (result == AssetConverter::Success);
+    return result;
+}
+
+uint8_t AssetManager::convertFile(AssetConverter *converter, AssetConverterSettings *settings, const QString &cache) {
+    uint8_t result = converter->convertFile(settings);
+    if(result == AssetConverter::Success) {
+        // The key depends on the dependencies recorded during the conversion
+        QString artifacts = artifactsPath(cache, converter, settings);
+        if(!artifacts.isEmpty()) {
+            storeArtifacts(settings, artifacts);
+        }
+    }
+    return result;
+}
+
+bool AssetManager::fetchArtifacts(AssetConverterSettings *settings, const QString &artifacts) {
+    QFile file(artifacts + "/" + gManifest);
+    if(!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QJsonObject manifest = QJsonDocument::fromJson(file.readAll()).object();
+    file.close();
+
+    QDir dir(QFileInfo(settings->absoluteDestination()).absolutePath());
+    dir.mkpath(dir.absolutePath());
+
+    QStringList files = { settings->destination() };
+    QJsonObject sub = manifest.value(gSubItems).toObject();
+    for(auto &it : sub.keys()) {
+        files.push_back(sub.value(it).toArray().at(0).toString());
+    }
+    // The current artifacts are replaced only when all the files are fetched
+    QString suffix = "." + QUuid::createUuid().toString();
+    QStringList temps;
+    for(auto &it : files) {
+        QString temp = dir.absoluteFilePath(it) + suffix;
+        if(!QFile::copy(artifacts + "/" + it, temp)) {
+            for(auto &t : temps) {
+                QFile::remove(t);
+            }
+            return false;
+        }
+        temps.push_back(temp);
+    }
+    for(auto &it : files) {
+        QString dst = dir.absoluteFilePath(it);
+        QFile::remove(dst);
+        if(!QFile::rename(dst + suffix, dst)) {
+            return false;
+        }
+    }
+
+    for(auto &it : sub.keys()) {
+        QJsonArray array = sub.value(it).toArray();
+        settings->setSubItem(it, array.at(0).toString(), array.at(1).toInt());
+        if(array.size() > 2) {
+            settings->setSubItemData(it, array.at(2).toObject());
+        }
+    }
+    settings->setCurrentVersion(settings->version());
+
+    return true;
+}
+
+void AssetManager::storeArtifacts(AssetConverterSettings *settings, const QString &artifacts) {
+    if(QFileInfo::exists(artifacts)) {
+        return;
+    }
+    QDir dir(QFileInfo(settings->absoluteDestination()).absolutePath());
+
+    // Entries are assembled aside and published with a single rename, so readers never see a partial one
+    QString temp = artifacts + "." + QUuid::createUuid().toString();
+    if(!QDir().mkpath(temp)) {
+        return;
+    }
+
+    bool result = QFile::copy(settings->absoluteDestination(), temp + "/" + settings->destination());
+
+    QJsonObject sub;
+    for(const QString &it : settings->subKeys()) {
+        QString uuid = settings->subItem(it);
+        if(QFileInfo::exists(dir.absoluteFilePath(uuid))) {
+            result &= QFile::copy(dir.absoluteFilePath(uuid), temp + "/" + uuid);
+        }
+
+        QJsonArray array;
+        array.push_back(uuid);
+        array.push_back(settings->subType(it));
+        QJsonObject data = settings->subItemData(it);
+        if(!data.isEmpty()) {
+            array.push_back(data);
+        }
+        sub[it] = array;
+    }
+
+    QJsonObject manifest;
+    manifest.insert(gSubItems, sub);
+
+    QFile file(temp + "/" + gManifest);
+    if(result && file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(manifest).toJson(QJsonDocument::Compact));
+        file.close();
+
+        if(QDir().rename(temp, artifacts)) {
+            return;
+        }
+    }
+    QDir(temp).removeRecursively();
+}
+
+void AssetManager::convertFinished(AssetConverterSettings *settings, uint8_t result) {
+    switch(result) {
+        case AssetConverter::Success: {
+            Log(Log::INF) << "Converting:" << qPrintable(settings->source());
+
+            QString guid = settings->destination();
+            QString type = settings->typeName();
+            QString source = settings->source();
+            registerAsset(source, guid, type);
+
+            for(const QString &it : settings->subKeys()) {
+                QString value = settings->subItem(it);
+                QString type = settings->subTypeName(it);
+                QString path = source + "/" + it;
+
+                registerAsset(path, value, type);
+
+                if(QFileInfo::exists(m_projectManager->importPath() + "/" + value)) {
+                    Object *res = Engine::loadResource(value.toStdString());
+                    Engine::resourceSystem()->reloadResource(static_cast<Resource *>(res), true);
+                    emit imported(path, type);
                 }
+            }
 
-                Object *res = Engine::loadResource(guid.toStdString());
-                Engine::resourceSystem()->reloadResource(static_cast<Resource *>(res), true);
-                emit imported(source, type);
+            Object *res = Engine::loadResource(guid.toStdString());
+            Engine::resourceSystem()->reloadResource(static_cast<Resource *>(res), true);
+            emit imported(source, type);
 
-                settings->saveSettings();
-            } break;
-            case AssetConverter::CopyAsIs: {
-                QDir dir(m_projectManager->contentPath());
+            settings->saveSettings();
+        } break;
+        case AssetConverter::CopyAsIs: {
+            QDir dir(m_projectManager->contentPath());
+
+            QString dst = m_projectManager->importPath() + "/" + settings->destination();
+            QFileInfo info(dst);
+            dir.mkpath(info.absoluteDir().absolutePath());
+            QFile::copy(settings->source(), dst);
+        } break;
+        default: break;
+    }
+
+    m_importProgress++;
+    emit importProgress(m_importProgress, m_importCount);
+}
+
+void AssetManager::loadStamps() {
+    QFile file(m_projectManager->cachePath() + "/" + gStamps);
+    if(file.open(QIODevice::ReadOnly)) {
+        m_stamps = QJsonDocument::fromJson(file.readAll()).object();
+        file.close();
+    }
+}
+
+void AssetManager::saveStamps() {
+    QDir dir(m_projectManager->contentPath());
+
+    QJsonObject stamps;
+    for(AssetConverterSettings *it : qAsConst(m_converterSettings)) {
+        if(it->sourceSize() >= 0 && !it->hash().isEmpty()) {
+            QJsonArray stamp;
+            stamp.push_back(double(it->sourceSize()));
+            stamp.push_back(double(it->sourceModified()));
+            stamp.push_back(it->hash());
 
-                QString dst = m_projectManager->importPath() + "/" + settings->destination();
-                QFileInfo info(dst);
-                dir.mkpath(info.absoluteDir().absolutePath());
-                QFile::copy(settings->source(), dst);
-            } break;
-            default: break;
+            stamps[dir.relativeFilePath(it->source())] = stamp;
         }
     }
+    m_stamps = stamps;
+
+    QFile file(m_projectManager->cachePath() + "/" + gStamps);
+    if(file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(stamps).toJson(QJsonDocument::Compact));
+        file.close();
+    }
 }
 
 bool AssetManager::isOutdated() const {
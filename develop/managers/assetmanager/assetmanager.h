@@ -7,6 +7,8 @@
 #include <QTimer>
 #include <QImage>
 #include <QSet>
+#include <QMutex>
+#include <QJsonObject>
 
 #include <engine.h>
 #include <module.h>
@@ -17,6 +19,7 @@
 
 class QFileSystemWatcher;
 class QAbstractItemModel;
+class QThreadPool;
 
 class ProjectManager;
 
@@ -91,6 +94,7 @@ signals:
 
     void imported(const QString &path, const QString &type);
     void importStarted(int count, const QString &stage);
+    void importProgress(int value, int count);
     void importFinished();
 
     void iconUpdated(QString guid);
@@ -107,6 +111,8 @@ protected slots:
     void onDirectoryChanged(const QString &path, bool force = false);
 
 private:
+    friend class ImportJob;
+
     AssetManager();
     ~AssetManager();
 
@@ -124,6 +130,21 @@ protected:
     QFileSystemWatcher *m_fileWatcher;
 
     QList<AssetConverterSettings *> m_importQueue;
+    QList<AssetConverterSettings *> m_stageQueue;
+    QList<AssetConverterSettings *> m_deferredImports;
+
+    QSet<AssetConverterSettings *> m_forcedImports;
+    QSet<AssetConverterSettings *> m_activeImports;
+    QSet<AssetConverterSettings *> m_retriedImports;
+
+    QThreadPool *m_threadPool;
+
+    QMutex m_resultsLock;
+    QList<QPair<AssetConverterSettings *, uint8_t>> m_importResults;
+    QList<AssetConverterSettings *> m_preparedImports;
+
+    int32_t m_importCount;
+    int32_t m_importProgress;
 
     ProjectManager *m_projectManager;
 
@@ -136,11 +157,32 @@ protected:
 
     QHash<QString, QImage> m_defaultIcons;
 
+    QJsonObject m_stamps;
+
 protected:
     void cleanupBundle();
     void dumpBundle();
 
     void convert(AssetConverterSettings *settings);
+    void convertFinished(AssetConverterSettings *settings, uint8_t result);
+
+    bool processStage();
+
+    void startImports();
+    void finishImport(AssetConverterSettings *settings, uint8_t result);
+
+    void loadStamps();
+    void saveStamps();
+
+    QString sharedCachePath() const;
+
+    static QString artifactsPath(const QString &cache, AssetConverter *converter, AssetConverterSettings *settings);
+
+    static uint8_t importFile(AssetConverter *converter, AssetConverterSettings *settings, const QString &cache, bool force, bool &prepared);
+    static uint8_t convertFile(AssetConverter *converter, AssetConverterSettings *settings, const QString &cache);
+
+    static bool fetchArtifacts(AssetConverterSettings *settings, const QString &artifacts);
+    static void storeArtifacts(AssetConverterSettings *settings, const QString &artifacts);
 
     QString pathToLocal(const QFileInfo &source);
 
@@ -60,6 +60,7 @@ static string pathTo(Object *src, Object *dst) {
 AssimpImportSettings::AssimpImportSettings() :
         m_pRootActor(nullptr),
         m_pRootBone(nullptr),
+        m_pScene(nullptr),
         m_UseScale(false),
         m_Scale(1.0f),
         m_Colors(true),
@@ -74,6 +75,10 @@ AssimpImportSettings::AssimpImportSettings() :
     setVersion(FORMAT_VERSION);
 }
 
+AssimpImportSettings::~AssimpImportSettings() {
+    aiReleaseImport(m_pScene);
+}
+
 QStringList AssimpImportSettings::typeNames() const {
     return { "Prefab", "Mesh", "Pose", "AnimationClip" };
 }
@@ -202,12 +207,28 @@ Actor *AssimpConverter::createActor(const AssetConverterSettings *settings, cons
     return AssetConverter::createActor(settings, guid);
 }
 
+AssetConverter::ReturnCode AssimpConverter::prepareFile(AssetConverterSettings *settings) {
+    AssimpImportSettings *fbxSettings = static_cast<AssimpImportSettings *>(settings);
+
+    // Parsing and post processing don't touch the engine, the actors are composed in convertFile() on the main thread
+    aiReleaseImport(fbxSettings->m_pScene);
+    fbxSettings->m_pScene = aiImportFile(qPrintable(fbxSettings->source()), aiProcessPreset_TargetRealtime_MaxQuality);
+
+    return (fbxSettings->m_pScene) ? Success : InternalError;
+}
+
 AssetConverter::ReturnCode AssimpConverter::convertFile(AssetConverterSettings *settings) {
     QTime time;
     time.start();
 
     AssimpImportSettings *fbxSettings = static_cast<AssimpImportSettings *>(settings);
 
+    const aiScene *scene = fbxSettings->m_pScene;
+    fbxSettings->m_pScene = nullptr;
+    if(scene == nullptr) {
+        scene = aiImportFile(qPrintable(fbxSettings->source()), aiProcessPreset_TargetRealtime_MaxQuality);
+    }
+
     fbxSettings->m_Renders.clear();
     fbxSettings->m_Resources.clear();
     fbxSettings->m_Bones.clear();
@@ -216,7 +237,6 @@ AssetConverter::ReturnCode AssimpConverter::convertFile(AssetConverterSettings *
     fbxSettings->m_pRootBone = nullptr;
     fbxSettings->m_Flip = false;
 
-    const aiScene *scene = aiImportFile(qPrintable(fbxSettings->source()), aiProcessPreset_TargetRealtime_MaxQuality);
     if(scene) {
         aiMetadata *meta = scene->mMetaData;
         for(uint32_t m = 0; m < meta->mNumProperties; m++) {
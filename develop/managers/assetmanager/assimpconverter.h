@@ -40,6 +40,7 @@ public:
     Q_ENUM(Compression)
 
     AssimpImportSettings();
+    ~AssimpImportSettings();
 
     bool colors() const;
     void setColors(bool value);
@@ -79,6 +80,8 @@ public:
     Actor *m_pRootActor;
     Actor *m_pRootBone;
 
+    const aiScene *m_pScene;
+
     bool m_Flip;
 
 private:
@@ -107,6 +110,7 @@ public:
     AssimpConverter();
 
     QStringList suffixes() const Q_DECL_OVERRIDE { return {"fbx"}; }
+    ReturnCode prepareFile(AssetConverterSettings *) Q_DECL_OVERRIDE;
     ReturnCode convertFile(AssetConverterSettings *) Q_DECL_OVERRIDE;
 
     AssetConverterSettings *createSettings() const Q_DECL_OVERRIDE;
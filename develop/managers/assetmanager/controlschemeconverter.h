@@ -8,6 +8,7 @@ class ControlScehemeConverter : public AssetConverter {
     QStringList suffixes() const Q_DECL_OVERRIDE { return {"controlscheme"}; }
     ReturnCode convertFile(AssetConverterSettings *) Q_DECL_OVERRIDE;
     AssetConverterSettings *createSettings() const Q_DECL_OVERRIDE;
+    bool isThreadSafe() const Q_DECL_OVERRIDE { return true; }
     QString templatePath() const Q_DECL_OVERRIDE { return ":/Templates/Control_Scheme.controlscheme"; }
 };
 
@@ -17,6 +17,7 @@ class TextConverter : public AssetConverter {
     QStringList suffixes() const Q_DECL_OVERRIDE { return {"txt", "json", "html", "htm", "xml"}; }
     ReturnCode convertFile(AssetConverterSettings *s) Q_DECL_OVERRIDE;
     AssetConverterSettings *createSettings() const Q_DECL_OVERRIDE;
+    bool isThreadSafe() const Q_DECL_OVERRIDE { return true; }
 };
 
 #endif // TEXTCONVERTER_H
@@ -18,6 +18,7 @@ public:
     QStringList suffixes() const Q_DECL_OVERRIDE { return {"loc"}; }
     ReturnCode convertFile(AssetConverterSettings *s) Q_DECL_OVERRIDE;
     AssetConverterSettings *createSettings() const Q_DECL_OVERRIDE;
+    bool isThreadSafe() const Q_DECL_OVERRIDE { return true; }
 };
 
 #endif // TRANSLATORCONVERTER_H
@@ -1,12 +1,12 @@
 #ifndef DESKTOPADAPTOR_H
 #define DESKTOPADAPTOR_H
 
-#include "platformadaptor.h"
+#include "nativeadaptor.h"
 
 struct GLFWwindow;
 struct GLFWmonitor;
 
-class DesktopAdaptor : public PlatformAdaptor {
+class DesktopAdaptor : public NativeAdaptor {
 public:
     DesktopAdaptor(Engine *engine);
 
@@ -46,14 +46,6 @@ public:
     Vector4 joystickThumbs(int index) const override;
     Vector2 joystickTriggers(int index) const override;
 
-    void *pluginLoad(const char *name) override;
-
-    bool pluginUnload(void *plugin) override;
-
-    void *pluginAddress(void *plugin, const string &name) override;
-
-    string locationLocalDir() const override;
-
     void syncConfiguration(VariantMap &map) const override;
 
 protected:
@@ -0,0 +1,49 @@
+#ifndef HEADLESSADAPTOR_H
+#define HEADLESSADAPTOR_H
+
+#include "nativeadaptor.h"
+
+class ENGINE_EXPORT HeadlessAdaptor : public NativeAdaptor {
+public:
+    HeadlessAdaptor(Engine *engine);
+
+    virtual ~HeadlessAdaptor() {}
+
+    bool init() override;
+
+    void update() override;
+
+    bool start() override;
+
+    void stop() override;
+
+    void destroy() override;
+
+    bool isValid() override;
+
+    string inputString() const override;
+
+    uint32_t screenWidth() const override;
+    uint32_t screenHeight() const override;
+
+    void syncConfiguration(VariantMap &map) const override;
+
+protected:
+    uint64_t m_frame;
+    uint64_t m_frames;
+
+    uint64_t m_frameStart;
+    uint64_t m_frameInterval;
+
+    uint64_t m_total;
+    uint64_t m_minimum;
+    uint64_t m_maximum;
+
+    uint32_t m_width;
+    uint32_t m_height;
+
+    bool m_running;
+
+};
+
+#endif // HEADLESSADAPTOR_H
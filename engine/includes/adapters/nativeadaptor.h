@@ -0,0 +1,32 @@
+#ifndef NATIVEADAPTOR_H
+#define NATIVEADAPTOR_H
+
+#include "platformadaptor.h"
+
+class ENGINE_EXPORT NativeAdaptor : public PlatformAdaptor {
+public:
+    NativeAdaptor(Engine *engine);
+
+    virtual ~NativeAdaptor() {}
+
+    static bool loadConfiguration(Engine *engine);
+
+    static string localDirectory();
+
+    void *pluginLoad(const char *name) override;
+
+    bool pluginUnload(void *plugin) override;
+
+    void *pluginAddress(void *plugin, const string &name) override;
+
+    string locationLocalDir() const override;
+
+protected:
+    void saveConfiguration(const VariantMap &map) const;
+
+protected:
+    Engine *m_engine;
+
+};
+
+#endif // NATIVEADAPTOR_H
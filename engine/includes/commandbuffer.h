@@ -9,7 +9,12 @@
 #define LOCAL_BIND      1
 #define UNIFORM_BIND    4
 
+#define POLYGONS    "Polygons"
+#define DRAWCALLS   "Draw Calls"
+#define UPLOADS     "Uploads"
+
 class ComputeInstance;
+class ComputeBuffer;
 class RenderTarget;
 class Texture;
 class Mesh;
@@ -64,6 +69,8 @@ public:
 
     virtual void drawMeshInstanced(const Matrix4 *models, uint32_t count, Mesh *mesh, uint32_t sub, uint32_t layer = CommandBuffer::DEFAULT, MaterialInstance *material = nullptr);
 
+    virtual void drawMeshIndirect(ComputeBuffer *models, ComputeBuffer *arguments, Mesh *mesh, uint32_t sub, uint32_t layer = CommandBuffer::DEFAULT, MaterialInstance *material = nullptr);
+
     virtual void setRenderTarget(RenderTarget *target, uint32_t level = 0);
 
     virtual void setColor(const Vector4 &color);
@@ -100,6 +107,10 @@ public:
 
     static void setInited();
 
+    static bool isComputeSupported();
+
+    static void setComputeSupported(bool supported);
+
 protected:
     bool m_screenProjection;
 
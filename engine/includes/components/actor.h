@@ -23,8 +23,8 @@ class ENGINE_EXPORT Actor : public Object {
         A_METHOD(Transform *, Actor::transform),
         A_METHOD(Scene *, Actor::scene),
         A_METHOD(World *, Actor::world),
-        A_METHOD(Component *, Actor::component),
-        A_METHOD(Component *, Actor::componentInChild),
+        A_METHODEX(Component *, Actor::component, Component *(Actor::*)(const string)),
+        A_METHODEX(Component *, Actor::componentInChild, Component *(Actor::*)(const string)),
         A_METHOD(Component *, Actor::addComponent),
         A_METHOD(Object *, Actor::clone),
         A_METHOD(void, Actor::deleteLater)
@@ -49,8 +49,23 @@ public:
     Component *component(const string type);
     Component *componentInChild(const string type);
 
+    Component *component(const MetaObject *type);
+    Component *componentInChild(const MetaObject *type);
+
+    template<typename T>
+    T *component() {
+        return static_cast<T *>(component(T::metaClass()));
+    }
+
+    template<typename T>
+    T *componentInChild() {
+        return static_cast<T *>(componentInChild(T::metaClass()));
+    }
+
     Component *addComponent(const string type);
 
+    static void invalidateComponents();
+
     bool isEnabled() const;
     void setEnabled(const bool enabled);
 
@@ -85,6 +100,9 @@ private:
 
     void clearCloneRef() override;
 
+    void addChild(Object *child, int32_t position = -1) override;
+    void removeChild(Object *child) override;
+
     void setHierarchyEnabled(bool enabled);
 
     void setScene(Scene *scene);
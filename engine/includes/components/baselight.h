@@ -14,7 +14,8 @@ class ENGINE_EXPORT BaseLight : public NativeBehaviour {
         A_PROPERTY(bool, castShadows, BaseLight::castShadows, BaseLight::setCastShadows),
         A_PROPERTY(float, brightness, BaseLight::brightness, BaseLight::setBrightness),
         A_PROPERTYEX(Vector4, color, BaseLight::color, BaseLight::setColor, "editor=Color"),
-        A_PROPERTY(Vector4, bias, BaseLight::bias, BaseLight::setBias)
+        A_PROPERTY(Vector4, bias, BaseLight::bias, BaseLight::setBias),
+        A_PROPERTY(int, shadowUpdateRate, BaseLight::shadowUpdateRate, BaseLight::setShadowUpdateRate)
     )
     A_NOMETHODS()
 
@@ -43,6 +44,9 @@ public:
     Vector4 bias() const;
     void setBias(const Vector4 bias);
 
+    int shadowUpdateRate() const;
+    void setShadowUpdateRate(int rate);
+
     virtual int lightType() const;
 
     MaterialInstance *material() const;
@@ -69,6 +73,8 @@ private:
 
     Vector4 m_color;
 
+    int m_shadowUpdateRate;
+
     MaterialInstance *m_materialInstance;
 
 };
@@ -60,6 +60,8 @@ public:
 protected:
     void draw(CommandBuffer &buffer, uint32_t layer) override;
 
+    bool batch(SpriteBatch &batch) override;
+
     void loadUserData(const VariantMap &data) override;
     VariantMap saveUserData() const override;
 
@@ -5,6 +5,7 @@
 
 class RectTransform;
 class CommandBuffer;
+class SpriteBatch;
 
 class ENGINE_EXPORT Widget : public NativeBehaviour {
     A_REGISTER(Widget, NativeBehaviour, Components/UI)
@@ -28,6 +29,8 @@ public:
 
     virtual void draw(CommandBuffer &buffer, uint32_t layer);
 
+    virtual bool batch(SpriteBatch &batch);
+
 public: // slots
     void lower();
 
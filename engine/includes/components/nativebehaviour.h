@@ -16,6 +16,8 @@ public:
 
     virtual void update();
 
+    virtual void fixedUpdate();
+
 };
 
 #endif // NATIVEBEHAVIOUR_H
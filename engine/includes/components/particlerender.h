@@ -4,7 +4,6 @@
 #include "renderable.h"
 
 class ParticleEmitter;
-class ParticleData;
 class ParticleEffect;
 class ParticleRenderPrivate;
 
@@ -26,13 +25,12 @@ public:
     void deltaUpdate(float dt);
 
 private:
-    void spawnParticle(ParticleEmitter &emitter, ParticleData &data);
-    void updateParticle(ParticleEmitter &emitter, ParticleData &data, float dt);
-
     AABBox bound() const override;
 
     void draw(CommandBuffer &buffer, uint32_t layer) override;
 
+    void dispatch(CommandBuffer &buffer) override;
+
     void update() override;
 
     void loadUserData(const VariantMap &data) override;
@@ -6,6 +6,7 @@
 #include <amath.h>
 
 class CommandBuffer;
+class SpriteBatch;
 
 class ENGINE_EXPORT Renderable : public NativeBehaviour {
     A_REGISTER(Renderable, NativeBehaviour, General)
@@ -21,6 +22,10 @@ public:
 
     virtual void draw(CommandBuffer &buffer, uint32_t layer);
 
+    virtual void dispatch(CommandBuffer &buffer);
+
+    virtual bool batch(SpriteBatch &batch);
+
     virtual AABBox bound() const;
 
     virtual int priority() const;
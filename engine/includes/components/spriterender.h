@@ -70,6 +70,8 @@ public:
 private:
     void draw(CommandBuffer &buffer, uint32_t layer) override;
 
+    bool batch(SpriteBatch &batch) override;
+
     AABBox localBound() const override;
 
     void loadUserData(const VariantMap &data) override;
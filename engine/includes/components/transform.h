@@ -40,6 +40,8 @@ public:
     Quaternion quaternion() const;
     void setQuaternion(const Quaternion quaternion);
 
+    void setPositionAndQuaternion(const Vector3 &position, const Quaternion &quaternion);
+
     Vector3 scale() const;
     void setScale(const Vector3 scale);
 
@@ -56,8 +58,25 @@ public:
 
     void setParent(Object *parent, int32_t position = -1, bool force = false) override;
 
+    bool interpolate() const;
+    void setInterpolate(bool enabled);
+
+    bool isInterpolated() const;
+
+    Matrix4 renderTransform() const;
+
     int hash() const;
 
+    bool isTracked() const;
+    void setTracked(bool enabled);
+
+    static void takeChanges(vector<Transform *> &changes);
+
+    static void beginFixedUpdate();
+    static void beginFixedStep();
+    static void endFixedUpdate();
+    static void applyInterpolation(float factor);
+
 protected:
     const list<Transform *> &children() const;
 
@@ -5,7 +5,10 @@
 #include "system.h"
 #include "scene.h"
 
+class QueryBatch;
+
 typedef bool (*RayCastCallback)(System *system, World *graph, const Ray &ray, float maxDistance, Ray::Hit *hit);
+typedef bool (*QueryBatchCallback)(System *system, World *graph, QueryBatch *batch);
 
 class ENGINE_EXPORT World : public Object {
     A_REGISTER(World, Object, General)
@@ -40,6 +43,14 @@ public:
 
     void setRayCastHandler(RayCastCallback callback, System *system);
 
+    bool submitQueries(QueryBatch *batch);
+
+    void setQueryBatchHandler(QueryBatchCallback callback, System *system);
+
+    const Object::ObjectList &findCachedChildren(const MetaObject *type);
+
+    static void hierarchyChanged();
+
 public: // signals
     void sceneLoaded();
     void sceneUnloaded();
@@ -48,11 +59,19 @@ public: // signals
 
 private:
     void addChild(Object *child, int32_t position = -1) override;
+    void removeChild(Object *child) override;
 
 private:
+    typedef unordered_map<const MetaObject *, pair<uint32_t, Object::ObjectList>> TypeCache;
+
+    TypeCache m_typeCache;
+
     RayCastCallback m_rayCastCallback;
     System *m_rayCastSystem;
 
+    QueryBatchCallback m_queryBatchCallback;
+    System *m_queryBatchSystem;
+
     Scene *m_activeScene;
 
     bool m_dirty;
@@ -47,6 +47,19 @@ public:
     QString hash() const;
     void setHash(const QString &hash);
 
+    QString sourceHash() const;
+    QString artifactKey() const;
+
+    qint64 sourceSize() const;
+    qint64 sourceModified() const;
+    void setSourceStamp(qint64 size, qint64 modified);
+
+    const QStringList dependencies() const;
+    void addDependency(const QString &path);
+    void clearDependencies();
+
+    bool isDependencyChanged() const;
+
     uint32_t version() const;
     void setVersion(uint32_t version);
 
@@ -71,6 +84,15 @@ public:
 signals:
     void updated();
 
+protected:
+    struct FileStamp {
+        qint64 size = -1;
+        qint64 modified = -1;
+        QString md5;
+    };
+
+    QString dependencyHash(const QString &path) const;
+
 protected:
     bool m_valid;
     bool m_modified;
@@ -80,6 +102,8 @@ protected:
     uint32_t m_currentVersion;
 
     mutable QString m_md5;
+    mutable qint64 m_sourceSize;
+    mutable qint64 m_sourceModified;
     QString m_destination;
     QString m_absoluteDestination;
     QString m_source;
@@ -87,6 +111,10 @@ protected:
     QStringMap m_subItems;
     QStringMap m_subTypeNames;
     QMap<QString, int32_t> m_subTypes;
+
+    QStringMap m_dependencies;
+
+    mutable QMap<QString, FileStamp> m_dependencyStamps;
 };
 
 typedef QList<uint32_t> QIntegerList;
@@ -106,9 +134,12 @@ public:
     virtual void init();
     virtual QStringList suffixes() const = 0;
 
+    virtual ReturnCode prepareFile(AssetConverterSettings *settings);
     virtual ReturnCode convertFile(AssetConverterSettings *settings) = 0;
     virtual AssetConverterSettings *createSettings() const = 0;
 
+    virtual bool isThreadSafe() const;
+
     virtual void renameAsset(AssetConverterSettings *settings, const QString &oldName, const QString &newName);
 
     virtual QString templatePath() const;
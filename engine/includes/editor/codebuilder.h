@@ -5,6 +5,8 @@
 
 #include <QMap>
 
+#include <atomic>
+
 class QAbstractItemModel;
 
 class ENGINE_EXPORT BuilderSettings : public AssetConverterSettings {
@@ -49,6 +51,8 @@ public:
 
     ReturnCode convertFile(AssetConverterSettings *) Q_DECL_OVERRIDE;
 
+    bool isThreadSafe() const Q_DECL_OVERRIDE;
+
 signals:
     void buildSuccessful();
 
@@ -71,7 +75,7 @@ protected:
 
     QStringList m_sources;
 
-    bool m_outdated;
+    std::atomic<bool> m_outdated;
 };
 
 #endif // CodeBUILDER_H
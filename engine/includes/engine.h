@@ -20,6 +20,7 @@ class RenderSystem;
 class Resource;
 class World;
 class PlatformAdaptor;
+class ThreadPool;
 
 #if defined(SHARED_DEFINE) && defined(_WIN32)
     #ifdef ENGINE_LIBRARY
@@ -94,8 +95,12 @@ public:
 
     static void setGameMode(bool flag);
 
+    static bool isHeadless();
+
     static File *file();
 
+    static ThreadPool *threadPool();
+
     static string locationAppDir();
 
     static string locationAppConfig();
@@ -123,6 +128,14 @@ private:
 
     void processEvents() override;
 
+    void addObject(Object *object) override;
+
+    void removeObject(Object *object) override;
+
+    void compactBehaviours();
+
+    void fixedUpdate();
+
     static void addSystem(System *system);
 
 private:
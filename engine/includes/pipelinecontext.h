@@ -19,6 +19,7 @@ class Texture;
 class RenderTarget;
 class PipelinePass;
 class GuiLayer;
+class SpriteBatch;
 
 class Widget;
 class BaseLight;
@@ -106,6 +107,8 @@ protected:
 
     GuiLayer *m_guiLayer;
 
+    SpriteBatch *m_spriteBatch;
+
     int32_t m_width;
     int32_t m_height;
 
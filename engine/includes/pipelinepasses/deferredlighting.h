@@ -5,6 +5,9 @@
 
 class RenderTarget;
 class Mesh;
+class MaterialInstance;
+class BaseLight;
+class Camera;
 
 class DeferredLighting : public PipelinePass {
 
@@ -17,6 +20,10 @@ public:
 public:
     DeferredLighting();
 
+    void buildClusters(Camera *camera, const list<BaseLight *> &lights);
+
+    const vector<uint32_t> &clusterLights(uint32_t x, uint32_t y, uint32_t z) const;
+
 private:
     Texture *draw(Texture *source, PipelineContext *context) override;
 
@@ -24,11 +31,25 @@ private:
 
     void setInput(uint32_t index, Texture *texture) override;
 
+    bool isClustered(BaseLight *light) const;
+
 private:
+    vector<vector<uint32_t>> m_clusterLights;
+
+    Vector4 m_clusterParams;
+
     RenderTarget *m_lightPass;
 
     Mesh *m_box;
 
+    MaterialInstance *m_clustered;
+
+    Texture *m_lightsMap;
+
+    Texture *m_clustersMap;
+
+    Texture *m_indicesMap;
+
 };
 
 #endif // DEFERREDLIGHTING_H
@@ -4,6 +4,7 @@
 #include <amath.h>
 
 #include "pipelinepass.h"
+#include "spritebatch.h"
 
 class GuiLayer : public PipelinePass {
 public:
@@ -19,6 +20,8 @@ private:
     void resize(int32_t width, int32_t height) override;
 
 private:
+    SpriteBatch m_batch;
+
     int32_t m_width;
     int32_t m_height;
 
@@ -14,6 +14,7 @@ class AreaLight;
 class DirectLight;
 class SpotLight;
 class PointLight;
+class BaseLight;
 class Renderable;
 
 class ShadowMap : public PipelinePass {
@@ -25,21 +26,87 @@ private:
 
     uint32_t layer() const override;
 
-    void areaLightUpdate(PipelineContext *context, AreaLight *light, list<Renderable *> &components);
+    struct FaceState {
+        Matrix4 matrix;
+
+        uint32_t hash = 0;
+
+        uint32_t updated = 0;
+
+        bool dynamic = false;
+
+        bool valid = false;
+
+        bool cached = false;
+
+    };
+
+    struct ShadowTiles {
+        RenderTarget *target = nullptr;
+
+        RenderTarget *cache = nullptr;
+
+        vector<AtlasNode *> tiles;
+
+        vector<AtlasNode *> cacheTiles;
+
+        vector<FaceState> faces;
+
+        uint32_t updated = 0;
+
+    };
+
+    struct FaceRequest {
+        ShadowTiles *tiles;
+
+        uint32_t face;
+
+        Matrix4 view;
+
+        Matrix4 crop;
+
+        list<Renderable *> statics;
+
+        list<Renderable *> dynamics;
+
+        uint32_t hash;
+
+    };
+
+    void cubeLightUpdate(PipelineContext *context, BaseLight *light, float zFar, list<Renderable *> &components);
     void directLightUpdate(PipelineContext *context, DirectLight *light, list<Renderable *> &components, Camera &camera);
-    void pointLightUpdate(PipelineContext *context, PointLight *light, list<Renderable *> &components);
     void spotLightUpdate(PipelineContext *context, SpotLight *light, list<Renderable *> &components);
 
+    bool prepareFace(FaceRequest &request, const list<Renderable *> &filter) const;
+    void renderFace(PipelineContext *context, const FaceRequest &request);
+
+    bool isUpdateRequired(BaseLight *light, ShadowTiles *tiles) const;
+
     void cleanShadowCache();
 
-    RenderTarget *requestShadowTiles(uint32_t id, uint32_t lod, int32_t *x, int32_t *y, int32_t *w, int32_t *h, uint32_t count);
+    ShadowTiles *requestShadowTiles(uint32_t id, uint32_t lod, uint32_t count);
+
+    RenderTarget *allocateTiles(unordered_map<RenderTarget *, AtlasNode *> &pages, uint32_t lod, uint32_t count, vector<AtlasNode *> &tiles, bool exact);
+
+    void releaseCachePage(RenderTarget *page);
+
+    Vector4 tileRect(const AtlasNode *node, const RenderTarget *page) const;
 
 private:
-    unordered_map<uint32_t, pair<RenderTarget *, vector<AtlasNode *>>> m_tiles;
+    unordered_map<uint32_t, ShadowTiles> m_tiles;
     unordered_map<RenderTarget *, AtlasNode *> m_shadowPages;
+    unordered_map<RenderTarget *, AtlasNode *> m_cachePages;
+
+    vector<FaceRequest> m_requests;
+
+    list<pair<BaseLight *, ShadowTiles *>> m_cubeLights;
 
     Matrix4 m_scale;
 
+    MaterialInstance *m_copy;
+
+    uint32_t m_frame;
+
     vector<Quaternion> m_directions;
 
 };
@@ -0,0 +1,82 @@
+#ifndef QUERYBATCH_H
+#define QUERYBATCH_H
+
+#include "engine.h"
+
+#include <amath.h>
+
+class QueryBatchPrivate;
+
+class ENGINE_EXPORT QueryBatch {
+public:
+    enum QueryType {
+        RayCast = 0,
+        SphereSweep,
+        BoxSweep,
+        SphereOverlap,
+        BoxOverlap
+    };
+
+    struct Query {
+        Quaternion rotation;
+
+        Vector3 origin;
+
+        Vector3 direction;
+
+        Vector3 extent;
+
+        float distance = 0.0f;
+
+        int type = RayCast;
+    };
+
+    struct Result {
+        Ray::Hit hit;
+
+        vector<Object *> objects;
+
+        bool valid = false;
+    };
+
+public:
+    QueryBatch();
+    ~QueryBatch();
+
+    uint32_t addRayCast(const Ray &ray, float distance);
+
+    uint32_t addSphereSweep(const Vector3 &origin, const Vector3 &direction, float radius, float distance);
+
+    uint32_t addBoxSweep(const Vector3 &origin, const Vector3 &direction, const Vector3 &halfExtents, const Quaternion &rotation, float distance);
+
+    uint32_t addSphereOverlap(const Vector3 &center, float radius);
+
+    uint32_t addBoxOverlap(const Vector3 &center, const Vector3 &halfExtents, const Quaternion &rotation);
+
+    void clear();
+
+    uint32_t size() const;
+
+    const Query &query(uint32_t index) const;
+
+    const Result &result(uint32_t index) const;
+
+    bool isFinished() const;
+
+    void wait();
+
+    void begin(uint32_t tasks);
+
+    void finish();
+
+    Result *resultData();
+
+private:
+    uint32_t add(const Query &query);
+
+private:
+    QueryBatchPrivate *p_ptr;
+
+};
+
+#endif // QUERYBATCH_H
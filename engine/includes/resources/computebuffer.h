@@ -18,9 +18,15 @@ public:
     virtual ByteArray data() const;
     void setData(const ByteArray &data);
 
+protected:
+    void switchState(ResourceState state) override;
+    bool isUnloadable() override;
+
 protected:
     ByteArray m_buffer;
 
+    uint32_t m_stride;
+
     bool m_bufferDirty;
 
 };
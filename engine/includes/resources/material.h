@@ -195,6 +195,8 @@ public:
     uint16_t surfaceType() const;
     void setSurfaceType(uint16_t type);
 
+    bool isEqual(const MaterialInstance &instance) const;
+
 protected:
     friend class Material;
 
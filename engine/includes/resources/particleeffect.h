@@ -9,34 +9,44 @@
 class Material;
 class Mesh;
 
-class ParticleData {
+class ENGINE_EXPORT ParticleBuffer {
 public:
-    ParticleData();
+    ParticleBuffer();
 
-    /// Current life of the particle in seconds
-    float life;
+    uint32_t emit(uint32_t count);
+
+    void compact();
+
+    void clear();
+
+    /// Number of alive particles stored at the beginning of the arrays
+    uint32_t count;
+    /// Current life of the particles in seconds
+    vector<float> life;
     /// Current animation frame
-    float frame;
-    /// Distance to camera
-    float distance;
-    /// Transformed position of particle
-    Vector3 transform;
-    /// Current rotation of particle in rads
-    Vector3 angle;
-    /// Current color and alpha of particle
-    Vector4 color;
-    /// Current size of particle
-    Vector3 size;
-    /// Delta to change color and alpha of particle every second
-    Vector4 colrate;
-    /// Current position of the particle
-    Vector3 position;
-    /// Delta to change position of particle every second
-    Vector3 velocity;
-    /// Delta to change rotation of particle every second in degrees
-    Vector3 anglerate;
-    /// Delta to change size of particle every second
-    Vector3 sizerate;
+    vector<float> frame;
+    /// Current rotation of particles in rads
+    Vector3Vector angle;
+    /// Current color and alpha of particles
+    Vector4Vector color;
+    /// Current size of particles
+    Vector3Vector size;
+    /// Delta to change color and alpha of particles every second
+    Vector4Vector colrate;
+    /// Current position of the particles
+    Vector3Vector position;
+    /// Delta to change position of particles every second
+    Vector3Vector velocity;
+    /// Delta to change rotation of particles every second in degrees
+    Vector3Vector anglerate;
+    /// Delta to change size of particles every second
+    Vector3Vector sizerate;
+
+private:
+    void resize(uint32_t size);
+
+    void move(uint32_t to, uint32_t from);
+
 };
 
 class ENGINE_EXPORT ParticleModificator {
@@ -64,8 +74,15 @@ public:
     ParticleModificator();
     virtual ~ParticleModificator();
 
-    virtual void spawnParticle(ParticleData &data);
-    virtual void updateParticle(ParticleData &data, float dt);
+    virtual void spawnParticles(ParticleBuffer &buffer, uint32_t first, uint32_t count);
+    virtual void updateParticles(ParticleBuffer &buffer, float dt);
+
+    virtual int32_t classType() const;
+
+    ValueType valueType() const;
+
+    Vector4 minimum() const;
+    Vector4 maximum() const;
 
     void loadData(const VariantList &list);
 
@@ -0,0 +1,57 @@
+#ifndef SPRITEBATCH_H
+#define SPRITEBATCH_H
+
+#include <amath.h>
+
+#include <engine.h>
+
+class Mesh;
+class MaterialInstance;
+
+class CommandBuffer;
+
+class ENGINE_EXPORT SpriteBatch {
+public:
+    SpriteBatch();
+    ~SpriteBatch();
+
+    void begin(CommandBuffer *buffer, uint32_t layer);
+
+    void add(Mesh *mesh, const Matrix4 &transform, MaterialInstance *material, const Vector4 &color = Vector4(1.0f));
+
+    void flush();
+
+    uint32_t layer() const;
+
+private:
+    struct Batch {
+        Mesh *mesh;
+
+        MaterialInstance *material;
+
+        Vector4 color;
+
+        Vector2 min;
+
+        Vector2 max;
+    };
+
+    vector<Mesh *> m_meshes;
+
+    vector<Batch> m_batches;
+
+    Vector3Vector m_points;
+
+    Matrix4 m_viewProjection;
+
+    CommandBuffer *m_buffer;
+
+    uint32_t m_layer;
+
+    uint32_t m_used;
+
+    bool m_ordered;
+
+};
+
+#endif // SPRITEBATCH_H
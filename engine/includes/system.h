@@ -23,6 +23,8 @@ public:
 
     virtual void update(World *sceneGraph) = 0;
 
+    virtual void fixedUpdate(World *sceneGraph);
+
     virtual int threadPolicy() const = 0;
 
     virtual void syncSettings() const;
@@ -0,0 +1,26 @@
+#ifndef NULLRENDERSYSTEM_H
+#define NULLRENDERSYSTEM_H
+
+#include "rendersystem.h"
+
+class ENGINE_EXPORT NullRenderSystem : public RenderSystem {
+public:
+    NullRenderSystem(Engine *engine);
+    ~NullRenderSystem();
+
+    bool init() override;
+
+    void update(World *world) override;
+
+    uint32_t drawCalls() const;
+
+    uint32_t polygons() const;
+
+    uint32_t dispatches() const;
+
+private:
+    Engine *m_engine;
+
+};
+
+#endif // NULLRENDERSYSTEM_H
@@ -9,6 +9,14 @@ class ENGINE_EXPORT ResourceSystem : public System {
 public:
     typedef unordered_map<string, pair<string, string>> DictionaryMap;
 
+    struct ResourceHashes {
+        uint64_t file = 0;
+
+        size_t size = 0;
+
+        unordered_map<uint32_t, uint64_t> blocks;
+    };
+
 public:
     ResourceSystem();
 
@@ -47,6 +55,9 @@ private:
     mutable ResourceSystem::DictionaryMap  m_indexMap;
     unordered_map<string, Resource *> m_resourceCache;
     unordered_map<Resource *, string> m_referenceCache;
+    unordered_map<Resource *, ResourceHashes> m_hashCache;
+
+    mutex m_cacheMutex;
 
     set<Resource *> m_deleteList;
 
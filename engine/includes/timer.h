@@ -13,6 +13,8 @@ public:
 
     static void update();
 
+    static void advance(uint64_t delta);
+
     static float deltaTime();
 
     static float scale();
@@ -20,7 +22,26 @@ public:
     static void setScale(float scale);
 
     static float time();
+
+    static double preciseTime();
+
+    static float fixedDeltaTime();
+
+    static void setFixedDeltaTime(float delta);
+
+    static uint32_t maxFixedSteps();
+
+    static void setMaxFixedSteps(uint32_t steps);
+
+    static uint32_t fixedSteps();
+
+    static uint64_t fixedTick();
+
+    static double fixedTime();
+
+    static float interpolation();
+
+    static void nextFixedStep();
 };
 
 #endif // TIMER
-
@@ -1,23 +1,14 @@
 #include "adapters/desktopadaptor.h"
-#ifdef _WIN32
-    #include <Windows.h>
-    #include <ShlObj.h>
-#elif __APPLE__
+#ifdef __APPLE__
     #include <CoreFoundation/CoreFoundation.h>
 #endif
-#ifdef __GNUC__
-    #include <dlfcn.h>
-    #include <sys/stat.h>
-#endif
 #include <GLFW/glfw3.h>
 
 #include <log.h>
 #include <file.h>
 #include <utils.h>
-#include <json.h>
 
 #include <mutex>
-#include <algorithm>
 #include <string>
 #include <cstring>
 
@@ -43,9 +34,6 @@ bool DesktopAdaptor::s_Windowed = false;
 bool DesktopAdaptor::s_vSync = false;
 bool DesktopAdaptor::s_mouseLocked = false;
 
-static Engine *g_pEngine = nullptr;
-static File *g_pFile = nullptr;
-
 static string gAppConfig;
 
 static unordered_map<int32_t, int32_t> s_Keys;
@@ -69,12 +57,11 @@ protected:
 };
 
 DesktopAdaptor::DesktopAdaptor(Engine *engine) :
+        NativeAdaptor(engine),
         m_pWindow(nullptr),
         m_pMonitor(nullptr) {
     Log::overrideHandler(new DesktopHandler());
 
-    g_pEngine = engine;
-
 }
 
 bool DesktopAdaptor::init() {
@@ -125,46 +112,7 @@ void DesktopAdaptor::update() {
 }
 
 bool DesktopAdaptor::start() {
-    g_pFile->fsearchPathAdd((g_pEngine->locationAppDir() + "/base.pak").c_str());
-
-    if(Engine::reloadBundle() == false) {
-        Log(Log::ERR) << "Filed to load bundle";
-    }
-
-    gAppConfig = g_pEngine->locationAppConfig();
-    g_pFile = g_pEngine->file();
-
-#if _WIN32
-    int32_t size = MultiByteToWideChar(CP_UTF8, 0, gAppConfig.c_str(), gAppConfig.size(), nullptr, 0);
-    if(size) {
-        wstring path;
-        path.resize(size);
-        MultiByteToWideChar(CP_UTF8, 0, gAppConfig.c_str(), gAppConfig.size(), &path[0], size);
-
-        uint32_t start = 0;
-        for(int32_t slash=0; slash != -1; start = slash) {
-            slash = path.find(L"/", start + 1);
-            if(slash) {
-                CreateDirectoryW(&path.substr(0, slash)[0], nullptr);
-                DWORD error = GetLastError();
-                if(error == ERROR_ALREADY_EXISTS || error == ERROR_ACCESS_DENIED) {
-                    continue;
-                }
-                break;
-            }
-        }
-    }
-#else
-    for(size_t i = 1; i <= gAppConfig.size(); i++) {
-        if(gAppConfig[i] == '/' || i == gAppConfig.size()) {
-            int result = ::mkdir(gAppConfig.substr(0, i).c_str(), 0777);
-            if(result != 0 && (errno == EEXIST || errno == EACCES)) {
-                continue;
-            }
-        }
-    }
-#endif
-    g_pFile->fsearchPathAdd(gAppConfig.c_str(), true);
+    gAppConfig = m_engine->locationAppConfig();
 
     s_Width = Engine::value(SCREEN_WIDTH, s_Width).toInt();
     s_Height = Engine::value(SCREEN_HEIGHT, s_Height).toInt();
@@ -180,29 +128,15 @@ bool DesktopAdaptor::start() {
         }
     }
 
-    if(!g_pFile->exists(CONFIG_NAME)) {
+    File *file = m_engine->file();
+    if(file && !file->exists(CONFIG_NAME)) {
         Engine::syncValues();
     }
 
-    _FILE *fp = g_pFile->fopen(CONFIG_NAME, "r");
-    if(fp) {
-        ByteArray data;
-        data.resize(g_pFile->fsize(fp));
-        g_pFile->fread(&data[0], data.size(), 1, fp);
-        g_pFile->fclose(fp);
-
-        Variant var = Json::load(string(data.begin(), data.end()));
-        if(var.isValid()) {
-            for(auto &it : var.toMap()) {
-                Engine::setValue(it.first, it.second);
-            }
-        }
-    }
-
     s_Windowed = Engine::value(SCREEN_WINDOWED, s_Windowed).toBool();
     s_vSync = Engine::value(SCREEN_VSYNC, s_vSync).toBool();
 
-    m_pWindow = glfwCreateWindow(s_Width, s_Height, g_pEngine->applicationName().c_str(), (s_Windowed) ? nullptr : m_pMonitor, nullptr);
+    m_pWindow = glfwCreateWindow(s_Width, s_Height, m_engine->applicationName().c_str(), (s_Windowed) ? nullptr : m_pMonitor, nullptr);
     if(!m_pWindow) {
         stop();
         return false;
@@ -322,30 +256,6 @@ Vector2 DesktopAdaptor::joystickTriggers(int index) const {
     return Vector2();
 }
 
-void *DesktopAdaptor::pluginLoad(const char *name) {
-#ifdef WIN32
-    return static_cast<void*>(LoadLibraryW(reinterpret_cast<LPCWSTR>(name)));
-#elif(__GNUC__)
-    return dlopen(name, RTLD_NOW);
-#endif
-}
-
-bool DesktopAdaptor::pluginUnload(void *plugin) {
-#ifdef WIN32
-    return FreeLibrary(reinterpret_cast<HINSTANCE>(plugin));
-#elif(__GNUC__)
-    return dlclose(plugin);
-#endif
-}
-
-void *DesktopAdaptor::pluginAddress(void *plugin, const string &name) {
-#ifdef WIN32
-    return (void*)GetProcAddress(reinterpret_cast<HINSTANCE>(plugin), name.c_str());
-#elif(__GNUC__)
-    return dlsym(plugin, name.c_str());
-#endif
-}
-
 void DesktopAdaptor::keyCallback(GLFWwindow *, int code, int, int action, int) {
     s_Keys[static_cast<Input::KeyCode>(code)] = action;
 }
@@ -371,23 +281,6 @@ void DesktopAdaptor::errorCallback(int error, const char *description) {
     Log(Log::ERR) << "Desktop adaptor failed with code:" << error << description;
 }
 
-string DesktopAdaptor::locationLocalDir() const {
-    string result;
-#if _WIN32
-    wchar_t path[MAX_PATH];
-    if(SHGetSpecialFolderPathW(nullptr, path, CSIDL_LOCAL_APPDATA, FALSE)) {
-        result = Utils::wstringToUtf8(wstring(path));
-        replace(result.begin(), result.end(), '\\', '/');
-    }
-#elif __APPLE__
-    result = "~/Library/Preferences";
-#else
-    result += ::getenv("HOME");
-    result += "/.config";
-#endif
-    return result;
-}
-
 void DesktopAdaptor::syncConfiguration(VariantMap &map) const {
     s_Width = Engine::value(SCREEN_WIDTH, s_Width).toInt();
     s_Height = Engine::value(SCREEN_HEIGHT, s_Height).toInt();
@@ -407,10 +300,5 @@ void DesktopAdaptor::syncConfiguration(VariantMap &map) const {
     map[SCREEN_WINDOWED] = s_Windowed;
     map[SCREEN_VSYNC] = s_vSync;
 
-    _FILE *fp = g_pFile->fopen(CONFIG_NAME, "w");
-    if(fp) {
-        string data = Json::save(map, 0);
-        g_pFile->fwrite(&data[0], data.size(), 1, fp);
-        g_pFile->fclose(fp);
-    }
+    saveConfiguration(map);
 }
@@ -0,0 +1,118 @@
+#include "adapters/headlessadaptor.h"
+
+#include <log.h>
+
+#include <chrono>
+#include <thread>
+
+#define DEFAULT_WIDTH 1280
+#define DEFAULT_HEIGHT 720
+
+namespace {
+    const char *SCREEN_WIDTH("screen.width");
+    const char *SCREEN_HEIGHT("screen.height");
+    const char *HEADLESS_FRAMES("headless.frames");
+    const char *HEADLESS_FRAMERATE("headless.framerate");
+};
+
+static uint64_t currentTime() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*!
+    \class HeadlessAdaptor
+    \brief The HeadlessAdaptor class runs the game cycle without a window, graphics context and input devices.
+    \inmodule Engine
+
+    The adaptor is used by dedicated servers and automated benchmarks on the machines without a display.
+    The game cycle can be limited with \c headless.frames setting (0 means infinite run) and throttled with \c headless.framerate setting (0 means as fast as possible).
+    Frame time statistic is printed to the log when the cycle is stopped.
+*/
+
+HeadlessAdaptor::HeadlessAdaptor(Engine *engine) :
+        NativeAdaptor(engine),
+        m_frame(0),
+        m_frames(0),
+        m_frameStart(0),
+        m_frameInterval(0),
+        m_total(0),
+        m_minimum(UINT64_MAX),
+        m_maximum(0),
+        m_width(DEFAULT_WIDTH),
+        m_height(DEFAULT_HEIGHT),
+        m_running(false) {
+
+}
+
+bool HeadlessAdaptor::init() {
+    return true;
+}
+
+void HeadlessAdaptor::update() {
+    uint64_t time = currentTime();
+    uint64_t delta = time - m_frameStart;
+
+    m_total += delta;
+    m_minimum = MIN(m_minimum, delta);
+    m_maximum = MAX(m_maximum, delta);
+    m_frame++;
+
+    if(m_frameInterval > delta) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(m_frameInterval - delta));
+        time = currentTime();
+    }
+    m_frameStart = time;
+
+    PlatformAdaptor::update();
+}
+
+bool HeadlessAdaptor::start() {
+    m_width = MAX(Engine::value(SCREEN_WIDTH, m_width).toInt(), 1);
+    m_height = MAX(Engine::value(SCREEN_HEIGHT, m_height).toInt(), 1);
+
+    m_frames = MAX(Engine::value(HEADLESS_FRAMES, 0).toInt(), 0);
+
+    int32_t rate = Engine::value(HEADLESS_FRAMERATE, 0).toInt();
+    m_frameInterval = (rate > 0) ? 1000000000 / rate : 0;
+
+    m_frame = 0;
+    m_frameStart = currentTime();
+    m_running = true;
+
+    return true;
+}
+
+void HeadlessAdaptor::stop() {
+    if(m_running && m_frame > 0) {
+        Log(Log::INF) << "Headless cycle finished. Frames:" << (int)m_frame
+                      << "Average:" << (float)(m_total / m_frame) / 1000000.0f
+                      << "Min:" << (float)m_minimum / 1000000.0f
+                      << "Max:" << (float)m_maximum / 1000000.0f << "ms";
+    }
+    m_running = false;
+}
+
+void HeadlessAdaptor::destroy() {
+
+}
+
+bool HeadlessAdaptor::isValid() {
+    return m_running && (m_frames == 0 || m_frame < m_frames);
+}
+
+string HeadlessAdaptor::inputString() const {
+    return string();
+}
+
+uint32_t HeadlessAdaptor::screenWidth() const {
+    return m_width;
+}
+
+uint32_t HeadlessAdaptor::screenHeight() const {
+    return m_height;
+}
+
+void HeadlessAdaptor::syncConfiguration(VariantMap &map) const {
+    map[SCREEN_WIDTH] = static_cast<int32_t>(m_width);
+    map[SCREEN_HEIGHT] = static_cast<int32_t>(m_height);
+}
@@ -0,0 +1,172 @@
+#include "adapters/nativeadaptor.h"
+#ifdef _WIN32
+    #include <Windows.h>
+    #include <ShlObj.h>
+#endif
+#ifdef __GNUC__
+    #include <dlfcn.h>
+    #include <sys/stat.h>
+#endif
+
+#include <log.h>
+#include <file.h>
+#include <utils.h>
+#include <json.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+#define CONFIG_NAME "config.json"
+
+/*!
+    \class NativeAdaptor
+    \brief The NativeAdaptor class contains the functionality shared by the desktop platform adaptors.
+    \inmodule Engine
+
+    It loads the game bundle and the configuration file, provides the native plugin loading and the location of the local settings directory.
+    Both DesktopAdaptor and HeadlessAdaptor store the configuration in the same directory.
+*/
+
+NativeAdaptor::NativeAdaptor(Engine *engine) :
+        m_engine(engine) {
+
+}
+/*!
+    Loads the game bundle and applies the values from the configuration file to the \a engine.
+    This method doesn't require an adaptor instance, so it's called before the adaptor is chosen because some values (for example \c platform.headless) affect the Engine initialization.
+    Returns true if the configuration file has been loaded; otherwise returns false.
+*/
+bool NativeAdaptor::loadConfiguration(Engine *engine) {
+    File *file = engine->file();
+    if(file == nullptr) {
+        return false;
+    }
+
+    file->fsearchPathAdd((engine->locationAppDir() + "/base.pak").c_str());
+
+    if(Engine::reloadBundle() == false) {
+        Log(Log::ERR) << "Failed to load bundle";
+    }
+
+    string config = engine->locationAppConfig();
+#ifdef _WIN32
+    int32_t size = MultiByteToWideChar(CP_UTF8, 0, config.c_str(), config.size(), nullptr, 0);
+    if(size) {
+        wstring path;
+        path.resize(size);
+        MultiByteToWideChar(CP_UTF8, 0, config.c_str(), config.size(), &path[0], size);
+
+        uint32_t start = 0;
+        for(int32_t slash=0; slash != -1; start = slash) {
+            slash = path.find(L"/", start + 1);
+            if(slash) {
+                CreateDirectoryW(&path.substr(0, slash)[0], nullptr);
+                DWORD error = GetLastError();
+                if(error == ERROR_ALREADY_EXISTS || error == ERROR_ACCESS_DENIED) {
+                    continue;
+                }
+                break;
+            }
+        }
+    }
+#else
+    for(size_t i = 1; i <= config.size(); i++) {
+        if(config[i] == '/' || i == config.size()) {
+            int result = ::mkdir(config.substr(0, i).c_str(), 0777);
+            if(result != 0 && (errno == EEXIST || errno == EACCES)) {
+                continue;
+            }
+        }
+    }
+#endif
+    file->fsearchPathAdd(config.c_str(), true);
+
+    _FILE *fp = file->fopen(CONFIG_NAME, "r");
+    if(fp) {
+        ByteArray data;
+        data.resize(file->fsize(fp));
+        file->fread(&data[0], data.size(), 1, fp);
+        file->fclose(fp);
+
+        Variant var = Json::load(string(data.begin(), data.end()));
+        if(var.isValid()) {
+            for(auto &it : var.toMap()) {
+                Engine::setValue(it.first, it.second);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+/*!
+    Writes the configuration \a map to the configuration file.
+*/
+void NativeAdaptor::saveConfiguration(const VariantMap &map) const {
+    File *file = m_engine->file();
+    if(file == nullptr) {
+        return;
+    }
+
+    _FILE *fp = file->fopen(CONFIG_NAME, "w");
+    if(fp) {
+        string data = Json::save(map, 0);
+        file->fwrite(&data[0], data.size(), 1, fp);
+        file->fclose(fp);
+    }
+}
+
+void *NativeAdaptor::pluginLoad(const char *name) {
+#ifdef _WIN32
+    // Plugin names are UTF-8 encoded, so they must be converted before passing to the wide char API
+    wstring path;
+    int32_t size = MultiByteToWideChar(CP_UTF8, 0, name, -1, nullptr, 0);
+    if(size > 0) {
+        path.resize(size);
+        MultiByteToWideChar(CP_UTF8, 0, name, -1, &path[0], size);
+    }
+    return static_cast<void *>(LoadLibraryW(path.c_str()));
+#elif(__GNUC__)
+    return dlopen(name, RTLD_NOW);
+#endif
+}
+
+bool NativeAdaptor::pluginUnload(void *plugin) {
+#ifdef _WIN32
+    return FreeLibrary(reinterpret_cast<HINSTANCE>(plugin));
+#elif(__GNUC__)
+    return dlclose(plugin);
+#endif
+}
+
+void *NativeAdaptor::pluginAddress(void *plugin, const string &name) {
+#ifdef _WIN32
+    return (void*)GetProcAddress(reinterpret_cast<HINSTANCE>(plugin), name.c_str());
+#elif(__GNUC__)
+    return dlsym(plugin, name.c_str());
+#endif
+}
+
+string NativeAdaptor::locationLocalDir() const {
+    return localDirectory();
+}
+/*!
+    Returns the local settings directory of the current user.
+*/
+string NativeAdaptor::localDirectory() {
+    string result;
+#if _WIN32
+    wchar_t path[MAX_PATH];
+    if(SHGetSpecialFolderPathW(nullptr, path, CSIDL_LOCAL_APPDATA, FALSE)) {
+        result = Utils::wstringToUtf8(wstring(path));
+        replace(result.begin(), result.end(), '\\', '/');
+    }
+#elif __APPLE__
+    result = "~/Library/Preferences";
+#else
+    const char *home = ::getenv("HOME");
+    if(home) {
+        result = string(home) + "/.config";
+    }
+#endif
+    return result;
+}
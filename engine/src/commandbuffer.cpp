@@ -3,6 +3,7 @@
 #include <cstring>
 
 static bool s_Inited = false;
+static bool s_Compute = false;
 
 CommandBuffer::CommandBuffer() :
     m_screenProjection(false),
@@ -44,6 +45,15 @@ void CommandBuffer::drawMeshInstanced(const Matrix4 *models, uint32_t count, Mes
     A_UNUSED(material);
 }
 
+void CommandBuffer::drawMeshIndirect(ComputeBuffer *models, ComputeBuffer *arguments, Mesh *mesh, uint32_t sub, uint32_t layer, MaterialInstance *material) {
+    A_UNUSED(models);
+    A_UNUSED(arguments);
+    A_UNUSED(mesh);
+    A_UNUSED(sub);
+    A_UNUSED(layer);
+    A_UNUSED(material);
+}
+
 void CommandBuffer::setRenderTarget(RenderTarget *target, uint32_t level) {
     A_UNUSED(target);
     A_UNUSED(level);
@@ -67,6 +77,14 @@ void CommandBuffer::setInited() {
     s_Inited = true;
 }
 
+bool CommandBuffer::isComputeSupported() {
+    return s_Compute;
+}
+
+void CommandBuffer::setComputeSupported(bool supported) {
+    s_Compute = supported;
+}
+
 void CommandBuffer::setColor(const Vector4 &color) {
     m_local.color = color;
 }
@@ -1,5 +1,6 @@
 #include "components/actor.h"
 #include "components/scene.h"
+#include "components/world.h"
 #include "components/transform.h"
 
 #include "resources/prefab.h"
@@ -9,6 +10,7 @@
 #include "commandbuffer.h"
 
 #include <cstring>
+#include <mutex>
 
 #include <json.h>
 #include <log.h>
@@ -18,11 +20,52 @@ const char *PREFAB  ("Prefab");
 const char *DATA    ("PrefabData");
 const char *STATIC  ("Static");
 const char *DELETED ("Deleted");
-const char *TRANSFORM("Transform");
+
+static atomic<uint32_t> s_componentsVersion(1);
+
+typedef unordered_map<uint32_t, Object *> HierarchyIndex;
+
+/*!
+    \internal
+    Adds the objects of the \a root hierarchy to the \a index by UUID and by the UUID of the original object.
+    The index gives the same results as ObjectSystem::findObject() for this hierarchy, the first object in depth-first order wins.
+*/
+static void indexHierarchy(Object *root, HierarchyIndex &index) {
+    Object::ObjectList objects;
+    Object::enumObjects(root, objects);
+    for(auto it : objects) {
+        index.emplace(it->uuid(), it);
+        if(it->clonedFrom() != 0) {
+            index.emplace(it->clonedFrom(), it);
+        }
+    }
+}
+/*!
+    \internal
+    Removes the objects of the \a root hierarchy from the \a index.
+*/
+static void unindexHierarchy(Object *root, HierarchyIndex &index) {
+    Object::ObjectList objects;
+    Object::enumObjects(root, objects);
+    for(auto it : objects) {
+        for(uint32_t key : {it->uuid(), it->clonedFrom()}) {
+            auto item = index.find(key);
+            if(item != index.end() && item->second == it) {
+                index.erase(item);
+            }
+        }
+    }
+}
+
+static Object *findIndexed(const HierarchyIndex &index, uint32_t uuid) {
+    auto it = index.find(uuid);
+    return (it != index.end()) ? it->second : nullptr;
+}
 
 class ActorPrivate : public Resource::IObserver {
 public:
     explicit ActorPrivate(Actor *actor) :
+        m_componentsVersion(0),
         m_transform(nullptr),
         m_prefab(nullptr),
         m_scene(nullptr),
@@ -54,6 +97,7 @@ public:
                     Object::enumObjects(m_actor, deleteObjects);
 
                     list<pair<Object *, Object *>> array;
+                    unordered_map<Object *, Object *> instances;
 
                     for(auto prefabObject : prefabObjects) {
                         bool create = true;
@@ -62,6 +106,7 @@ public:
                             Object *clone = *it;
                             if(prefabObject->uuid() == clone->clonedFrom()) {
                                 array.push_back(make_pair(prefabObject, clone));
+                                instances[prefabObject] = clone;
                                 it = deleteObjects.erase(it);
                                 create = false;
                                 break;
@@ -73,10 +118,18 @@ public:
                             ++it;
                         }
                         if(create) {
-                            Object *parent = System::findObject(prefabObject->parent()->uuid(), m_actor);
+                            // Parents precede children, so the parent is already matched or created
+                            Object *parent = nullptr;
+                            auto instance = instances.find(prefabObject->parent());
+                            if(instance != instances.end()) {
+                                parent = instance->second;
+                            } else {
+                                parent = System::findObject(prefabObject->parent()->uuid(), m_actor);
+                            }
                             Object *result = prefabObject->clone(parent ? parent : m_actor);
 
                             array.push_back(make_pair(prefabObject, result));
+                            instances[prefabObject] = result;
                         }
                     }
 
@@ -103,7 +156,7 @@ public:
                             }
                         }
 
-                        for(auto item : it.first->getReceivers()) {
+                        for(auto item : *it.first->getReceivers()) {
                             MetaMethod signal = it.second->metaObject()->method(item.signal);
                             MetaMethod method = item.receiver->metaObject()->method(item.method);
                             Object::connect(it.second, (to_string(1) + signal.signature()).c_str(),
@@ -142,11 +195,12 @@ public:
         }
     }
 
-    static Component *componentInChildHelper(const string &type, Object *parent) {
+    template<typename T>
+    static Component *componentInChildHelper(const T type, Object *parent) {
         PROFILE_FUNCTION();
         for(auto it : parent->getChildren()) {
             const MetaObject *meta = it->metaObject();
-            if(meta->canCastTo(type.c_str())) {
+            if(meta->canCastTo(type)) {
                 return static_cast<Component *>(it);
             } else {
                 Component *result = componentInChildHelper(type, it);
@@ -158,8 +212,54 @@ public:
         return nullptr;
     }
 
+    /*!
+        \internal
+        Rebuilds the table of components in case of the Actor's children or the MetaObjects were changed since the last lookup.
+        Each child is placed to the slots of its type and all parent types, the first child wins.
+    */
+    void validateComponents() {
+        uint32_t version = s_componentsVersion.load(memory_order_relaxed);
+        if(m_componentsVersion.load(memory_order_acquire) == version) {
+            return;
+        }
+        lock_guard<mutex> locker(m_componentsMutex);
+        if(m_componentsVersion.load(memory_order_relaxed) == version) {
+            return;
+        }
+        m_components.clear();
+        for(auto it : m_actor->getChildren()) {
+            for(const MetaObject *meta = it->metaObject(); meta != nullptr; meta = meta->super()) {
+                uint32_t index = meta->index();
+                if(index >= m_components.size()) {
+                    m_components.resize(index + 1, nullptr);
+                }
+                if(m_components[index] == nullptr) {
+                    m_components[index] = static_cast<Component *>(it);
+                }
+            }
+        }
+        m_componentsVersion.store(version, memory_order_release);
+    }
+
+    /*!
+        \internal
+        Marks the table of components as outdated.
+    */
+    void resetComponents() {
+        lock_guard<mutex> locker(m_componentsMutex);
+        m_componentsVersion.store(0, memory_order_release);
+    }
+
+    typedef vector<Component *> ComponentTable;
+
     VariantMap m_data;
 
+    ComponentTable m_components;
+
+    mutex m_componentsMutex;
+
+    atomic<uint32_t> m_componentsVersion;
+
     Transform *m_transform;
 
     Prefab *m_prefab;
@@ -201,6 +301,8 @@ Actor::Actor() :
 }
 
 Actor::~Actor() {
+    World::hierarchyChanged();
+
     delete p_ptr;
     p_ptr = nullptr;
 }
@@ -316,7 +418,7 @@ void Actor::setLayers(const int layers) {
 Transform *Actor::transform() {
     PROFILE_FUNCTION();
     if(p_ptr->m_transform == nullptr) {
-        p_ptr->m_transform = static_cast<Transform *>(component(TRANSFORM));
+        p_ptr->m_transform = component<Transform>();
     }
     return p_ptr->m_transform;
 }
@@ -339,22 +441,56 @@ World *Actor::world() const{
 }
 /*!
     Returns the component with \a type if one is attached to this Actor; otherwise returns nullptr.
+    The \a type is resolved by the name among the children, after that the component is taken from the table of the Actor.
 */
 Component *Actor::component(const string type) {
     PROFILE_FUNCTION();
     for(auto it : getChildren()) {
         const MetaObject *meta = it->metaObject();
         if(meta->canCastTo(type.c_str())) {
-            return static_cast<Component *>(it);
+            while(type != meta->name()) {
+                meta = meta->super();
+            }
+            return component(meta);
         }
     }
     return nullptr;
 }
+/*!
+    Returns the component with \a type if one is attached to this Actor; otherwise returns nullptr.
+    This overload performs no string operations, the component is taken from the table of the Actor by the MetaObject::index() of the \a type.
+    The table is rebuilt on the first lookup after the change of the Actor's children or invalidateComponents() call.
+    The templated version can be used to get the component of the specific class:
+    \code
+        MeshRender *render = actor->component<MeshRender>();
+    \endcode
+*/
+Component *Actor::component(const MetaObject *type) {
+    PROFILE_FUNCTION();
+    p_ptr->validateComponents();
+
+    uint32_t index = type->index();
+    return (index < p_ptr->m_components.size()) ? p_ptr->m_components[index] : nullptr;
+}
 /*!
     Returns the component with \a type in the Actor's children using depth search.
     A component is returned only if it's found on a current Actor; otherwise returns nullptr.
 */
 Component *Actor::componentInChild(const string type) {
+    PROFILE_FUNCTION();
+    for(auto it : getChildren()) {
+        Component *result = ActorPrivate::componentInChildHelper(type.c_str(), it);
+        if(result) {
+            return static_cast<Component *>(result);
+        }
+    }
+    return nullptr;
+}
+/*!
+    Returns the component with \a type in the Actor's children using depth search.
+    This overload performs no string operations, see component() for the templated version.
+*/
+Component *Actor::componentInChild(const MetaObject *type) {
     PROFILE_FUNCTION();
     for(auto it : getChildren()) {
         Component *result = ActorPrivate::componentInChildHelper(type, it);
@@ -408,6 +544,40 @@ void Actor::clearCloneRef() {
         }
     }
 }
+/*!
+    Invalidates the cached component lookups of all actors.
+    This method must be called before deletion of the dynamically created MetaObjects, for example, on the reload of scripts.
+
+    \sa component()
+*/
+void Actor::invalidateComponents() {
+    s_componentsVersion++;
+}
+/*!
+    \internal
+    Adds the \a child object at given \a position and invalidates the cache of components.
+*/
+void Actor::addChild(Object *child, int32_t position) {
+    PROFILE_FUNCTION();
+    Object::addChild(child, position);
+
+    p_ptr->resetComponents();
+    World::hierarchyChanged();
+}
+/*!
+    \internal
+    Removes the \a child object and invalidates the cache of components.
+*/
+void Actor::removeChild(Object *child) {
+    PROFILE_FUNCTION();
+    Object::removeChild(child);
+
+    p_ptr->resetComponents();
+    if(child == p_ptr->m_transform) {
+        p_ptr->m_transform = nullptr;
+    }
+    World::hierarchyChanged();
+}
 /*!
     Makes the actor a child of the \a parent at given \a position.
     \note Please ignore the \a force flag it will be provided by the default.
@@ -417,6 +587,7 @@ void Actor::setParent(Object *parent, int32_t position, bool force) {
     if(parent == this || (Object::parent() == parent && position == -1)) {
         return;
     }
+    World::hierarchyChanged();
 
     p_ptr->m_scene = nullptr;
 
@@ -507,10 +678,14 @@ void Actor::loadObjectData(const VariantMap &data) {
 
             it = data.find(DELETED);
             if(it != data.end()) {
+                // The other instances of the prefab share the clone references, so the lookups use the index of this copy only
+                HierarchyIndex index;
+                indexHierarchy(actor, index);
                 for(auto &item : (*it).second.toList()) {
                     uint32_t uuid = static_cast<uint32_t>(item.toInt());
-                    Object *result = ObjectSystem::findObject(uuid, actor);
+                    Object *result = findIndexed(index, uuid);
                     if(result && result != actor) {
+                        unindexHierarchy(result, index);
                         delete result;
                     }
                 }
@@ -525,13 +700,20 @@ void Actor::loadObjectData(const VariantMap &data) {
             unordered_map<uint32_t, uint32_t> staticMap;
             auto it = data.find(STATIC);
             if(it != data.end()) {
+                HierarchyIndex index;
+                indexHierarchy(this, index);
                 for(auto &item : (*it).second.toList()) {
                     VariantList array = item.toList();
 
                     uint32_t clone = static_cast<uint32_t>(array.front().toInt());
-                    Object *result = ObjectSystem::findObject(clone, this);
+                    Object *result = findIndexed(index, clone);
                     if(result) {
+                        auto previous = index.find(result->uuid());
+                        if(previous != index.end() && previous->second == result) {
+                            index.erase(previous);
+                        }
                         ObjectSystem::replaceUUID(result, static_cast<uint32_t>(array.back().toInt()));
+                        index.emplace(result->uuid(), result);
                     }
                 }
             }
@@ -563,6 +745,9 @@ void Actor::loadUserData(const VariantMap &data) {
                 cacheMap[clone] = object;
             }
 
+            HierarchyIndex hierarchy;
+            indexHierarchy(this, hierarchy);
+
             const VariantList &list = (*it).second.toList();
             for(auto &item : list) {
                 const VariantList &fields = item.toList();
@@ -585,7 +770,7 @@ void Actor::loadUserData(const VariantMap &data) {
                                 } else if(var.type() == MetaType::INTEGER) { // Component
                                     uint32_t uuid = static_cast<uint32_t>(var.toInt());
 
-                                    Object *obj = Engine::findObject(uuid, this);
+                                    Object *obj = findIndexed(hierarchy, uuid);
                                     if(obj == nullptr) {
                                         obj = Engine::findObject(uuid, Engine::findRoot(this));
                                     }
@@ -28,6 +28,7 @@ BaseLight::BaseLight() :
     m_bias(0.001f),
     m_params(1.0f, 1.0f, 0.5f, 1.0f),
     m_color(1.0f),
+    m_shadowUpdateRate(1),
     m_materialInstance(nullptr) {
 
 }
@@ -97,6 +98,20 @@ void BaseLight::setBias(const Vector4 bias) {
         m_materialInstance->setVector4(uniBias, &m_bias);
     }
 }
+/*!
+    Returns the number of frames between two shadow map updates.
+*/
+int BaseLight::shadowUpdateRate() const {
+    return m_shadowUpdateRate;
+}
+/*!
+    Changes the number of frames between two shadow map updates to \a rate.
+    The value 1 means that shadows are updated every frame.
+    Use greater values for distant or slow changing light sources to reduce the rendering cost.
+*/
+void BaseLight::setShadowUpdateRate(int rate) {
+    m_shadowUpdateRate = MAX(rate, 1);
+}
 
 int BaseLight::lightType() const {
     return Invalid;
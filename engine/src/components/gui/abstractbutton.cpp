@@ -205,13 +205,13 @@ void AbstractButton::update() {
             if(m_checkable) {
                 setChecked(!m_checked);
             }
-            emitSignal(_SIGNAL(pressed()));
+            emitSignal(_SIGNAL_ID(AbstractButton, pressed()));
         }
 
         if(Input::isMouseButtonUp(0) || (Input::touchCount() > 0 && Input::touchState(0) == Input::TOUCH_ENDED)) {
             m_currentFade = 0.0f;
 
-            emitSignal(_SIGNAL(clicked()));
+            emitSignal(_SIGNAL_ID(AbstractButton, clicked()));
         }
 
         if(Input::isMouseButton(0) || Input::touchCount() > 0) {
@@ -236,7 +236,7 @@ void AbstractButton::checkStateSet() {
         for(auto it : actor()->getChildren()) {
             Actor *actor = dynamic_cast<Actor *>(it);
             if(actor) {
-                AbstractButton *btn = static_cast<AbstractButton *>(actor->component("AbstractButton"));
+                AbstractButton *btn = actor->component<AbstractButton>();
                 if(btn && btn != this) {
                     btn->setChecked(false);
                 }
@@ -9,6 +9,7 @@
 #include <components/actor.h>
 #include <components/spriterender.h>
 #include <commandbuffer.h>
+#include <spritebatch.h>
 
 namespace {
     const char *gMaterial = "Material";
@@ -90,6 +91,21 @@ void Image::draw(CommandBuffer &buffer, uint32_t layer) {
         }
     }
 }
+/*!
+    \internal
+*/
+bool Image::batch(SpriteBatch &batch) {
+    if(m_mesh) {
+        Matrix4 mat(rectTransform()->worldTransform());
+        Vector3Vector &verts = m_mesh->vertices();
+        if(!verts.empty()) {
+            mat[12] -= verts[0].x;
+            mat[13] -= verts[0].y;
+            batch.add(m_mesh, mat, (m_customMaterial) ? m_customMaterial : m_material);
+        }
+    }
+    return true;
+}
 
 /*!
     Returns an instantiated Material assigned to Image.
@@ -63,7 +63,7 @@ void Menu::setTitle(const string &title) {
 }
 
 void Menu::show(const Vector2 &position) {
-    emitSignal(_SIGNAL(aboutToShow()));
+    emitSignal(_SIGNAL_ID(Menu, aboutToShow()));
     actor()->setEnabled(true);
     rectTransform()->setPosition(Vector3(position, 0.0f));
     m_visible = true;
@@ -72,7 +72,7 @@ void Menu::show(const Vector2 &position) {
 void Menu::hide() {
     if(m_visible) {
         m_visible = false;
-        emitSignal(_SIGNAL(aboutToHide()));
+        emitSignal(_SIGNAL_ID(Menu, aboutToHide()));
     }
     actor()->setEnabled(false);
 }
@@ -108,7 +108,7 @@ void Menu::update() {
                         r->setSize(Vector2(0.0f, it->rectTransform()->size().y));
                     }
                     if(Input::isMouseButtonDown(0)) {
-                        emitSignal(_SIGNAL(triggered(int)), index);
+                        emitSignal(_SIGNAL_ID(Menu, triggered(int)), index);
                         hide();
                     }
                     break;
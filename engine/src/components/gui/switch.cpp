@@ -158,7 +158,7 @@ void Switch::composeComponent() {
 
         // Add knob
         Actor *knob = Engine::composeActor("Frame", "Knob", background()->actor());
-        Frame *frame = static_cast<Frame *>(knob->component("Frame"));
+        Frame *frame = knob->component<Frame>();
         frame->setCorners(background()->corners());
         setKnobGraphic(frame);
 
@@ -116,7 +116,7 @@ void TextInput::update() {
             m_cursorPosition++;
             recalcCursor();
         } else if(Input::isKeyDown(Input::KEY_ENTER) || Input::isKeyDown(Input::KEY_KP_ENTER)) {
-            emitSignal(_SIGNAL(editingFinished()));
+            emitSignal(_SIGNAL_ID(TextInput, editingFinished()));
         } else {
             string sub = Input::inputString();
             sub.erase(remove_if(sub.begin(), sub.end(), [](unsigned char c) { return (c < 32);}), sub.end());
@@ -134,7 +134,7 @@ void TextInput::update() {
         }
 
         if(m_focused) {
-            emitSignal(_SIGNAL(focusOut()));
+            emitSignal(_SIGNAL_ID(TextInput, focusOut()));
             m_focused = false;
         }
     }
@@ -155,7 +155,7 @@ void TextInput::update() {
             if(m_cursor) {
                 m_cursor->setEnabled(true);
             }
-            emitSignal(_SIGNAL(focusIn()));
+            emitSignal(_SIGNAL_ID(TextInput, focusIn()));
             m_focused = true;
         }
 
@@ -51,6 +51,15 @@ void Widget::draw(CommandBuffer &buffer, uint32_t layer) {
         m_transform->setSize(buffer.viewport());
     }
 }
+/*!
+    \internal
+    Adds the widget geometry to the sprite \a batch instead of a separate draw call.
+    Returns false if the widget can't be batched and must be drawn with draw() method.
+*/
+bool Widget::batch(SpriteBatch &batch) {
+    A_UNUSED(batch);
+    return false;
+}
 /*!
     Lowers the widget to the bottom of the widget's stack.
 
@@ -149,7 +158,7 @@ void Widget::actorParentChanged() {
 
         object = dynamic_cast<Actor *>(object->parent());
         if(object) {
-            m_parent = static_cast<Widget *>(object->component("Widget"));
+            m_parent = object->component<Widget>();
         }
     }
 }
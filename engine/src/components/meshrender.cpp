@@ -35,7 +35,7 @@ void MeshRender::draw(CommandBuffer &buffer, uint32_t layer) {
             buffer.setColor(CommandBuffer::idToColor(a->uuid()));
         }
 
-        buffer.drawMesh(a->transform()->worldTransform(), m_mesh, 0, layer, m_material);
+        buffer.drawMesh(a->transform()->renderTransform(), m_mesh, 0, layer, m_material);
         buffer.setColor(Vector4(1.0f));
     }
 }
@@ -23,6 +23,10 @@
             void update() {
                 Log(Log::DBG) << "Update";
             }
+
+            void fixedUpdate() {
+                Log(Log::DBG) << "Fixed Update";
+            }
         };
     \endcode
 */
@@ -43,3 +47,11 @@ void NativeBehaviour::start() {
 void NativeBehaviour::update() {
 
 }
+/*!
+    Fixed update is called with the constant Timer::fixedDeltaTime() step, if the NativeBehaviour is enabled.
+    It can be called several times per frame or skipped in a frame depending on the frame rate.
+    All simulation logic, for example applying forces to rigid bodies, should be placed in this method to stay deterministic.
+*/
+void NativeBehaviour::fixedUpdate() {
+
+}
@@ -2,6 +2,8 @@
 
 #include <algorithm>
 #include <cfloat>
+#include <cmath>
+#include <cstring>
 
 #include "actor.h"
 #include "transform.h"
@@ -9,42 +11,393 @@
 
 #include "particleeffect.h"
 #include "material.h"
+#include "mesh.h"
+#include "computeshader.h"
+#include "computebuffer.h"
 
 #include "commandbuffer.h"
 #include "timer.h"
 
+#include <threadpool.h>
+
 #define EFFECT "Effect"
 
+#define PARALLEL_THRESHOLD 1024
+
+#define COMPUTE_GROUP 64
+#define COMPUTE_PARAMS 9
+
 typedef vector<Matrix4> BufferArray;
-typedef list<ParticleData> ParticleList;
+
+struct ComputeParticle {
+    Vector4 position;
+    Vector4 velocity;
+    Vector4 color;
+    Vector4 colrate;
+    Vector4 size;
+    Vector4 sizerate;
+};
+
+struct ComputeArguments {
+    uint32_t count;
+    uint32_t instanceCount;
+    uint32_t first;
+    uint32_t baseVertex;
+    uint32_t baseInstance;
+    uint32_t spawned;
+};
+
+class EmitterCompute {
+public:
+    enum Stage {
+        Simulate = 0,
+        Clear,
+        Sort
+    };
+
+public:
+    EmitterCompute() :
+            m_instance(nullptr),
+            m_particles(nullptr),
+            m_instances(nullptr),
+            m_arguments(nullptr),
+            m_capacity(0),
+            m_spawn(0),
+            m_dispatch(false),
+            m_local(false),
+            m_translucent(false) {
+
+    }
+
+    ~EmitterCompute() {
+        delete m_instance;
+
+        Engine::unloadResource(m_particles);
+        Engine::unloadResource(m_instances);
+        Engine::unloadResource(m_arguments);
+    }
+
+    bool init(ParticleEmitter *emitter, bool translucent) {
+        ComputeShader *compute = Engine::loadResource<ComputeShader>(".embedded/ParticleSimulation.compute");
+        if(compute == nullptr || emitter->mesh() == nullptr) {
+            return false;
+        }
+
+        Vector4 defaults[COMPUTE_PARAMS] = {Vector4(1.0f), Vector4(1.0f), Vector4(1.0f)};
+        for(int i = 0; i < COMPUTE_PARAMS; i++) {
+            m_min[i] = m_max[i] = defaults[i];
+        }
+
+        for(auto it : emitter->modifiers()) {
+            if(it->valueType() == ParticleModificator::CURVE) {
+                return false; // Curves are supported by the CPU path only
+            }
+            int32_t type = it->classType();
+            int32_t index = (type >= ParticleModificator::SCALESIZE) ? (type - ParticleModificator::SCALESIZE + 5) : (type - ParticleModificator::LIFETIME);
+            if(index >= 0 && index < COMPUTE_PARAMS) {
+                m_min[index] = it->minimum();
+                m_max[index] = it->maximum();
+            }
+        }
+
+        uint32_t count = static_cast<uint32_t>(ceilf(emitter->distibution() * MAX(m_min[0].x, m_max[0].x))) + 1;
+        m_capacity = COMPUTE_GROUP;
+        while(m_capacity < count) {
+            m_capacity <<= 1;
+        }
+
+        m_particles = Engine::objectCreate<ComputeBuffer>("");
+        m_particles->setStride(sizeof(ComputeParticle));
+        m_particles->setData(ByteArray(m_capacity * sizeof(ComputeParticle), 0));
+
+        m_instances = Engine::objectCreate<ComputeBuffer>("");
+        m_instances->setStride(sizeof(Matrix4));
+        m_instances->setData(ByteArray(m_capacity * sizeof(Matrix4), 0));
+
+        m_arguments = Engine::objectCreate<ComputeBuffer>("");
+        m_arguments->setStride(sizeof(ComputeArguments));
+
+        m_instance = compute->createInstance();
+        m_instance->setBuffer("particles", m_particles);
+        m_instance->setBuffer("instances", m_instances);
+        m_instance->setBuffer("arguments", m_arguments);
+        m_instance->setVector4("uni.minimum", m_min, COMPUTE_PARAMS);
+        m_instance->setVector4("uni.maximum", m_max, COMPUTE_PARAMS);
+
+        m_local = emitter->local();
+        m_translucent = translucent;
+
+        return true;
+    }
+
+    void update(const Matrix4 &world, const Vector3 &camera, uint32_t spawn, float dt) {
+        m_world = world;
+        m_camera = Vector4(camera, dt);
+        m_spawn = spawn;
+        m_dispatch = true;
+    }
+
+    void dispatch(CommandBuffer &buffer, Mesh *mesh) {
+        PROFILE_FUNCTION();
+        m_dispatch = false;
+
+        ComputeArguments args = {};
+        args.count = (mesh->indices().empty()) ? mesh->vertices().size() : mesh->indices().size();
+
+        ByteArray data(sizeof(ComputeArguments));
+        memcpy(&data[0], &args, sizeof(ComputeArguments));
+        m_arguments->setData(data);
+
+        uint32_t groups = m_capacity / COMPUTE_GROUP;
+
+        m_instance->setMatrix4("uni.world", &m_world);
+        m_instance->setVector4("uni.camera", &m_camera);
+
+        Vector4 sort(0.0f, 0.0f, m_capacity, 0.0f);
+        m_instance->setVector4("uni.sort", &sort);
+
+        Vector4 params(m_spawn, m_local ? 1.0f : 0.0f, RANGE(0.0f, 65535.0f), Simulate);
+        m_instance->setVector4("uni.params", &params);
+        buffer.dispatchCompute(m_instance, groups, 1, 1);
+
+        if(m_translucent) {
+            params.w = Clear;
+            m_instance->setVector4("uni.params", &params);
+            buffer.dispatchCompute(m_instance, groups, 1, 1);
+
+            params.w = Sort;
+            m_instance->setVector4("uni.params", &params);
+            // Bitonic sort network over the whole instance buffer
+            for(uint32_t k = 2; k <= m_capacity; k <<= 1) {
+                for(uint32_t j = k >> 1; j > 0; j >>= 1) {
+                    sort.x = j;
+                    sort.y = k;
+                    m_instance->setVector4("uni.sort", &sort);
+                    buffer.dispatchCompute(m_instance, groups, 1, 1);
+                }
+            }
+        }
+    }
+
+    AABBox bound() const {
+        // Particles never come back from the GPU, so the bound is estimated from the spawn ranges
+        float life = MAX(m_min[0].x, m_max[0].x);
+        Vector3 velocity(MAX(fabsf(m_min[8].x), fabsf(m_max[8].x)),
+                         MAX(fabsf(m_min[8].y), fabsf(m_max[8].y)),
+                         MAX(fabsf(m_min[8].z), fabsf(m_max[8].z)));
+        Vector3 position(MAX(fabsf(m_min[4].x), fabsf(m_max[4].x)),
+                         MAX(fabsf(m_min[4].y), fabsf(m_max[4].y)),
+                         MAX(fabsf(m_min[4].z), fabsf(m_max[4].z)));
+        Vector3 size(MAX(m_min[1].x, m_max[1].x),
+                     MAX(m_min[1].y, m_max[1].y),
+                     MAX(m_min[1].z, m_max[1].z));
+
+        return AABBox(Vector3(m_world[12], m_world[13], m_world[14]), position + velocity * life + size);
+    }
+
+    ComputeInstance *m_instance;
+
+    ComputeBuffer *m_particles;
+    ComputeBuffer *m_instances;
+    ComputeBuffer *m_arguments;
+
+    Matrix4 m_world;
+
+    Vector4 m_camera;
+
+    Vector4 m_min[COMPUTE_PARAMS];
+    Vector4 m_max[COMPUTE_PARAMS];
+
+    uint32_t m_capacity;
+    uint32_t m_spawn;
+
+    bool m_dispatch;
+    bool m_local;
+    bool m_translucent;
+
+};
+
+struct EmitterRender;
+
+class EmitterJob : public Object {
+public:
+    explicit EmitterJob(EmitterRender *render) :
+            m_render(render) {
+
+    }
+
+protected:
+    void processEvents() override;
+
+    EmitterRender *m_render;
+
+};
 
 struct EmitterRender {
     EmitterRender() :
+            m_emitter(nullptr),
             m_material(nullptr),
+            m_job(nullptr),
+            m_compute(nullptr),
             m_ejectionTime(0.0f),
             m_count(0.0f),
-            m_visibleCount(0) {
+            m_delta(0.0f),
+            m_visibleCount(0),
+            m_translucent(false) {
 
-        m_particles.resize(1);
         m_buffer.resize(1);
     }
 
     ~EmitterRender() {
         delete m_material;
+        delete m_job;
+        delete m_compute;
+    }
+
+    void update() {
+        PROFILE_FUNCTION();
+        ParticleBuffer &p = m_particles;
+
+        for(uint32_t i = 0; i < p.count; i++) {
+            p.life[i] -= m_delta;
+        }
+        p.compact();
+
+        for(auto it : m_emitter->modifiers()) {
+            it->updateParticles(p, m_delta);
+        }
+
+        if(m_buffer.size() < p.count) {
+            m_buffer.resize(MAX(p.count, m_buffer.size() * 2));
+        }
+
+        bool local = m_emitter->local();
+        m_min = Vector3(FLT_MAX);
+        m_max = Vector3(-FLT_MAX);
+        for(uint32_t i = 0; i < p.count; i++) {
+            Vector3 pos = (local) ? m_world * p.position[i] : p.position[i];
+            float radius = p.size[i].sqrLength();
+
+            Matrix4 &m = m_buffer[i];
+            m.mat[0]  = pos.x;
+            m.mat[1]  = pos.y;
+            m.mat[2]  = pos.z;
+
+            m.mat[3]  = p.angle[i].z;
+
+            m.mat[4]  = p.size[i].x;
+            m.mat[5]  = p.size[i].y;
+            m.mat[6]  = p.size[i].z;
+
+            m.mat[7]  = (m_camera - pos).sqrLength();
+
+            m.mat[10] = p.frame[i];
+            m.mat[11] = p.life[i];
+
+            m.mat[12] = p.color[i].x;
+            m.mat[13] = p.color[i].y;
+            m.mat[14] = p.color[i].z;
+            m.mat[15] = p.color[i].w;
+
+            m_min.x = MIN(m_min.x, pos.x - radius);
+            m_min.y = MIN(m_min.y, pos.y - radius);
+            m_min.z = MIN(m_min.z, pos.z - radius);
+
+            m_max.x = MAX(m_max.x, pos.x + radius);
+            m_max.y = MAX(m_max.y, pos.y + radius);
+            m_max.z = MAX(m_max.z, pos.z + radius);
+        }
+
+        if(m_translucent) {
+            sort();
+        }
+
+        m_visibleCount = p.count;
+    }
+
+    void sort() {
+        PROFILE_FUNCTION();
+        uint32_t count = m_particles.count;
+        if(count < 2) {
+            return;
+        }
+
+        m_keys.resize(count * 2);
+        m_indices.resize(count * 2);
+
+        uint32_t *keys = &m_keys[0];
+        uint32_t *indices = &m_indices[0];
+        uint32_t *keysTmp = keys + count;
+        uint32_t *indicesTmp = indices + count;
+        // Distances are non negative, so the inverted bit patterns give a back to front order
+        for(uint32_t i = 0; i < count; i++) {
+            uint32_t bits;
+            memcpy(&bits, &m_buffer[i].mat[7], sizeof(bits));
+            keys[i] = ~bits;
+            indices[i] = i;
+        }
+
+        for(uint32_t shift = 0; shift < 32; shift += 8) {
+            uint32_t histogram[257] = {0};
+            for(uint32_t i = 0; i < count; i++) {
+                histogram[((keys[i] >> shift) & 0xff) + 1]++;
+            }
+            for(uint32_t i = 1; i < 257; i++) {
+                histogram[i] += histogram[i - 1];
+            }
+            for(uint32_t i = 0; i < count; i++) {
+                uint32_t position = histogram[(keys[i] >> shift) & 0xff]++;
+                keysTmp[position] = keys[i];
+                indicesTmp[position] = indices[i];
+            }
+            std::swap(keys, keysTmp);
+            std::swap(indices, indicesTmp);
+        }
+
+        m_sorted.resize(count);
+        for(uint32_t i = 0; i < count; i++) {
+            m_sorted[i] = m_buffer[indices[i]];
+        }
+        std::copy(m_sorted.begin(), m_sorted.end(), m_buffer.begin());
     }
 
     BufferArray m_buffer;
-    ParticleList m_particles;
+    BufferArray m_sorted;
+
+    vector<uint32_t> m_keys;
+    vector<uint32_t> m_indices;
+
+    ParticleBuffer m_particles;
+
+    Matrix4 m_world;
+
+    Vector3 m_camera;
+
+    Vector3 m_min;
+    Vector3 m_max;
+
+    ParticleEmitter *m_emitter;
 
     MaterialInstance *m_material;
 
+    EmitterJob *m_job;
+
+    EmitterCompute *m_compute;
+
     float m_ejectionTime;
     float m_count;
+    float m_delta;
 
     uint32_t m_visibleCount;
+
+    bool m_translucent;
 };
 typedef deque<EmitterRender> EmitterArray;
 
+void EmitterJob::processEvents() {
+    m_render->update();
+}
+
 class ParticleRenderPrivate : public Resource::IObserver {
 public:
     ParticleRenderPrivate() :
@@ -65,13 +418,33 @@ public:
 
             for(int32_t i = 0; i < m_effect->emittersCount(); i++) {
                 ParticleEmitter *emitter = m_effect->emitter(i);
+                m_emitters[i].m_emitter = emitter;
                 if(emitter->material()) {
                     m_emitters[i].m_material = emitter->material()->createInstance(Material::Billboard);
+                    m_emitters[i].m_translucent = (emitter->material()->blendMode() == Material::Translucent);
+                }
+                if(emitter->gpu() && CommandBuffer::isComputeSupported()) {
+                    EmitterCompute *compute = new EmitterCompute;
+                    if(compute->init(emitter, m_emitters[i].m_translucent)) {
+                        m_emitters[i].m_compute = compute;
+                    } else {
+                        delete compute; // Fallback to the CPU path
+                    }
                 }
             }
         }
     }
 
+    static ThreadPool &threadPool() {
+        static ThreadPool pool;
+        static bool initialized = false;
+        if(!initialized) {
+            pool.setMaxThreads(MAX(ThreadPool::optimalThreadCount() - 1, 1));
+            initialized = true;
+        }
+        return pool;
+    }
+
     AABBox m_aabb;
     EmitterArray m_emitters;
     ParticleEffect *m_effect;
@@ -113,83 +486,93 @@ void ParticleRender::deltaUpdate(float dt) {
     Vector3 pos(camera->transform()->worldPosition());
 
     if(p_ptr->m_effect) {
-        p_ptr->m_aabb.setBox(Vector3(FLT_MAX), Vector3(-FLT_MAX));
+        ThreadPool &pool = ParticleRenderPrivate::threadPool();
+        bool parallel = false;
 
-        uint32_t index  = 0;
         for(auto &it : p_ptr->m_emitters) {
-            ParticleEmitter *emitter = p_ptr->m_effect->emitter(index);
+            ParticleEmitter *emitter = it.m_emitter;
 
-            it.m_visibleCount = 0;
-            uint32_t i = 0;
-            bool local = emitter->local();
             bool continous = emitter->continous();
 
-            // Spawn particles
             it.m_count += emitter->distibution() * dt;
-            while(isEnabled() && (continous || it.m_ejectionTime > 0.0f) && it.m_count >= 1.0f) {
-                ParticleData particle;
-                spawnParticle(*emitter, particle);
-                particle.transform = m * particle.position;
-                it.m_particles.push_back(particle);
-                it.m_count -= 1.0f;
+            if(it.m_compute) {
+                uint32_t count = 0;
+                if(isEnabled() && (continous || it.m_ejectionTime > 0.0f) && it.m_count >= 1.0f) {
+                    count = static_cast<uint32_t>(it.m_count);
+                    it.m_count -= count;
+                }
+                if(!continous) {
+                    it.m_ejectionTime -= dt;
+                }
+                it.m_compute->update(m, pos, count, dt);
+                continue;
             }
 
-            if(it.m_buffer.size() < it.m_particles.size()) {
-                it.m_buffer.resize(it.m_particles.size());
+            // Spawn particles
+            if(isEnabled() && (continous || it.m_ejectionTime > 0.0f) && it.m_count >= 1.0f) {
+                uint32_t count = static_cast<uint32_t>(it.m_count);
+                it.m_count -= count;
+
+                ParticleBuffer &particles = it.m_particles;
+                uint32_t first = particles.emit(count);
+                for(auto mod : emitter->modifiers()) {
+                    mod->spawnParticles(particles, first, count);
+                }
+                if(!emitter->local()) {
+                    for(uint32_t i = first; i < particles.count; i++) {
+                        particles.position[i] = m * particles.position[i];
+                    }
+                }
             }
 
             if(!continous) {
                 it.m_ejectionTime -= dt;
             }
-            // Update particles
-            for(auto &particle : it.m_particles) {
-                particle.life -= dt;
-                if(particle.life >= 0.0f) {
-                    updateParticle(*emitter, particle, dt);
-
-                    particle.transform = (local) ? m * particle.position : particle.position;
-                    particle.distance = (pos - particle.transform).sqrLength();
-
-                    it.m_visibleCount++;
-                } else {
-                    particle.distance = -1.0f;
-                    if(isEnabled() && (continous || it.m_ejectionTime > 0.0f) && it.m_count >= 1.0f) {
-                        spawnParticle(*emitter, particle);
-                        particle.transform = m * particle.position;
-                        it.m_count -= 1.0f;
-                    }
-                }
-                it.m_buffer[i].mat[0]  = particle.transform.x;
-                it.m_buffer[i].mat[1]  = particle.transform.y;
-                it.m_buffer[i].mat[2]  = particle.transform.z;
-
-                it.m_buffer[i].mat[3]  = particle.angle.z;
-
-                it.m_buffer[i].mat[4]  = particle.size.x;
-                it.m_buffer[i].mat[5]  = particle.size.y;
-                it.m_buffer[i].mat[6]  = particle.size.z;
-
-                it.m_buffer[i].mat[7]  = particle.distance;
-
-                it.m_buffer[i].mat[10] = particle.frame;
-                it.m_buffer[i].mat[11] = particle.life;
 
-                it.m_buffer[i].mat[12] = particle.color.x;
-                it.m_buffer[i].mat[13] = particle.color.y;
-                it.m_buffer[i].mat[14] = particle.color.z;
-                it.m_buffer[i].mat[15] = particle.color.w;
-
-                if(particle.life > 0.0f) {
-                    p_ptr->m_aabb.encapsulate(particle.transform, particle.size.sqrLength());
+            // Update particles
+            it.m_world = m;
+            it.m_camera = pos;
+            it.m_delta = dt;
+            if(it.m_particles.count >= PARALLEL_THRESHOLD) {
+                if(it.m_job == nullptr) {
+                    it.m_job = new EmitterJob(&it);
                 }
-
-                i++;
+                pool.start(*it.m_job);
+                parallel = true;
+            } else {
+                it.update();
             }
+        }
 
-            std::sort(it.m_buffer.begin(), it.m_buffer.end(), [](const Matrix4 &left, const Matrix4 &right) { return left[7] > right[7]; });
+        if(parallel) {
+            pool.waitForDone();
+        }
 
-            index++;
+        Vector3 min(FLT_MAX);
+        Vector3 max(-FLT_MAX);
+        for(auto &it : p_ptr->m_emitters) {
+            if(it.m_compute) {
+                Vector3 bb[2];
+                it.m_compute->bound().box(bb[0], bb[1]);
+
+                min.x = MIN(min.x, bb[0].x);
+                min.y = MIN(min.y, bb[0].y);
+                min.z = MIN(min.z, bb[0].z);
+
+                max.x = MAX(max.x, bb[1].x);
+                max.y = MAX(max.y, bb[1].y);
+                max.z = MAX(max.z, bb[1].z);
+            } else if(it.m_visibleCount > 0) {
+                min.x = MIN(min.x, it.m_min.x);
+                min.y = MIN(min.y, it.m_min.y);
+                min.z = MIN(min.z, it.m_min.z);
+
+                max.x = MAX(max.x, it.m_max.x);
+                max.y = MAX(max.y, it.m_max.y);
+                max.z = MAX(max.z, it.m_max.z);
+            }
         }
+        p_ptr->m_aabb.setBox(min, max);
     }
 }
 /*!
@@ -201,17 +584,27 @@ void ParticleRender::draw(CommandBuffer &buffer, uint32_t layer) {
         if(layer & CommandBuffer::RAYCAST) {
             buffer.setColor(CommandBuffer::idToColor(a->uuid()));
         }
-        uint32_t index = 0;
         for(auto &it : p_ptr->m_emitters) {
-            if(it.m_visibleCount > 0) {
-                ParticleEmitter *emitter = p_ptr->m_effect->emitter(index);
-                buffer.drawMeshInstanced(&it.m_buffer[0], it.m_visibleCount, emitter->mesh(), 0, layer, it.m_material);
+            if(it.m_compute) {
+                buffer.drawMeshIndirect(it.m_compute->m_instances, it.m_compute->m_arguments, it.m_emitter->mesh(), 0, layer, it.m_material);
+            } else if(it.m_visibleCount > 0) {
+                buffer.drawMeshInstanced(&it.m_buffer[0], it.m_visibleCount, it.m_emitter->mesh(), 0, layer, it.m_material);
             }
-            index++;
         }
         buffer.setColor(Vector4(1.0f));
     }
 }
+/*!
+    \internal
+    Simulates the GPU emitters once per frame, the draw() calls only read the results.
+*/
+void ParticleRender::dispatch(CommandBuffer &buffer) {
+    for(auto &it : p_ptr->m_emitters) {
+        if(it.m_compute && it.m_compute->m_dispatch) {
+            it.m_compute->dispatch(buffer, it.m_emitter->mesh());
+        }
+    }
+}
 /*!
     Returns a ParticleEffect assigned to the this component.
 */
@@ -234,27 +627,6 @@ void ParticleRender::setEffect(ParticleEffect *effect) {
 /*!
     \internal
 */
-void ParticleRender::spawnParticle(ParticleEmitter &emitter, ParticleData &data) {
-    PROFILE_FUNCTION();
-    data.position.x = 0.0f;
-    data.position.y = 0.0f;
-    data.position.z = 0.0f;
-    for(auto &it : emitter.modifiers()) {
-        it->spawnParticle(data);
-    }
-}
-/*!
-    \internal
-*/
-void ParticleRender::updateParticle(ParticleEmitter &emitter, ParticleData &data, float dt) {
-    PROFILE_FUNCTION();
-    for(auto &it : emitter.modifiers()) {
-        it->updateParticle(data, dt);
-    }
-}
-/*!
-    \internal
-*/
 AABBox ParticleRender::bound() const {
     return p_ptr->m_aabb;
 }
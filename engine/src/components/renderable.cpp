@@ -27,9 +27,10 @@ AABBox Renderable::bound() const {
     AABBox bb = localBound();
     Transform *t = transform();
     int32_t hash = t->hash();
-    if(hash != m_transformHash || m_localBox != bb) {
+    // Interpolated transforms are moved between the fixed updates without changes of the hash
+    if(hash != m_transformHash || m_localBox != bb || t->isInterpolated()) {
         m_localBox = bb;
-        m_worldBox = m_localBox * t->worldTransform();
+        m_worldBox = m_localBox * t->renderTransform();
         m_transformHash = hash;
     }
     return m_worldBox;
@@ -41,6 +42,23 @@ void Renderable::draw(CommandBuffer &buffer, uint32_t layer) {
     A_UNUSED(buffer);
     A_UNUSED(layer);
 }
+/*!
+    \internal
+    Records the compute work of the component to the command \a buffer.
+    It's called once per frame before the first render pass, so the results are ready for all draw() calls.
+*/
+void Renderable::dispatch(CommandBuffer &buffer) {
+    A_UNUSED(buffer);
+}
+/*!
+    \internal
+    Adds the component geometry to the sprite \a batch instead of a separate draw call.
+    Returns false if the component can't be batched and must be drawn with draw() method.
+*/
+bool Renderable::batch(SpriteBatch &batch) {
+    A_UNUSED(batch);
+    return false;
+}
 /*!
     Returns the prority value used to sort renadarble components before drawing.
     Lower values are rendered first and higher are rendered last.
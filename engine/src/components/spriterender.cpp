@@ -8,6 +8,7 @@
 
 #include "commandbuffer.h"
 #include "pipelinecontext.h"
+#include "spritebatch.h"
 
 #include <math.h>
 
@@ -125,7 +126,7 @@ void SpriteRender::draw(CommandBuffer &buffer, uint32_t layer) {
             buffer.setColor(CommandBuffer::idToColor(a->uuid()));
         }
 
-        buffer.drawMesh(a->transform()->worldTransform(),
+        buffer.drawMesh(a->transform()->renderTransform(),
                         (p_ptr->m_customMesh) ? p_ptr->m_customMesh : p_ptr->m_mesh,
                         0, layer, p_ptr->m_material);
         buffer.setColor(Vector4(1.0f));
@@ -134,6 +135,21 @@ void SpriteRender::draw(CommandBuffer &buffer, uint32_t layer) {
 /*!
     \internal
 */
+bool SpriteRender::batch(SpriteBatch &batch) {
+    Actor *a = actor();
+    if(batch.layer() & CommandBuffer::RAYCAST) {
+        // Each sprite must be drawn with the own id color
+        return false;
+    }
+    if(p_ptr->m_mesh && batch.layer() & a->layers()) {
+        batch.add((p_ptr->m_customMesh) ? p_ptr->m_customMesh : p_ptr->m_mesh,
+                  a->transform()->renderTransform(), p_ptr->m_material);
+    }
+    return true;
+}
+/*!
+    \internal
+*/
 AABBox SpriteRender::localBound() const {
     if(p_ptr->m_customMesh) {
         return p_ptr->m_customMesh->bound();
@@ -101,7 +101,7 @@ void TextRender::draw(CommandBuffer &buffer, uint32_t layer) {
         } else {
             buffer.setColor(p_ptr->m_color);
         }
-        buffer.drawMesh(a->transform()->worldTransform(), p_ptr->m_mesh, 0, layer, p_ptr->m_material);
+        buffer.drawMesh(a->transform()->renderTransform(), p_ptr->m_mesh, 0, layer, p_ptr->m_material);
         buffer.setColor(Vector4(1.0f));
     }
 }
@@ -7,13 +7,34 @@
 
 class TransformPrivate {
 public:
-    TransformPrivate()  {
+    TransformPrivate() :
+            m_interpolate(false),
+            m_tracked(false),
+            m_changed(false) {
 
     }
 
     mutex m_mutex;
 
+    Vector3 m_fixedPosition[2];
+    Quaternion m_fixedQuaternion[2];
+
+    Vector3 m_renderPosition;
+    Quaternion m_renderQuaternion;
+
+    bool m_interpolate;
+
+    bool m_tracked;
+
+    bool m_changed;
+
 };
+
+static mutex s_interpolatedMutex;
+static list<Transform *> s_interpolated;
+
+static mutex s_changedMutex;
+static vector<Transform *> s_changed;
 /*!
     \class Transform
     \brief Position, rotation and scale of an Actor.
@@ -42,6 +63,9 @@ Transform::Transform() :
 }
 
 Transform::~Transform() {
+    setInterpolate(false);
+    setTracked(false);
+
     setParentTransform(nullptr, true);
 
     list<Transform *> temp = m_children;
@@ -98,6 +122,16 @@ void Transform::setQuaternion(const Quaternion quaternion) {
 #endif
     setDirty();
 }
+/*!
+    Changes both \a position and \a quaternion of the Transform in local space.
+    Unlike the separate calls of setPosition() and setQuaternion() the Transform and its children are marked as changed only once.
+*/
+void Transform::setPositionAndQuaternion(const Vector3 &position, const Quaternion &quaternion) {
+    unique_lock<mutex> locker(p_ptr->m_mutex);
+    m_position = position;
+    m_quaternion = quaternion;
+    setDirty();
+}
 /*!
     Returns current scale of the Transform in local space.
 */
@@ -233,12 +267,153 @@ void Transform::setParent(Object *parent, int32_t position, bool force) {
         setParentTransform(p->transform(), true);
     }
 }
+/*!
+    Returns true if the Transform is rendered with interpolation between the last two fixed update states; otherwise returns false.
+*/
+bool Transform::interpolate() const {
+    return p_ptr->m_interpolate;
+}
+/*!
+    Enables or disables rendering with interpolation between the last two fixed update states.
+    Should be \a enabled for the objects which are moved in the fixed update phase, for example by physics, to avoid a stutter when the frame rate differs from the fixed update rate.
+    The interpolated state is used for rendering only (see renderTransform()), the Transform itself always keeps the last fixed state.
+    \note Changes of the position or rotation made outside of the fixed update phase are treated as a teleportation.
+*/
+void Transform::setInterpolate(bool enabled) {
+    unique_lock<mutex> locker(s_interpolatedMutex);
+    if(p_ptr->m_interpolate == enabled) {
+        return;
+    }
+    p_ptr->m_interpolate = enabled;
+    if(enabled) {
+        p_ptr->m_fixedPosition[0] = p_ptr->m_fixedPosition[1] = p_ptr->m_renderPosition = m_position;
+        p_ptr->m_fixedQuaternion[0] = p_ptr->m_fixedQuaternion[1] = p_ptr->m_renderQuaternion = m_quaternion;
+        s_interpolated.push_back(this);
+    } else {
+        s_interpolated.remove(this);
+    }
+}
+/*!
+    Returns true if the Transform or any of its parents is rendered with interpolation; otherwise returns false.
+*/
+bool Transform::isInterpolated() const {
+    for(const Transform *it = this; it != nullptr; it = it->m_parent) {
+        if(it->p_ptr->m_interpolate) {
+            return true;
+        }
+    }
+    return false;
+}
+/*!
+    Returns the transform matrix in world space which must be used for rendering.
+    For the interpolated transforms (and their children) it's blended between the last two fixed update states; otherwise it's equal to worldTransform().
+*/
+Matrix4 Transform::renderTransform() const {
+    if(!isInterpolated()) {
+        return worldTransform();
+    }
+
+    Matrix4 local;
+    TransformPrivate *p = p_ptr;
+    if(p->m_interpolate && m_position == p->m_fixedPosition[1] && m_quaternion == p->m_fixedQuaternion[1]) {
+        local = Matrix4(p->m_renderPosition, p->m_renderQuaternion, m_scale);
+    } else { // Teleported after the fixed update phase
+        local = localTransform();
+    }
+
+    if(m_parent) {
+        return m_parent->renderTransform() * local;
+    }
+    return local;
+}
+/*!
+    Detects teleportations of the interpolated transforms before the fixed update phase.
+    \internal
+*/
+void Transform::beginFixedUpdate() {
+    unique_lock<mutex> locker(s_interpolatedMutex);
+    for(auto it : s_interpolated) {
+        TransformPrivate *p = it->p_ptr;
+        if(it->m_position != p->m_fixedPosition[1] || it->m_quaternion != p->m_fixedQuaternion[1]) {
+            p->m_fixedPosition[0] = p->m_fixedPosition[1] = p->m_renderPosition = it->m_position;
+            p->m_fixedQuaternion[0] = p->m_fixedQuaternion[1] = p->m_renderQuaternion = it->m_quaternion;
+        }
+    }
+}
+/*!
+    Stores the previous fixed state for all interpolated transforms before the fixed update step.
+    \internal
+*/
+void Transform::beginFixedStep() {
+    unique_lock<mutex> locker(s_interpolatedMutex);
+    for(auto it : s_interpolated) {
+        it->p_ptr->m_fixedPosition[0] = it->m_position;
+        it->p_ptr->m_fixedQuaternion[0] = it->m_quaternion;
+    }
+}
+/*!
+    Stores the current fixed state for all interpolated transforms after the fixed update phase.
+    \internal
+*/
+void Transform::endFixedUpdate() {
+    unique_lock<mutex> locker(s_interpolatedMutex);
+    for(auto it : s_interpolated) {
+        it->p_ptr->m_fixedPosition[1] = it->m_position;
+        it->p_ptr->m_fixedQuaternion[1] = it->m_quaternion;
+    }
+}
+/*!
+    Blends the last two fixed states of all interpolated transforms with the \a factor.
+    The result is used by renderTransform() only, the transforms keep the last fixed state.
+    \internal
+*/
+void Transform::applyInterpolation(float factor) {
+    unique_lock<mutex> locker(s_interpolatedMutex);
+    for(auto it : s_interpolated) {
+        TransformPrivate *p = it->p_ptr;
+
+        p->m_renderPosition = p->m_fixedPosition[0] + (p->m_fixedPosition[1] - p->m_fixedPosition[0]) * factor;
+        p->m_renderQuaternion.mix(p->m_fixedQuaternion[0], p->m_fixedQuaternion[1], factor);
+    }
+}
 /*!
     \internal
 */
 int Transform::hash() const {
     return m_hash;
 }
+/*!
+    Returns true if the changes of the Transform are tracked; otherwise returns false.
+*/
+bool Transform::isTracked() const {
+    return p_ptr->m_tracked;
+}
+/*!
+    Enables or disables the tracking of changes for the Transform.
+    When \a enabled, each change of the Transform or any of its parents puts the Transform to the list of changes which can be retrieved with takeChanges().
+    This allows the systems, for example physics, to synchronize only the moved objects instead of checking all of them every frame.
+*/
+void Transform::setTracked(bool enabled) {
+    unique_lock<mutex> locker(s_changedMutex);
+    p_ptr->m_tracked = enabled;
+    if(!enabled && p_ptr->m_changed) {
+        p_ptr->m_changed = false;
+        s_changed.erase(std::remove(s_changed.begin(), s_changed.end(), this), s_changed.end());
+    }
+}
+/*!
+    Moves all tracked transforms which were changed since the last call to the \a changes list.
+    Each Transform appears in the list only once regardless of the number of changes.
+    \internal
+*/
+void Transform::takeChanges(vector<Transform *> &changes) {
+    unique_lock<mutex> locker(s_changedMutex);
+    for(auto it : s_changed) {
+        it->p_ptr->m_changed = false;
+    }
+    changes.insert(changes.end(), s_changed.begin(), s_changed.end());
+    s_changed.clear();
+}
 /*!
     \internal
 */
@@ -250,6 +425,13 @@ const list<Transform *> &Transform::children() const {
 */
 void Transform::setDirty() {
     m_dirty = true;
+    if(p_ptr->m_tracked) {
+        unique_lock<mutex> locker(s_changedMutex);
+        if(p_ptr->m_tracked && !p_ptr->m_changed) {
+            p_ptr->m_changed = true;
+            s_changed.push_back(this);
+        }
+    }
     for(auto it : m_children) {
         it->setDirty();
     }
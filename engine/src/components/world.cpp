@@ -1,11 +1,17 @@
 #include "components/world.h"
 
+#include "querybatch.h"
+
 #include "components/actor.h"
 #include "components/scene.h"
 #include "resources/map.h"
 
 #include "components/private/postprocessorsettings.h"
 
+#include <atomic>
+
+static atomic<uint32_t> s_hierarchyVersion(1);
+
 /*!
     \class World
     \brief A root object in the scene graph hierarchy.
@@ -20,6 +26,8 @@
 World::World() :
     m_rayCastCallback(nullptr),
     m_rayCastSystem(nullptr),
+    m_queryBatchCallback(nullptr),
+    m_queryBatchSystem(nullptr),
     m_activeScene(nullptr),
     m_dirty(true),
     m_update(false) {
@@ -60,7 +68,7 @@ Scene *World::loadScene(const string &path, bool additive) {
                 }
                 scene->setParent(this);
             }
-            emitSignal(_SIGNAL(sceneLoaded()));
+            emitSignal(_SIGNAL_ID(World, sceneLoaded()));
             return scene;
         }
     }
@@ -73,7 +81,7 @@ void World::unloadScene(Scene *scene) {
     Resource *map = dynamic_cast<Resource *>(scene->resource());
     if(map) {
         Engine::unloadResource(map);
-        emitSignal(_SIGNAL(sceneUnloaded()));
+        emitSignal(_SIGNAL_ID(World, sceneUnloaded()));
         if(m_activeScene == scene) {
             Scene *newScene = nullptr;
             for(auto it : getChildren()) {
@@ -101,11 +109,12 @@ Scene *World::activeScene() const {
 */
 void World::setActiveScene(Scene *scene) {
     m_activeScene = scene;
-    emitSignal(_SIGNAL(activeSceneChanged()));
+    emitSignal(_SIGNAL_ID(World, activeSceneChanged()));
 }
 /*!
     Casts a ray, from point \a origin, in direction \a direction, of length \a maxDistance, against all colliders in the World.
     Returns true if the ray has a \a hit with a Collider; otherwise returns false.
+    The distance of the \a hit is the fraction of \a maxDistance in range [0, 1].
 */
 bool World::rayCast(const Ray &ray, float maxDistance, Ray::Hit *hit) {
     if(m_rayCastCallback) {
@@ -124,6 +133,67 @@ void World::setRayCastHandler(RayCastCallback callback, System *system) {
     m_rayCastCallback = callback;
     m_rayCastSystem = system;
 }
+/*!
+    Submits the \a batch of physics queries for the asynchronous execution.
+    The results are ready at the latest by the next frame, use QueryBatch::isFinished() or QueryBatch::wait() to synchronize.
+    Returns true if the batch is accepted by a physical system; otherwise the batch is finished immediately without results and returns false.
+*/
+bool World::submitQueries(QueryBatch *batch) {
+    if(batch == nullptr) {
+        return false;
+    }
+    if(m_queryBatchCallback) {
+        return m_queryBatchCallback(m_queryBatchSystem, this, batch);
+    }
+    batch->begin(0);
+    return false;
+}
+/*!
+    Sets the query batch \a callback function.
+
+    This function will be used to execute the batched ray casts, sweeps and overlap tests.
+    This callback is added by any physical \a system by the default.
+*/
+void World::setQueryBatchHandler(QueryBatchCallback callback, System *system) {
+    m_queryBatchCallback = callback;
+    m_queryBatchSystem = system;
+}
+/*!
+    Returns all objects of the \a type in the World hierarchy.
+    The list is built once and reused until the hierarchy of any World is changed, which makes it suitable for the per frame lookups of the common types like Camera or the light sources.
+    \code
+        for(auto it : world->findCachedChildren(Camera::metaClass())) {
+            Camera *camera = static_cast<Camera *>(it);
+            ...
+        }
+    \endcode
+    \note The returned list must not be kept between the frames.
+*/
+const Object::ObjectList &World::findCachedChildren(const MetaObject *type) {
+    PROFILE_FUNCTION();
+    uint32_t version = s_hierarchyVersion.load();
+
+    auto &entry = m_typeCache[type];
+    if(entry.first != version) {
+        entry.first = version;
+        entry.second.clear();
+        visitChildren([&entry, type](Object *object) {
+            if(object->metaObject()->canCastTo(type)) {
+                entry.second.push_back(object);
+            }
+            return true;
+        });
+    }
+    return entry.second;
+}
+/*!
+    \internal
+    Invalidates the cached lists of findCachedChildren().
+    This method is called by the Actor on each change of the hierarchy.
+*/
+void World::hierarchyChanged() {
+    s_hierarchyVersion++;
+}
 /*!
     \internal
 */
@@ -132,5 +202,14 @@ void World::addChild(Object *child, int32_t position) {
     if(m_activeScene == nullptr && dynamic_cast<Scene *>(child)) {
         setActiveScene(static_cast<Scene *>(child));
     }
+    hierarchyChanged();
+}
+/*!
+    \internal
+*/
+void World::removeChild(Object *child) {
+    Object::removeChild(child);
+
+    hierarchyChanged();
 }
 
@@ -5,6 +5,9 @@
 #include <QJsonDocument>
 #include <QMetaProperty>
 #include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDateTime>
 #include <QCryptographicHash>
 
 #include "editor/projectmanager.h"
@@ -15,14 +18,49 @@ namespace {
     const char *gMd5("md5");
     const char *gVersion("version");
     const char *gGUID("guid");
+    const char *gDependencies("dependencies");
 };
 
+static QJsonObject settingsProperties(const QObject *object) {
+    QJsonObject result;
+    const QMetaObject *meta = object->metaObject();
+    for(int i = 0; i < meta->propertyCount(); i++) {
+        QMetaProperty property = meta->property(i);
+        if(QString(property.name()) != "objectName") {
+            result.insert(property.name(), QJsonValue::fromVariant(property.read(object)));
+        }
+    }
+    return result;
+}
+
+static QString fileHash(const QString &path) {
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+    QCryptographicHash crypto(QCryptographicHash::Md5);
+    crypto.addData(&file);
+    file.close();
+
+    QByteArray md5 = crypto.result().toHex();
+    md5 = md5.insert(20, '-');
+    md5 = md5.insert(16, '-');
+    md5 = md5.insert(12, '-');
+    md5 = md5.insert( 8, '-');
+    md5.push_front('{');
+    md5.push_back('}');
+
+    return md5;
+}
+
 AssetConverterSettings::AssetConverterSettings() :
         m_valid(false),
         m_modified(false),
         m_type(MetaType::INVALID),
         m_version(0),
-        m_currentVersion(0) {
+        m_currentVersion(0),
+        m_sourceSize(-1),
+        m_sourceModified(-1) {
 
     connect(this, &AssetConverterSettings::updated, this, &AssetConverterSettings::setModified);
 }
@@ -53,28 +91,14 @@ bool AssetConverterSettings::isOutdated() const {
     if(version() > currentVersion()) {
         return true;
     }
-    bool result = true;
-
-    QFile file(source());
-    if(file.open(QIODevice::ReadOnly)) {
-        QByteArray md5 = QCryptographicHash::hash(file.readAll(), QCryptographicHash::Md5).toHex();
-        file.close();
-
-        md5 = md5.insert(20, '-');
-        md5 = md5.insert(16, '-');
-        md5 = md5.insert(12, '-');
-        md5 = md5.insert( 8, '-');
-        md5.push_front('{');
-        md5.push_back('}');
-
-        if(hash() == md5) {
-            if(isCode() || QFileInfo::exists(absoluteDestination())) {
-                result = false;
-            }
+    QString md5 = hash();
+    QString current = sourceHash();
+    if(!current.isEmpty() && current == md5 && !isDependencyChanged()) {
+        if(isCode() || QFileInfo::exists(absoluteDestination())) {
+            return false;
         }
-        m_md5 = md5;
     }
-    return result;
+    return true;
 }
 
 bool AssetConverterSettings::isCode() const {
@@ -103,6 +127,118 @@ QString AssetConverterSettings::hash() const {
 }
 void AssetConverterSettings::setHash(const QString &hash) {
     m_md5 = hash;
+    m_sourceSize = -1;
+    m_sourceModified = -1;
+}
+
+QString AssetConverterSettings::sourceHash() const {
+    QFileInfo info(source());
+    if(!info.exists()) {
+        return QString();
+    }
+    qint64 size = info.size();
+    qint64 modified = info.lastModified().toMSecsSinceEpoch();
+
+    if(m_md5.isEmpty() || size != m_sourceSize || modified != m_sourceModified) {
+        QString md5 = fileHash(source());
+        if(md5.isEmpty()) {
+            return QString();
+        }
+        m_md5 = md5;
+        m_sourceSize = size;
+        m_sourceModified = modified;
+    }
+    return m_md5;
+}
+/*!
+    Returns the list of absolute paths to the files used by the converter to produce the asset.
+*/
+const QStringList AssetConverterSettings::dependencies() const {
+    return m_dependencies.keys();
+}
+/*!
+    Records the file with \a path as a dependency of the asset.
+    The converter should call this method for each additional file it reads, so the asset will be reimported when one of them has been changed.
+*/
+void AssetConverterSettings::addDependency(const QString &path) {
+    QFileInfo info(path);
+    m_dependencies[info.absoluteFilePath()] = dependencyHash(info.absoluteFilePath());
+}
+/*!
+    Removes all the recorded dependencies.
+*/
+void AssetConverterSettings::clearDependencies() {
+    m_dependencies.clear();
+    m_dependencyStamps.clear();
+}
+/*!
+    Returns true in case of one of the recorded dependencies was changed or removed since the last conversion; otherwise returns false.
+*/
+bool AssetConverterSettings::isDependencyChanged() const {
+    for(auto it = m_dependencies.constBegin(); it != m_dependencies.constEnd(); ++it) {
+        if(dependencyHash(it.key()) != it.value()) {
+            return true;
+        }
+    }
+    return false;
+}
+/*!
+    \internal
+    Returns the current content hash of the dependency file with \a path.
+    Same as for the source file the hash is recalculated only when the size or modification time of the file has been changed.
+*/
+QString AssetConverterSettings::dependencyHash(const QString &path) const {
+    QFileInfo info(path);
+    if(!info.exists()) {
+        m_dependencyStamps.remove(path);
+        return QString();
+    }
+    qint64 size = info.size();
+    qint64 modified = info.lastModified().toMSecsSinceEpoch();
+
+    FileStamp &stamp = m_dependencyStamps[path];
+    if(stamp.md5.isEmpty() || size != stamp.size || modified != stamp.modified) {
+        stamp.md5 = fileHash(path);
+        stamp.size = size;
+        stamp.modified = modified;
+    }
+    return stamp.md5;
+}
+
+QString AssetConverterSettings::artifactKey() const {
+    QString md5 = sourceHash();
+    if(md5.isEmpty()) {
+        return QString();
+    }
+    QCryptographicHash crypto(QCryptographicHash::Sha1);
+    crypto.addData(md5.toLatin1());
+    crypto.addData(destination().toLatin1());
+    crypto.addData(QByteArray::number(type()));
+    crypto.addData(QByteArray::number(version()));
+    crypto.addData(QJsonDocument(settingsProperties(this)).toJson(QJsonDocument::Compact));
+
+    // The absolute paths differ between the machines, so only the current contents of the dependencies are used
+    QStringList hashes;
+    for(auto it = m_dependencies.constBegin(); it != m_dependencies.constEnd(); ++it) {
+        hashes.push_back(dependencyHash(it.key()));
+    }
+    hashes.sort();
+    crypto.addData(hashes.join(',').toLatin1());
+
+    return crypto.result().toHex();
+}
+
+qint64 AssetConverterSettings::sourceSize() const {
+    return m_sourceSize;
+}
+
+qint64 AssetConverterSettings::sourceModified() const {
+    return m_sourceModified;
+}
+
+void AssetConverterSettings::setSourceStamp(qint64 size, qint64 modified) {
+    m_sourceSize = size;
+    m_sourceModified = modified;
 }
 
 uint32_t AssetConverterSettings::version() const {
@@ -200,6 +336,13 @@ bool AssetConverterSettings::loadSettings() {
         setHash(object.value(gMd5).toString());
         setCurrentVersion(uint32_t(object.value(gVersion).toInt()));
 
+        QDir dir(ProjectManager::instance()->contentPath());
+        m_dependencies.clear();
+        QJsonObject dependencies = object.value(gDependencies).toObject();
+        foreach(QString it, dependencies.keys()) {
+            m_dependencies[dir.absoluteFilePath(it)] = dependencies.value(it).toString();
+        }
+
         QJsonObject sub = object.value(gSubItems).toObject();
         foreach(QString it, sub.keys()) {
             QJsonArray array = sub.value(it).toArray();
@@ -222,17 +365,7 @@ bool AssetConverterSettings::loadSettings() {
 }
 
 void AssetConverterSettings::saveSettings() {
-    QJsonObject set;
-    QObject *object = dynamic_cast<QObject *>(this);
-    if(object) {
-        const QMetaObject *meta = object->metaObject();
-        for(int i = 0; i < meta->propertyCount(); i++) {
-            QMetaProperty property = meta->property(i);
-            if(QString(property.name()) != "objectName") {
-                set.insert(property.name(), QJsonValue::fromVariant(property.read(object)));
-            }
-        }
-    }
+    QJsonObject set = settingsProperties(this);
 
     QJsonObject obj;
     obj.insert(gVersion, int(currentVersion()));
@@ -257,6 +390,15 @@ void AssetConverterSettings::saveSettings() {
     }
     obj.insert(gSubItems, sub);
 
+    if(!m_dependencies.isEmpty()) {
+        QDir dir(ProjectManager::instance()->contentPath());
+        QJsonObject dependencies;
+        for(auto it = m_dependencies.constBegin(); it != m_dependencies.constEnd(); ++it) {
+            dependencies[dir.relativeFilePath(it.key())] = it.value();
+        }
+        obj.insert(gDependencies, dependencies);
+    }
+
     QFile fp(QString(source()) + gMetaExt);
     if(fp.open(QIODevice::WriteOnly)) {
         fp.write(QJsonDocument(obj).toJson(QJsonDocument::Indented));
@@ -281,6 +423,24 @@ AssetConverterSettings *AssetConverter::createSettings() const {
     return new AssetConverterSettings();
 }
 
+/*!
+    Runs the part of the conversion for the \a settings which doesn't touch the engine systems.
+    This method is called on an import thread for the converters which are not thread safe, convertFile() is called right after on the main thread in case of Success.
+    Converters can override it to move the heavy work like the source parsing out of the main thread.
+
+    \sa isThreadSafe()
+*/
+AssetConverter::ReturnCode AssetConverter::prepareFile(AssetConverterSettings *settings) {
+    Q_UNUSED(settings)
+    return Success;
+}
+/*!
+    Returns true in case of convertFile() can be called from the import threads; otherwise returns false.
+    Such converters must not use the engine systems, the resources have to be created on the stack.
+*/
+bool AssetConverter::isThreadSafe() const {
+    return false;
+}
 void AssetConverter::renameAsset(AssetConverterSettings *settings, const QString &oldName, const QString &newName) {
     Q_UNUSED(settings)
     Q_UNUSED(oldName)
@@ -53,6 +53,12 @@ AssetConverter::ReturnCode CodeBuilder::convertFile(AssetConverterSettings *) {
     makeOutdated();
     return Skipped;
 }
+/*!
+    Sources are only marked to be rebuilt by buildProject() on the main thread, so they are converted on the import threads.
+*/
+bool CodeBuilder::isThreadSafe() const {
+    return true;
+}
 
 AssetConverterSettings *CodeBuilder::createSettings() const {
     return new BuilderSettings();
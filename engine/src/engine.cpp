@@ -1,6 +1,8 @@
 #include "engine.h"
 
 #include <stdint.h>
+#include <cstdlib>
+#include <cstring>
 #include <sstream>
 
 #include <log.h>
@@ -33,6 +35,7 @@
     #include "adapters/mobileadaptor.h"
 #else
     #include "adapters/desktopadaptor.h"
+    #include "adapters/headlessadaptor.h"
 #endif
 #include "resources/text.h"
 #include "resources/texture.h"
@@ -56,6 +59,7 @@
 
 #include "systems/resourcesystem.h"
 #include "systems/rendersystem.h"
+#include "systems/nullrendersystem.h"
 
 #include "pipelinecontext.h"
 #include "commandbuffer.h"
@@ -76,6 +80,14 @@ namespace {
     static const char *gProject(".project");
 
     static const char *gTransform("Transform");
+
+    static const char *gFixedRate("timer.fixedrate");
+    static const char *gMaxFixedSteps("timer.maxfixedsteps");
+
+    static const char *gProfilerSummary("profiler.summary");
+
+    static const char *gHeadless("platform.headless");
+    static const char *gHeadlessEnv("THUNDER_HEADLESS");
 }
 
 #define INDEX_VERSION 2
@@ -93,6 +105,17 @@ public:
         if(m_platform) {
             m_platform->destroy();
             delete m_platform;
+            m_platform = nullptr;
+        }
+
+        if(m_nullRender) {
+            if(m_renderSystem == m_nullRender) {
+                m_renderSystem = nullptr;
+            }
+            m_pool.remove(m_nullRender);
+            m_serial.remove(m_nullRender);
+            delete m_nullRender;
+            m_nullRender = nullptr;
         }
 
         //for(auto it : m_pool) {
@@ -119,6 +142,8 @@ public:
 
     static bool              m_game;
 
+    static bool              m_headless;
+
     static string            m_applicationPath;
 
     static string            m_applicationDir;
@@ -137,12 +162,25 @@ public:
 
     static RenderSystem     *m_renderSystem;
 
+    RenderSystem            *m_nullRender = nullptr;
+
     static Translator       *m_translator;
+
+    vector<NativeBehaviour *> m_behaviours;
+
+    unordered_map<Object *, size_t> m_behaviourIndices;
+
+    bool                     m_behavioursDirty = false;
+
+    uint32_t                 m_summaryInterval = 0;
+
+    uint32_t                 m_summaryFrames = 0;
 };
 
 File            *EnginePrivate::m_file = nullptr;
 
 bool             EnginePrivate::m_game = false;
+bool             EnginePrivate::m_headless = false;
 VariantMap       EnginePrivate::m_values;
 string           EnginePrivate::m_applicationPath;
 string           EnginePrivate::m_applicationDir;
@@ -262,6 +300,10 @@ Engine::~Engine() {
 
     deleteAllObjects();
 
+    if(EnginePrivate::m_instance == this) {
+        EnginePrivate::m_instance = nullptr;
+    }
+
     delete p_ptr;
 }
 /*!
@@ -273,7 +315,19 @@ bool Engine::init() {
 #ifdef THUNDER_MOBILE
     EnginePrivate::m_platform = new MobileAdaptor(this);
 #else
-    EnginePrivate::m_platform = new DesktopAdaptor(this);
+    // The bundle and config file can enable headless mode, so they must be loaded before the adaptor is chosen
+    NativeAdaptor::loadConfiguration(this);
+
+    const char *headless = getenv(gHeadlessEnv);
+    EnginePrivate::m_headless = (value(gHeadless, false).toBool() || (headless && strcmp(headless, "0") != 0));
+    if(EnginePrivate::m_headless) {
+        EnginePrivate::m_platform = new HeadlessAdaptor(this);
+        // Owned by the engine, the render modules are not loaded in headless mode
+        p_ptr->m_nullRender = new NullRenderSystem(this);
+        addSystem(p_ptr->m_nullRender);
+    } else {
+        EnginePrivate::m_platform = new DesktopAdaptor(this);
+    }
 #endif
     bool result = EnginePrivate::m_platform->init();
 
@@ -294,6 +348,13 @@ bool Engine::start() {
 
     p_ptr->m_platform->start();
 
+    int32_t rate = value(gFixedRate, 60).toInt();
+    if(rate > 0) {
+        Timer::setFixedDeltaTime(1.0f / static_cast<float>(rate));
+    }
+    Timer::setMaxFixedSteps(value(gMaxFixedSteps, static_cast<int32_t>(Timer::maxFixedSteps())).toInt());
+    p_ptr->m_summaryInterval = MAX(value(gProfilerSummary, 0).toInt(), 0);
+
     for(auto it : EnginePrivate::m_pool) {
         if(!it->init()) {
             Log(Log::ERR) << "Failed to initialize system:" << it->name().c_str();
@@ -356,16 +417,25 @@ void Engine::resize() {
 /*!
     This method launches all your game modules responsible for processing all the game logic.
     It calls on each iteration of the game cycle.
+    In builds with the profiler, the statistic of the last complete frame is printed to the log every \c profiler.summary frames (0 means never).
     \note Usually, this method calls internally and must not be called manually.
 */
 void Engine::update() {
+    PROFILE_FRAME;
     PROFILE_FUNCTION();
 
+#ifdef PROFILING_ENABLED
+    if(p_ptr->m_summaryInterval > 0 && (++p_ptr->m_summaryFrames % p_ptr->m_summaryInterval) == 0) {
+        Log(Log::INF) << PROFILER_SUMMARY;
+    }
+#endif
+
     Camera *camera = Camera::current();
     if(camera == nullptr || !camera->isEnabled() || !camera->actor()->isEnabled()) {
-        for(auto it : EnginePrivate::m_world->findChildren<Camera *>()) {
-            if(it->isEnabled() && it->actor()->isEnabled()) { // Get first active Camera
-                camera = it;
+        for(auto it : EnginePrivate::m_world->findCachedChildren(Camera::metaClass())) {
+            Camera *component = static_cast<Camera *>(it);
+            if(component->isEnabled() && component->actor()->isEnabled()) { // Get first active Camera
+                camera = component;
                 break;
             }
         }
@@ -375,6 +445,8 @@ void Engine::update() {
 
     processEvents();
 
+    fixedUpdate();
+
     EnginePrivate::m_world->setToBeUpdated(true);
 
     for(auto it : EnginePrivate::m_pool) {
@@ -401,8 +473,10 @@ void Engine::processEvents() {
         ObjectSystem::processEvents();
 
         if(isGameMode()) {
-            for(auto it : m_objectList) {
-                NativeBehaviour *comp = dynamic_cast<NativeBehaviour *>(it);
+            compactBehaviours();
+
+            for(size_t i = 0; i < p_ptr->m_behaviours.size(); i++) {
+                NativeBehaviour *comp = p_ptr->m_behaviours[i];
                 if(comp && comp->isEnabled() && comp->world() == EnginePrivate::m_world) {
                     if(!comp->isStarted()) {
                         comp->start();
@@ -416,6 +490,96 @@ void Engine::processEvents() {
         aError() << "Unable to proceess game cycle";
     }
 }
+/*!
+    Executes the fixed update phase.
+    The phase is repeated Timer::fixedSteps() times per frame with the constant Timer::fixedDeltaTime() step.
+    NativeBehaviour::fixedUpdate() and System::fixedUpdate() are called on each step, after that the render state of all interpolated transforms is blended between the last two fixed states.
+    \internal
+*/
+void Engine::fixedUpdate() {
+    PROFILE_FUNCTION();
+
+    uint32_t steps = Timer::fixedSteps();
+    if(steps > 0) {
+        Transform::beginFixedUpdate();
+
+        for(uint32_t step = 0; step < steps; step++) {
+            Transform::beginFixedStep();
+
+            if(isGameMode()) {
+                compactBehaviours();
+
+                for(size_t i = 0; i < p_ptr->m_behaviours.size(); i++) {
+                    NativeBehaviour *comp = p_ptr->m_behaviours[i];
+                    if(comp && comp->isEnabled() && comp->isStarted() && comp->world() == EnginePrivate::m_world) {
+                        comp->fixedUpdate();
+                    }
+                }
+            }
+
+            for(auto it : EnginePrivate::m_pool) {
+                it->setActiveGraph(EnginePrivate::m_world);
+                it->fixedUpdate(EnginePrivate::m_world);
+            }
+            for(auto it : EnginePrivate::m_serial) {
+                it->setActiveGraph(EnginePrivate::m_world);
+                it->fixedUpdate(EnginePrivate::m_world);
+            }
+
+            Timer::nextFixedStep();
+        }
+
+        Transform::endFixedUpdate();
+    }
+
+    Transform::applyInterpolation(Timer::interpolation());
+}
+/*!
+    \internal
+    Registers the \a object in the engine and adds it to the update list in case of NativeBehaviour.
+*/
+void Engine::addObject(Object *object) {
+    ObjectSystem::addObject(object);
+
+    NativeBehaviour *behaviour = dynamic_cast<NativeBehaviour *>(object);
+    if(behaviour) {
+        p_ptr->m_behaviourIndices[object] = p_ptr->m_behaviours.size();
+        p_ptr->m_behaviours.push_back(behaviour);
+    }
+}
+/*!
+    \internal
+    Unregisters the \a object from the engine.
+    The update list slot is cleared only to keep the update loops valid, the list is compacted before the next loop.
+*/
+void Engine::removeObject(Object *object) {
+    ObjectSystem::removeObject(object);
+
+    auto it = p_ptr->m_behaviourIndices.find(object);
+    if(it != p_ptr->m_behaviourIndices.end()) {
+        p_ptr->m_behaviours[it->second] = nullptr;
+        p_ptr->m_behaviourIndices.erase(it);
+        p_ptr->m_behavioursDirty = true;
+    }
+}
+/*!
+    \internal
+    Removes the cleared slots from the update list.
+*/
+void Engine::compactBehaviours() {
+    if(p_ptr->m_behavioursDirty) {
+        size_t index = 0;
+        for(auto it : p_ptr->m_behaviours) {
+            if(it) {
+                p_ptr->m_behaviourIndices[it] = index;
+                p_ptr->m_behaviours[index] = it;
+                index++;
+            }
+        }
+        p_ptr->m_behaviours.resize(index);
+        p_ptr->m_behavioursDirty = false;
+    }
+}
 /*!
     \internal
 */
@@ -605,6 +769,18 @@ bool Engine::reloadBundle() {
 ResourceSystem *Engine::resourceSystem() {
     return EnginePrivate::m_resourceSystem;
 }
+/*!
+    Returns the thread pool which executes the systems with the System::Pool policy.
+    External modules can start their parallel jobs on it instead of creating own threads.
+    The jobs can be started from a system update which itself occupies one of the pool threads, so the caller must never block on the jobs which haven't started yet.
+    Returns nullptr if the engine doesn't exist.
+*/
+ThreadPool *Engine::threadPool() {
+    if(EnginePrivate::m_instance) {
+        return &EnginePrivate::m_instance->p_ptr->m_threadPool;
+    }
+    return nullptr;
+}
 /*!
     Returns the render system which can be used in external modules.
 */
@@ -617,6 +793,14 @@ RenderSystem *Engine::renderSystem() {
 bool Engine::isGameMode() {
     return EnginePrivate::m_game;
 }
+/*!
+    Returns true if the engine runs without a window and graphics device; otherwise returns false.
+    Headless mode is enabled with \c platform.headless setting (in the project settings, config file or set before init() call) or \c THUNDER_HEADLESS environment variable.
+    In this mode render modules are ignored and the NullRenderSystem is used instead.
+*/
+bool Engine::isHeadless() {
+    return EnginePrivate::m_headless;
+}
 /*!
     Set game \a flag to true if game started; otherwise set false.
 */
@@ -640,6 +824,10 @@ void Engine::addModule(Module *module) {
     PROFILE_FUNCTION();
     VariantMap metaInfo = Json::load(module->metaInfo()).toMap();
     for(auto &it : metaInfo[gObjects].toMap()) {
+        if(it.second.toString() == "render" && EnginePrivate::m_headless) {
+            Log(Log::DBG) << "Render module skipped in headless mode:" << it.first.c_str();
+            continue;
+        }
         if(it.second.toString() == "system" || it.second.toString() == "render") {
             addSystem(reinterpret_cast<System *>(module->getObject(it.first.c_str())));
         }
@@ -705,8 +893,11 @@ string Engine::locationAppDir() {
 string Engine::locationAppConfig() {
     PROFILE_FUNCTION();
 
+#ifdef THUNDER_MOBILE
     string result = EnginePrivate::m_platform->locationLocalDir();
-#ifndef THUNDER_MOBILE
+#else
+    // The configuration is loaded before the platform adaptor is chosen
+    string result = EnginePrivate::m_platform ? EnginePrivate::m_platform->locationLocalDir() : NativeAdaptor::localDirectory();
     if(!EnginePrivate::m_organization.empty()) {
         result  += "/" + EnginePrivate::m_organization;
     }
@@ -28,6 +28,7 @@
 #include "pipelinepasses/guilayer.h"
 
 #include "commandbuffer.h"
+#include "spritebatch.h"
 
 #include <algorithm>
 
@@ -43,6 +44,7 @@ PipelineContext::PipelineContext() :
         m_final(nullptr),
         m_camera(nullptr),
         m_guiLayer(new GuiLayer),
+        m_spriteBatch(new SpriteBatch),
         m_width(64),
         m_height(64),
         m_frustumCulling(true) {
@@ -74,6 +76,8 @@ PipelineContext::PipelineContext() :
 
 PipelineContext::~PipelineContext() {
     m_textureBuffers.clear();
+
+    delete m_spriteBatch;
 }
 
 CommandBuffer *PipelineContext::buffer() const {
@@ -83,6 +87,11 @@ CommandBuffer *PipelineContext::buffer() const {
 void PipelineContext::draw(Camera *camera) {
     setCurrentCamera(camera);
 
+    // Compute work is recorded before the passes which draw its results
+    for(auto it : m_sceneComponents) {
+        it->dispatch(*m_buffer);
+    }
+
     m_final = nullptr;
     for(auto it : m_renderPasses) {
         if(it->isEnabled()) {
@@ -285,9 +294,15 @@ list<string> PipelineContext::renderTextures() const {
 }
 
 void PipelineContext::drawRenderers(uint32_t layer, const list<Renderable *> &list) {
+    // Batchable components are merged by material until a component which must be drawn on its own
+    m_spriteBatch->begin(m_buffer, layer);
     for(auto it : list) {
-        it->draw(*m_buffer, layer);
+        if(!it->batch(*m_spriteBatch)) {
+            m_spriteBatch->flush();
+            it->draw(*m_buffer, layer);
+        }
     }
+    m_spriteBatch->flush();
 }
 
 list<Renderable *> &PipelineContext::sceneComponents() {
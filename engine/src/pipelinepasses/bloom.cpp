@@ -21,7 +21,8 @@ namespace {
 Bloom::Bloom() :
         m_threshold(1.0f),
         m_width(0),
-        m_height(0) {
+        m_height(0),
+        m_material(nullptr) {
 
     setName("Bloom");
 
@@ -102,5 +103,7 @@ void Bloom::resize(int32_t width, int32_t height) {
 
 void Bloom::setSettings(const PostProcessSettings &settings) {
     m_threshold = settings.readValue(bloomThreshold).toFloat();
-    m_material->setFloat("uni.threshold", &m_threshold);
+    if(m_material) {
+        m_material->setFloat("uni.threshold", &m_threshold);
+    }
 }
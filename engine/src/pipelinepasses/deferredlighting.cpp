@@ -9,31 +9,93 @@
 
 #include "resources/rendertarget.h"
 #include "resources/mesh.h"
+#include "resources/material.h"
 
 #include "pipelinecontext.h"
 #include "commandbuffer.h"
 
+#include <cmath>
+#include <cstring>
+#include <float.h>
+
+#define TILES_X 16
+#define TILES_Y 9
+#define SLICES 24
+
+#define MAX_LIGHTS 1024
+
+#define INDEX_WIDTH 1024
+#define INDEX_HEIGHT 16
+#define MAX_INDICES (INDEX_WIDTH * INDEX_HEIGHT * 4)
+
 namespace {
+    const char *clusteredLighting("graphics.clusteredlighting");
+
     const char *uniPosition  = "uni.position";
     const char *uniDirection = "uni.direction";
     const char *uniRight     = "uni.right";
     const char *uniUp        = "uni.up";
+    const char *uniClusters  = "uni.clusters";
+
+    inline void setTexel(float *data, uint32_t x, uint32_t y, const Vector4 &value) {
+        memcpy(&data[(y * MAX_LIGHTS + x) * 4], &value, sizeof(Vector4));
+    }
 }
 
 DeferredLighting::DeferredLighting() :
+    m_clusterLights(TILES_X * TILES_Y * SLICES),
     m_lightPass(Engine::objectCreate<RenderTarget>("lightPass")),
-    m_box(Engine::loadResource<Mesh>(".embedded/cube.fbx/Box001")) {
+    m_box(Engine::loadResource<Mesh>(".embedded/cube.fbx/Box001")),
+    m_clustered(nullptr),
+    m_lightsMap(Engine::objectCreate<Texture>()),
+    m_clustersMap(Engine::objectCreate<Texture>()),
+    m_indicesMap(Engine::objectCreate<Texture>()) {
+
+    Engine::setValue(clusteredLighting, true);
 
+    Material *material = Engine::loadResource<Material>(".embedded/ClusteredLighting.shader");
+    if(material) {
+        m_clustered = material->createInstance();
+    }
+
+    m_lightsMap->setFormat(Texture::RGBA32Float);
+    m_lightsMap->setFiltering(Texture::None);
+    m_lightsMap->resize(MAX_LIGHTS, 4);
+
+    m_clustersMap->setFormat(Texture::RGBA32Float);
+    m_clustersMap->setFiltering(Texture::None);
+    m_clustersMap->resize(TILES_X * TILES_Y, SLICES);
+
+    m_indicesMap->setFormat(Texture::RGBA32Float);
+    m_indicesMap->setFiltering(Texture::None);
+    m_indicesMap->resize(INDEX_WIDTH, INDEX_HEIGHT);
+
+    if(m_clustered) {
+        m_clustered->setTexture("lightsMap", m_lightsMap);
+        m_clustered->setTexture("clustersMap", m_clustersMap);
+        m_clustered->setTexture("indicesMap", m_indicesMap);
+    }
 }
 
 Texture *DeferredLighting::draw(Texture *source, PipelineContext *context) {
     CommandBuffer *buffer = context->buffer();
 
+    Camera *camera = context->currentCamera();
+    bool clustered = (m_clustered && !camera->orthographic() && Engine::value(clusteredLighting, true).toBool());
+
+    list<BaseLight *> clusteredLights;
+
     buffer->setRenderTarget(m_lightPass);
     // Light pass
     for(auto it : context->sceneLights()) {
         BaseLight *light = static_cast<BaseLight *>(it);
 
+        // Simple lights are shaded all together in one pass, the rest is drawn with light volumes
+        if(clustered && clusteredLights.size() < MAX_LIGHTS && isClustered(light)) {
+            clusteredLights.push_back(light);
+            continue;
+        }
+
         Mesh *mesh = m_box;
 
         Matrix4 mat;
@@ -117,6 +179,14 @@ Texture *DeferredLighting::draw(Texture *source, PipelineContext *context) {
         }
     }
 
+    if(!clusteredLights.empty()) {
+        buildClusters(camera, clusteredLights);
+
+        buffer->setScreenProjection();
+        buffer->drawMesh(Matrix4(), PipelineContext::defaultPlane(), 0, CommandBuffer::LIGHT, m_clustered);
+        buffer->resetViewProjection();
+    }
+
     // Transparent pass
     context->drawRenderers(CommandBuffer::TRANSLUCENT, context->culledComponents());
 
@@ -134,3 +204,151 @@ void DeferredLighting::setInput(uint32_t index, Texture *texture) {
 uint32_t DeferredLighting::layer() const {
     return CommandBuffer::LIGHT;
 }
+
+bool DeferredLighting::isClustered(BaseLight *light) const {
+    // Shadows require an own shadow map per light source
+    if(light->castShadows()) {
+        return false;
+    }
+    switch(light->lightType()) {
+    case BaseLight::PointLight: {
+        PointLight *point = static_cast<PointLight *>(light);
+        return (point->sourceRadius() == 0.0f && point->sourceLength() == 0.0f);
+    }
+    case BaseLight::SpotLight: return true;
+    default: break;
+    }
+    return false;
+}
+/*!
+    Splits the view frustum to TILES_X * TILES_Y * SLICES clusters with exponential depth distribution and
+    assigns the \a lights to the clusters which intersect the light bounding spheres.
+*/
+void DeferredLighting::buildClusters(Camera *camera, const list<BaseLight *> &lights) {
+    for(auto &it : m_clusterLights) {
+        it.clear();
+    }
+
+    Matrix4 view(camera->viewMatrix());
+    Matrix4 projection(camera->projectionMatrix());
+
+    float zNear = camera->nearPlane();
+    float zFar = camera->farPlane();
+    float range = logf(zFar / zNear);
+
+    auto sliceIndex = [zNear, range](float z) {
+        int32_t slice = static_cast<int32_t>(logf(z / zNear) / range * SLICES);
+        return CLAMP(slice, 0, SLICES - 1);
+    };
+
+    float *data = reinterpret_cast<float *>(&(m_lightsMap->surface(0)[0])[0]);
+
+    uint32_t index = 0;
+    for(auto light : lights) {
+        Transform *t = light->transform();
+        Matrix4 m(t->worldTransform());
+
+        Vector3 position(m[12], m[13], m[14]);
+        Vector3 direction;
+        float type = 0.0f;
+        float cutoff = 0.0f;
+        float radius = 0.0f;
+
+        if(light->lightType() == BaseLight::SpotLight) {
+            SpotLight *spot = static_cast<SpotLight *>(light);
+            direction = t->worldQuaternion() * Vector3(0.0f, 0.0f,-1.0f);
+            type = 1.0f;
+            cutoff = cos(DEG2RAD * spot->outerAngle() * 0.5f);
+            radius = spot->attenuationDistance();
+        } else {
+            radius = static_cast<PointLight *>(light)->attenuationRadius();
+        }
+
+        Vector4 color(light->color());
+
+        setTexel(data, index, 0, Vector4(position, type));
+        setTexel(data, index, 1, Vector4(color.x, color.y, color.z, light->brightness()));
+        setTexel(data, index, 2, Vector4(direction, cutoff));
+        setTexel(data, index, 3, Vector4(radius, 0.0f, 0.0f, 0.0f));
+
+        Vector3 center(view * position);
+        float depth = -center.z;
+        if(depth + radius >= zNear && depth - radius <= zFar) {
+            int32_t z0 = sliceIndex(MAX(depth - radius, zNear));
+            int32_t z1 = sliceIndex(MIN(depth + radius, zFar));
+
+            int32_t x0 = 0, x1 = TILES_X - 1;
+            int32_t y0 = 0, y1 = TILES_Y - 1;
+
+            bool visible = true;
+            // Light volumes which contain the camera cover whole screen
+            if(depth - radius > zNear) {
+                Vector2 min( FLT_MAX);
+                Vector2 max(-FLT_MAX);
+                for(int32_t i = 0; i < 8; i++) {
+                    Vector3 corner(center.x + ((i & 1) ? radius : -radius),
+                                   center.y + ((i & 2) ? radius : -radius),
+                                   center.z + ((i & 4) ? radius : -radius));
+
+                    Vector4 p(projection * Vector4(corner, 1.0f));
+                    Vector2 ndc(p.x / p.w, p.y / p.w);
+
+                    min.x = MIN(min.x, ndc.x);
+                    min.y = MIN(min.y, ndc.y);
+                    max.x = MAX(max.x, ndc.x);
+                    max.y = MAX(max.y, ndc.y);
+                }
+                visible = (max.x >= -1.0f && min.x <= 1.0f && max.y >= -1.0f && min.y <= 1.0f);
+
+                x0 = CLAMP(static_cast<int32_t>((min.x * 0.5f + 0.5f) * TILES_X), 0, TILES_X - 1);
+                x1 = CLAMP(static_cast<int32_t>((max.x * 0.5f + 0.5f) * TILES_X), 0, TILES_X - 1);
+                y0 = CLAMP(static_cast<int32_t>((min.y * 0.5f + 0.5f) * TILES_Y), 0, TILES_Y - 1);
+                y1 = CLAMP(static_cast<int32_t>((max.y * 0.5f + 0.5f) * TILES_Y), 0, TILES_Y - 1);
+            }
+
+            if(visible) {
+                for(int32_t z = z0; z <= z1; z++) {
+                    for(int32_t y = y0; y <= y1; y++) {
+                        for(int32_t x = x0; x <= x1; x++) {
+                            m_clusterLights[(z * TILES_Y + y) * TILES_X + x].push_back(index);
+                        }
+                    }
+                }
+            }
+        }
+        index++;
+    }
+
+    float *clusters = reinterpret_cast<float *>(&(m_clustersMap->surface(0)[0])[0]);
+    float *indices = reinterpret_cast<float *>(&(m_indicesMap->surface(0)[0])[0]);
+
+    uint32_t offset = 0;
+    for(uint32_t i = 0; i < m_clusterLights.size(); i++) {
+        auto &list = m_clusterLights[i];
+
+        uint32_t count = MIN(static_cast<uint32_t>(list.size()), MAX_INDICES - offset);
+        for(uint32_t j = 0; j < count; j++) {
+            indices[offset + j] = static_cast<float>(list[j]);
+        }
+
+        clusters[i * 4] = static_cast<float>(offset);
+        clusters[i * 4 + 1] = static_cast<float>(count);
+
+        offset += count;
+    }
+
+    m_lightsMap->setDirty();
+    m_clustersMap->setDirty();
+    m_indicesMap->setDirty();
+
+    m_clusterParams = Vector4(zNear, range, static_cast<float>(index), 0.0f);
+    if(m_clustered) {
+        m_clustered->setVector4(uniClusters, &m_clusterParams);
+    }
+}
+/*!
+    Returns the list of light indices assigned to the cluster with \a x, \a y tile and \a z slice coordinates.
+*/
+const vector<uint32_t> &DeferredLighting::clusterLights(uint32_t x, uint32_t y, uint32_t z) const {
+    return m_clusterLights[(z * TILES_Y + y) * TILES_X + x];
+}
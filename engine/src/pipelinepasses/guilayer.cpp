@@ -23,9 +23,14 @@ Texture *GuiLayer::draw(Texture *source, PipelineContext *context) {
     } else {
         context->cameraReset();
     }
+    m_batch.begin(buffer, CommandBuffer::UI);
     for(auto it : context->uiComponents()) {
-        it->draw(*buffer, CommandBuffer::UI);
+        if(!it->batch(m_batch)) {
+            m_batch.flush();
+            it->draw(*buffer, CommandBuffer::UI);
+        }
     }
+    m_batch.flush();
 
     return source;
 }
@@ -19,6 +19,8 @@
 #include "resources/rendertarget.h"
 
 #include <float.h>
+#include <cstring>
+#include <algorithm>
 
 #define SIDES 6
 #define MAX_LODS 4
@@ -28,19 +30,58 @@
 #define SM_RESOLUTION_DEFAULT 2048
 
 #define SHADOW_MAP  "shadowMap"
+#define DEPTH_MAP   "depthMap"
 
 namespace {
     const char *shadowmap("graphics.shadowmap");
+    const char *shadowmapBudget("graphics.shadowmap.budget");
 
     const char *uniLod       = "uni.lod";
     const char *uniMatrix    = "uni.matrix";
     const char *uniTiles     = "uni.tiles";
+    const char *uniTile      = "uni.tile";
+
+    inline void hashCombine(uint32_t &seed, uint32_t value) {
+        seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+
+    inline void hashCombine(uint32_t &seed, const Matrix4 &matrix) {
+        uint32_t buffer[16];
+        memcpy(buffer, matrix.mat, sizeof(float) * 16);
+        for(int i = 0; i < 16; i++) {
+            hashCombine(seed, buffer[i]);
+        }
+    }
 };
 
-ShadowMap::ShadowMap() {
+/*!
+    \class ShadowMap
+    \brief Renders the shadow maps for all shadow casting light sources.
+    \inmodule Engine
+
+    Every shadow tile is backed by a cache tile which contains static casters only.
+    While the light source or one of the static casters keeps changing, the static casters are drawn directly to the shadow tile and the cache stays unused.
+    As soon as they stay the same for two updates, the static casters are rendered into the cache once.
+    After that the cached depth is copied to the shadow tile each update and dynamic casters are drawn on top of it.
+    A tile without dynamic casters and without changes isn't touched at all.
+
+    BaseLight::shadowUpdateRate can be used to skip updates for the particular light source.
+    The "graphics.shadowmap.budget" value limits the number of cube faces (point and area lights) which can be updated per frame.
+    The faces without valid content are updated first, then the faces which were updated the longest time ago.
+    Zero value means no limit.
+*/
+
+ShadowMap::ShadowMap() :
+        m_copy(nullptr),
+        m_frame(0) {
 
     Engine::setValue(shadowmap, true);
 
+    Material *material = Engine::loadResource<Material>(".embedded/ShadowCopy.shader");
+    if(material) {
+        m_copy = material->createInstance();
+    }
+
     m_scale[0]  = 0.5f;
     m_scale[5]  = 0.5f;
     m_scale[10] = 0.5f;
@@ -60,19 +101,62 @@ ShadowMap::ShadowMap() {
 Texture *ShadowMap::draw(Texture *source, PipelineContext *context) {
     cleanShadowCache();
 
+    m_frame++;
+
     list<Renderable *> &components = context->sceneComponents();
     for(auto &it : context->sceneLights()) {
         BaseLight *base = static_cast<BaseLight *>(it);
         if(base->castShadows()) {
             switch(base->lightType()) {
             case BaseLight::DirectLight: directLightUpdate(context, static_cast<DirectLight *>(base), components, *context->currentCamera()); break;
-            case BaseLight::AreaLight: areaLightUpdate(context, static_cast<AreaLight *>(base), components); break;
-            case BaseLight::PointLight: pointLightUpdate(context, static_cast<PointLight *>(base), components); break;
+            case BaseLight::AreaLight: cubeLightUpdate(context, base, static_cast<AreaLight *>(base)->radius(), components); break;
+            case BaseLight::PointLight: cubeLightUpdate(context, base, static_cast<PointLight *>(base)->attenuationRadius(), components); break;
             case BaseLight::SpotLight: spotLightUpdate(context, static_cast<SpotLight *>(base), components); break;
             default: break;
             }
         }
     }
+
+    // Faces without valid content go first, then the oldest ones
+    std::stable_sort(m_requests.begin(), m_requests.end(), [](const FaceRequest &left, const FaceRequest &right) {
+        const FaceState &l = left.tiles->faces[left.face];
+        const FaceState &r = right.tiles->faces[right.face];
+        if(l.valid != r.valid) {
+            return !l.valid;
+        }
+        return l.updated < r.updated;
+    });
+
+    int32_t budget = Engine::value(shadowmapBudget, 0).toInt();
+    int32_t updated = 0;
+    for(auto &it : m_requests) {
+        // Invalid faces must be rendered regardless of the budget to avoid garbage in the shadows
+        if(budget <= 0 || updated < budget || !it.tiles->faces[it.face].valid) {
+            renderFace(context, it);
+            updated++;
+        }
+    }
+    m_requests.clear();
+
+    for(auto &it : m_cubeLights) {
+        auto instance = it.first->material();
+        if(instance) {
+            ShadowTiles *shadow = it.second;
+
+            Vector4 tiles[SIDES];
+            Matrix4 matrix[SIDES];
+            for(int32_t i = 0; i < SIDES; i++) {
+                matrix[i] = shadow->faces[i].matrix;
+                tiles[i] = tileRect(shadow->tiles[i], shadow->target);
+            }
+
+            instance->setMatrix4(uniMatrix, matrix, SIDES);
+            instance->setVector4(uniTiles, tiles, SIDES);
+            instance->setTexture(SHADOW_MAP, shadow->target->depthAttachment());
+        }
+    }
+    m_cubeLights.clear();
+
     context->buffer()->resetViewProjection();
 
     return source;
@@ -82,61 +166,45 @@ uint32_t ShadowMap::layer() const {
     return CommandBuffer::SHADOWCAST;
 }
 
-void ShadowMap::areaLightUpdate(PipelineContext *context, AreaLight *light, list<Renderable *> &components) {
-    CommandBuffer *buffer = context->buffer();
-    Transform *t = light->transform();
-
-    int32_t x[SIDES], y[SIDES], w[SIDES], h[SIDES];
-    RenderTarget *shadowMap = requestShadowTiles(light->uuid(), 1, x, y, w, h, SIDES);
+void ShadowMap::cubeLightUpdate(PipelineContext *context, BaseLight *light, float zFar, list<Renderable *> &components) {
+    ShadowTiles *tiles = requestShadowTiles(light->uuid(), 1, SIDES);
+    if(tiles == nullptr || !isUpdateRequired(light, tiles)) {
+        return;
+    }
+    tiles->updated = m_frame;
 
     float zNear = 0.1f;
-    float zFar = light->radius();
     Matrix4 crop = Matrix4::perspective(90.0f, 1.0f, zNear, zFar);
 
-    Matrix4 wt = t->worldTransform();
+    Matrix4 wt(light->transform()->worldTransform());
     Vector3 position(wt[12], wt[13], wt[14]);
 
     Matrix4 wp;
     wp.translate(position);
 
-    Vector4 tiles[SIDES];
-    Matrix4 matrix[SIDES];
-
-    uint32_t pageSize = Texture::maxTextureSize();
-
-    buffer->setRenderTarget(shadowMap);
-    for(int32_t i = 0; i < m_directions.size(); i++) {
-        Matrix4 mat = (wp * Matrix4(m_directions[i].toMatrix())).inverse();
-        matrix[i] = m_scale * crop * mat;
-
-        tiles[i] = Vector4(static_cast<float>(x[i]) / pageSize,
-                           static_cast<float>(y[i]) / pageSize,
-                           static_cast<float>(w[i]) / pageSize,
-                           static_cast<float>(h[i]) / pageSize);
-
-        buffer->enableScissor(x[i], y[i], w[i], h[i]);
-        buffer->clearRenderTarget();
-        buffer->disableScissor();
+    // Drop everything outside of the light range once instead of per face
+    list<Renderable *> casters;
+    for(auto it : components) {
+        if(it->bound().intersect(position, zFar)) {
+            casters.push_back(it);
+        }
+    }
 
-        buffer->setViewProjection(mat, crop);
-        buffer->setViewport(x[i], y[i], w[i], h[i]);
+    for(int32_t i = 0; i < SIDES; i++) {
+        FaceRequest request;
+        request.tiles = tiles;
+        request.face = i;
+        request.view = (wp * Matrix4(m_directions[i].toMatrix())).inverse();
+        request.crop = crop;
 
         AABBox bb;
         auto corners = Camera::frustumCorners(false, 90.0f, 1.0f, position, m_directions[i], zNear, zFar);
-        RenderList filter = context->frustumCulling(corners, components, bb);
-        // Draw in the depth buffer from position of the light source
-        for(auto it : filter) {
-            static_cast<Renderable *>(it)->draw(*buffer, CommandBuffer::SHADOWCAST);
+        if(prepareFace(request, context->frustumCulling(corners, casters, bb))) {
+            m_requests.push_back(request);
         }
-        buffer->resetViewProjection();
     }
 
-    auto instance = light->material();
-    if(instance) {
-        instance->setMatrix4(uniMatrix, matrix, SIDES);
-        instance->setVector4(uniTiles, tiles, SIDES);
-        instance->setTexture(SHADOW_MAP, shadowMap->depthAttachment());
-    }
+    m_cubeLights.push_back(make_pair(light, tiles));
 }
 
 void ShadowMap::directLightUpdate(PipelineContext *context, DirectLight *light, list<Renderable *> &components, Camera &camera) {
@@ -174,13 +242,12 @@ void ShadowMap::directLightUpdate(PipelineContext *context, DirectLight *light,
     float sigma = (camera.orthographic()) ? camera.orthoSize() : camera.fov();
     ratio = camera.ratio();
 
-    int32_t x[MAX_LODS], y[MAX_LODS], w[MAX_LODS], h[MAX_LODS];
-    RenderTarget *shadowMap = requestShadowTiles(light->uuid(), 0, x, y, w, h, MAX_LODS);
-
-    Vector4 tiles[MAX_LODS];
-    Matrix4 matrix[MAX_LODS];
+    ShadowTiles *shadow = requestShadowTiles(light->uuid(), 0, MAX_LODS);
+    if(shadow == nullptr || !isUpdateRequired(light, shadow)) {
+        return;
+    }
+    shadow->updated = m_frame;
 
-    buffer->setRenderTarget(shadowMap);
     for(int32_t lod = 0; lod < MAX_LODS; lod++) {
         float dist = distance[lod];
         auto points = Camera::frustumCorners(orthographic, sigma, ratio, wPosition, wRotation, nearPlane, dist);
@@ -207,159 +274,185 @@ void ShadowMap::directLightUpdate(PipelineContext *context, DirectLight *light,
         min.z = -bb.radius; /// \todo Negative values are bad for Vulkan
         max.z = bb.radius;
 
-        Matrix4 crop = Matrix4::ortho(min.x, max.x, min.y, max.y, min.z, max.z);
-
-        uint32_t pageSize = Texture::maxTextureSize();
+        FaceRequest request;
+        request.tiles = shadow;
+        request.face = lod;
+        request.view = rot;
+        request.crop = Matrix4::ortho(min.x, max.x, min.y, max.y, min.z, max.z);
 
-        matrix[lod] = m_scale * crop * rot;
-        tiles[lod] = Vector4(static_cast<float>(x[lod]) / pageSize,
-                             static_cast<float>(y[lod]) / pageSize,
-                             static_cast<float>(w[lod]) / pageSize,
-                             static_cast<float>(h[lod]) / pageSize);
-
-        buffer->enableScissor(x[lod], y[lod], w[lod], h[lod]);
-        buffer->clearRenderTarget();
-        buffer->disableScissor();
-
-        buffer->setViewProjection(rot, crop);
-        buffer->setViewport(x[lod], y[lod], w[lod], h[lod]);
-
-        // Draw in the depth buffer from position of the light source
-        for(auto it : filter) {
-            static_cast<Renderable *>(it)->draw(*buffer, CommandBuffer::SHADOWCAST);
+        if(prepareFace(request, filter)) {
+            renderFace(context, request);
         }
     }
 
     auto instance = light->material();
     if(instance) {
+        Vector4 tiles[MAX_LODS];
+        Matrix4 matrix[MAX_LODS];
+        for(int32_t lod = 0; lod < MAX_LODS; lod++) {
+            matrix[lod] = shadow->faces[lod].matrix;
+            tiles[lod] = tileRect(shadow->tiles[lod], shadow->target);
+        }
+
         instance->setMatrix4(uniMatrix, matrix, MAX_LODS);
         instance->setVector4(uniTiles, tiles,  MAX_LODS);
         instance->setVector4(uniLod, &normalizedDistance);
-        instance->setTexture(SHADOW_MAP, shadowMap->depthAttachment());
+        instance->setTexture(SHADOW_MAP, shadow->target->depthAttachment());
     }
 }
 
-void ShadowMap::pointLightUpdate(PipelineContext *context, PointLight *light, list<Renderable *> &components) {
-    CommandBuffer *buffer = context->buffer();
-    Transform *t = light->transform();
-
-    int32_t x[SIDES], y[SIDES], w[SIDES], h[SIDES];
-    RenderTarget *shadowMap = requestShadowTiles(light->uuid(), 1, x, y, w, h, SIDES);
+void ShadowMap::spotLightUpdate(PipelineContext *context, SpotLight *light, list<Renderable *> &components) {
+    ShadowTiles *shadow = requestShadowTiles(light->uuid(), 1, 1);
+    if(shadow == nullptr || !isUpdateRequired(light, shadow)) {
+        return;
+    }
+    shadow->updated = m_frame;
 
-    float zNear = 0.1f;
-    float zFar = light->attenuationRadius();
-    Matrix4 crop = Matrix4::perspective(90.0f, 1.0f, zNear, zFar);
+    Transform *t = light->transform();
 
+    Quaternion q(t->worldQuaternion());
     Matrix4 wt(t->worldTransform());
+
     Vector3 position(wt[12], wt[13], wt[14]);
 
-    Matrix4 wp;
-    wp.translate(position);
+    float zNear = 0.1f;
+    float zFar = light->attenuationDistance();
 
-    Vector4 tiles[SIDES];
-    Matrix4 matrix[SIDES];
+    FaceRequest request;
+    request.tiles = shadow;
+    request.face = 0;
+    request.view = wt.inverse();
+    request.crop = Matrix4::perspective(light->outerAngle() * 2.0f, 1.0f, zNear, zFar);
 
-    uint32_t pageSize = Texture::maxTextureSize();
+    list<Renderable *> casters;
+    for(auto it : components) {
+        if(it->bound().intersect(position, zFar)) {
+            casters.push_back(it);
+        }
+    }
 
-    buffer->setRenderTarget(shadowMap);
-    for(int32_t i = 0; i < m_directions.size(); i++) {
-        Matrix4 mat = (wp * Matrix4(m_directions[i].toMatrix())).inverse();
-        matrix[i] = m_scale * crop * mat;
+    AABBox bb;
+    auto corners = Camera::frustumCorners(false, light->outerAngle() * 2.0f, 1.0f, position, q, zNear, zFar);
+    if(prepareFace(request, context->frustumCulling(corners, casters, bb))) {
+        renderFace(context, request);
+    }
 
-        tiles[i] = Vector4(static_cast<float>(x[i]) / pageSize,
-                           static_cast<float>(y[i]) / pageSize,
-                           static_cast<float>(w[i]) / pageSize,
-                           static_cast<float>(h[i]) / pageSize);
+    auto instance = light->material();
+    if(instance) {
+        Vector4 tiles(tileRect(shadow->tiles[0], shadow->target));
 
-        buffer->enableScissor(x[i], y[i], w[i], h[i]);
-        buffer->clearRenderTarget();
-        buffer->disableScissor();
+        instance->setMatrix4(uniMatrix, &shadow->faces[0].matrix);
+        instance->setVector4(uniTiles,  &tiles);
+        instance->setTexture(SHADOW_MAP, shadow->target->depthAttachment());
+    }
+}
 
-        buffer->setViewProjection(mat, crop);
-        buffer->setViewport(x[i], y[i], w[i], h[i]);
+bool ShadowMap::prepareFace(FaceRequest &request, const list<Renderable *> &filter) const {
+    uint32_t hash = 0;
+    hashCombine(hash, request.view);
+    hashCombine(hash, request.crop);
 
-        AABBox bb;
-        auto corners = Camera::frustumCorners(false, 90.0f, 1.0f, position, m_directions[i], zNear, zFar);
-        RenderList filter = context->frustumCulling(corners, components, bb);
+    for(auto it : filter) {
+        Actor *actor = it->actor();
+        if(actor && actor->isStatic()) {
+            Transform *t = actor->transform();
+            t->worldTransform(); // Makes sure that the hash is up to date
+
+            hashCombine(hash, it->uuid());
+            hashCombine(hash, static_cast<uint32_t>(t->hash()));
 
-        // Draw in the depth buffer from position of the light source
-        for(auto it : filter) {
-            static_cast<Renderable *>(it)->draw(*buffer, CommandBuffer::SHADOWCAST);
+            request.statics.push_back(it);
+        } else {
+            request.dynamics.push_back(it);
         }
-        buffer->resetViewProjection();
     }
+    request.hash = hash;
 
-    auto instance = light->material();
-    if(instance) {
-        instance->setMatrix4(uniMatrix, matrix, SIDES);
-        instance->setVector4(uniTiles,  tiles, SIDES);
-        instance->setTexture(SHADOW_MAP, shadowMap->depthAttachment());
-    }
+    const FaceState &state = request.tiles->faces[request.face];
+    // Dynamic casters from the previous update must be erased as well
+    return !state.valid || state.hash != hash || state.dynamic || !request.dynamics.empty();
 }
 
-void ShadowMap::spotLightUpdate(PipelineContext *context, SpotLight *light, list<Renderable *> &components) {
+void ShadowMap::renderFace(PipelineContext *context, const FaceRequest &request) {
     CommandBuffer *buffer = context->buffer();
-    Transform *t = light->transform();
 
-    Quaternion q(t->worldQuaternion());
-    Matrix4 wt(t->worldTransform());
-    Matrix4 rot(wt.inverse());
+    ShadowTiles *shadow = request.tiles;
+    FaceState &state = shadow->faces[request.face];
 
-    Vector3 position(wt[12], wt[13], wt[14]);
+    // The cache pays off only when the static casters are reused, a changed face would draw them twice
+    bool cached = (m_copy && state.valid && state.hash == request.hash);
 
-    float zNear = 0.1f;
-    float zFar = light->attenuationDistance();
-    Matrix4 crop = Matrix4::perspective(light->outerAngle() * 2.0f, 1.0f, zNear, zFar);
+    AtlasNode *cache = shadow->cacheTiles[request.face];
+    if(cached && !state.cached) {
+        buffer->setRenderTarget(shadow->cache);
+        buffer->enableScissor(cache->x, cache->y, cache->w, cache->h);
+        buffer->clearRenderTarget();
+        buffer->disableScissor();
 
-    int32_t x, y, w, h;
-    RenderTarget *shadowMap = requestShadowTiles(light->uuid(), 1, &x, &y, &w, &h, 1);
+        buffer->setViewProjection(request.view, request.crop);
+        buffer->setViewport(cache->x, cache->y, cache->w, cache->h);
 
-    uint32_t pageSize = Texture::maxTextureSize();
-    Matrix4 matrix = m_scale * crop * rot;
-    Vector4 tiles = Vector4(static_cast<float>(x) / pageSize,
-                            static_cast<float>(y) / pageSize,
-                            static_cast<float>(w) / pageSize,
-                            static_cast<float>(h) / pageSize);
+        for(auto it : request.statics) {
+            it->draw(*buffer, CommandBuffer::SHADOWCAST);
+        }
+        buffer->resetViewProjection();
+    }
 
-    buffer->setRenderTarget(shadowMap);
-    buffer->enableScissor(x, y, w, h);
+    AtlasNode *node = shadow->tiles[request.face];
+    buffer->setRenderTarget(shadow->target);
+    buffer->enableScissor(node->x, node->y, node->w, node->h);
     buffer->clearRenderTarget();
     buffer->disableScissor();
 
-    buffer->setViewProjection(rot, crop);
-    buffer->setViewport(x, y, w, h);
+    buffer->setViewport(node->x, node->y, node->w, node->h);
 
-    AABBox bb;
-    auto corners = Camera::frustumCorners(false, light->outerAngle() * 2.0f, 1.0f, position, q, zNear, zFar);
-    RenderList filter = context->frustumCulling(corners, components, bb);
+    if(cached) {
+        Vector4 rect(tileRect(cache, shadow->cache));
+        m_copy->setVector4(uniTile, &rect);
+        m_copy->setTexture(DEPTH_MAP, shadow->cache->depthAttachment());
+
+        buffer->drawMesh(Matrix4(), PipelineContext::defaultPlane(), 0, CommandBuffer::UI, m_copy);
+    }
 
+    buffer->setViewProjection(request.view, request.crop);
     // Draw in the depth buffer from position of the light source
-    for(auto it : filter) {
+    if(!cached) {
+        for(auto it : request.statics) {
+            it->draw(*buffer, CommandBuffer::SHADOWCAST);
+        }
+    }
+    for(auto it : request.dynamics) {
         it->draw(*buffer, CommandBuffer::SHADOWCAST);
     }
     buffer->resetViewProjection();
 
-    auto instance = light->material();
-    if(instance) {
-        instance->setMatrix4(uniMatrix, &matrix);
-        instance->setVector4(uniTiles,  &tiles);
-        instance->setTexture(SHADOW_MAP, shadowMap->depthAttachment());
-    }
+    state.matrix = m_scale * request.crop * request.view;
+    state.hash = request.hash;
+    state.updated = m_frame;
+    state.dynamic = !request.dynamics.empty();
+    state.valid = true;
+    state.cached = cached;
+}
+
+bool ShadowMap::isUpdateRequired(BaseLight *light, ShadowTiles *tiles) const {
+    uint32_t rate = static_cast<uint32_t>(MAX(light->shadowUpdateRate(), 1));
+    return (tiles->updated == 0 || (m_frame - tiles->updated) >= rate);
 }
 
 void ShadowMap::cleanShadowCache() {
     for(auto tiles = m_tiles.begin(); tiles != m_tiles.end(); ) {
         bool outdate = false;
-        for(auto &it : tiles->second.second) {
+        for(auto &it : tiles->second.tiles) {
             if(it->dirty == true) {
                 outdate = true;
                 break;
             }
         }
         if(outdate) {
-            for(auto &it : tiles->second.second) {
+            for(auto &it : tiles->second.tiles) {
                 delete it;
             }
+            releaseCachePage(tiles->second.cache);
             tiles = m_tiles.erase(tiles);
         } else {
             ++tiles;
@@ -371,26 +464,48 @@ void ShadowMap::cleanShadowCache() {
     //}
 
     for(auto &tile : m_tiles) {
-        for(auto &it : tile.second.second) {
+        for(auto &it : tile.second.tiles) {
             it->dirty = true;
         }
     }
 }
 
-RenderTarget *ShadowMap::requestShadowTiles(uint32_t id, uint32_t lod, int32_t *x, int32_t *y, int32_t *w, int32_t *h, uint32_t count) {
+ShadowMap::ShadowTiles *ShadowMap::requestShadowTiles(uint32_t id, uint32_t lod, uint32_t count) {
     auto tile = m_tiles.find(id);
     if(tile != m_tiles.end()) {
-        for(uint32_t i = 0; i < count; i++) {
-            AtlasNode *node = tile->second.second[i];
-            x[i] = node->x;
-            y[i] = node->y;
-            w[i] = node->w;
-            h[i] = node->h;
-            node->dirty = false;
+        for(auto &it : tile->second.tiles) {
+            it->dirty = false;
+        }
+        return &tile->second;
+    }
+
+    ShadowTiles tiles;
+    tiles.target = allocateTiles(m_shadowPages, lod, count, tiles.tiles, false);
+    if(tiles.target) {
+        tiles.cache = allocateTiles(m_cachePages, lod, count, tiles.cacheTiles, true);
+    }
+    if(tiles.tiles.size() != count || tiles.cacheTiles.size() != count) {
+        for(auto &it : tiles.tiles) {
+            delete it;
         }
-        return tile->second.first;
+        releaseCachePage(tiles.cache);
+        return nullptr;
     }
+    tiles.faces.resize(count);
 
+    ShadowTiles &result = m_tiles[id];
+    result = tiles;
+    return &result;
+}
+
+/*!
+    Allocates \a count tiles of the \a lod resolution in one of the \a pages.
+    Shadow pages are shared between the light sources and have the maximum texture size.
+    In case of \a exact flag a dedicated page is created with the size of the requested region only,
+    this is used for the static casters cache which must be released together with the light tiles.
+    Returns nullptr if the region doesn't fit into a page of the maximum texture size.
+*/
+RenderTarget *ShadowMap::allocateTiles(unordered_map<RenderTarget *, AtlasNode *> &pages, uint32_t lod, uint32_t count, vector<AtlasNode *> &tiles, bool exact) {
     int32_t width = (SM_RESOLUTION_DEFAULT >> lod);
     int32_t height = (SM_RESOLUTION_DEFAULT >> lod);
 
@@ -400,22 +515,29 @@ RenderTarget *ShadowMap::requestShadowTiles(uint32_t id, uint32_t lod, int32_t *
     RenderTarget *target = nullptr;
     AtlasNode *sub = nullptr;
 
-    for(auto page : m_shadowPages) {
-        target = page.first;
-        AtlasNode *root = page.second;
+    if(!exact) {
+        for(auto page : pages) {
+            target = page.first;
+            AtlasNode *root = page.second;
 
-        sub = root->insert(width * columns, height * rows);
-        if(sub) {
-            break;
+            sub = root->insert(width * columns, height * rows);
+            if(sub) {
+                break;
+            }
         }
     }
 
     if(sub == nullptr) {
-        uint32_t pageSize = Texture::maxTextureSize();
+        uint32_t pageWidth = exact ? width * columns : Texture::maxTextureSize();
+        uint32_t pageHeight = exact ? height * rows : Texture::maxTextureSize();
+        if(pageWidth < width * columns || pageHeight < height * rows) {
+            return nullptr;
+        }
+
         Texture *map = Engine::objectCreate<Texture>();
         map->setFormat(Texture::Depth);
-        map->setWidth(pageSize);
-        map->setHeight(pageSize);
+        map->setWidth(pageWidth);
+        map->setHeight(pageHeight);
         map->setDepthBits(24);
 
         target = Engine::objectCreate<RenderTarget>();
@@ -423,28 +545,45 @@ RenderTarget *ShadowMap::requestShadowTiles(uint32_t id, uint32_t lod, int32_t *
 
         AtlasNode *root = new AtlasNode;
 
-        root->w = pageSize;
-        root->h = pageSize;
+        root->w = pageWidth;
+        root->h = pageHeight;
 
-        m_shadowPages[target] = root;
+        pages[target] = root;
 
         sub = root->insert(width * columns, height * rows);
     }
 
-    vector<AtlasNode *> tiles;
     for(uint32_t i = 0; i < count; i++) {
         AtlasNode *node = sub->insert(width, height);
         if(node) {
-            x[i] = node->x;
-            y[i] = node->y;
-            w[i] = node->w;
-            h[i] = node->h;
             node->fill = true;
             tiles.push_back(node);
         }
     }
-    if(tiles.size() == count) {
-        m_tiles[id] = make_pair(target, tiles);
-    }
     return target;
 }
+
+/*!
+    Releases the cache \a page with all tiles allocated in it.
+*/
+void ShadowMap::releaseCachePage(RenderTarget *page) {
+    auto it = m_cachePages.find(page);
+    if(it != m_cachePages.end()) {
+        delete it->second;
+
+        Engine::unloadResource(page->depthAttachment());
+        Engine::unloadResource(page);
+
+        m_cachePages.erase(it);
+    }
+}
+
+Vector4 ShadowMap::tileRect(const AtlasNode *node, const RenderTarget *page) const {
+    Texture *map = page->depthAttachment();
+    float pageWidth = static_cast<float>(map->width());
+    float pageHeight = static_cast<float>(map->height());
+    return Vector4(static_cast<float>(node->x) / pageWidth,
+                   static_cast<float>(node->y) / pageHeight,
+                   static_cast<float>(node->w) / pageWidth,
+                   static_cast<float>(node->h) / pageHeight);
+}
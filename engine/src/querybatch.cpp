@@ -0,0 +1,228 @@
+#include "querybatch.h"
+
+#include <mutex>
+#include <condition_variable>
+
+class QueryBatchPrivate {
+public:
+    QueryBatchPrivate() :
+            m_pending(0) {
+
+    }
+
+    vector<QueryBatch::Query> m_queries;
+
+    vector<QueryBatch::Result> m_results;
+
+    mutex m_mutex;
+
+    condition_variable m_condition;
+
+    uint32_t m_pending;
+
+};
+
+/*!
+    \class QueryBatch
+    \brief The QueryBatch class contains a set of physics queries to be executed together.
+    \inmodule Engine
+
+    The batch is filled with ray casts, sweeps and overlap tests and submitted to a World with World::submitQueries().
+    The physics system executes the queries on the worker threads against the state of the last simulation step and the results are ready at the latest by the next frame.
+    The isFinished() method can be used to poll the batch state and wait() to block until all queries are done.
+    Unlike World::rayCast(), the distance of the hits is measured in world units along the query direction.
+
+    The batch must not be modified or destroyed while it's in flight, the destructor waits for the completion.
+
+    \code
+        QueryBatch batch;
+        for(auto it : agents) {
+            batch.addRayCast(Ray(it->position(), Vector3(0.0f,-1.0f, 0.0f)), 2.0f);
+        }
+        world->submitQueries(&batch);
+        ...
+        if(batch.isFinished()) {
+            for(uint32_t i = 0; i < batch.size(); i++) {
+                const QueryBatch::Result &result = batch.result(i);
+                if(result.valid) {
+                    ...
+                }
+            }
+        }
+    \endcode
+*/
+/*!
+    \enum QueryBatch::QueryType
+
+    \value RayCast \c Casts a ray and returns the closest hit.
+    \value SphereSweep \c Sweeps a sphere along the direction and returns the closest hit.
+    \value BoxSweep \c Sweeps an oriented box along the direction and returns the closest hit.
+    \value SphereOverlap \c Returns all objects overlapping the sphere.
+    \value BoxOverlap \c Returns all objects overlapping the oriented box.
+*/
+
+QueryBatch::QueryBatch() :
+        p_ptr(new QueryBatchPrivate) {
+
+}
+
+QueryBatch::~QueryBatch() {
+    wait();
+
+    delete p_ptr;
+}
+/*!
+    Adds a \a ray cast query limited by the \a distance.
+    Returns the index of the query in the batch.
+*/
+uint32_t QueryBatch::addRayCast(const Ray &ray, float distance) {
+    Query query;
+    query.type = RayCast;
+    query.origin = ray.pos;
+    query.direction = ray.dir;
+    query.distance = distance;
+
+    return add(query);
+}
+/*!
+    Adds a sweep query for the sphere with the \a radius moving from the \a origin along the \a direction on the \a distance.
+    Returns the index of the query in the batch.
+*/
+uint32_t QueryBatch::addSphereSweep(const Vector3 &origin, const Vector3 &direction, float radius, float distance) {
+    Query query;
+    query.type = SphereSweep;
+    query.origin = origin;
+    query.direction = direction;
+    query.extent = Vector3(radius);
+    query.distance = distance;
+
+    return add(query);
+}
+/*!
+    Adds a sweep query for the box with the \a halfExtents and the \a rotation moving from the \a origin along the \a direction on the \a distance.
+    Returns the index of the query in the batch.
+*/
+uint32_t QueryBatch::addBoxSweep(const Vector3 &origin, const Vector3 &direction, const Vector3 &halfExtents, const Quaternion &rotation, float distance) {
+    Query query;
+    query.type = BoxSweep;
+    query.origin = origin;
+    query.direction = direction;
+    query.extent = halfExtents;
+    query.rotation = rotation;
+    query.distance = distance;
+
+    return add(query);
+}
+/*!
+    Adds an overlap query for the sphere with the \a center and the \a radius.
+    Returns the index of the query in the batch.
+*/
+uint32_t QueryBatch::addSphereOverlap(const Vector3 &center, float radius) {
+    Query query;
+    query.type = SphereOverlap;
+    query.origin = center;
+    query.extent = Vector3(radius);
+
+    return add(query);
+}
+/*!
+    Adds an overlap query for the box with the \a center, the \a halfExtents and the \a rotation.
+    Returns the index of the query in the batch.
+*/
+uint32_t QueryBatch::addBoxOverlap(const Vector3 &center, const Vector3 &halfExtents, const Quaternion &rotation) {
+    Query query;
+    query.type = BoxOverlap;
+    query.origin = center;
+    query.extent = halfExtents;
+    query.rotation = rotation;
+
+    return add(query);
+}
+/*!
+    Removes all queries and results from the batch.
+*/
+void QueryBatch::clear() {
+    wait();
+
+    p_ptr->m_queries.clear();
+    p_ptr->m_results.clear();
+}
+/*!
+    Returns the number of queries in the batch.
+*/
+uint32_t QueryBatch::size() const {
+    return p_ptr->m_queries.size();
+}
+/*!
+    Returns the query with the \a index.
+*/
+const QueryBatch::Query &QueryBatch::query(uint32_t index) const {
+    return p_ptr->m_queries[index];
+}
+/*!
+    Returns the result of the query with the \a index.
+    The result is valid only when the batch is finished.
+*/
+const QueryBatch::Result &QueryBatch::result(uint32_t index) const {
+    return p_ptr->m_results[index];
+}
+/*!
+    Returns true if all submitted queries are executed; otherwise returns false.
+*/
+bool QueryBatch::isFinished() const {
+    unique_lock<mutex> locker(p_ptr->m_mutex);
+    return (p_ptr->m_pending == 0);
+}
+/*!
+    Blocks until all submitted queries are executed.
+*/
+void QueryBatch::wait() {
+    unique_lock<mutex> locker(p_ptr->m_mutex);
+    p_ptr->m_condition.wait(locker, [this]() { return (p_ptr->m_pending == 0); });
+}
+/*!
+    \internal
+    Marks the batch as in flight and resets the results.
+    The batch will be finished after the \a tasks number of finish() calls.
+    This method is used by the physics systems.
+*/
+void QueryBatch::begin(uint32_t tasks) {
+    wait();
+
+    p_ptr->m_results.clear();
+    p_ptr->m_results.resize(p_ptr->m_queries.size());
+
+    unique_lock<mutex> locker(p_ptr->m_mutex);
+    p_ptr->m_pending = tasks;
+}
+/*!
+    \internal
+    Completes one of the tasks started by begin().
+    This method is used by the physics systems and can be called from any thread.
+*/
+void QueryBatch::finish() {
+    unique_lock<mutex> locker(p_ptr->m_mutex);
+    if(p_ptr->m_pending > 0) {
+        p_ptr->m_pending--;
+        if(p_ptr->m_pending == 0) {
+            p_ptr->m_condition.notify_all();
+        }
+    }
+}
+/*!
+    \internal
+    Returns the writable array of the results.
+    Each result must be written only by the task which executes the corresponding query.
+*/
+QueryBatch::Result *QueryBatch::resultData() {
+    return p_ptr->m_results.data();
+}
+
+uint32_t QueryBatch::add(const Query &query) {
+    wait();
+
+    p_ptr->m_queries.push_back(query);
+    p_ptr->m_results.push_back(Result());
+
+    return p_ptr->m_queries.size() - 1;
+}
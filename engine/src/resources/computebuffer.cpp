@@ -1,6 +1,15 @@
 #include "resources/computebuffer.h"
 
+/*!
+    \class ComputeBuffer
+    \brief ComputeBuffer is a GPU data buffer used by compute shaders.
+    \inmodule Resources
+
+    The buffer stays on the GPU side, data is uploaded only after a setData() call.
+*/
+
 ComputeBuffer::ComputeBuffer() :
+        m_stride(1),
         m_bufferDirty(false) {
 
 }
@@ -8,22 +17,48 @@ ComputeBuffer::ComputeBuffer() :
 ComputeBuffer::~ComputeBuffer() {
 
 }
-
+/*!
+    Returns the number of elements in the buffer.
+*/
 uint32_t ComputeBuffer::count() const {
-    return 0;
+    return m_buffer.size() / m_stride;
 }
-
+/*!
+    Returns the size of one element of the buffer in bytes.
+*/
 uint32_t ComputeBuffer::stride() const {
-    return 0;
+    return m_stride;
 }
+/*!
+    Sets the size of one element of the buffer in bytes to \a stride.
+*/
 void ComputeBuffer::setStride(uint32_t stride) {
-    A_UNUSED(stride);
+    m_stride = MAX(stride, 1);
 }
-
+/*!
+    Returns a CPU side copy of the buffer data.
+*/
 ByteArray ComputeBuffer::data() const {
     return m_buffer;
 }
+/*!
+    Replaces the buffer content with the provided \a data.
+*/
 void ComputeBuffer::setData(const ByteArray &data) {
     m_buffer = data;
     m_bufferDirty = true;
+
+    switchState(ToBeUpdated);
+}
+/*!
+    \internal
+*/
+void ComputeBuffer::switchState(ResourceState state) {
+    setState(state);
+}
+/*!
+    \internal
+*/
+bool ComputeBuffer::isUnloadable() {
+    return true;
 }
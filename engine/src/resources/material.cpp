@@ -15,7 +15,7 @@ MaterialInstance::MaterialInstance(Material *material) :
         m_uniformDirty(true) {
 
     if(m_material->m_uniformSize > 0) {
-        m_uniformBuffer = new uint8_t[m_material->m_uniformSize];
+        m_uniformBuffer = new uint8_t[m_material->m_uniformSize]();
     }
 }
 
@@ -96,6 +96,23 @@ uint16_t MaterialInstance::surfaceType() const {
 void MaterialInstance::setSurfaceType(uint16_t type) {
     m_surfaceType = type;
 }
+/*!
+    Returns true if the \a instance refers to the same material with the same textures and uniform values.
+    Such instances are interchangeable, so geometry which uses them can be drawn in the single batch.
+*/
+bool MaterialInstance::isEqual(const MaterialInstance &instance) const {
+    if(this == &instance) {
+        return true;
+    }
+    if(m_material != instance.m_material || m_surfaceType != instance.m_surfaceType ||
+       m_textureOverride != instance.m_textureOverride) {
+        return false;
+    }
+    if(m_uniformBuffer && instance.m_uniformBuffer) {
+        return (memcmp(m_uniformBuffer, instance.m_uniformBuffer, m_material->m_uniformSize) == 0);
+    }
+    return (m_uniformBuffer == instance.m_uniformBuffer);
+}
 
 /*!
     \class Material
@@ -3,6 +3,8 @@
 #include "material.h"
 #include "mesh.h"
 
+#include <algorithm>
+
 #define EMITTERS "Emitters"
 
 ParticleModificator::ParticleModificator() :
@@ -15,15 +17,33 @@ ParticleModificator::~ParticleModificator() {
 
 }
 
-void ParticleModificator::spawnParticle(ParticleData &data) {
-    A_UNUSED(data);
+void ParticleModificator::spawnParticles(ParticleBuffer &buffer, uint32_t first, uint32_t count) {
+    A_UNUSED(buffer);
+    A_UNUSED(first);
+    A_UNUSED(count);
 }
 
-void ParticleModificator::updateParticle(ParticleData &data, float dt) {
-    A_UNUSED(data);
+void ParticleModificator::updateParticles(ParticleBuffer &buffer, float dt) {
+    A_UNUSED(buffer);
     A_UNUSED(dt);
 }
 
+int32_t ParticleModificator::classType() const {
+    return 0;
+}
+
+ParticleModificator::ValueType ParticleModificator::valueType() const {
+    return m_Type;
+}
+
+Vector4 ParticleModificator::minimum() const {
+    return m_Min;
+}
+
+Vector4 ParticleModificator::maximum() const {
+    return (m_Type == RANGE) ? m_Max : m_Min;
+}
+
 void ParticleModificator::loadData(const VariantList &list) {
     auto it = list.begin();
     m_Type = static_cast<ValueType>((*it).toInt());
@@ -106,207 +126,227 @@ void ParticleEmitter::setModifiers(const ModifiersDeque &modifiers) {
 }
 
 
-ParticleData::ParticleData() :
-        life(1.0),
-        frame(0.0),
-        distance(-1.0f),
-        transform(0.0f),
-        angle(0.0f),
-        color(1.0f),
-        size(1.0f),
-        colrate(0.0f),
-        position(0.0f),
-        velocity(0.0f),
-        anglerate(0.0f),
-        sizerate(0.0f) {
+ParticleBuffer::ParticleBuffer() :
+        count(0) {
+
+}
+/*!
+    Appends \a number of the default particles to the end of the alive range.
+    Returns an index of the first emitted particle.
+*/
+uint32_t ParticleBuffer::emit(uint32_t number) {
+    uint32_t first = count;
+    if(first + number > life.size()) {
+        resize(MAX(first + number, life.size() * 2));
+    }
+
+    std::fill(life.begin() + first, life.begin() + first + number, 1.0f);
+    std::fill(frame.begin() + first, frame.begin() + first + number, 0.0f);
+    std::fill(angle.begin() + first, angle.begin() + first + number, Vector3(0.0f));
+    std::fill(color.begin() + first, color.begin() + first + number, Vector4(1.0f));
+    std::fill(size.begin() + first, size.begin() + first + number, Vector3(1.0f));
+    std::fill(colrate.begin() + first, colrate.begin() + first + number, Vector4(0.0f));
+    std::fill(position.begin() + first, position.begin() + first + number, Vector3(0.0f));
+    std::fill(velocity.begin() + first, velocity.begin() + first + number, Vector3(0.0f));
+    std::fill(anglerate.begin() + first, anglerate.begin() + first + number, Vector3(0.0f));
+    std::fill(sizerate.begin() + first, sizerate.begin() + first + number, Vector3(0.0f));
+
+    count += number;
+    return first;
+}
+/*!
+    Removes all dead particles by moving the last alive particles into the freed slots.
+    The order of the particles is not preserved.
+*/
+void ParticleBuffer::compact() {
+    uint32_t i = 0;
+    while(i < count) {
+        if(life[i] < 0.0f) {
+            count--;
+            move(i, count);
+        } else {
+            i++;
+        }
+    }
+}
+/*!
+    Removes all particles but keeps allocated memory.
+*/
+void ParticleBuffer::clear() {
+    count = 0;
+}
+
+void ParticleBuffer::resize(uint32_t size) {
+    life.resize(size);
+    frame.resize(size);
+    angle.resize(size);
+    color.resize(size);
+    this->size.resize(size);
+    colrate.resize(size);
+    position.resize(size);
+    velocity.resize(size);
+    anglerate.resize(size);
+    sizerate.resize(size);
+}
+
+void ParticleBuffer::move(uint32_t to, uint32_t from) {
+    life[to] = life[from];
+    frame[to] = frame[from];
+    angle[to] = angle[from];
+    color[to] = color[from];
+    size[to] = size[from];
+    colrate[to] = colrate[from];
+    position[to] = position[from];
+    velocity[to] = velocity[from];
+    anglerate[to] = anglerate[from];
+    sizerate[to] = sizerate[from];
+}
+
+inline void setValue(float &value, const Vector4 &data) {
+    value = data.x;
+}
 
+inline void setValue(Vector3 &value, const Vector4 &data) {
+    value = Vector3(data.x, data.y, data.z);
+}
+
+inline void setValue(Vector4 &value, const Vector4 &data) {
+    value = data;
+}
+
+template<typename T>
+void spawnValues(vector<T> &array, uint32_t first, uint32_t count, int32_t type, const Vector4 &min, const Vector4 &max, float scale = 1.0f) {
+    switch(type) {
+        case ParticleModificator::CONSTANT: {
+            T value;
+            setValue(value, min * scale);
+            std::fill(array.begin() + first, array.begin() + first + count, value);
+        } break;
+        case ParticleModificator::RANGE: {
+            for(uint32_t i = first; i < first + count; i++) {
+                setValue(array[i], Vector4(RANGE(min.x, max.x), RANGE(min.y, max.y), RANGE(min.z, max.z), RANGE(min.w, max.w)) * scale);
+            }
+        } break;
+        default: break;
+    }
+}
+inline void integrateValue(Vector3 &value, const Vector3 &rate, float dt) {
+    value.x += rate.x * dt;
+    value.y += rate.y * dt;
+    value.z += rate.z * dt;
+}
+
+inline void integrateValue(Vector4 &value, const Vector4 &rate, float dt) {
+    value.x += rate.x * dt;
+    value.y += rate.y * dt;
+    value.z += rate.z * dt;
+    value.w += rate.w * dt;
+}
+// Flat kernel over the whole array, the compiler is able to vectorize it
+template<typename T>
+void integrateValues(vector<T> &array, const vector<T> &rate, uint32_t count, float dt) {
+    T *value = array.data();
+    const T *delta = rate.data();
+    for(uint32_t i = 0; i < count; i++) {
+        integrateValue(value[i], delta[i], dt);
+    }
 }
 
 class Lifetime: public ParticleModificator {
 public:
-    void spawnParticle(ParticleData &data) {
-        switch(m_Type) {
-            case CONSTANT: {
-                data.life = m_Min.x;
-            } break;
-            case RANGE: {
-                data.life = RANGE(m_Min.x, m_Max.x);
-            } break;
-            default: break;
-        }
+    int32_t classType() const override { return LIFETIME; }
+
+    void spawnParticles(ParticleBuffer &buffer, uint32_t first, uint32_t count) override {
+        spawnValues(buffer.life, first, count, m_Type, m_Min, m_Max);
     }
 };
 
 class StartSize: public ParticleModificator {
 public:
-    void spawnParticle(ParticleData &data) {
-        switch(m_Type) {
-            case CONSTANT: {
-                data.size.x = m_Min.x;
-                data.size.y = m_Min.y;
-                data.size.z = m_Min.z;
-            } break;
-            case RANGE: {
-                data.size.x = RANGE(m_Min.x, m_Max.x);
-                data.size.y = RANGE(m_Min.y, m_Max.y);
-                data.size.z = RANGE(m_Min.z, m_Max.z);
-            } break;
-            default: break;
-        }
+    int32_t classType() const override { return STARTSIZE; }
+
+    void spawnParticles(ParticleBuffer &buffer, uint32_t first, uint32_t count) override {
+        spawnValues(buffer.size, first, count, m_Type, m_Min, m_Max);
     }
 };
 
 class StartColor: public ParticleModificator {
 public:
-    void spawnParticle(ParticleData &data) {
-        switch(m_Type) {
-            case CONSTANT: {
-                data.color.x = m_Min.x;
-                data.color.y = m_Min.y;
-                data.color.z = m_Min.z;
-                data.color.w = m_Min.w;
-            } break;
-            case RANGE: {
-                data.color.x = RANGE(m_Min.x, m_Max.x);
-                data.color.y = RANGE(m_Min.y, m_Max.y);
-                data.color.z = RANGE(m_Min.z, m_Max.z);
-                data.color.w = RANGE(m_Min.w, m_Max.w);
-            } break;
-            default: break;
-        }
+    int32_t classType() const override { return STARTCOLOR; }
+
+    void spawnParticles(ParticleBuffer &buffer, uint32_t first, uint32_t count) override {
+        spawnValues(buffer.color, first, count, m_Type, m_Min, m_Max);
     }
 };
 
 class StartAngle: public ParticleModificator {
 public:
-    void spawnParticle(ParticleData &data) {
-        switch(m_Type) {
-            case CONSTANT: {
-                data.angle.x = m_Min.x * DEG2RAD;
-                data.angle.y = m_Min.y * DEG2RAD;
-                data.angle.z = m_Min.z * DEG2RAD;
-            } break;
-            case RANGE: {
-                data.angle.x = RANGE(m_Min.x, m_Max.x) * DEG2RAD;
-                data.angle.y = RANGE(m_Min.y, m_Max.y) * DEG2RAD;
-                data.angle.z = RANGE(m_Min.z, m_Max.z) * DEG2RAD;
-            } break;
-            default: break;
-        }
+    int32_t classType() const override { return STARTANGLE; }
+
+    void spawnParticles(ParticleBuffer &buffer, uint32_t first, uint32_t count) override {
+        spawnValues(buffer.angle, first, count, m_Type, m_Min, m_Max, DEG2RAD);
     }
 };
 
 class StartPosition: public ParticleModificator {
 public:
-    void spawnParticle(ParticleData &data) {
-        switch(m_Type) {
-            case CONSTANT: {
-                data.position.x = m_Min.x;
-                data.position.y = m_Min.y;
-                data.position.z = m_Min.z;
-            } break;
-            case RANGE: {
-                data.position.x = RANGE(m_Min.x, m_Max.x);
-                data.position.y = RANGE(m_Min.y, m_Max.y);
-                data.position.z = RANGE(m_Min.z, m_Max.z);
-            } break;
-            default: break;
-        }
+    int32_t classType() const override { return STARTPOSITION; }
+
+    void spawnParticles(ParticleBuffer &buffer, uint32_t first, uint32_t count) override {
+        spawnValues(buffer.position, first, count, m_Type, m_Min, m_Max);
     }
 };
 
 
 class ScaleSize: public ParticleModificator {
 public:
-    void spawnParticle(ParticleData &data) {
-        switch(m_Type) {
-            case CONSTANT: {
-                data.sizerate.x = m_Min.x;
-                data.sizerate.y = m_Min.y;
-                data.sizerate.z = m_Min.z;
-            } break;
-            case RANGE: {
-                data.sizerate.x = RANGE(m_Min.x, m_Max.x);
-                data.sizerate.y = RANGE(m_Min.y, m_Max.y);
-                data.sizerate.z = RANGE(m_Min.z, m_Max.z);
-            } break;
-            default: break;
-        }
+    int32_t classType() const override { return SCALESIZE; }
+
+    void spawnParticles(ParticleBuffer &buffer, uint32_t first, uint32_t count) override {
+        spawnValues(buffer.sizerate, first, count, m_Type, m_Min, m_Max);
     }
 
-    void updateParticle(ParticleData &data, float dt) {
-        data.size += data.sizerate * dt;
+    void updateParticles(ParticleBuffer &buffer, float dt) override {
+        integrateValues(buffer.size, buffer.sizerate, buffer.count, dt);
     }
 };
 
 class ScaleColor: public ParticleModificator {
 public:
-    void spawnParticle(ParticleData &data) {
-        switch(m_Type) {
-            case CONSTANT: {
-                data.colrate.x = m_Min.x;
-                data.colrate.y = m_Min.y;
-                data.colrate.z = m_Min.z;
-                data.colrate.w = m_Min.w;
-            } break;
-            case RANGE: {
-                data.colrate.x = RANGE(m_Min.x, m_Max.x);
-                data.colrate.y = RANGE(m_Min.y, m_Max.y);
-                data.colrate.z = RANGE(m_Min.z, m_Max.z);
-                data.colrate.w = RANGE(m_Min.w, m_Max.w);
-            } break;
-            default: break;
-        }
+    int32_t classType() const override { return SCALECOLOR; }
+
+    void spawnParticles(ParticleBuffer &buffer, uint32_t first, uint32_t count) override {
+        spawnValues(buffer.colrate, first, count, m_Type, m_Min, m_Max);
     }
 
-    void updateParticle(ParticleData &data, float dt) {
-        data.color += data.colrate * dt;
+    void updateParticles(ParticleBuffer &buffer, float dt) override {
+        integrateValues(buffer.color, buffer.colrate, buffer.count, dt);
     }
 };
 
 class ScaleAngle: public ParticleModificator {
 public:
-    void spawnParticle(ParticleData &data) {
-        switch(m_Type) {
-            case CONSTANT: {
-                data.anglerate.x = m_Min.x;
-                data.anglerate.y = m_Min.y;
-                data.anglerate.z = m_Min.z;
-            } break;
-            case RANGE: {
-                data.anglerate.x = RANGE(m_Min.x, m_Max.x);
-                data.anglerate.y = RANGE(m_Min.y, m_Max.y);
-                data.anglerate.z = RANGE(m_Min.z, m_Max.z);
-            } break;
-            default: break;
-        }
+    int32_t classType() const override { return SCALEANGLE; }
+
+    void spawnParticles(ParticleBuffer &buffer, uint32_t first, uint32_t count) override {
+        spawnValues(buffer.anglerate, first, count, m_Type, m_Min, m_Max);
     }
 
-    void updateParticle(ParticleData &data, float dt) {
-        data.angle += data.anglerate * DEG2RAD * dt;
+    void updateParticles(ParticleBuffer &buffer, float dt) override {
+        integrateValues(buffer.angle, buffer.anglerate, buffer.count, DEG2RAD * dt);
     }
 };
 
 class Velocity: public ParticleModificator {
 public:
-    void spawnParticle(ParticleData &data) {
-        switch(m_Type) {
-            case CONSTANT: {
-                data.velocity.x = m_Min.x;
-                data.velocity.y = m_Min.y;
-                data.velocity.z = m_Min.z;
-            } break;
-            case RANGE: {
-                data.velocity.x = RANGE(m_Min.x, m_Max.x);
-                data.velocity.y = RANGE(m_Min.y, m_Max.y);
-                data.velocity.z = RANGE(m_Min.z, m_Max.z);
-            } break;
-            default: break;
-        }
+    int32_t classType() const override { return VELOCITY; }
+
+    void spawnParticles(ParticleBuffer &buffer, uint32_t first, uint32_t count) override {
+        spawnValues(buffer.velocity, first, count, m_Type, m_Min, m_Max);
     }
 
-    void updateParticle(ParticleData &data, float dt) {
-        data.position += data.velocity * dt;
+    void updateParticles(ParticleBuffer &buffer, float dt) override {
+        integrateValues(buffer.position, buffer.velocity, buffer.count, dt);
     }
 };
 
@@ -0,0 +1,163 @@
+#include "spritebatch.h"
+
+#include "resources/mesh.h"
+#include "resources/material.h"
+
+#include "commandbuffer.h"
+
+#include <cfloat>
+
+/*!
+    \class SpriteBatch
+    \brief Merges 2D geometry which shares the same material state to reduce the number of draw calls.
+    \inmodule Engine
+
+    Geometry is transformed to the world space on the CPU and appended to the dynamic mesh.
+    Incoming geometry joins the latest open batch with the same material state, so interleaved atlases and materials don't break batching.
+    For the translucent and UI layers the geometry can't be moved over a batch which it overlaps on the screen, so the visible order of drawing is kept.
+    All open batches are submitted in the order of creation on the flush() call.
+*/
+
+SpriteBatch::SpriteBatch() :
+        m_buffer(nullptr),
+        m_layer(0),
+        m_used(0),
+        m_ordered(true) {
+
+}
+
+SpriteBatch::~SpriteBatch() {
+    for(auto it : m_meshes) {
+        Engine::unloadResource(it);
+    }
+}
+/*!
+    Starts a new sequence of batches for the \a layer which will be submitted to the command \a buffer.
+*/
+void SpriteBatch::begin(CommandBuffer *buffer, uint32_t layer) {
+    m_buffer = buffer;
+    m_layer = layer;
+    m_used = 0;
+    m_batches.clear();
+
+    m_viewProjection = m_buffer->projection() * m_buffer->view();
+    // The depth test resolves the order of opaque geometry
+    m_ordered = !(m_layer & (CommandBuffer::DEFAULT | CommandBuffer::SHADOWCAST));
+}
+/*!
+    Appends the \a mesh with world \a transform to the batch with the same \a material and local \a color.
+    A new batch will be opened if there is no such batch or the geometry overlaps the batches opened after it.
+*/
+void SpriteBatch::add(Mesh *mesh, const Matrix4 &transform, MaterialInstance *material, const Vector4 &color) {
+    if(mesh == nullptr || material == nullptr || mesh->vertices().empty()) {
+        return;
+    }
+
+    int32_t blend = material->material()->blendMode();
+    if(((m_layer & CommandBuffer::DEFAULT) && blend != Material::Opaque) ||
+       ((m_layer & CommandBuffer::TRANSLUCENT) && blend == Material::Opaque)) {
+        // Will be skipped by the render anyway
+        return;
+    }
+
+    m_points.clear();
+    m_points.reserve(mesh->vertices().size());
+
+    Vector2 min(FLT_MAX);
+    Vector2 max(-FLT_MAX);
+    for(auto &it : mesh->vertices()) {
+        Vector3 point = transform * it;
+        m_points.push_back(point);
+
+        Vector4 screen = m_viewProjection * Vector4(point, 1.0f);
+        if(screen.w <= 0.0f) {
+            // Behind the camera, the projection can't be trusted
+            min = Vector2(-FLT_MAX);
+            max = Vector2(FLT_MAX);
+        } else {
+            min.x = MIN(min.x, screen.x / screen.w);
+            min.y = MIN(min.y, screen.y / screen.w);
+            max.x = MAX(max.x, screen.x / screen.w);
+            max.y = MAX(max.y, screen.y / screen.w);
+        }
+    }
+
+    Batch *batch = nullptr;
+    for(auto it = m_batches.rbegin(); it != m_batches.rend(); ++it) {
+        if(it->color == color && it->material->isEqual(*material)) {
+            batch = &(*it);
+            break;
+        }
+        if(m_ordered && it->min.x <= max.x && min.x <= it->max.x && it->min.y <= max.y && min.y <= it->max.y) {
+            break;
+        }
+    }
+
+    if(batch == nullptr) {
+        if(m_used == m_meshes.size()) {
+            Mesh *dynamic = Engine::objectCreate<Mesh>("");
+            dynamic->makeDynamic();
+            m_meshes.push_back(dynamic);
+        }
+        Mesh *current = m_meshes[m_used];
+        current->clear();
+        m_used++;
+
+        m_batches.push_back({current, material, color, min, max});
+        batch = &m_batches.back();
+    } else {
+        batch->min.x = MIN(batch->min.x, min.x);
+        batch->min.y = MIN(batch->min.y, min.y);
+        batch->max.x = MAX(batch->max.x, max.x);
+        batch->max.y = MAX(batch->max.y, max.y);
+    }
+
+    Vector3Vector &vertices = batch->mesh->vertices();
+    Vector2Vector &uv0 = batch->mesh->uv0();
+    Vector4Vector &colors = batch->mesh->colors();
+    IndexVector &indices = batch->mesh->indices();
+
+    uint32_t offset = vertices.size();
+    uint32_t count = m_points.size();
+
+    vertices.insert(vertices.end(), m_points.begin(), m_points.end());
+
+    Vector2Vector &srcUv = mesh->uv0();
+    if(srcUv.size() == count) {
+        uv0.insert(uv0.end(), srcUv.begin(), srcUv.end());
+    } else {
+        uv0.resize(offset + count, Vector2(0.0f));
+    }
+
+    Vector4Vector &srcColors = mesh->colors();
+    if(srcColors.size() == count) {
+        colors.insert(colors.end(), srcColors.begin(), srcColors.end());
+    } else {
+        colors.resize(offset + count, Vector4(1.0f));
+    }
+
+    for(auto it : mesh->indices()) {
+        indices.push_back(it + offset);
+    }
+}
+/*!
+    Submits all open batches to the command buffer.
+*/
+void SpriteBatch::flush() {
+    for(auto &it : m_batches) {
+        it.mesh->recalcBounds();
+
+        m_buffer->setColor(it.color);
+        m_buffer->drawMesh(Matrix4(), it.mesh, 0, m_layer, it.material);
+    }
+    if(!m_batches.empty()) {
+        m_buffer->setColor(Vector4(1.0f));
+        m_batches.clear();
+    }
+}
+/*!
+    Returns the layer which is used for the current sequence of batches.
+*/
+uint32_t SpriteBatch::layer() const {
+    return m_layer;
+}
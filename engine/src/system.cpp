@@ -43,6 +43,13 @@ System::System() :
     m_pWorld(nullptr) {
 
 }
+/*!
+    All processing operations which require a constant time step for the current \a sceneGraph must be done in this method.
+    This method is called in the main thread Timer::fixedSteps() times per frame before System::update.
+*/
+void System::fixedUpdate(World *sceneGraph) {
+    A_UNUSED(sceneGraph);
+}
 /*!
     This method is a callback to react on saving game settings.
 */
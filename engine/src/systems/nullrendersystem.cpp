@@ -0,0 +1,185 @@
+#include "systems/nullrendersystem.h"
+
+#include "pipelinecontext.h"
+#include "commandbuffer.h"
+
+#include "resources/mesh.h"
+
+static int32_t registered = 0;
+
+class NullCommandBuffer : public CommandBuffer {
+    A_OVERRIDE(NullCommandBuffer, CommandBuffer, System)
+
+public:
+    NullCommandBuffer() :
+            m_drawCalls(0),
+            m_polygons(0),
+            m_dispatches(0) {
+
+    }
+
+    void begin() {
+        m_drawCalls = 0;
+        m_polygons = 0;
+        m_dispatches = 0;
+    }
+
+    void dispatchCompute(ComputeInstance *shader, int32_t groupsX, int32_t groupsY, int32_t groupsZ) override {
+        A_UNUSED(groupsX);
+        A_UNUSED(groupsY);
+        A_UNUSED(groupsZ);
+
+        if(shader) {
+            m_dispatches++;
+        }
+    }
+
+    void drawMesh(const Matrix4 &model, Mesh *mesh, uint32_t sub, uint32_t layer, MaterialInstance *material) override {
+        A_UNUSED(model);
+        A_UNUSED(sub);
+        A_UNUSED(layer);
+
+        if(mesh && material) {
+            accumulate(mesh, 1);
+        }
+    }
+
+    void drawMeshInstanced(const Matrix4 *models, uint32_t count, Mesh *mesh, uint32_t sub, uint32_t layer, MaterialInstance *material) override {
+        A_UNUSED(models);
+        A_UNUSED(sub);
+        A_UNUSED(layer);
+
+        if(mesh && material) {
+            accumulate(mesh, count);
+        }
+    }
+
+    void drawMeshIndirect(ComputeBuffer *models, ComputeBuffer *arguments, Mesh *mesh, uint32_t sub, uint32_t layer, MaterialInstance *material) override {
+        A_UNUSED(models);
+        A_UNUSED(sub);
+        A_UNUSED(layer);
+
+        if(mesh && arguments && material) {
+            m_drawCalls++;
+            PROFILER_STAT(DRAWCALLS, 1);
+        }
+    }
+
+    uint32_t m_drawCalls;
+
+    uint32_t m_polygons;
+
+    uint32_t m_dispatches;
+
+protected:
+    void accumulate(Mesh *mesh, uint32_t instances) {
+        uint32_t polygons = 0;
+        if(mesh->indices().empty()) {
+            uint32_t vert = mesh->vertices().size();
+            polygons = (vert > 2) ? vert - 2 : 0;
+        } else {
+            polygons = mesh->indices().size() / 3;
+        }
+        polygons *= instances;
+
+        m_drawCalls++;
+        m_polygons += polygons;
+
+        PROFILER_STAT(POLYGONS, polygons);
+        PROFILER_STAT(DRAWCALLS, 1);
+    }
+
+};
+
+static NullCommandBuffer *nullBuffer(PipelineContext *context) {
+    if(context) {
+        return dynamic_cast<NullCommandBuffer *>(context->buffer());
+    }
+    return nullptr;
+}
+
+/*!
+    \class NullRenderSystem
+    \brief The NullRenderSystem class executes the render pipeline without a graphics device.
+    \inmodule Engine
+
+    All rendering commands are accepted and counted but never reach a GPU.
+    This system is used in headless mode by dedicated servers and automated benchmarks to keep the full game cycle, including culling and pipeline logic, on the machines without a display.
+*/
+
+NullRenderSystem::NullRenderSystem(Engine *engine) :
+        RenderSystem(),
+        m_engine(engine) {
+
+    if(registered == 0) {
+        NullCommandBuffer::registerClassFactory(m_engine);
+    }
+    ++registered;
+
+    setName("NullRender");
+}
+
+NullRenderSystem::~NullRenderSystem() {
+    --registered;
+    if(registered == 0) {
+        NullCommandBuffer::unregisterClassFactory(m_engine);
+    }
+}
+/*!
+    Initialization of render.
+*/
+bool NullRenderSystem::init() {
+    PROFILE_FUNCTION();
+
+    bool result = RenderSystem::init();
+
+    CommandBuffer::setInited();
+
+    return result;
+}
+/*!
+    Executes the render pipeline for the \a world and collects the rendering statistic.
+*/
+void NullRenderSystem::update(World *world) {
+    PROFILE_FUNCTION();
+
+    PipelineContext *context = pipelineContext();
+    if(context) {
+        NullCommandBuffer *buffer = nullBuffer(context);
+        if(buffer) {
+            buffer->begin();
+        }
+
+        RenderSystem::update(world);
+    }
+}
+/*!
+    Returns the number of draw calls submitted during the last frame.
+*/
+uint32_t NullRenderSystem::drawCalls() const {
+    NullCommandBuffer *buffer = nullBuffer(pipelineContext());
+    if(buffer) {
+        return buffer->m_drawCalls;
+    }
+    return 0;
+}
+/*!
+    Returns the number of polygons submitted during the last frame.
+*/
+uint32_t NullRenderSystem::polygons() const {
+    NullCommandBuffer *buffer = nullBuffer(pipelineContext());
+    if(buffer) {
+        return buffer->m_polygons;
+    }
+    return 0;
+}
+/*!
+    Returns the number of compute dispatches submitted during the last frame.
+*/
+uint32_t NullRenderSystem::dispatches() const {
+    NullCommandBuffer *buffer = nullBuffer(pipelineContext());
+    if(buffer) {
+        return buffer->m_dispatches;
+    }
+    return 0;
+}
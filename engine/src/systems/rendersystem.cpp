@@ -151,6 +151,7 @@ void RenderSystem::update(World *world) {
 
     PROFILER_RESET(POLYGONS);
     PROFILER_RESET(DRAWCALLS);
+    PROFILER_RESET(UPLOADS);
 
     Camera *camera = Camera::current();
     if(camera && m_pipelineContext) {
@@ -8,6 +8,51 @@
 
 #include "resources/resource.h"
 
+#include <unordered_set>
+
+// 64-bit FNV-1a, a collision must not hide an edit of the resource
+static const uint64_t HASH_BASIS = 14695981039346656037ull;
+
+static uint64_t hashBytes(uint64_t hash, const void *data, size_t size) {
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    for(size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static uint64_t hashVariant(uint64_t hash, const Variant &value) {
+    uint32_t type = value.type();
+    hash = hashBytes(hash, &type, sizeof(type));
+    switch(type) {
+        case MetaType::INVALID: break;
+        case MetaType::STRING: {
+            const string &str = *(reinterpret_cast<const string *>(value.data()));
+            hash = hashBytes(hash, str.data(), str.size());
+        } break;
+        case MetaType::BYTEARRAY: {
+            const ByteArray &array = *(reinterpret_cast<const ByteArray *>(value.data()));
+            hash = hashBytes(hash, array.data(), array.size());
+        } break;
+        case MetaType::VARIANTLIST: {
+            for(auto &it : *(reinterpret_cast<const VariantList *>(value.data()))) {
+                hash = hashVariant(hash, it);
+            }
+        } break;
+        case MetaType::VARIANTMAP: {
+            for(auto &it : *(reinterpret_cast<const VariantMap *>(value.data()))) {
+                hash = hashBytes(hash, it.first.data(), it.first.size());
+                hash = hashVariant(hash, it.second);
+            }
+        } break;
+        default: {
+            hash = hashBytes(hash, value.data(), MetaType::size(type));
+        } break;
+    }
+    return hash;
+}
+
 ResourceSystem::ResourceSystem() {
     setName("ResourceSystem");
 
@@ -37,6 +82,7 @@ int ResourceSystem::threadPolicy() const {
 
 void ResourceSystem::setResource(Resource *object, const string &uuid) {
     PROFILE_FUNCTION();
+    unique_lock<mutex> locker(m_cacheMutex);
 
     m_resourceCache[uuid] = object;
     m_referenceCache[object] = uuid;
@@ -73,7 +119,18 @@ Resource *ResourceSystem::loadResource(const string &path) {
                 var = Json::load(string(data.begin(), data.end()));
             }
             if(var.isValid()) {
-                return static_cast<Resource *>(Engine::toObject(var, nullptr, uuid));
+                Resource *result = static_cast<Resource *>(Engine::toObject(var, nullptr, uuid));
+                if(result) {
+                    unique_lock<mutex> locker(m_cacheMutex);
+                    ResourceHashes &hashes = m_hashCache[result];
+                    hashes.file = hashBytes(HASH_BASIS, data.data(), data.size());
+                    hashes.size = data.size();
+                    for(auto &it : var.toList()) {
+                        const VariantList &fields = *(reinterpret_cast<const VariantList *>(it.data()));
+                        hashes.blocks[std::next(fields.begin(), 1)->toInt()] = hashVariant(HASH_BASIS, it);
+                    }
+                }
+                return result;
             }
         }
 
@@ -128,6 +185,8 @@ ResourceSystem::DictionaryMap &ResourceSystem::indices() const {
 
 void ResourceSystem::deleteFromCahe(Resource *resource) {
     PROFILE_FUNCTION();
+    // Resources can be destroyed from the asset import threads
+    unique_lock<mutex> locker(m_cacheMutex);
     auto ref = m_referenceCache.find(resource);
     if(ref != m_referenceCache.end()) {
         auto res = m_resourceCache.find(ref->second);
@@ -136,6 +195,7 @@ void ResourceSystem::deleteFromCahe(Resource *resource) {
         }
         m_referenceCache.erase(ref);
     }
+    m_hashCache.erase(resource);
 }
 
 void ResourceSystem::processState(Resource *resource) {
@@ -152,6 +212,18 @@ void ResourceSystem::processState(Resource *resource) {
                         file->fread(&data[0], data.size(), 1, fp);
                         file->fclose(fp);
 
+                        m_cacheMutex.lock();
+                        ResourceHashes &hashes = m_hashCache[resource];
+                        m_cacheMutex.unlock();
+
+                        uint64_t fileHash = hashBytes(HASH_BASIS, data.data(), data.size());
+                        if(hashes.file == fileHash && hashes.size == data.size()) {
+                            resource->switchState(Resource::Ready);
+                            break;
+                        }
+                        hashes.file = fileHash;
+                        hashes.size = data.size();
+
                         Variant var = Bson::load(data);
                         if(!var.isValid()) {
                             var = Json::load(string(data.begin(), data.end()));
@@ -160,14 +232,20 @@ void ResourceSystem::processState(Resource *resource) {
                         ObjectList deleteObjects;
                         enumObjects(resource, deleteObjects);
 
+                        unordered_set<Object *> keepObjects;
+                        unordered_map<uint32_t, uint64_t> blocks;
+                        bool rootChanged = false;
+
                         VariantList objects = var.toList();
-                        auto delIt = deleteObjects.begin();
                         bool first = true;
                         for(auto &obj : objects) {
                             VariantList fields = obj.toList();
                             auto it = std::next(fields.begin(), 1);
                             uint32_t id = it->toInt();
 
+                            uint64_t hash = hashVariant(HASH_BASIS, obj);
+                            blocks[id] = hash;
+
                             Object *object = resource;
                             if(!first) {
                                 object = Engine::findObject(id, resource);
@@ -176,6 +254,13 @@ void ResourceSystem::processState(Resource *resource) {
                             }
 
                             if(object) {
+                                keepObjects.insert(object);
+
+                                auto prev = hashes.blocks.find(id);
+                                if(prev != hashes.blocks.end() && prev->second == hash) {
+                                    continue;
+                                }
+
                                 it = std::next(fields.begin(), 4);
                                 VariantMap &properties = *(reinterpret_cast<VariantMap *>((*it).data()));
                                 for(const auto &prop : properties) {
@@ -187,20 +272,25 @@ void ResourceSystem::processState(Resource *resource) {
 
                                 object->loadUserData(fields.back().toMap());
 
-                                delIt = deleteObjects.erase(delIt);
+                                if(object == resource) {
+                                    rootChanged = true;
+                                }
                             } else {
                                 VariantList list;
                                 list.push_back(obj);
                                 Engine::toObject(list, resource, uuid);
                             }
                         }
+                        hashes.blocks.swap(blocks);
 
                         deleteObjects.reverse();
                         for(auto toDel : deleteObjects) {
-                            delete toDel;
+                            if(keepObjects.find(toDel) == keepObjects.end()) {
+                                delete toDel;
+                            }
                         }
 
-                        resource->switchState(Resource::ToBeUpdated);
+                        resource->switchState(rootChanged ? Resource::ToBeUpdated : Resource::Ready);
                     } else {
                         Log(Log::ERR) << "Unable to load resource: " << uuid.c_str();
                         resource->setState(Resource::Invalid);
@@ -1,9 +1,18 @@
 #include "timer.h"
 
+#define NANOSECONDS 1000000000.0
+
 static TimePoint m_sLastTime;
-static float m_sTime      = 0.0;
-static float m_sDeltaTime = 0.0;
-static float m_sTimeScale = 1.0;
+static uint64_t m_sTime      = 0;
+static float m_sDeltaTime    = 0.0;
+static float m_sTimeScale    = 1.0;
+
+static uint64_t m_sFixedStep        = 16666667; // 60 Hz
+static uint64_t m_sFixedAccumulator = 0;
+static uint64_t m_sFixedTick        = 0;
+static uint32_t m_sFixedSteps       = 0;
+static uint32_t m_sMaxFixedSteps    = 5;
+static float m_sInterpolation       = 0.0;
 
 /*!
     \class Timer
@@ -14,6 +23,11 @@ static float m_sTimeScale = 1.0;
     This class is used in all systems which doing any animation.
     Using deltaTime() method developers are able to calculate a logic based on delays for example shots or movements of your character.
     Time scale value can be used for the slow-motion effects because it applied for all deltaTime() values.
+
+    Besides the variable frame time the Timer drives the fixed update phase.
+    The elapsed time is accumulated in integer nanoseconds and consumed in the steps of fixedDeltaTime() length, so the simulation advances identically regardless of the frame rate.
+    The number of steps per frame is limited by maxFixedSteps() to avoid the spiral of death after a frame time spike; the excess time is dropped.
+    The remaining part of the step is returned by interpolation() and used to blend the last two fixed states for rendering.
 */
 
 /*!
@@ -22,9 +36,13 @@ static float m_sTimeScale = 1.0;
     \internal
 */
 void Timer::reset() {
-    m_sTime = 0.0;
+    m_sTime = 0;
     m_sDeltaTime = 0.0;
     m_sTimeScale = 1.0;
+    m_sFixedAccumulator = 0;
+    m_sFixedTick = 0;
+    m_sFixedSteps = 0;
+    m_sInterpolation = 0.0;
     m_sLastTime = std::chrono::high_resolution_clock::now();
 }
 /*!
@@ -35,16 +53,49 @@ void Timer::reset() {
 void Timer::update() {
     TimePoint current = std::chrono::high_resolution_clock::now();
 
-    m_sDeltaTime = (std::chrono::duration_cast<std::chrono::duration<float> >(current - m_sLastTime)).count() * m_sTimeScale;
-    m_sTime += m_sDeltaTime;
+    uint64_t delta = std::chrono::duration_cast<std::chrono::nanoseconds>(current - m_sLastTime).count();
     m_sLastTime = current;
+
+    advance(delta);
+}
+/*!
+    Advances the Timer by \a delta nanoseconds of the real time.
+    \note Usually, this method calls internally and must not be called manually.
+    \internal
+*/
+void Timer::advance(uint64_t delta) {
+    delta = static_cast<uint64_t>(delta * static_cast<double>(m_sTimeScale));
+
+    m_sDeltaTime = static_cast<float>(delta / NANOSECONDS);
+    m_sTime += delta;
+
+    m_sFixedAccumulator += delta;
+
+    uint64_t steps = m_sFixedAccumulator / m_sFixedStep;
+    if(steps > m_sMaxFixedSteps) {
+        steps = m_sMaxFixedSteps;
+    }
+    m_sFixedAccumulator -= steps * m_sFixedStep;
+    if(m_sFixedAccumulator >= m_sFixedStep) {
+        m_sFixedAccumulator %= m_sFixedStep;
+    }
+
+    m_sFixedSteps = static_cast<uint32_t>(steps);
+    m_sInterpolation = static_cast<float>(static_cast<double>(m_sFixedAccumulator) / m_sFixedStep);
 }
 /*!
     Returns the time in seconds since the start of the game.
     \note This value is updated in each frame. In case of calling multiple times in a single frame will return the same result.
 */
 float Timer::time() {
-    return m_sTime;
+    return static_cast<float>(m_sTime / NANOSECONDS);
+}
+/*!
+    Returns the time in seconds since the start of the game with double precision.
+    \note This value is updated in each frame. In case of calling multiple times in a single frame will return the same result.
+*/
+double Timer::preciseTime() {
+    return m_sTime / NANOSECONDS;
 }
 /*!
     Returns the time in seconds since the last frame.
@@ -65,3 +116,61 @@ float Timer::scale() {
 void Timer::setScale(float scale) {
     m_sTimeScale = scale;
 }
+/*!
+    Returns the duration of a fixed update step in seconds.
+*/
+float Timer::fixedDeltaTime() {
+    return static_cast<float>(m_sFixedStep / NANOSECONDS);
+}
+/*!
+    Sets the duration of a fixed update step to \a delta seconds.
+*/
+void Timer::setFixedDeltaTime(float delta) {
+    if(delta > 0.0f) {
+        m_sFixedStep = MAX(static_cast<uint64_t>(static_cast<double>(delta) * NANOSECONDS), 1ULL);
+    }
+}
+/*!
+    Returns the maximum number of fixed update steps which can be executed in a single frame.
+*/
+uint32_t Timer::maxFixedSteps() {
+    return m_sMaxFixedSteps;
+}
+/*!
+    Sets the maximum number of fixed update \a steps which can be executed in a single frame.
+*/
+void Timer::setMaxFixedSteps(uint32_t steps) {
+    m_sMaxFixedSteps = MAX(steps, 1U);
+}
+/*!
+    Returns the number of fixed update steps which must be executed in the current frame.
+*/
+uint32_t Timer::fixedSteps() {
+    return m_sFixedSteps;
+}
+/*!
+    Returns the number of executed fixed update steps since the start of the game.
+*/
+uint64_t Timer::fixedTick() {
+    return m_sFixedTick;
+}
+/*!
+    Returns the simulation time in seconds of the current fixed update step.
+*/
+double Timer::fixedTime() {
+    return (m_sFixedTick * m_sFixedStep) / NANOSECONDS;
+}
+/*!
+    Returns the blend factor between the last two fixed states in range [0, 1).
+*/
+float Timer::interpolation() {
+    return m_sInterpolation;
+}
+/*!
+    Advances the fixed update tick counter.
+    \note Usually, this method calls internally and must not be called manually.
+    \internal
+*/
+void Timer::nextFixedStep() {
+    m_sFixedTick++;
+}
@@ -1,6 +1,8 @@
 #include "tst_common.h"
 
 #include "components/actor.h"
+#include "components/world.h"
+#include "components/scene.h"
 #include "components/transform.h"
 #include "components/component.h"
 #include "components/camera.h"
@@ -79,6 +81,116 @@ void Transform_hierarchy() {
     QCOMPARE(t2->parentTransform() == t1, true);
 }
 
+void Transform_interpolation() {
+    ObjectSystem system;
+    Actor::registerClassFactory(&system);
+    Transform::registerClassFactory(&system);
+
+    Actor a1;
+    a1.addComponent("Transform");
+
+    Actor a2;
+    a2.addComponent("Transform");
+
+    Transform *t1 = a1.transform();
+    Transform *t2 = a2.transform();
+
+    a2.setParent(&a1);
+    t2->setPosition(Vector3(0.0f, 1.0f, 0.0f));
+
+    t1->setInterpolate(true);
+    QCOMPARE(t1->isInterpolated(), true);
+    QCOMPARE(t2->isInterpolated(), true);
+
+    Transform::beginFixedUpdate();
+    Transform::beginFixedStep();
+    t1->setPosition(Vector3(10.0f, 0.0f, 0.0f));
+    Transform::endFixedUpdate();
+
+    Transform::applyInterpolation(0.5f);
+
+    // The Transform keeps the fixed state, only the rendering is interpolated
+    QCOMPARE(t1->position() == Vector3(10.0f, 0.0f, 0.0f), true);
+    QCOMPARE(t1->worldPosition() == Vector3(10.0f, 0.0f, 0.0f), true);
+
+    Matrix4 m1(t1->renderTransform());
+    QCOMPARE(Vector3(m1[12], m1[13], m1[14]) == Vector3(5.0f, 0.0f, 0.0f), true);
+    Matrix4 m2(t2->renderTransform());
+    QCOMPARE(Vector3(m2[12], m2[13], m2[14]) == Vector3(5.0f, 1.0f, 0.0f), true);
+
+    // Changes outside of the fixed update phase are teleportations
+    t1->setPosition(Vector3(20.0f, 0.0f, 0.0f));
+    m1 = t1->renderTransform();
+    QCOMPARE(Vector3(m1[12], m1[13], m1[14]) == Vector3(20.0f, 0.0f, 0.0f), true);
+
+    Transform::beginFixedUpdate();
+    Transform::beginFixedStep();
+    Transform::endFixedUpdate();
+    Transform::applyInterpolation(0.5f);
+    m1 = t1->renderTransform();
+    QCOMPARE(Vector3(m1[12], m1[13], m1[14]) == Vector3(20.0f, 0.0f, 0.0f), true);
+
+    t1->setInterpolate(false);
+    QCOMPARE(t2->isInterpolated(), false);
+    QCOMPARE(t2->renderTransform() == t2->worldTransform(), true);
+}
+
+void Transform_changes() {
+    ObjectSystem system;
+    Actor::registerClassFactory(&system);
+    Transform::registerClassFactory(&system);
+    TestComponent::registerClassFactory(&system);
+
+    Actor a1;
+    a1.addComponent("Transform");
+
+    Actor a2;
+    a2.addComponent("Transform");
+    a2.addComponent("TestComponent");
+
+    Transform *t1 = a1.transform();
+    Transform *t2 = a2.transform();
+
+    a2.setParent(&a1);
+
+    vector<Transform *> changes;
+    Transform::takeChanges(changes);
+    changes.clear();
+
+    // Untracked transforms are not reported
+    t2->setPosition(Vector3(1.0f));
+    Transform::takeChanges(changes);
+    QCOMPARE(changes.empty(), true);
+
+    t2->setTracked(true);
+    t2->setPosition(Vector3(2.0f));
+    t2->setRotation(Vector3(0.0f, 90.0f, 0.0f));
+    Transform::takeChanges(changes);
+    QCOMPARE(changes.size(), 1);
+    QCOMPARE(changes.front() == t2, true);
+
+    // The physics resolves the components to synchronize from the changed transforms
+    QCOMPARE(changes.front()->actor()->findChildren<TestComponent *>(false).size(), 1);
+
+    // Changes are consumed once
+    changes.clear();
+    Transform::takeChanges(changes);
+    QCOMPARE(changes.empty(), true);
+
+    // Moving of the parent affects the tracked child
+    t1->setPosition(Vector3(5.0f));
+    Transform::takeChanges(changes);
+    QCOMPARE(changes.size(), 1);
+    QCOMPARE(changes.front() == t2, true);
+    changes.clear();
+
+    // Pending change is discarded with the tracking
+    t2->setPosition(Vector3(3.0f));
+    t2->setTracked(false);
+    Transform::takeChanges(changes);
+    QCOMPARE(changes.empty(), true);
+}
+
 void Add_Remove_Component() {
     ObjectSystem system;
     Actor::registerClassFactory(&system);
@@ -93,6 +205,8 @@ void Add_Remove_Component() {
 
     Component *result1 = a1.component("Component");
     QCOMPARE(component == result1, true);
+    QCOMPARE(a1.component<Component>() == component, true);
+    QCOMPARE(a1.component<Camera>() == nullptr, true);
 
     a1.setParent(&parent);
 
@@ -101,6 +215,94 @@ void Add_Remove_Component() {
 
     delete component;
     QCOMPARE(a1.getChildren().size(), 0);
+    QCOMPARE(a1.component<Component>() == nullptr, true);
+}
+
+void Find_cached_children() {
+    ObjectSystem system;
+    Actor::registerClassFactory(&system);
+    Component::registerClassFactory(&system);
+    Transform::registerClassFactory(&system);
+
+    World world;
+    Scene scene;
+    scene.setParent(&world);
+
+    Actor outside;
+    outside.addComponent("Transform");
+
+    Actor a1;
+    a1.addComponent("Transform");
+    a1.setParent(&scene);
+    QCOMPARE(world.findCachedChildren(Actor::metaClass()).size(), 1);
+    QCOMPARE(world.findCachedChildren(Component::metaClass()).size(), 1);
+
+    // Add
+    Actor *a2 = new Actor;
+    a2->addComponent("Transform");
+    a2->setParent(&scene);
+    QCOMPARE(world.findCachedChildren(Actor::metaClass()).size(), 2);
+
+    Component *component = a2->addComponent("Component");
+    QCOMPARE(world.findCachedChildren(Component::metaClass()).size(), 3);
+
+    // Remove
+    delete component;
+    QCOMPARE(world.findCachedChildren(Component::metaClass()).size(), 2);
+
+    // Reparent
+    a1.setParent(&outside);
+    QCOMPARE(world.findCachedChildren(Actor::metaClass()).size(), 1);
+    QCOMPARE(world.findCachedChildren(Actor::metaClass()).front() == a2, true);
+
+    a1.setParent(a2);
+    QCOMPARE(world.findCachedChildren(Actor::metaClass()).size(), 2);
+
+    // Destroy
+    a1.setParent(&scene);
+    delete a2;
+    QCOMPARE(world.findCachedChildren(Actor::metaClass()).size(), 1);
+    QCOMPARE(world.findCachedChildren(Actor::metaClass()).front() == &a1, true);
+}
+
+void Invalidate_dynamic_component() {
+    ObjectSystem system;
+    Actor::registerClassFactory(&system);
+    Component::registerClassFactory(&system);
+
+    Actor a1;
+    Component *component = a1.addComponent("Component");
+
+    // Script classes create and delete own MetaObjects on reload
+    MetaObject *meta = new MetaObject("DynamicComponent", Component::metaClass(), nullptr, nullptr, nullptr, nullptr);
+    QCOMPARE(a1.component(meta) == nullptr, true);
+
+    Actor::invalidateComponents();
+    delete meta;
+
+    QCOMPARE(a1.component("Component") == component, true);
+    QCOMPARE(a1.component<Component>() == component, true);
+}
+
+void Set_property_benchmark() {
+    Engine system(nullptr, "");
+    RenderSystem render;
+
+    // Renderables must be created by the RenderSystem which tracks them
+    Actor *actor = Engine::objectCreate<Actor>("Actor");
+    MeshRender *mesh = dynamic_cast<MeshRender *>(actor->addComponent("MeshRender"));
+    QVERIFY(mesh != nullptr);
+
+    QCOMPARE(mesh->metaObject()->indexOfProperty("enabled") > -1, true);
+    QCOMPARE(mesh->metaObject()->indexOfProperty("unknown"), -1);
+
+    QBENCHMARK {
+        mesh->setProperty("enabled", false);
+        mesh->setProperty("enabled", true);
+    }
+    QCOMPARE(mesh->isEnabled(), true);
+
+    delete actor;
 }
 
 void Prefab_serialization() {
@@ -0,0 +1,59 @@
+#include "tst_common.h"
+
+#include "resources/atlas.h"
+
+class AtlasTest : public QObject {
+    Q_OBJECT
+private slots:
+
+void Pack_shadow_tiles() {
+    AtlasNode root;
+    root.w = 1024;
+    root.h = 1024;
+
+    // The region for a cube light with six 256x256 faces
+    AtlasNode *region = root.insert(256 * 3, 256 * 2);
+    QVERIFY(region != nullptr);
+    QCOMPARE(region->x, 0);
+    QCOMPARE(region->y, 0);
+    QCOMPARE(region->w, 768);
+    QCOMPARE(region->h, 512);
+
+    for(int i = 0; i < 6; i++) {
+        AtlasNode *node = region->insert(256, 256);
+        QVERIFY(node != nullptr);
+        QCOMPARE(node->w, 256);
+        QCOMPARE(node->h, 256);
+        QVERIFY(node->x + node->w <= region->w);
+        QVERIFY(node->y + node->h <= region->h);
+        node->fill = true;
+    }
+    QVERIFY(region->insert(256, 256) == nullptr);
+
+    // The rest of the page is still available
+    AtlasNode *next = root.insert(512, 512);
+    QVERIFY(next != nullptr);
+    QCOMPARE(next->y, 512);
+    next->fill = true;
+
+    QVERIFY(root.insert(1024, 1024) == nullptr);
+}
+
+void Pack_exact_page() {
+    AtlasNode root;
+    root.w = 256;
+    root.h = 256;
+
+    AtlasNode *region = root.insert(256, 256);
+    QVERIFY(region == &root);
+
+    AtlasNode *node = region->insert(256, 256);
+    QVERIFY(node == &root);
+    node->fill = true;
+
+    QVERIFY(root.insert(1, 1) == nullptr);
+}
+
+} REGISTER(AtlasTest)
+
+#include "tst_atlas.moc"
@@ -0,0 +1,109 @@
+#include "tst_common.h"
+
+#include "adapters/headlessadaptor.h"
+
+#include "systems/nullrendersystem.h"
+
+#include "components/world.h"
+#include "components/scene.h"
+#include "components/actor.h"
+#include "components/transform.h"
+#include "components/camera.h"
+#include "components/meshrender.h"
+
+#include "resources/material.h"
+#include "resources/mesh.h"
+
+#include "file.h"
+
+// The render passes request the embedded resources which are not available in tests
+class EmptyFile : public File {
+public:
+    _FILE *fopen(const char *path, const char *mode) override {
+        A_UNUSED(path);
+        A_UNUSED(mode);
+        return nullptr;
+    }
+};
+
+class HeadlessTest : public QObject {
+    Q_OBJECT
+private slots:
+
+void Init_and_update() {
+    EmptyFile file;
+    Engine engine(&file, "");
+
+    Engine::setValue("platform.headless", true);
+    Engine::setValue("screen.width", 640);
+    Engine::setValue("screen.height", 480);
+    Engine::setValue("headless.frames", 3);
+
+    QCOMPARE(engine.init(), true);
+    QCOMPARE(Engine::isHeadless(), true);
+
+    NullRenderSystem *render = dynamic_cast<NullRenderSystem *>(Engine::renderSystem());
+    QVERIFY(render != nullptr);
+
+    // The final blit material and plane are taken from the resource cache
+    Material *material = Engine::objectCreate<Material>();
+    Engine::setResource(material, ".embedded/DefaultPostEffect.shader");
+
+    Mesh *plane = Engine::objectCreate<Mesh>();
+    plane->setVertices({Vector3(-1.0f,-1.0f, 0.0f), Vector3(-1.0f, 1.0f, 0.0f), Vector3(1.0f, 1.0f, 0.0f), Vector3(1.0f,-1.0f, 0.0f)});
+    plane->setIndices({0, 1, 2, 0, 2, 3});
+    plane->recalcBounds();
+    Engine::setResource(plane, ".embedded/plane.fbx/Plane001");
+
+    QCOMPARE(render->init(), true);
+
+    Scene *scene = Engine::world()->createScene("Scene");
+
+    Engine::composeActor("Camera", "Camera", scene);
+
+    Actor *actor = Engine::composeActor("MeshRender", "Mesh", scene);
+    actor->transform()->setPosition(Vector3(0.0f, 0.0f,-5.0f));
+    MeshRender *mesh = actor->component<MeshRender>();
+    QVERIFY(mesh != nullptr);
+    mesh->setMesh(plane);
+    mesh->setMaterial(material);
+
+    // Without the renderable only the final blit reaches the command buffer
+    actor->setEnabled(false);
+    engine.update();
+    QCOMPARE(render->drawCalls(), 1);
+    QCOMPARE(render->polygons(), 2);
+
+    // The mesh is visible to the camera, each pass which draws it adds the quad
+    actor->setEnabled(true);
+    for(int i = 0; i < 3; i++) {
+        engine.update();
+    }
+    QVERIFY(render->drawCalls() > 1);
+    QCOMPARE(render->polygons(), render->drawCalls() * 2);
+
+    // Moved behind the camera the mesh is culled
+    actor->transform()->setPosition(Vector3(0.0f, 0.0f, 5.0f));
+    for(int i = 0; i < 2; i++) {
+        engine.update();
+    }
+    QCOMPARE(render->drawCalls(), 1);
+
+    HeadlessAdaptor adaptor(&engine);
+    QCOMPARE(adaptor.init(), true);
+    QCOMPARE(adaptor.start(), true);
+    QCOMPARE(adaptor.screenWidth(), 640);
+    QCOMPARE(adaptor.screenHeight(), 480);
+
+    uint32_t frames = 0;
+    while(adaptor.isValid()) {
+        adaptor.update();
+        frames++;
+    }
+    QCOMPARE(frames, 3);
+    adaptor.stop();
+}
+
+} REGISTER(HeadlessTest)
+
+#include "tst_headless.moc"
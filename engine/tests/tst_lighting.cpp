@@ -0,0 +1,86 @@
+#include "tst_common.h"
+
+#include "components/actor.h"
+#include "components/transform.h"
+#include "components/camera.h"
+#include "components/pointlight.h"
+
+#include "pipelinepasses/deferredlighting.h"
+
+#include "systems/rendersystem.h"
+
+#include "file.h"
+
+// Lights and pipeline passes request the embedded materials which are not available in tests
+class EmptyFile : public File {
+public:
+    _FILE *fopen(const char *path, const char *mode) override {
+        A_UNUSED(path);
+        A_UNUSED(mode);
+        return nullptr;
+    }
+};
+
+class LightingTest : public QObject {
+    Q_OBJECT
+private slots:
+
+void Build_light_clusters() {
+    EmptyFile file;
+    Engine system(&file, "");
+    RenderSystem render;
+
+    Actor *view = Engine::composeActor("Camera", "Camera");
+    Camera *camera = view->component<Camera>();
+    QVERIFY(camera != nullptr);
+
+    // Reference values for the 45 degree frustum with 0.1 - 1000 depth range
+    list<BaseLight *> lights;
+    Actor *front = Engine::composeActor("PointLight", "Front");
+    front->transform()->setPosition(Vector3(0.0f, 0.0f,-10.0f));
+    PointLight *light = front->component<PointLight>();
+    light->setAttenuationRadius(1.0f);
+    lights.push_back(light);
+
+    Actor *back = Engine::composeActor("PointLight", "Back");
+    back->transform()->setPosition(Vector3(0.0f, 0.0f, 10.0f));
+    light = back->component<PointLight>();
+    light->setAttenuationRadius(1.0f);
+    lights.push_back(light);
+
+    Actor *around = Engine::composeActor("PointLight", "Around");
+    light = around->component<PointLight>();
+    light->setAttenuationRadius(5.0f);
+    lights.push_back(light);
+
+    DeferredLighting pass;
+    pass.buildClusters(camera, lights);
+
+    // The front light covers 9 - 11 units depth range which is 11 - 12 slices and 5 - 10, 3 - 5 tiles
+    QCOMPARE(pass.clusterLights(7, 4, 11).size(), 1);
+    QCOMPARE(pass.clusterLights(7, 4, 11)[0], 0);
+    QCOMPARE(pass.clusterLights(5, 3, 12).size(), 1);
+    QCOMPARE(pass.clusterLights(10, 5, 12).size(), 1);
+    QCOMPARE(pass.clusterLights(4, 4, 11).size(), 0);
+    QCOMPARE(pass.clusterLights(11, 4, 11).size(), 0);
+    QCOMPARE(pass.clusterLights(7, 2, 11).size(), 0);
+    QCOMPARE(pass.clusterLights(7, 6, 11).size(), 0);
+    QCOMPARE(pass.clusterLights(7, 4, 13).size(), 0);
+
+    // The light around the camera covers the whole screen up to 5 units which is 10 slice
+    QCOMPARE(pass.clusterLights(0, 0, 0).size(), 1);
+    QCOMPARE(pass.clusterLights(0, 0, 0)[0], 2);
+    QCOMPARE(pass.clusterLights(15, 8, 10).size(), 1);
+    QCOMPARE(pass.clusterLights(15, 8, 11).size(), 0);
+
+    // The light behind the camera is not visible
+    for(uint32_t z = 0; z < 24; z++) {
+        for(auto it : pass.clusterLights(7, 4, z)) {
+            QVERIFY(it != 1);
+        }
+    }
+}
+
+} REGISTER(LightingTest)
+
+#include "tst_lighting.moc"
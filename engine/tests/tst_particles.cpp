@@ -0,0 +1,204 @@
+#include "tst_common.h"
+
+#include "resources/particleeffect.h"
+#include "resources/computeshader.h"
+#include "resources/material.h"
+#include "resources/mesh.h"
+
+#include "components/actor.h"
+#include "components/camera.h"
+#include "components/particlerender.h"
+
+#include "systems/rendersystem.h"
+
+#include "commandbuffer.h"
+#include "file.h"
+
+// The embedded compute shader is not available in tests
+class EmptyFile : public File {
+public:
+    _FILE *fopen(const char *path, const char *mode) override {
+        A_UNUSED(path);
+        A_UNUSED(mode);
+        return nullptr;
+    }
+};
+
+class ParticleBufferCalls : public CommandBuffer {
+public:
+    void dispatchCompute(ComputeInstance *shader, int32_t groupsX, int32_t groupsY, int32_t groupsZ) override {
+        A_UNUSED(shader);
+        A_UNUSED(groupsY);
+        A_UNUSED(groupsZ);
+
+        dispatches++;
+        groups = groupsX;
+    }
+
+    void drawMeshInstanced(const Matrix4 *models, uint32_t count, Mesh *mesh, uint32_t sub, uint32_t layer, MaterialInstance *material) override {
+        A_UNUSED(models);
+        A_UNUSED(mesh);
+        A_UNUSED(sub);
+        A_UNUSED(layer);
+        A_UNUSED(material);
+
+        instanced++;
+        instances = count;
+    }
+
+    void drawMeshIndirect(ComputeBuffer *models, ComputeBuffer *arguments, Mesh *mesh, uint32_t sub, uint32_t layer, MaterialInstance *material) override {
+        A_UNUSED(models);
+        A_UNUSED(arguments);
+        A_UNUSED(mesh);
+        A_UNUSED(sub);
+        A_UNUSED(layer);
+        A_UNUSED(material);
+
+        indirect++;
+    }
+
+    void reset() {
+        dispatches = 0;
+        instanced = 0;
+        indirect = 0;
+    }
+
+    uint32_t dispatches = 0;
+    uint32_t instanced = 0;
+    uint32_t indirect = 0;
+
+    uint32_t groups = 0;
+    uint32_t instances = 0;
+};
+
+class ParticlesTest : public QObject {
+    Q_OBJECT
+private slots:
+
+void Update_particles() {
+    Engine system(nullptr, "");
+
+    VariantList modifiers;
+    modifiers.push_back(VariantList({ParticleModificator::LIFETIME, VariantList({ParticleModificator::CONSTANT, Vector4(2.0f)})}));
+    modifiers.push_back(VariantList({ParticleModificator::STARTPOSITION, VariantList({ParticleModificator::CONSTANT, Vector4(1.0f, 2.0f, 3.0f, 0.0f)})}));
+    modifiers.push_back(VariantList({ParticleModificator::VELOCITY, VariantList({ParticleModificator::CONSTANT, Vector4(2.0f, 0.0f, -2.0f, 0.0f)})}));
+
+    VariantList emitter = {"", "", false, false, true, 1.0f, modifiers};
+
+    VariantMap data;
+    data["Emitters"] = VariantList({emitter});
+
+    ParticleEffect effect;
+    effect.loadUserData(data);
+    QCOMPARE(effect.emittersCount(), 1);
+
+    ModifiersDeque &list = effect.emitter(0)->modifiers();
+    QCOMPARE(list.size(), 3);
+
+    ParticleBuffer buffer;
+    uint32_t first = buffer.emit(4);
+    QCOMPARE(first, 0);
+    QCOMPARE(buffer.count, 4);
+
+    for(auto it : list) {
+        it->spawnParticles(buffer, first, 4);
+    }
+    QCOMPARE(buffer.life[3], 2.0f);
+    QCOMPARE(buffer.position[3] == Vector3(1.0f, 2.0f, 3.0f), true);
+
+    for(auto it : list) {
+        it->updateParticles(buffer, 0.5f);
+    }
+    QCOMPARE(buffer.position[0] == Vector3(2.0f, 2.0f, 2.0f), true);
+    QCOMPARE(buffer.position[3] == Vector3(2.0f, 2.0f, 2.0f), true);
+
+    buffer.life[1] = -1.0f;
+    buffer.position[3] = Vector3(5.0f);
+    buffer.compact();
+    QCOMPARE(buffer.count, 3);
+    QCOMPARE(buffer.position[1] == Vector3(5.0f), true);
+
+    first = buffer.emit(2);
+    QCOMPARE(first, 3);
+    QCOMPARE(buffer.count, 5);
+}
+
+void Compute_fallback() {
+    EmptyFile file;
+    Engine system(&file, "");
+    RenderSystem render;
+
+    Mesh *quad = Engine::objectCreate<Mesh>();
+    quad->setVertices({Vector3(-1.0f,-1.0f, 0.0f), Vector3(-1.0f, 1.0f, 0.0f), Vector3(1.0f, 1.0f, 0.0f), Vector3(1.0f,-1.0f, 0.0f)});
+    quad->setIndices({0, 1, 2, 0, 2, 3});
+    Engine::setResource(quad, "Quad");
+
+    Material *material = Engine::objectCreate<Material>();
+    Engine::setResource(material, "Material");
+
+    VariantList modifiers;
+    modifiers.push_back(VariantList({ParticleModificator::LIFETIME, VariantList({ParticleModificator::CONSTANT, Vector4(2.0f)})}));
+
+    VariantMap data;
+    data["Emitters"] = VariantList({VariantList({"Quad", "Material", true, false, true, 10.0f, modifiers})});
+
+    ParticleEffect *effect = Engine::objectCreate<ParticleEffect>();
+    effect->loadUserData(data);
+    QCOMPARE(effect->emitter(0)->gpu(), true);
+
+    Actor *view = Engine::composeActor("Camera", "Camera");
+    Camera::setCurrent(view->component<Camera>());
+
+    Actor *actor = Engine::composeActor("ParticleRender", "Particles");
+    ParticleRender *particles = actor->component<ParticleRender>();
+    QVERIFY(particles != nullptr);
+    Renderable *renderable = particles;
+
+    ParticleBufferCalls buffer;
+
+    // The backend without compute support simulates the emitter on the CPU
+    CommandBuffer::setComputeSupported(false);
+    particles->setEffect(effect);
+    particles->deltaUpdate(1.0f);
+    renderable->dispatch(buffer);
+    renderable->draw(buffer, CommandBuffer::DEFAULT);
+    QCOMPARE(buffer.dispatches, 0);
+    QCOMPARE(buffer.indirect, 0);
+    QCOMPARE(buffer.instanced, 1);
+    QCOMPARE(buffer.instances, 10);
+
+    // Compute is supported, but the simulation shader can't be loaded
+    buffer.reset();
+    CommandBuffer::setComputeSupported(true);
+    particles->setEffect(effect);
+    particles->deltaUpdate(1.0f);
+    renderable->dispatch(buffer);
+    renderable->draw(buffer, CommandBuffer::DEFAULT);
+    QCOMPARE(buffer.dispatches, 0);
+    QCOMPARE(buffer.indirect, 0);
+    QCOMPARE(buffer.instanced, 1);
+
+    // The simulation is dispatched once per update, the draw calls only consume the result
+    ComputeShader *shader = Engine::objectCreate<ComputeShader>();
+    Engine::setResource(shader, ".embedded/ParticleSimulation.compute");
+
+    buffer.reset();
+    particles->setEffect(effect);
+    particles->deltaUpdate(1.0f);
+    renderable->dispatch(buffer);
+    renderable->draw(buffer, CommandBuffer::DEFAULT);
+    renderable->draw(buffer, CommandBuffer::DEFAULT);
+    QCOMPARE(buffer.dispatches, 1);
+    QCOMPARE(buffer.groups, 1);
+    QCOMPARE(buffer.instanced, 0);
+    QCOMPARE(buffer.indirect, 2);
+
+    renderable->dispatch(buffer);
+    QCOMPARE(buffer.dispatches, 1);
+
+    CommandBuffer::setComputeSupported(false);
+}
+
+} REGISTER(ParticlesTest)
+
+#include "tst_particles.moc"
@@ -0,0 +1,74 @@
+#include "tst_common.h"
+
+#include "querybatch.h"
+
+#include "components/world.h"
+
+#include <thread>
+
+class QueryBatchTest : public QObject {
+    Q_OBJECT
+private slots:
+
+void Fill_batch() {
+    QueryBatch batch;
+    QCOMPARE(batch.addRayCast(Ray(Vector3(), Vector3(0.0f,-1.0f, 0.0f)), 2.0f), 0);
+    QCOMPARE(batch.addSphereOverlap(Vector3(1.0f), 0.5f), 1);
+    QCOMPARE(batch.size(), 2);
+
+    QCOMPARE(batch.query(0).type, QueryBatch::RayCast);
+    QCOMPARE(batch.query(0).distance, 2.0f);
+    QCOMPARE(batch.query(1).type, QueryBatch::SphereOverlap);
+    QCOMPARE(batch.query(1).extent == Vector3(0.5f), true);
+    QCOMPARE(batch.isFinished(), true);
+
+    batch.clear();
+    QCOMPARE(batch.size(), 0);
+}
+
+void Submit_without_physics() {
+    World world;
+
+    QueryBatch batch;
+    batch.addRayCast(Ray(Vector3(), Vector3(0.0f, 0.0f, 1.0f)), 10.0f);
+
+    QCOMPARE(world.submitQueries(&batch), false);
+    QCOMPARE(batch.isFinished(), true);
+    QCOMPARE(batch.result(0).valid, false);
+}
+
+void Finish_tasks() {
+    QueryBatch batch;
+    batch.addRayCast(Ray(Vector3(), Vector3(0.0f, 0.0f, 1.0f)), 10.0f);
+    batch.addBoxOverlap(Vector3(), Vector3(1.0f), Quaternion());
+
+    batch.begin(2);
+    QCOMPARE(batch.isFinished(), false);
+
+    batch.resultData()[1].valid = true;
+    batch.finish();
+    QCOMPARE(batch.isFinished(), false);
+
+    std::thread worker([&batch]() {
+        batch.resultData()[0].valid = true;
+        batch.finish();
+    });
+    batch.wait();
+    worker.join();
+
+    QCOMPARE(batch.isFinished(), true);
+    QCOMPARE(batch.result(0).valid, true);
+    QCOMPARE(batch.result(1).valid, true);
+
+    // Extra calls don't underflow the counter
+    batch.finish();
+    QCOMPARE(batch.isFinished(), true);
+
+    // Results are reset for the next submission
+    batch.begin(0);
+    QCOMPARE(batch.result(0).valid, false);
+}
+
+} REGISTER(QueryBatchTest)
+
+#include "tst_querybatch.moc"
@@ -0,0 +1,176 @@
+#include "tst_common.h"
+
+#include "resources/resource.h"
+
+#include "systems/resourcesystem.h"
+
+#include "file.h"
+
+#include <bson.h>
+
+#include <cstring>
+
+class TestBlock : public Object {
+public:
+    A_REGISTER(TestBlock, Object, General);
+
+    A_NOPROPERTIES()
+    A_NOMETHODS()
+
+    TestBlock() :
+            m_value(0),
+            m_loads(0) {
+
+    }
+
+    void loadUserData(const VariantMap &data) override {
+        auto it = data.find("value");
+        if(it != data.end()) {
+            m_value = it->second.toInt();
+        }
+        m_loads++;
+    }
+
+    VariantMap saveUserData() const override {
+        VariantMap result;
+        result["value"] = m_value;
+        return result;
+    }
+
+    int m_value;
+    int m_loads;
+
+};
+
+class TestResource : public Resource {
+public:
+    A_REGISTER(TestResource, Resource, Resources);
+
+    A_NOPROPERTIES()
+    A_NOMETHODS()
+
+    TestResource() :
+            m_loads(0) {
+
+    }
+
+    void loadUserData(const VariantMap &) override {
+        m_loads++;
+    }
+
+    int m_loads;
+
+};
+
+class MemoryFile : public File {
+public:
+    struct Stream {
+        ByteArray data;
+        size_t pos;
+    };
+
+    _FILE *fopen(const char *path, const char *) override {
+        auto it = m_files.find(path);
+        if(it == m_files.end()) {
+            return nullptr;
+        }
+        return new Stream({it->second, 0});
+    }
+
+    int fclose(_FILE *stream) override {
+        delete static_cast<Stream *>(stream);
+        return 0;
+    }
+
+    _size_t fsize(_FILE *stream) override {
+        return static_cast<Stream *>(stream)->data.size();
+    }
+
+    _size_t fread(void *ptr, _size_t size, _size_t count, _FILE *stream) override {
+        Stream *s = static_cast<Stream *>(stream);
+        size_t bytes = std::min(size_t(size * count), s->data.size() - s->pos);
+        memcpy(ptr, &s->data[s->pos], bytes);
+        s->pos += bytes;
+        return bytes / size;
+    }
+
+    map<string, ByteArray> m_files;
+
+};
+
+class ResourceSystemTest : public QObject {
+    Q_OBJECT
+private slots:
+
+void Reload_resource_delta() {
+    MemoryFile file;
+    Engine system(&file, "");
+    TestBlock::registerClassFactory(&system);
+    TestResource::registerClassFactory(system.resourceSystem());
+
+    TestResource *source = new TestResource;
+    TestBlock *sourceBlock = Engine::objectCreate<TestBlock>("Block", source);
+    sourceBlock->m_value = 1;
+
+    file.m_files["TestResource"] = Bson::save(Engine::toVariant(source));
+
+    TestResource *resource = Engine::loadResource<TestResource>("TestResource");
+    QCOMPARE(resource != nullptr, true);
+    QCOMPARE(resource->getChildren().size(), 1);
+
+    TestBlock *block = dynamic_cast<TestBlock *>(resource->getChildren().front());
+    QCOMPARE(block != nullptr, true);
+    QCOMPARE(block->m_value, 1);
+
+    int resourceLoads = resource->m_loads;
+    int blockLoads = block->m_loads;
+
+    // Identical file is not parsed
+    Engine::reloadResource("TestResource");
+    QCOMPARE(resource->state(), Resource::Ready);
+    QCOMPARE(resource->m_loads, resourceLoads);
+    QCOMPARE(block->m_loads, blockLoads);
+
+    // Only the changed block is reloaded
+    sourceBlock->m_value = 2;
+    file.m_files["TestResource"] = Bson::save(Engine::toVariant(source));
+
+    Engine::reloadResource("TestResource");
+    QCOMPARE(resource->state(), Resource::Ready);
+    QCOMPARE(resource->m_loads, resourceLoads);
+    QCOMPARE(resource->getChildren().size(), 1);
+    QCOMPARE(resource->getChildren().front() == block, true);
+    QCOMPARE(block->m_loads, blockLoads + 1);
+    QCOMPARE(block->m_value, 2);
+
+    // Removed object is deleted
+    delete sourceBlock;
+    file.m_files["TestResource"] = Bson::save(Engine::toVariant(source));
+
+    Engine::reloadResource("TestResource");
+    QCOMPARE(resource->m_loads, resourceLoads);
+    QCOMPARE(resource->getChildren().size(), 0);
+
+    // The edit which keeps the size of the file is detected
+    TestBlock *sizedBlock = Engine::objectCreate<TestBlock>("Block", source);
+    sizedBlock->m_value = 3;
+    file.m_files["TestResource"] = Bson::save(Engine::toVariant(source));
+    Engine::reloadResource("TestResource");
+    QCOMPARE(resource->getChildren().size(), 1);
+
+    ByteArray previous = file.m_files["TestResource"];
+    sizedBlock->m_value = 4;
+    file.m_files["TestResource"] = Bson::save(Engine::toVariant(source));
+    QCOMPARE(file.m_files["TestResource"].size(), previous.size());
+
+    Engine::reloadResource("TestResource");
+    block = dynamic_cast<TestBlock *>(resource->getChildren().front());
+    QCOMPARE(block != nullptr, true);
+    QCOMPARE(block->m_value, 4);
+
+    delete source;
+}
+
+} REGISTER(ResourceSystemTest)
+
+#include "tst_resourcesystem.moc"
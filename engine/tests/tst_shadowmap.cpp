@@ -0,0 +1,255 @@
+#include "tst_common.h"
+
+#include "components/world.h"
+#include "components/scene.h"
+#include "components/actor.h"
+#include "components/transform.h"
+#include "components/camera.h"
+#include "components/meshrender.h"
+#include "components/pointlight.h"
+
+#include "resources/material.h"
+#include "resources/mesh.h"
+#include "resources/texture.h"
+
+#include "systems/rendersystem.h"
+
+#include "pipelinecontext.h"
+#include "pipelinepass.h"
+#include "commandbuffer.h"
+#include "file.h"
+
+// The embedded resources are not available in tests
+class EmptyFile : public File {
+public:
+    _FILE *fopen(const char *path, const char *mode) override {
+        A_UNUSED(path);
+        A_UNUSED(mode);
+        return nullptr;
+    }
+};
+
+class ShadowBuffer : public CommandBuffer {
+    A_OVERRIDE(ShadowBuffer, CommandBuffer, System)
+
+public:
+    void drawMesh(const Matrix4 &model, Mesh *mesh, uint32_t sub, uint32_t layer, MaterialInstance *material) override {
+        A_UNUSED(model);
+        A_UNUSED(sub);
+        A_UNUSED(material);
+
+        if(layer == CommandBuffer::SHADOWCAST) {
+            casters[mesh]++;
+        } else if(layer == CommandBuffer::UI) {
+            copies++;
+        }
+    }
+
+    void reset() {
+        casters.clear();
+        copies = 0;
+    }
+
+    map<Mesh *, uint32_t> casters;
+
+    uint32_t copies = 0;
+};
+
+static Mesh *createCube() {
+    Mesh *mesh = Engine::objectCreate<Mesh>();
+    mesh->setVertices({Vector3(-0.5f,-0.5f,-0.5f), Vector3( 0.5f,-0.5f,-0.5f), Vector3( 0.5f, 0.5f,-0.5f), Vector3(-0.5f, 0.5f,-0.5f),
+                       Vector3(-0.5f,-0.5f, 0.5f), Vector3( 0.5f,-0.5f, 0.5f), Vector3( 0.5f, 0.5f, 0.5f), Vector3(-0.5f, 0.5f, 0.5f)});
+    mesh->setIndices({0, 1, 2, 0, 2, 3, 4, 5, 6, 4, 6, 7});
+    mesh->recalcBounds();
+    return mesh;
+}
+
+static MeshRender *createCaster(Scene *scene, Mesh *mesh, const Vector3 &position, bool isStatic) {
+    Actor *actor = Engine::composeActor("MeshRender", "Caster", scene);
+    actor->transform()->setPosition(position);
+    actor->setStatic(isStatic);
+
+    MeshRender *render = actor->component<MeshRender>();
+    render->setMesh(mesh);
+    return render;
+}
+
+// Runs the scene analysis and the shadow pass only, the rest of the pipeline doesn't matter here
+static void drawShadows(PipelineContext *context, ShadowBuffer *buffer) {
+    World *world = Engine::world();
+    Camera *camera = Camera::current();
+
+    buffer->reset();
+    context->analizeGraph(world);
+    context->setCurrentCamera(camera);
+    context->renderPasses().front()->draw(nullptr, context);
+}
+
+class ShadowMapTest : public QObject {
+    Q_OBJECT
+private slots:
+
+void Static_casters_cache() {
+    EmptyFile file;
+    Engine system(&file, "");
+    RenderSystem render;
+    ShadowBuffer::registerClassFactory(&render);
+    // Six cube faces don't fit into the default page size
+    Texture::setMaxTextureSize(4096);
+
+    Engine::setResource(Engine::objectCreate<Material>(), ".embedded/ShadowCopy.shader");
+
+    PipelineContext *context = Engine::objectCreate<PipelineContext>();
+    ShadowBuffer *buffer = dynamic_cast<ShadowBuffer *>(context->buffer());
+    QVERIFY(buffer != nullptr);
+
+    Scene *scene = Engine::world()->createScene("Scene");
+
+    Actor *view = Engine::composeActor("Camera", "Camera", scene);
+    Camera::setCurrent(view->component<Camera>());
+
+    Actor *actor = Engine::composeActor("PointLight", "Light", scene);
+    PointLight *light = actor->component<PointLight>();
+    light->setCastShadows(true);
+    light->setAttenuationRadius(10.0f);
+
+    Mesh *wall = createCube();
+    Mesh *box = createCube();
+    MeshRender *statics = createCaster(scene, wall, Vector3(0.0f, 0.0f,-3.0f), true);
+    MeshRender *dynamics = createCaster(scene, box, Vector3(0.0f, 0.0f,-2.0f), false);
+
+    // The first update has nothing to reuse, the static casters go straight to the shadow tiles
+    drawShadows(context, buffer);
+    uint32_t faces = buffer->casters[wall];
+    QVERIFY(faces > 0);
+    QVERIFY(buffer->casters[box] > 0);
+    QCOMPARE(buffer->copies, 0);
+
+    // Nothing has been changed, the static casters are rendered into the cache once
+    drawShadows(context, buffer);
+    QCOMPARE(buffer->casters[wall], faces);
+    QVERIFY(buffer->copies > 0);
+
+    // The cached depth is reused, only the dynamic casters are redrawn
+    drawShadows(context, buffer);
+    QCOMPARE(buffer->casters[wall], 0);
+    QVERIFY(buffer->casters[box] > 0);
+    uint32_t copies = buffer->copies;
+    QVERIFY(copies > 0);
+
+    // Moved static caster invalidates the cache
+    statics->actor()->transform()->setPosition(Vector3(0.0f, 0.0f,-4.0f));
+    drawShadows(context, buffer);
+    QCOMPARE(buffer->casters[wall], faces);
+    QVERIFY(buffer->copies < copies);
+
+    drawShadows(context, buffer);
+    QCOMPARE(buffer->casters[wall], faces);
+    QCOMPARE(buffer->copies, copies);
+
+    drawShadows(context, buffer);
+    QCOMPARE(buffer->casters[wall], 0);
+
+    // Without dynamic casters the shadow tiles stay untouched
+    dynamics->actor()->setEnabled(false);
+    drawShadows(context, buffer);
+    drawShadows(context, buffer);
+    QCOMPARE(buffer->casters[wall], 0);
+    QCOMPARE(buffer->copies, 0);
+
+    ShadowBuffer::unregisterClassFactory(&render);
+}
+
+void Moving_light() {
+    EmptyFile file;
+    Engine system(&file, "");
+    RenderSystem render;
+    ShadowBuffer::registerClassFactory(&render);
+    Texture::setMaxTextureSize(4096);
+
+    Engine::setResource(Engine::objectCreate<Material>(), ".embedded/ShadowCopy.shader");
+
+    PipelineContext *context = Engine::objectCreate<PipelineContext>();
+    ShadowBuffer *buffer = dynamic_cast<ShadowBuffer *>(context->buffer());
+    QVERIFY(buffer != nullptr);
+
+    Scene *scene = Engine::world()->createScene("Scene");
+
+    Actor *view = Engine::composeActor("Camera", "Camera", scene);
+    Camera::setCurrent(view->component<Camera>());
+
+    Actor *actor = Engine::composeActor("PointLight", "Light", scene);
+    PointLight *light = actor->component<PointLight>();
+    light->setCastShadows(true);
+    light->setAttenuationRadius(10.0f);
+
+    Mesh *wall = createCube();
+    createCaster(scene, wall, Vector3(0.0f, 0.0f,-3.0f), true);
+
+    drawShadows(context, buffer);
+    QVERIFY(buffer->casters[wall] > 0);
+
+    // The cache would never be reused, so the static casters are drawn directly without copying
+    uint32_t faces = 0;
+    for(int i = 1; i < 4; i++) {
+        actor->transform()->setPosition(Vector3(0.0f, 0.0f, 0.1f * i));
+        drawShadows(context, buffer);
+        if(i == 1) {
+            faces = buffer->casters[wall];
+            QVERIFY(faces > 0);
+        }
+        QCOMPARE(buffer->casters[wall], faces);
+        QCOMPARE(buffer->copies, 0);
+    }
+
+    ShadowBuffer::unregisterClassFactory(&render);
+}
+
+void Update_budget() {
+    EmptyFile file;
+    Engine system(&file, "");
+    RenderSystem render;
+    ShadowBuffer::registerClassFactory(&render);
+    Texture::setMaxTextureSize(4096);
+
+    PipelineContext *context = Engine::objectCreate<PipelineContext>();
+    ShadowBuffer *buffer = dynamic_cast<ShadowBuffer *>(context->buffer());
+    QVERIFY(buffer != nullptr);
+
+    Scene *scene = Engine::world()->createScene("Scene");
+
+    Actor *view = Engine::composeActor("Camera", "Camera", scene);
+    Camera::setCurrent(view->component<Camera>());
+
+    Actor *actor = Engine::composeActor("PointLight", "Light", scene);
+    PointLight *light = actor->component<PointLight>();
+    light->setCastShadows(true);
+    light->setAttenuationRadius(10.0f);
+
+    // The light source is inside of the dynamic caster, so it's visible from all six faces
+    Mesh *box = createCube();
+    MeshRender *dynamics = createCaster(scene, box, Vector3(), false);
+    dynamics->actor()->transform()->setScale(Vector3(4.0f));
+
+    Engine::setValue("graphics.shadowmap.budget", 2);
+
+    // Faces without valid content are rendered regardless of the budget
+    drawShadows(context, buffer);
+    QCOMPARE(buffer->casters[box], 6);
+
+    for(int i = 0; i < 3; i++) {
+        drawShadows(context, buffer);
+        QCOMPARE(buffer->casters[box], 2);
+    }
+
+    Engine::setValue("graphics.shadowmap.budget", 0);
+
+    drawShadows(context, buffer);
+    QCOMPARE(buffer->casters[box], 6);
+
+    ShadowBuffer::unregisterClassFactory(&render);
+}
+
+} REGISTER(ShadowMapTest)
+
+#include "tst_shadowmap.moc"
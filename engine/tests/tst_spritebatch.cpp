@@ -0,0 +1,154 @@
+#include "tst_common.h"
+
+#include "spritebatch.h"
+#include "commandbuffer.h"
+
+#include "resources/material.h"
+#include "resources/texture.h"
+#include "resources/mesh.h"
+
+class CountBuffer : public CommandBuffer {
+public:
+    void drawMesh(const Matrix4 &model, Mesh *mesh, uint32_t sub, uint32_t layer, MaterialInstance *material) override {
+        A_UNUSED(model);
+        A_UNUSED(sub);
+        A_UNUSED(layer);
+
+        meshes.push_back(mesh);
+        materials.push_back(material);
+    }
+
+    vector<Mesh *> meshes;
+
+    vector<MaterialInstance *> materials;
+};
+
+class SpriteBatchTest : public QObject {
+    Q_OBJECT
+private slots:
+
+void Material_instance_equal() {
+    Engine system(nullptr, "");
+
+    VariantMap data;
+    data["Uniforms"] = VariantList({VariantList({1.0f, 4, "uni.value"})});
+
+    Material material;
+    material.loadUserData(data);
+
+    MaterialInstance *first = material.createInstance();
+    MaterialInstance *second = material.createInstance();
+    QCOMPARE(first->isEqual(*second), true);
+
+    float value = 2.0f;
+    second->setFloat("uni.value", &value);
+    QCOMPARE(first->isEqual(*second), false);
+    first->setFloat("uni.value", &value);
+    QCOMPARE(first->isEqual(*second), true);
+
+    Texture *texture = Engine::objectCreate<Texture>();
+    first->setTexture("mainTexture", texture);
+    QCOMPARE(first->isEqual(*second), false);
+    second->setTexture("mainTexture", texture);
+    QCOMPARE(first->isEqual(*second), true);
+
+    Material other;
+    other.loadUserData(data);
+    MaterialInstance *third = other.createInstance();
+    third->setFloat("uni.value", &value);
+    third->setTexture("mainTexture", texture);
+    QCOMPARE(first->isEqual(*third), false);
+
+    delete first;
+    delete second;
+    delete third;
+}
+
+void Merge_interleaved_materials() {
+    Engine system(nullptr, "");
+
+    Material material;
+    material.setBlendMode(Material::Opaque);
+
+    MaterialInstance *first = material.createInstance();
+    MaterialInstance *second = material.createInstance();
+    second->setTexture("mainTexture", Engine::objectCreate<Texture>());
+
+    Mesh quad;
+    quad.setVertices({Vector3(-0.1f,-0.1f, 0.0f), Vector3(-0.1f, 0.1f, 0.0f), Vector3(0.1f, 0.1f, 0.0f), Vector3(0.1f,-0.1f, 0.0f)});
+    quad.setIndices({0, 1, 2, 0, 2, 3});
+
+    CountBuffer buffer;
+    SpriteBatch batch;
+
+    // The depth test keeps the opaque result independent from the order
+    batch.begin(&buffer, CommandBuffer::DEFAULT);
+    for(int i = 0; i < 4; i++) {
+        batch.add(&quad, Matrix4(), (i % 2) ? second : first);
+    }
+    batch.flush();
+
+    QCOMPARE(buffer.meshes.size(), 2);
+    QCOMPARE(buffer.materials[0], first);
+    QCOMPARE(buffer.materials[1], second);
+    QCOMPARE(buffer.meshes[0]->vertices().size(), 8);
+    QCOMPARE(buffer.meshes[0]->indices().size(), 12);
+    QCOMPARE(buffer.meshes[0]->indices()[6], 4);
+
+    delete first;
+    delete second;
+}
+
+void Keep_translucent_order() {
+    Engine system(nullptr, "");
+
+    Material material;
+    material.setBlendMode(Material::Translucent);
+
+    MaterialInstance *first = material.createInstance();
+    MaterialInstance *second = material.createInstance();
+    second->setTexture("mainTexture", Engine::objectCreate<Texture>());
+
+    Mesh quad;
+    quad.setVertices({Vector3(-0.1f,-0.1f, 0.0f), Vector3(-0.1f, 0.1f, 0.0f), Vector3(0.1f, 0.1f, 0.0f), Vector3(0.1f,-0.1f, 0.0f)});
+    quad.setIndices({0, 1, 2, 0, 2, 3});
+
+    Matrix4 left;
+    left.translate(Vector3(-0.5f, 0.0f, 0.0f));
+    Matrix4 right;
+    right.translate(Vector3(0.5f, 0.0f, 0.0f));
+
+    CountBuffer buffer;
+    SpriteBatch batch;
+
+    // The second sprite is drawn over the first ones, so the third one can't join the first batch
+    batch.begin(&buffer, CommandBuffer::TRANSLUCENT);
+    batch.add(&quad, left, first);
+    batch.add(&quad, left, second);
+    batch.add(&quad, left, first);
+    batch.flush();
+
+    QCOMPARE(buffer.meshes.size(), 3);
+    QCOMPARE(buffer.materials[2], first);
+
+    // Sprites which don't overlap on the screen can be reordered
+    buffer.meshes.clear();
+    buffer.materials.clear();
+
+    batch.begin(&buffer, CommandBuffer::TRANSLUCENT);
+    batch.add(&quad, left, first);
+    batch.add(&quad, right, second);
+    batch.add(&quad, left, first);
+    batch.flush();
+
+    QCOMPARE(buffer.meshes.size(), 2);
+    QCOMPARE(buffer.materials[0], first);
+    QCOMPARE(buffer.meshes[0]->vertices().size(), 8);
+
+    delete first;
+    delete second;
+}
+
+} REGISTER(SpriteBatchTest)
+
+#include "tst_spritebatch.moc"
@@ -0,0 +1,56 @@
+#include "tst_common.h"
+
+#include "timer.h"
+
+class TimerTest : public QObject {
+    Q_OBJECT
+private slots:
+
+void Fixed_steps() {
+    Timer::reset();
+    Timer::setFixedDeltaTime(1.0f / 64.0f); // 15625000 ns
+    Timer::setMaxFixedSteps(5);
+
+    Timer::advance(39062500);
+    QCOMPARE(Timer::fixedSteps(), 2);
+    QCOMPARE(Timer::interpolation(), 0.5f);
+
+    Timer::advance(7812500);
+    QCOMPARE(Timer::fixedSteps(), 1);
+    QCOMPARE(Timer::interpolation(), 0.0f);
+
+    Timer::advance(3906250);
+    QCOMPARE(Timer::fixedSteps(), 0);
+    QCOMPARE(Timer::interpolation(), 0.25f);
+
+    // The excess steps after a spike are dropped
+    Timer::advance(156250000);
+    QCOMPARE(Timer::fixedSteps(), 5);
+    QCOMPARE(Timer::interpolation(), 0.25f);
+
+    Timer::setFixedDeltaTime(1.0f / 60.0f);
+    Timer::reset();
+}
+
+void Time_accumulation() {
+    Timer::reset();
+
+    // One hour of 60 FPS frames must not lose any nanosecond
+    const uint64_t frame = 16666667;
+    const uint64_t frames = 216000;
+    for(uint64_t i = 0; i < frames; i++) {
+        Timer::advance(frame);
+    }
+    QCOMPARE(Timer::preciseTime(), (frame * frames) / 1000000000.0);
+    QCOMPARE(Timer::deltaTime(), static_cast<float>(frame / 1000000000.0));
+
+    Timer::setScale(0.5f);
+    Timer::advance(20000000);
+    QCOMPARE(Timer::deltaTime(), 0.01f);
+
+    Timer::reset();
+}
+
+} REGISTER(TimerTest)
+
+#include "tst_timer.moc"
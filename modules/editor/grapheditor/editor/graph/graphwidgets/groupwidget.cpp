@@ -57,7 +57,7 @@ void GroupWidget::update() {
     if(m_title) {
         bool hover = m_title->rectTransform()->isHovered(cursor.x, cursor.y);
         if(hover && Input::isMouseButtonDown(0)) {
-            emitSignal(_SIGNAL(pressed()));
+            emitSignal(_SIGNAL_ID(NodeWidget, pressed()));
         } else {
             RectTransform *r = rectTransform();
             Vector3 pos = r->worldPosition();
@@ -177,7 +177,7 @@ void NodeWidget::update() {
     if(m_title) {
         bool hover = m_title->rectTransform()->isHovered(pos.x, pos.y);
         if(hover && Input::isMouseButtonDown(0)) {
-            emitSignal(_SIGNAL(pressed()));
+            emitSignal(_SIGNAL_ID(NodeWidget, pressed()));
         } else {
             if(m_node && m_node->isState()) { // For state machine
                 bool hover = rectTransform()->isHovered(pos.x, pos.y);
@@ -199,10 +199,10 @@ void NodeWidget::update() {
 
                 if(m_hovered) {
                     if(Input::isMouseButtonDown(Input::MOUSE_LEFT)) {
-                        emitSignal(_SIGNAL(portPressed(int)), -1);
+                        emitSignal(_SIGNAL_ID(NodeWidget, portPressed(int)), -1);
                     }
                     if(Input::isMouseButtonUp(Input::MOUSE_LEFT)) {
-                        emitSignal(_SIGNAL(portReleased(int)), -1);
+                        emitSignal(_SIGNAL_ID(NodeWidget, portReleased(int)), -1);
                     }
                 }
             }
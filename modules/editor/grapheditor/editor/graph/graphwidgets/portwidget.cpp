@@ -108,10 +108,10 @@ void PortWidget::update() {
 
         if(m_hovered) {
             if(Input::isMouseButtonDown(Input::MOUSE_LEFT)) {
-                emitSignal(_SIGNAL(pressed(int)), m_port->m_node->portPosition(m_port));
+                emitSignal(_SIGNAL_ID(PortWidget, pressed(int)), m_port->m_node->portPosition(m_port));
             }
             if(Input::isMouseButtonUp(Input::MOUSE_LEFT)) {
-                emitSignal(_SIGNAL(released(int)), m_port->m_node->portPosition(m_port));
+                emitSignal(_SIGNAL_ID(PortWidget, released(int)), m_port->m_node->portPosition(m_port));
             }
         }
     }
@@ -13,6 +13,7 @@
 
 #include <resources/mesh.h>
 #include <resources/material.h>
+#include <resources/computeshader.h>
 
 #include <commandbuffer.h>
 
@@ -34,6 +35,7 @@ namespace  {
 
     const char *gTexture2D("texture2d");
     const char *gTextureCubemap("samplercube");
+    const char *gBuffer("buffer");
 };
 
 ShaderBuilderSettings::ShaderBuilderSettings() {
@@ -76,14 +78,9 @@ ShaderBuilderSettings::Rhi ShaderBuilder::currentRhi() {
         {"RenderDX", ShaderBuilderSettings::Rhi::DirectX},
     };
 
-    static ShaderBuilderSettings::Rhi rhi = ShaderBuilderSettings::Rhi::Invalid;
-    if(rhi == ShaderBuilderSettings::Rhi::Invalid) {
-        if(qEnvironmentVariableIsSet(qPrintable(gRhi))) {
-            rhi = rhiMap.value(qEnvironmentVariable(qPrintable(gRhi)));
-        } else {
-            rhi = ShaderBuilderSettings::Rhi::OpenGL;
-        }
-    }
+    // Initialized once, the shaders are converted on the import threads
+    static const ShaderBuilderSettings::Rhi rhi = qEnvironmentVariableIsSet(qPrintable(gRhi)) ?
+        rhiMap.value(qEnvironmentVariable(qPrintable(gRhi))) : ShaderBuilderSettings::Rhi::OpenGL;
 
     return rhi;
 }
@@ -119,6 +116,8 @@ AssetConverter::ReturnCode ShaderBuilder::convertFile(AssetConverterSettings *se
 
     ShaderBuilderSettings *builderSettings = static_cast<ShaderBuilderSettings *>(settings);
 
+    QStringList includes;
+
     QFileInfo info(builderSettings->source());
     if(info.suffix() == "mtl") {
         ShaderNodeGraph nodeGraph;
@@ -127,30 +126,32 @@ AssetConverter::ReturnCode ShaderBuilder::convertFile(AssetConverterSettings *se
             if(builderSettings->currentVersion() != builderSettings->version()) {
                 nodeGraph.save(builderSettings->source());
             }
-            data = nodeGraph.data();
+            data = nodeGraph.data(false, nullptr, &includes);
         }
     } else if(info.suffix() == "shader") {
-        parseShaderFormat(builderSettings->source(), data);
+        parseShaderFormat(builderSettings->source(), data, false, &includes);
     } else if(info.suffix() == "compute") {
-        parseShaderFormat(builderSettings->source(), data, true);
+        parseShaderFormat(builderSettings->source(), data, true, &includes);
+    }
+
+    for(auto &it : includes) {
+        builderSettings->addDependency(it);
     }
 
     if(data.empty()) {
         return InternalError;
     }
 
-    uint32_t version = 430;
-    bool es = false;
+    bool compute = (info.suffix() == "compute");
 
     ShaderBuilderSettings::Rhi rhi = currentRhi();
 
-    if(ProjectManager::instance()->currentPlatformName() != "desktop") {
-        version = 300;
-        es = true;
+    SpirVConverter::Inputs inputs;
+    if(compute) {
+        data[SHADER] = compile(rhi, data[SHADER].toString(), inputs, EShLangCompute);
+        return saveResource(builderSettings, ComputeShader::metaClass()->name(), data);
     }
-    SpirVConverter::setGlslVersion(version, es);
 
-    SpirVConverter::Inputs inputs;
     data[SHADER] = compile(rhi, data[SHADER].toString(), inputs, EShLangFragment);
     {
         auto it = data.find(SIMPLE);
@@ -190,14 +191,18 @@ AssetConverter::ReturnCode ShaderBuilder::convertFile(AssetConverterSettings *se
         }
     }
 
+    return saveResource(builderSettings, Material::metaClass()->name(), data);
+}
+
+AssetConverter::ReturnCode ShaderBuilder::saveResource(ShaderBuilderSettings *settings, const char *type, const VariantMap &data) const {
     VariantList result;
 
     VariantList object;
 
-    object.push_back(Material::metaClass()->name()); // type
+    object.push_back(type); // type
     object.push_back(0); // id
     object.push_back(0); // parent
-    object.push_back(builderSettings->destination().toStdString()); // name
+    object.push_back(settings->destination().toStdString()); // name
 
     object.push_back(VariantMap()); // properties
 
@@ -206,13 +211,13 @@ AssetConverter::ReturnCode ShaderBuilder::convertFile(AssetConverterSettings *se
 
     result.push_back(object);
 
-    QFile file(builderSettings->absoluteDestination());
+    QFile file(settings->absoluteDestination());
     if(file.open(QIODevice::WriteOnly)) {
         ByteArray data = Bson::save(result);
         file.write(reinterpret_cast<const char *>(&data[0]), data.size());
         file.close();
-        builderSettings->setCurrentVersion(builderSettings->version());
-        builderSettings->setRhi(rhi);
+        settings->setCurrentVersion(settings->version());
+        settings->setRhi(currentRhi());
         return Success;
     }
 
@@ -226,7 +231,10 @@ Variant ShaderBuilder::compile(ShaderBuilderSettings::Rhi rhi, const string &buf
     vector<uint32_t> spv = SpirVConverter::glslToSpv(buff, static_cast<EShLanguage>(stage), inputs);
     if(!spv.empty()) {
         switch(rhi) {
-            case ShaderBuilderSettings::Rhi::OpenGL: data = SpirVConverter::spvToGlsl(spv); break;
+            case ShaderBuilderSettings::Rhi::OpenGL: {
+                bool es = (ProjectManager::instance()->currentPlatformName() != "desktop");
+                data = SpirVConverter::spvToGlsl(spv, es ? 300 : 430, es);
+            } break;
             case ShaderBuilderSettings::Rhi::Metal: data = SpirVConverter::spvToMetal(spv); break;
             case ShaderBuilderSettings::Rhi::DirectX: data = SpirVConverter::spvToHlsl(spv); break;
             default: {
@@ -241,7 +249,7 @@ Variant ShaderBuilder::compile(ShaderBuilderSettings::Rhi rhi, const string &buf
     return data;
 }
 
-bool ShaderBuilder::parseShaderFormat(const QString &path, VariantMap &user, bool compute) {
+bool ShaderBuilder::parseShaderFormat(const QString &path, VariantMap &user, bool compute, QStringList *includes) {
     QFile file(path);
     if(file.open(QIODevice::ReadOnly | QIODevice::Text)) {
         QDomDocument doc;
@@ -276,7 +284,7 @@ bool ShaderBuilder::parseShaderFormat(const QString &path, VariantMap &user, boo
             if(compute) {
                 QString str = shaders.value(gCompute);
                 if(!str.isEmpty()) {
-                    user[SHADER] = loadShader(str, define, pragmas).toStdString();
+                    user[SHADER] = loadShader(str, define, pragmas, includes).toStdString();
                 }
             } else {
                 if(materialType == Material::PostProcess) {
@@ -286,16 +294,16 @@ bool ShaderBuilder::parseShaderFormat(const QString &path, VariantMap &user, boo
                 QString str;
                 str = shaders.value(gFragment);
                 if(!str.isEmpty()) {
-                    user[SHADER] = loadShader(str, define, pragmas).toStdString();
+                    user[SHADER] = loadShader(str, define, pragmas, includes).toStdString();
                 } else {
-                    user[SHADER] = loadIncludes("Default.frag", define, pragmas).toStdString();
+                    user[SHADER] = loadIncludes("Default.frag", define, pragmas, includes).toStdString();
                 }
 
                 str = shaders.value(gVertex);
                 if(!str.isEmpty()) {
-                    user[STATIC] = loadShader(shaders.value(gVertex), define, pragmas).toStdString();
+                    user[STATIC] = loadShader(shaders.value(gVertex), define, pragmas, includes).toStdString();
                 } else {
-                    user[STATIC] = loadIncludes("Default.vert", define, pragmas).toStdString();
+                    user[STATIC] = loadIncludes("Default.vert", define, pragmas, includes).toStdString();
                 }
             }
         }
@@ -308,6 +316,7 @@ bool ShaderBuilder::parseShaderFormat(const QString &path, VariantMap &user, boo
 bool ShaderBuilder::parseProperties(const QDomElement &element, VariantMap &user) {
     int binding = UNIFORM_BIND;
     VariantList textures;
+    VariantList buffers;
     VariantList uniforms;
 
     QDomNode p = element.firstChild();
@@ -345,6 +354,14 @@ bool ShaderBuilder::parseProperties(const QDomElement &element, VariantMap &user
                 texture.push_back(flags); // flags
 
                 textures.push_back(texture);
+            } else if(type.toLower() == gBuffer) { // Storage buffer
+                VariantList buffer;
+                buffer.push_back(property.attribute("path").toStdString()); // path
+                buffer.push_back(property.attribute("binding").toInt()); // binding
+                buffer.push_back(name.toStdString()); // name
+                buffer.push_back(0); // flags
+
+                buffers.push_back(buffer);
             } else { // Uniform
                 VariantList data;
 
@@ -385,6 +402,7 @@ bool ShaderBuilder::parseProperties(const QDomElement &element, VariantMap &user
     }
 
     user[TEXTURES] = textures;
+    user[BUFFERS] = buffers;
     user[UNIFORMS] = uniforms;
 
     return true;
@@ -427,7 +445,7 @@ bool ShaderBuilder::parsePass(const QDomElement &element, int &materialType, Var
     return true;
 }
 
-QString ShaderBuilder::loadIncludes(const QString &path, const QString &define, const PragmaMap &pragmas) {
+QString ShaderBuilder::loadIncludes(const QString &path, const QString &define, const PragmaMap &pragmas, QStringList *includes) {
     QStringList paths;
     paths << ProjectManager::instance()->contentPath() + "/";
     paths << ":/shaders/";
@@ -437,7 +455,11 @@ QString ShaderBuilder::loadIncludes(const QString &path, const QString &define,
     foreach(QString it, paths) {
         QFile file(it + path);
         if(file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            QString result = loadShader(file.readAll(), define, pragmas);
+            // Built-in shaders are the part of the converter build
+            if(includes && !it.startsWith(":")) {
+                includes->push_back(QFileInfo(file).absoluteFilePath());
+            }
+            QString result = loadShader(file.readAll(), define, pragmas, includes);
             file.close();
             return result;
         }
@@ -446,7 +468,7 @@ QString ShaderBuilder::loadIncludes(const QString &path, const QString &define,
     return QString();
 }
 
-QString ShaderBuilder::loadShader(const QString &data, const QString &define, const PragmaMap &pragmas) {
+QString ShaderBuilder::loadShader(const QString &data, const QString &define, const PragmaMap &pragmas, QStringList *includes) {
     QString output;
     QStringList lines(data.split("\n"));
 
@@ -458,7 +480,7 @@ QString ShaderBuilder::loadShader(const QString &data, const QString &define, co
         string data = line.simplified().toStdString();
         if(regex_match(data, matches, include)) {
             string next(matches[1]);
-            output += loadIncludes(next.c_str(), define, pragmas) + "\n";
+            output += loadIncludes(next.c_str(), define, pragmas, includes) + "\n";
         } else if(regex_match(data, matches, pragma)) {
             if(matches[1] == "flags") {
                 output += define + "\n";
@@ -25,6 +25,7 @@
 #define DEPTHWRITE "DepthWrite"
 #define WIREFRAME  "Wireframe"
 #define TEXTURES   "Textures"
+#define BUFFERS    "Buffers"
 #define UNIFORMS   "Uniforms"
 #define PROPERTIES "Properties"
 
@@ -62,7 +63,7 @@ class ShaderBuilder : public AssetConverter {
 public:
     ShaderBuilder();
 
-    static QString loadIncludes(const QString &path, const QString &define, const PragmaMap &pragmas);
+    static QString loadIncludes(const QString &path, const QString &define, const PragmaMap &pragmas, QStringList *includes = nullptr);
 
     static ShaderBuilderSettings::Rhi currentRhi();
 
@@ -72,18 +73,22 @@ private:
     QStringList suffixes() const Q_DECL_OVERRIDE;
     ReturnCode convertFile(AssetConverterSettings *) Q_DECL_OVERRIDE;
 
+    bool isThreadSafe() const Q_DECL_OVERRIDE { return true; }
+
+    ReturnCode saveResource(ShaderBuilderSettings *settings, const char *type, const VariantMap &data) const;
+
     AssetConverterSettings *createSettings() const Q_DECL_OVERRIDE;
 
     Actor *createActor(const AssetConverterSettings *settings, const QString &guid) const Q_DECL_OVERRIDE;
 
     Variant compile(ShaderBuilderSettings::Rhi rhi, const string &buff, SpirVConverter::Inputs &inputs, int stage) const;
 
-    bool parseShaderFormat(const QString &path, VariantMap &data, bool compute = false);
+    bool parseShaderFormat(const QString &path, VariantMap &data, bool compute = false, QStringList *includes = nullptr);
 
     bool parseProperties(const QDomElement &element, VariantMap &user);
     bool parsePass(const QDomElement &element, int &materialType, VariantMap &user);
 
-    static QString loadShader(const QString &data, const QString &define, const PragmaMap &pragmas);
+    static QString loadShader(const QString &data, const QString &define, const PragmaMap &pragmas, QStringList *includes = nullptr);
 
 private:
     typedef QMap<QString, ShaderBuilderSettings::Rhi> RhiMap;
@@ -508,7 +508,7 @@ bool ShaderNodeGraph::buildGraph(GraphNode *node) {
     return true;
 }
 
-VariantMap ShaderNodeGraph::data(bool editor, ShaderRootNode *root) const {
+VariantMap ShaderNodeGraph::data(bool editor, ShaderRootNode *root, QStringList *includes) const {
     if(root == nullptr) {
         root = static_cast<ShaderRootNode *>(m_rootNode);
     }
@@ -614,14 +614,14 @@ VariantMap ShaderNodeGraph::data(bool editor, ShaderRootNode *root) const {
 
     QString fragment = "Shader.frag";
     {
-        Variant data = ShaderBuilder::loadIncludes(fragment, define, m_pragmas).toStdString();
+        Variant data = ShaderBuilder::loadIncludes(fragment, define, m_pragmas, includes).toStdString();
         if(data.isValid()) {
             user[SHADER] = data;
         }
     }
     if(root->materialType() == ShaderRootNode::Surface && !editor) {
         define += "\n#define SIMPLE 1";
-        Variant data = ShaderBuilder::loadIncludes(fragment, define, m_pragmas).toStdString();
+        Variant data = ShaderBuilder::loadIncludes(fragment, define, m_pragmas, includes).toStdString();
         if(data.isValid()) {
             user[SIMPLE] = data;
         }
@@ -636,7 +636,7 @@ VariantMap ShaderNodeGraph::data(bool editor, ShaderRootNode *root) const {
             localDefine += "\n#define TYPE_STATIC";
         }
 
-        Variant data = ShaderBuilder::loadIncludes(vertex, localDefine, m_pragmas).toStdString();
+        Variant data = ShaderBuilder::loadIncludes(vertex, localDefine, m_pragmas, includes).toStdString();
         if(data.isValid()) {
             user[STATIC] = data;
         }
@@ -644,21 +644,21 @@ VariantMap ShaderNodeGraph::data(bool editor, ShaderRootNode *root) const {
     if(root->materialType() == ShaderRootNode::Surface && !editor) {
         {
             QString localDefine = define + "\n#define INSTANCING";
-            Variant data = ShaderBuilder::loadIncludes(vertex, localDefine, m_pragmas).toStdString();
+            Variant data = ShaderBuilder::loadIncludes(vertex, localDefine, m_pragmas, includes).toStdString();
             if(data.isValid()) {
                 user[INSTANCED] = data;
             }
         }
         {
             QString localDefine = define + "\n#define TYPE_BILLBOARD";
-            Variant data = ShaderBuilder::loadIncludes(vertex, localDefine, m_pragmas).toStdString();
+            Variant data = ShaderBuilder::loadIncludes(vertex, localDefine, m_pragmas, includes).toStdString();
             if(data.isValid()) {
                 user[PARTICLE] = data;
             }
         }
         {
             QString localDefine = define + "\n#define TYPE_SKINNED";
-            Variant data = ShaderBuilder::loadIncludes(vertex, localDefine, m_pragmas).toStdString();
+            Variant data = ShaderBuilder::loadIncludes(vertex, localDefine, m_pragmas, includes).toStdString();
             if(data.isValid()) {
                 user[SKINNED] = data;
             }
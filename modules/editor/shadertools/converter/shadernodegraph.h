@@ -122,7 +122,7 @@ public:
     ShaderNodeGraph();
     ~ShaderNodeGraph() Q_DECL_OVERRIDE;
 
-    VariantMap data(bool editor = false, ShaderRootNode *root = nullptr) const;
+    VariantMap data(bool editor = false, ShaderRootNode *root = nullptr, QStringList *includes = nullptr) const;
 
     bool buildGraph(GraphNode *node = nullptr);
 
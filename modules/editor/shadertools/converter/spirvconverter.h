@@ -11,8 +11,6 @@
 #include <spirv_msl.hpp>
 #include <spirv_hlsl.hpp>
 
-static spirv_cross::CompilerGLSL::Options options;
-
 const TBuiltInResource DefaultResource = {
         /* .MaxLights = */ 32,
         /* .MaxClipPlanes = */ 6,
@@ -133,7 +131,9 @@ public:
     typedef vector<Input> Inputs;
 
     static vector<uint32_t> glslToSpv(const string &buff, EShLanguage stage, Inputs &inputs) {
-        ShInitialize();
+        // The process wide state of the glslang must be initialized once, shaders are compiled from several import threads
+        static const int initialized = ShInitialize();
+        A_UNUSED(initialized);
 
         glslang::TProgram program;
 
@@ -201,14 +201,13 @@ public:
         return vector<uint32_t>();
     }
 
-    static void setGlslVersion(uint32_t version, bool es) {
+    static string spvToGlsl(vector<uint32_t> spv, uint32_t version, bool es) {
+        spirv_cross::CompilerGLSL glsl(spv);
+
+        spirv_cross::CompilerGLSL::Options options;
         options.version = version;
         options.es = es;
         options.separate_shader_objects = false;
-    }
-
-    static string spvToGlsl(vector<uint32_t> spv) {
-        spirv_cross::CompilerGLSL glsl(spv);
         glsl.set_common_options(options);
 
         return glsl.compile();
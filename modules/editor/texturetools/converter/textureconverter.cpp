@@ -196,36 +196,63 @@ void TextureImportSettings::setSubItemData(const QString &name, const QJsonObjec
     m_Elements[name].m_Pivot = pivot;
 }
 
-AssetConverter::ReturnCode TextureConverter::convertFile(AssetConverterSettings *settings) {
-    Resource *resource = nullptr;
-
+AssetConverter::ReturnCode TextureConverter::prepareFile(AssetConverterSettings *settings) {
     TextureImportSettings *s = dynamic_cast<TextureImportSettings *>(settings);
     if(s) {
+        // Decoding and mipmapping run on the import thread, the texture isn't registered in the engine
+        Texture *texture = new Texture;
+        convertTexture(s, texture);
+
         if(s->textureType() == TextureImportSettings::TextureType::Sprite) {
-            Sprite *sprite = Engine::objectCreate<Sprite>();
-            convertSprite(s, sprite);
-            resource = sprite;
+            QMutexLocker locker(&m_lock);
+            m_textures[settings] = texture;
         } else {
-            Texture *texture = Engine::objectCreate<Texture>();
-            convertTexture(s, texture);
-            resource = texture;
+            saveResource(settings, texture);
+            delete texture;
         }
+    }
 
-        QFile file(settings->absoluteDestination());
-        if(file.open(QIODevice::WriteOnly)) {
-            ByteArray data = Bson::save( Engine::toVariant(resource) );
-            file.write((const char *)&data[0], data.size());
-            file.close();
+    return Success;
+}
+
+AssetConverter::ReturnCode TextureConverter::convertFile(AssetConverterSettings *settings) {
+    TextureImportSettings *s = dynamic_cast<TextureImportSettings *>(settings);
+    if(s && s->textureType() == TextureImportSettings::TextureType::Sprite) {
+        Texture *texture = nullptr;
+        {
+            QMutexLocker locker(&m_lock);
+            texture = m_textures.take(settings);
+        }
+        if(texture == nullptr) {
+            texture = new Texture;
+            convertTexture(s, texture);
         }
 
-        Engine::unloadResource(resource);
+        // Sprite meshes are created through the engine, so only the sprite is assembled on the main thread
+        Sprite *sprite = Engine::objectCreate<Sprite>();
+        sprite->setTexture(texture);
+        convertSprite(s, sprite);
 
-        settings->setCurrentVersion(settings->version());
+        saveResource(settings, sprite);
+
+        Engine::unloadResource(texture);
+        Engine::unloadResource(sprite);
     }
 
     return Success;
 }
 
+void TextureConverter::saveResource(AssetConverterSettings *settings, Resource *resource) const {
+    QFile file(settings->absoluteDestination());
+    if(file.open(QIODevice::WriteOnly)) {
+        ByteArray data = Bson::save( Engine::toVariant(resource) );
+        file.write((const char *)&data[0], data.size());
+        file.close();
+    }
+
+    settings->setCurrentVersion(settings->version());
+}
+
 void TextureConverter::convertTexture(TextureImportSettings *settings, Texture *texture) {
     uint8_t channels = 4;
     QImage src(settings->source());
@@ -330,8 +357,6 @@ void TextureConverter::convertTexture(TextureImportSettings *settings, Texture *
 }
 
 void TextureConverter::convertSprite(TextureImportSettings *settings, Sprite *sprite) {
-    convertTexture(settings, sprite->texture());
-
     float width = sprite->texture()->width();
     float height = sprite->texture()->height();
 
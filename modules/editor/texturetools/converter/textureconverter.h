@@ -7,6 +7,8 @@
 #include <editor/assetconverter.h>
 
 #include <QRect>
+#include <QMutex>
+#include <QHash>
 
 class QImage;
 
@@ -107,11 +109,19 @@ public:
 
 private:
     QStringList suffixes() const Q_DECL_OVERRIDE { return {"bmp", "dds", "jpg", "jpeg", "png", "tga", "ico", "tif"}; }
+    ReturnCode prepareFile(AssetConverterSettings *settings) Q_DECL_OVERRIDE;
     ReturnCode convertFile(AssetConverterSettings *settings) Q_DECL_OVERRIDE;
 
+    void saveResource(AssetConverterSettings *settings, Resource *resource) const;
+
     AssetConverterSettings *createSettings() const Q_DECL_OVERRIDE;
 
     Actor *createActor(const AssetConverterSettings *settings, const QString &guid) const Q_DECL_OVERRIDE;
+
+private:
+    QHash<AssetConverterSettings *, Texture *> m_textures;
+
+    QMutex m_lock;
 };
 
 #endif // TEXTURECONVERTER_H
@@ -0,0 +1,34 @@
+#ifndef BULLETQUERY_H
+#define BULLETQUERY_H
+
+#include <object.h>
+
+#include <querybatch.h>
+
+class btCollisionWorld;
+
+class BulletQueryTask : public Object {
+public:
+    BulletQueryTask(btCollisionWorld *world, QueryBatch *batch, uint32_t begin, uint32_t end);
+
+    void processEvents() override;
+
+    static bool rayTest(btCollisionWorld *world, const Vector3 &origin, const Vector3 &direction, float distance, Ray::Hit *hit);
+
+protected:
+    static bool sweepTest(btCollisionWorld *world, const QueryBatch::Query &query, Ray::Hit *hit);
+
+    static bool overlapTest(btCollisionWorld *world, const QueryBatch::Query &query, vector<Object *> &objects);
+
+protected:
+    btCollisionWorld *m_world;
+
+    QueryBatch *m_batch;
+
+    uint32_t m_begin;
+
+    uint32_t m_end;
+
+};
+
+#endif // BULLETQUERY_H
@@ -3,28 +3,50 @@
 
 #include <system.h>
 
+#include <mutex>
+
 class Engine;
 
 class btDefaultCollisionConfiguration;
 class btCollisionDispatcher;
 class btBroadphaseInterface;
-class btSequentialImpulseConstraintSolver;
+class btConstraintSolver;
+class btConstraintSolverPoolMt;
 class btDynamicsWorld;
 
+class BulletTaskScheduler;
+class Collider;
+class QueryBatch;
+class ThreadPool;
+class Transform;
+
 class BulletSystem : public System {
 public:
     BulletSystem(Engine *engine);
     ~BulletSystem() override;
 
-    bool init() override { return true; }
+    bool init() override;
 
     void update(World *world) override;
 
+    void fixedUpdate(World *world) override;
+
     int threadPolicy() const override;
 
+    unique_lock<recursive_mutex> waitQueries();
+
 private:
+    class ContactsBody;
+
     static bool rayCast(System *system, World *world, const Ray &ray, float distance, Ray::Hit *hit);
 
+    static bool queryBatch(System *system, World *world, QueryBatch *batch);
+
+protected:
+    void addObject(Object *object) override;
+
+    void removeObject(Object *object) override;
+
 protected:
     unordered_map<uint32_t, btDynamicsWorld *> m_worlds;
 
@@ -34,7 +56,27 @@ protected:
 
     btBroadphaseInterface *m_overlappingPairCache;
 
-    btSequentialImpulseConstraintSolver *m_solver;
+    btConstraintSolver *m_solver;
+
+    btConstraintSolverPoolMt *m_solverPool;
+
+    BulletTaskScheduler *m_scheduler;
+
+    vector<Collider *> m_detached;
+
+    vector<Collider *> m_updates;
+
+    vector<Collider *> m_touching;
+
+    vector<Collider *> m_contacts;
+
+    vector<Transform *> m_changes;
+
+    ThreadPool *m_queryPool;
+
+    vector<Object *> m_queryTasks;
+
+    recursive_mutex m_queryMutex;
 
 };
 
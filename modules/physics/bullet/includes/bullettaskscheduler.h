@@ -0,0 +1,54 @@
+#ifndef BULLETTASKSCHEDULER_H
+#define BULLETTASKSCHEDULER_H
+
+#include <atomic>
+#include <vector>
+
+#include <LinearMath/btThreads.h>
+
+#include <threadpool.h>
+
+class BulletTask;
+
+class BulletTaskScheduler : public btITaskScheduler {
+public:
+    explicit BulletTaskScheduler(int threads);
+    ~BulletTaskScheduler() override;
+
+    int getMaxNumThreads() const override;
+
+    int getNumThreads() const override;
+
+    void setNumThreads(int threads) override;
+
+    void parallelFor(int begin, int end, int grainSize, const btIParallelForBody &body) override;
+
+    btScalar parallelSum(int begin, int end, int grainSize, const btIParallelSumBody &body) override;
+
+protected:
+    btScalar dispatch(int begin, int end, int grainSize, const btIParallelForBody *forBody, const btIParallelSumBody *sumBody);
+
+protected:
+    friend class BulletTask;
+
+    ThreadPool m_pool;
+
+    std::vector<BulletTask *> m_tasks;
+
+    const btIParallelForBody *m_forBody;
+
+    const btIParallelSumBody *m_sumBody;
+
+    std::atomic<int> m_next;
+
+    int m_end;
+
+    int m_grainSize;
+
+    int m_threads;
+
+    std::atomic<bool> m_busy;
+
+};
+
+#endif // BULLETTASKSCHEDULER_H
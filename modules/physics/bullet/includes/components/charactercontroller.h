@@ -58,6 +58,10 @@ private:
 
     void update() override;
 
+    bool isUpdatable() const override;
+
+    void syncTransform() override;
+
     void destroyCharacter();
 
     void drawGizmosSelected() override;
@@ -4,9 +4,12 @@
 #include "component.h"
 #include "bullet.h"
 
+#include <mutex>
+
 class btCollisionShape;
 class btCollisionObject;
 class btDynamicsWorld;
+class btTransform;
 
 class RigidBody;
 
@@ -26,6 +29,8 @@ public:
 
     virtual void update();
 
+    virtual bool isUpdatable() const;
+
     RigidBody *attachedRigidBody() const;
     void setAttachedRigidBody(RigidBody *body);
 
@@ -39,19 +44,25 @@ protected:
 
     virtual btCollisionShape *shape();
 
+    virtual void syncTransform();
+
+    bool moveCollisionObject(btCollisionObject *object, const btTransform &transform);
+
     btDynamicsWorld *bulletWorld() const;
     void setBulletWorld(btDynamicsWorld *world);
 
-    void dirtyContacts();
+    void setContact(Collider *other);
 
-    void cleanContacts();
+    void resolveContacts();
 
-    void setContact(Collider *other);
+    void emitContacts();
 
     void destroyShape();
 
     void destroyCollider();
 
+    unique_lock<recursive_mutex> lockWorld();
+
     Vector4 gizmoColor() const;
 
 protected:
@@ -62,6 +73,8 @@ protected:
 
     CollisionMap m_collisions;
 
+    vector<uint32_t> m_pending;
+
     btCollisionShape *m_collisionShape;
 
     btCollisionObject *m_collisionObject;
@@ -70,6 +83,12 @@ protected:
 
     RigidBody *m_rigidBody;
 
+    uint32_t m_entered;
+
+    uint32_t m_stay;
+
+    uint32_t m_exited;
+
 };
 typedef Collider* ColliderPtr;
 
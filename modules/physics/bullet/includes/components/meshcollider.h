@@ -3,14 +3,18 @@
 
 #include "collider.h"
 
+#include <resource.h>
+
 class Mesh;
 class PhysicMaterial;
+class CollisionMesh;
 
-class BULLET_EXPORT MeshCollider : public Collider {
+class BULLET_EXPORT MeshCollider : public Collider, public Resource::IObserver {
     A_REGISTER(MeshCollider, Collider, Components/Physics)
 
     A_PROPERTIES(
-        A_PROPERTY(Mesh *, Shared_Mesh, MeshCollider::mesh, MeshCollider::setMesh)
+        A_PROPERTY(Mesh *, Shared_Mesh, MeshCollider::mesh, MeshCollider::setMesh),
+        A_PROPERTYEX(CollisionMesh *, Cooked_Mesh, MeshCollider::collisionMesh, MeshCollider::setCollisionMesh, "editor=Asset")
     )
     A_NOMETHODS()
 
@@ -21,6 +25,9 @@ public:
     Mesh *mesh() const;
     void setMesh(Mesh *mesh);
 
+    CollisionMesh *collisionMesh() const;
+    void setCollisionMesh(CollisionMesh *mesh);
+
     PhysicMaterial *material() const;
     void setMaterial(PhysicMaterial *material);
 
@@ -29,9 +36,15 @@ private:
 
     void setEnabled(bool enable) override;
 
+    void releaseShape();
+
+    void resourceUpdated(const Resource *resource, Resource::ResourceState state) override;
+
 protected:
     Mesh *m_mesh;
 
+    CollisionMesh *m_collisionMesh;
+
     PhysicMaterial *m_material;
 
 };
@@ -41,7 +41,7 @@ public:
     void setLockRotation(int flags);
 
 protected:
-    void update() override;
+    void syncTransform() override;
 
     void createCollider() override;
 
@@ -36,6 +36,10 @@ protected:
 
     void update() override;
 
+    bool isUpdatable() const override;
+
+    void syncTransform() override;
+
 private:
     void loadUserData(const VariantMap &data) override;
     VariantMap saveUserData() const override;
@@ -0,0 +1,62 @@
+#ifndef COLLISIONMESHCONVERTER_H
+#define COLLISIONMESHCONVERTER_H
+
+#include <assetconverter.h>
+
+#include "resources/collisionmesh.h"
+
+class CollisionMeshImportSettings : public AssetConverterSettings {
+    Q_OBJECT
+
+    Q_PROPERTY(MeshType Type READ meshType WRITE setMeshType DESIGNABLE true USER true)
+    Q_PROPERTY(int Max_Hulls READ maxHulls WRITE setMaxHulls DESIGNABLE true USER true)
+    Q_PROPERTY(int Max_Hull_Vertices READ maxVertices WRITE setMaxVertices DESIGNABLE true USER true)
+    Q_PROPERTY(float Concavity READ concavity WRITE setConcavity DESIGNABLE true USER true)
+
+public:
+    enum class MeshType {
+        Static = CollisionMesh::Static,
+        Convex = CollisionMesh::Convex
+    };
+    Q_ENUM(MeshType)
+
+public:
+    CollisionMeshImportSettings();
+
+    MeshType meshType() const;
+    void setMeshType(MeshType type);
+
+    int maxHulls() const;
+    void setMaxHulls(int hulls);
+
+    int maxVertices() const;
+    void setMaxVertices(int vertices);
+
+    float concavity() const;
+    void setConcavity(float concavity);
+
+private:
+    QString defaultIcon(QString) const Q_DECL_OVERRIDE;
+
+protected:
+    MeshType m_type;
+
+    int m_maxHulls;
+
+    int m_maxVertices;
+
+    float m_concavity;
+
+};
+
+class CollisionMeshConverter : public AssetConverter {
+private:
+    QStringList suffixes() const Q_DECL_OVERRIDE { return {"cmesh"}; }
+    ReturnCode convertFile(AssetConverterSettings *settings) Q_DECL_OVERRIDE;
+    AssetConverterSettings *createSettings() const Q_DECL_OVERRIDE;
+
+    QString templatePath() const Q_DECL_OVERRIDE { return ":/Templates/Collision_Mesh.cmesh"; }
+
+};
+
+#endif // COLLISIONMESHCONVERTER_H
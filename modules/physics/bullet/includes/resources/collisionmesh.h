@@ -0,0 +1,78 @@
+#ifndef COLLISIONMESH_H
+#define COLLISIONMESH_H
+
+#include "resource.h"
+
+class btCollisionShape;
+class btBvhTriangleMeshShape;
+class btTriangleIndexVertexArray;
+class btOptimizedBvh;
+
+class CollisionMesh : public Resource {
+    A_REGISTER(CollisionMesh, Resource, Resources)
+
+    A_NOPROPERTIES()
+    A_NOMETHODS()
+
+public:
+    enum MeshType {
+        Static = 0,
+        Convex
+    };
+
+public:
+    CollisionMesh();
+    ~CollisionMesh();
+
+    int type() const;
+    void setType(int type);
+
+    const Vector3Vector &vertices() const;
+    const IndexVector &indices() const;
+    void setTriangles(const Vector3Vector &vertices, const IndexVector &indices);
+
+    const ByteArray &bvh() const;
+    void setBvh(const ByteArray &data);
+
+    void bakeBvh();
+
+    const vector<Vector3Vector> &hulls() const;
+    void setHulls(const vector<Vector3Vector> &hulls);
+
+    btCollisionShape *createShape(const Vector3 &scale);
+
+    static void releaseShape(btCollisionShape *shape);
+
+private:
+    static ByteArray serializeBvh(btOptimizedBvh *bvh);
+
+    static int bvhSignature();
+
+    btBvhTriangleMeshShape *triangleShape();
+
+    void clearShape();
+
+    void loadUserData(const VariantMap &data) override;
+    VariantMap saveUserData() const override;
+
+private:
+    Vector3Vector m_vertices;
+
+    IndexVector m_indices;
+
+    ByteArray m_bvh;
+
+    vector<Vector3Vector> m_hulls;
+
+    int m_type;
+
+    btTriangleIndexVertexArray *m_meshInterface;
+
+    btBvhTriangleMeshShape *m_shape;
+
+    void *m_bvhBuffer;
+
+};
+typedef CollisionMesh* CollisionMeshPtr;
+
+#endif // COLLISIONMESH_H
@@ -6,6 +6,7 @@
 
 #ifdef SHARED_DEFINE
 #include "converters/physicmaterialconverter.h"
+#include "converters/collisionmeshconverter.h"
 
 Module *moduleCreate(Engine *engine) {
     return new Bullet(engine);
@@ -20,7 +21,8 @@ static const char *meta = \
 "   \"author\": \"Evgeniy Prikazchikov\","
 "   \"objects\": {"
 "       \"BulletSystem\": \"system\","
-"       \"PhysicMaterialConverter\": \"converter\""
+"       \"PhysicMaterialConverter\": \"converter\","
+"       \"CollisionMeshConverter\": \"converter\""
 "   },"
 "   \"components\": ["
 "       \"BoxCollider\","
@@ -54,6 +56,8 @@ void *Bullet::getObject(const char *name) {
 #ifdef SHARED_DEFINE
     else if(strcmp(name, "PhysicMaterialConverter") == 0) {
         return new PhysicMaterialConverter();
+    } else if(strcmp(name, "CollisionMeshConverter") == 0) {
+        return new CollisionMeshConverter();
     }
 #endif
     return nullptr;
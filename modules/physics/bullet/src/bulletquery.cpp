@@ -0,0 +1,236 @@
+#include "bulletquery.h"
+
+#include <btBulletCollisionCommon.h>
+#include <BulletCollision/NarrowPhaseCollision/btRaycastCallback.h>
+#include <BulletCollision/NarrowPhaseCollision/btGjkPairDetector.h>
+#include <BulletCollision/NarrowPhaseCollision/btGjkEpaPenetrationDepthSolver.h>
+#include <BulletCollision/NarrowPhaseCollision/btVoronoiSimplexSolver.h>
+#include <BulletCollision/NarrowPhaseCollision/btPointCollector.h>
+#include <BulletCollision/CollisionShapes/btTriangleShape.h>
+
+class AabbCollector : public btBroadphaseAabbCallback {
+public:
+    bool process(const btBroadphaseProxy *proxy) override {
+        m_objects.push_back(static_cast<btCollisionObject *>(proxy->m_clientObject));
+        return true;
+    }
+
+    vector<btCollisionObject *> m_objects;
+
+};
+
+static bool convexOverlap(const btConvexShape *query, const btTransform &queryTransform, const btConvexShape *shape, const btTransform &transform) {
+    btVoronoiSimplexSolver simplex;
+    btGjkEpaPenetrationDepthSolver penetration;
+    btGjkPairDetector detector(query, shape, &simplex, &penetration);
+
+    btDiscreteCollisionDetectorInterface::ClosestPointInput input;
+    input.m_transformA = queryTransform;
+    input.m_transformB = transform;
+
+    btPointCollector output;
+    detector.getClosestPoints(input, output, nullptr);
+
+    return output.m_hasResult && output.m_distance <= 0.0f;
+}
+
+class TriangleOverlap : public btTriangleCallback {
+public:
+    TriangleOverlap(const btConvexShape *query, const btTransform &queryTransform, const btTransform &transform) :
+            m_query(query),
+            m_queryTransform(queryTransform),
+            m_transform(transform),
+            m_result(false) {
+
+    }
+
+    void processTriangle(btVector3 *triangle, int partId, int triangleIndex) override {
+        A_UNUSED(partId);
+        A_UNUSED(triangleIndex);
+
+        if(!m_result) {
+            btTriangleShape shape(triangle[0], triangle[1], triangle[2]);
+            shape.setMargin(0.0f);
+            m_result = convexOverlap(m_query, m_queryTransform, &shape, m_transform);
+        }
+    }
+
+    const btConvexShape *m_query;
+
+    const btTransform &m_queryTransform;
+
+    const btTransform &m_transform;
+
+    bool m_result;
+
+};
+
+static bool shapeOverlap(const btConvexShape *query, const btTransform &queryTransform, const btCollisionShape *shape, const btTransform &transform) {
+    if(shape->isConvex()) {
+        return convexOverlap(query, queryTransform, static_cast<const btConvexShape *>(shape), transform);
+    }
+
+    if(shape->isCompound()) {
+        const btCompoundShape *compound = static_cast<const btCompoundShape *>(shape);
+        for(int i = 0; i < compound->getNumChildShapes(); i++) {
+            if(shapeOverlap(query, queryTransform, compound->getChildShape(i), transform * compound->getChildTransform(i))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    if(shape->isConcave()) {
+        btVector3 aabbMin;
+        btVector3 aabbMax;
+        query->getAabb(transform.inverse() * queryTransform, aabbMin, aabbMax);
+
+        TriangleOverlap callback(query, queryTransform, transform);
+        static_cast<const btConcaveShape *>(shape)->processAllTriangles(&callback, aabbMin, aabbMax);
+        return callback.m_result;
+    }
+
+    return false;
+}
+
+/*!
+    \class BulletQueryTask
+    \brief The BulletQueryTask class executes a range of queries from the QueryBatch.
+    \inmodule Bullet
+
+    The task only reads the collision world, so the number of tasks can be executed in parallel between the simulation steps.
+    The broadphase and narrowphase tests are performed with the stack allocated structures only.
+*/
+
+BulletQueryTask::BulletQueryTask(btCollisionWorld *world, QueryBatch *batch, uint32_t begin, uint32_t end) :
+        m_world(world),
+        m_batch(batch),
+        m_begin(begin),
+        m_end(end) {
+
+}
+/*!
+    Executes the range of queries and completes the task in the batch.
+*/
+void BulletQueryTask::processEvents() {
+    PROFILE_FUNCTION();
+
+    QueryBatch::Result *results = m_batch->resultData();
+    for(uint32_t i = m_begin; i < m_end; i++) {
+        const QueryBatch::Query &query = m_batch->query(i);
+        QueryBatch::Result &result = results[i];
+
+        switch(query.type) {
+            case QueryBatch::RayCast: {
+                result.valid = rayTest(m_world, query.origin, query.direction, query.distance, &result.hit);
+                if(result.valid) {
+                    result.hit.distance *= query.distance;
+                }
+            } break;
+            case QueryBatch::SphereSweep:
+            case QueryBatch::BoxSweep: {
+                result.valid = sweepTest(m_world, query, &result.hit);
+            } break;
+            case QueryBatch::SphereOverlap:
+            case QueryBatch::BoxOverlap: {
+                result.valid = overlapTest(m_world, query, result.objects);
+            } break;
+            default: break;
+        }
+    }
+
+    m_batch->finish();
+}
+/*!
+    Casts a ray from the \a origin along the \a direction limited by the \a distance against the collision \a world.
+    Returns true and fills the \a hit in case of intersection; otherwise returns false.
+    The distance of the \a hit is the fraction of the \a distance, as World::rayCast() reports it.
+*/
+bool BulletQueryTask::rayTest(btCollisionWorld *world, const Vector3 &origin, const Vector3 &direction, float distance, Ray::Hit *hit) {
+    btVector3 from(origin.x, origin.y, origin.z);
+    btVector3 to(origin.x + direction.x * distance,
+                 origin.y + direction.y * distance,
+                 origin.z + direction.z * distance);
+
+    btCollisionWorld::ClosestRayResultCallback closestResults(from, to);
+    closestResults.m_flags |= btTriangleRaycastCallback::kF_FilterBackfaces;
+
+    world->rayTest(from, to, closestResults);
+    if(closestResults.hasHit()) {
+        if(hit) {
+            hit->object = reinterpret_cast<Object *>(closestResults.m_collisionObject->getUserPointer());
+
+            hit->distance = closestResults.m_closestHitFraction;
+            hit->normal = Vector3(closestResults.m_hitNormalWorld.x(),
+                                  closestResults.m_hitNormalWorld.y(),
+                                  closestResults.m_hitNormalWorld.z());
+            hit->point = Vector3(closestResults.m_hitPointWorld.x(),
+                                 closestResults.m_hitPointWorld.y(),
+                                 closestResults.m_hitPointWorld.z());
+        }
+        return true;
+    }
+    return false;
+}
+
+bool BulletQueryTask::sweepTest(btCollisionWorld *world, const QueryBatch::Query &query, Ray::Hit *hit) {
+    if(query.distance <= 0.0f) {
+        return false;
+    }
+
+    Vector3 dir = query.direction;
+    dir.normalize();
+
+    btQuaternion rotation(query.rotation.x, query.rotation.y, query.rotation.z, query.rotation.w);
+    btTransform from(rotation, btVector3(query.origin.x, query.origin.y, query.origin.z));
+    btTransform to(rotation, btVector3(query.origin.x + dir.x * query.distance,
+                                       query.origin.y + dir.y * query.distance,
+                                       query.origin.z + dir.z * query.distance));
+
+    btSphereShape sphere(query.extent.x);
+    btBoxShape box(btVector3(query.extent.x, query.extent.y, query.extent.z));
+    btConvexShape *shape = (query.type == QueryBatch::SphereSweep) ? static_cast<btConvexShape *>(&sphere) : static_cast<btConvexShape *>(&box);
+
+    btCollisionWorld::ClosestConvexResultCallback closestResults(from.getOrigin(), to.getOrigin());
+    world->convexSweepTest(shape, from, to, closestResults);
+    if(closestResults.hasHit()) {
+        if(hit) {
+            hit->object = reinterpret_cast<Object *>(closestResults.m_hitCollisionObject->getUserPointer());
+
+            hit->distance = closestResults.m_closestHitFraction * query.distance;
+            hit->normal = Vector3(closestResults.m_hitNormalWorld.x(),
+                                  closestResults.m_hitNormalWorld.y(),
+                                  closestResults.m_hitNormalWorld.z());
+            hit->point = Vector3(closestResults.m_hitPointWorld.x(),
+                                 closestResults.m_hitPointWorld.y(),
+                                 closestResults.m_hitPointWorld.z());
+        }
+        return true;
+    }
+    return false;
+}
+
+bool BulletQueryTask::overlapTest(btCollisionWorld *world, const QueryBatch::Query &query, vector<Object *> &objects) {
+    btQuaternion rotation(query.rotation.x, query.rotation.y, query.rotation.z, query.rotation.w);
+    btTransform transform(rotation, btVector3(query.origin.x, query.origin.y, query.origin.z));
+
+    btSphereShape sphere(query.extent.x);
+    btBoxShape box(btVector3(query.extent.x, query.extent.y, query.extent.z));
+    btConvexShape *shape = (query.type == QueryBatch::SphereOverlap) ? static_cast<btConvexShape *>(&sphere) : static_cast<btConvexShape *>(&box);
+
+    btVector3 aabbMin;
+    btVector3 aabbMax;
+    shape->getAabb(transform, aabbMin, aabbMax);
+
+    AabbCollector collector;
+    world->getBroadphase()->aabbTest(aabbMin, aabbMax, collector);
+
+    for(auto it : collector.m_objects) {
+        Object *object = reinterpret_cast<Object *>(it->getUserPointer());
+        if(object && shapeOverlap(shape, transform, it->getCollisionShape(), it->getWorldTransform())) {
+            objects.push_back(object);
+        }
+    }
+
+    return !objects.empty();
+}
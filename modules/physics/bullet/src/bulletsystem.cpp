@@ -3,17 +3,24 @@
 #include <assert.h>
 
 #include <cstring>
+#include <algorithm>
 
 #include <btBulletDynamicsCommon.h>
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h>
 #include <BulletCollision/CollisionDispatch/btGhostObject.h>
 #include <BulletCollision/NarrowPhaseCollision/btRaycastCallback.h>
 
 #include <log.h>
 #include <timer.h>
+#include <threadpool.h>
+#include <querybatch.h>
 
 #include <components/world.h>
 #include <components/actor.h>
 #include <components/scene.h>
+#include <components/transform.h>
 
 #include <systems/resourcesystem.h>
 
@@ -26,15 +33,45 @@
 #include "components/charactercontroller.h"
 
 #include "resources/physicmaterial.h"
+#include "resources/collisionmesh.h"
 
 #include "bulletdebug.h"
+#include "bullettaskscheduler.h"
+#include "bulletquery.h"
+
+namespace {
+    const char *gMultithreaded("physics.multithreaded");
+    const char *gThreads("physics.threads");
+};
+
+#define QUERY_GRAIN 64
+
+class BulletSystem::ContactsBody : public btIParallelForBody {
+public:
+    explicit ContactsBody(vector<Collider *> &contacts) :
+            m_contacts(contacts) {
+
+    }
+
+    void forLoop(int begin, int end) const override {
+        for(int i = begin; i < end; i++) {
+            m_contacts[i]->resolveContacts();
+        }
+    }
+
+    vector<Collider *> &m_contacts;
+
+};
 
 BulletSystem::BulletSystem(Engine *engine) :
         System(),
         m_collisionConfiguration(new btDefaultCollisionConfiguration),
         m_dispatcher(new btCollisionDispatcher(m_collisionConfiguration)),
         m_overlappingPairCache(new btDbvtBroadphase),
-        m_solver(new btSequentialImpulseConstraintSolver) {
+        m_solver(new btSequentialImpulseConstraintSolver),
+        m_solverPool(nullptr),
+        m_scheduler(nullptr),
+        m_queryPool(nullptr) {
     PROFILE_FUNCTION();
 
     Collider::registerClassFactory(this);
@@ -50,6 +87,7 @@ BulletSystem::BulletSystem(Engine *engine) :
     MeshCollider::registerClassFactory(this);
 
     PhysicMaterial::registerClassFactory(engine->resourceSystem());
+    CollisionMesh::registerClassFactory(engine->resourceSystem());
 
     m_overlappingPairCache->getOverlappingPairCache()->setInternalGhostPairCallback(new btGhostPairCallback());
 }
@@ -57,6 +95,9 @@ BulletSystem::BulletSystem(Engine *engine) :
 BulletSystem::~BulletSystem() {
     PROFILE_FUNCTION();
 
+    waitQueries();
+    delete m_queryPool;
+
     for(auto &it : m_worlds) {
         delete it.second;
     }
@@ -66,10 +107,16 @@ BulletSystem::~BulletSystem() {
     }
 
     delete m_solver;
+    delete m_solverPool;
     delete m_overlappingPairCache;
     delete m_dispatcher;
     delete m_collisionConfiguration;
 
+    if(m_scheduler) {
+        btSetTaskScheduler(btGetSequentialTaskScheduler());
+        delete m_scheduler;
+    }
+
     Collider::unregisterClassFactory(this);
 
     RigidBody::unregisterClassFactory(this);
@@ -86,14 +133,60 @@ BulletSystem::~BulletSystem() {
     setName("Bullet Physics");
 }
 
+/*!
+    Initializes the physics backend.
+    When \c physics.multithreaded setting is enabled, the simulation uses btDiscreteDynamicsWorldMt with a parallel constraint solver and a parallel collision dispatcher.
+    Parallel loops are executed by BulletTaskScheduler on \c physics.threads threads (0 means the optimal thread count for the current system).
+*/
+bool BulletSystem::init() {
+    PROFILE_FUNCTION();
+
+    // The thread which calls it first becomes the main thread for Bullet
+    btGetCurrentThreadIndex();
+
+    if(m_scheduler == nullptr && m_worlds.empty() && Engine::value(gMultithreaded, false).toBool()) {
+        int threads = Engine::value(gThreads, 0).toInt();
+        if(threads <= 0) {
+            threads = ThreadPool::optimalThreadCount();
+        }
+
+        m_scheduler = new BulletTaskScheduler(threads);
+        btSetTaskScheduler(m_scheduler);
+
+        delete m_dispatcher;
+        m_dispatcher = new btCollisionDispatcherMt(m_collisionConfiguration);
+
+        delete m_solver;
+        m_solver = new btSequentialImpulseConstraintSolverMt;
+
+        m_solverPool = new btConstraintSolverPoolMt(m_scheduler->getNumThreads());
+
+        Log(Log::INF) << "Bullet Physics runs on" << m_scheduler->getNumThreads() << "threads";
+    }
+
+    return true;
+}
+
 void BulletSystem::update(World *world) {
+    A_UNUSED(world);
+}
+
+void BulletSystem::fixedUpdate(World *world) {
     PROFILE_FUNCTION();
 
+    // Queries read the dynamics world, so they must be completed before the world modification.
+    // New batches submitted from other threads wait until the step is finished.
+    unique_lock<recursive_mutex> locker = waitQueries();
+
     if(Engine::isGameMode()) {
         btDynamicsWorld *dynamicWorld = nullptr;
         auto it = m_worlds.find(world->uuid());
         if(it == m_worlds.end()) {
-            dynamicWorld = new btDiscreteDynamicsWorld(m_dispatcher, m_overlappingPairCache, m_solver, m_collisionConfiguration);
+            if(m_solverPool) {
+                dynamicWorld = new btDiscreteDynamicsWorldMt(m_dispatcher, m_overlappingPairCache, m_solverPool, m_solver, m_collisionConfiguration);
+            } else {
+                dynamicWorld = new btDiscreteDynamicsWorld(m_dispatcher, m_overlappingPairCache, m_solver, m_collisionConfiguration);
+            }
 #ifdef SHARED_DEFINE
             BulletDebug *dbg = new BulletDebug;
             dbg->setDebugMode(btIDebugDraw::DBG_DrawWireframe);
@@ -101,13 +194,47 @@ void BulletSystem::update(World *world) {
 #endif
             m_worlds[world->uuid()] = dynamicWorld;
             world->setRayCastHandler(&rayCast, this);
+            world->setQueryBatchHandler(&queryBatch, this);
         } else {
             dynamicWorld = it->second;
         }
 
-        for(auto &it : m_objectList) {
-            Collider *body = static_cast<Collider *>(it);
-            body->dirtyContacts();
+        // New colliders are attached once their actor appears in the world
+        auto detached = m_detached.begin();
+        while(detached != m_detached.end()) {
+            Collider *body = *detached;
+            if(body->world() == world) {
+                body->setBulletWorld(dynamicWorld);
+                if(body->isUpdatable()) {
+                    m_updates.push_back(body);
+                }
+                detached = m_detached.erase(detached);
+            } else {
+                ++detached;
+            }
+        }
+
+        // Only the moved transforms are pushed to the dynamics world, sleeping and static bodies are left untouched
+        Transform::takeChanges(m_changes);
+        for(auto it : m_changes) {
+            for(auto body : it->actor()->findChildren<Collider *>(false)) {
+                if(body->m_world) {
+                    body->syncTransform();
+                }
+            }
+        }
+        m_changes.clear();
+
+        // Colliders which touched something on the previous step must be resolved to emit the exited signals
+        m_contacts = m_touching;
+
+        // Body updates can modify the dynamics world, so they stay on the calling thread
+        for(auto body : m_updates) {
+            body->update();
+
+            if(!body->m_pending.empty() && body->m_collisions.empty()) {
+                m_contacts.push_back(body);
+            }
         }
 
         for(int i = 0; i < m_dispatcher->getNumManifolds(); i++) {
@@ -120,24 +247,31 @@ void BulletSystem::update(World *world) {
             Collider *colliderB = reinterpret_cast<Collider *>(b->getUserPointer());
 
             if(colliderA && colliderB) {
+                if(colliderA->m_pending.empty() && colliderA->m_collisions.empty()) {
+                    m_contacts.push_back(colliderA);
+                }
+                if(colliderB->m_pending.empty() && colliderB->m_collisions.empty()) {
+                    m_contacts.push_back(colliderB);
+                }
                 colliderA->setContact(colliderB);
                 colliderB->setContact(colliderA);
             }
         }
 
-        for(auto &it : m_objectList) {
-            Collider *body = static_cast<Collider *>(it);
-            if(body->m_world == nullptr) {
-                if(body->world() == world) {
-                    body->setBulletWorld(dynamicWorld);
-                }
-            }
+        btParallelFor(0, m_contacts.size(), 64, ContactsBody(m_contacts));
 
-            body->update();
-            body->cleanContacts();
+        m_touching.clear();
+        for(auto it : m_contacts) {
+            it->emitContacts();
+            if(!it->m_collisions.empty()) {
+                m_touching.push_back(it);
+            }
         }
 
-        dynamicWorld->stepSimulation(Timer::deltaTime(), 4);
+        // Contact handlers could submit queries on this thread
+        waitQueries();
+
+        dynamicWorld->stepSimulation(Timer::fixedDeltaTime(), 0);
     }
 }
 
@@ -149,29 +283,81 @@ bool BulletSystem::rayCast(System *system, World *world, const Ray &ray, float d
     BulletSystem *bullet = static_cast<BulletSystem *>(system);
     auto it = bullet->m_worlds.find(world->uuid());
     if(it != bullet->m_worlds.end()) {
-        btVector3 from(ray.pos.x, ray.pos.y, ray.pos.z);
-        btVector3 to(ray.pos.x + ray.dir.x * distance,
-                     ray.pos.y + ray.dir.y * distance,
-                     ray.pos.z + ray.dir.z * distance);
-
-        btCollisionWorld::ClosestRayResultCallback closestResults(from, to);
-        closestResults.m_flags |= btTriangleRaycastCallback::kF_FilterBackfaces;
-
-        it->second->rayTest(from, to, closestResults);
-        if(closestResults.hasHit()) {
-             if(hit) {
-                hit->object = reinterpret_cast<Object *>(closestResults.m_collisionObject->getUserPointer());
-
-                hit->distance = closestResults.m_closestHitFraction;
-                hit->normal = Vector3(closestResults.m_hitNormalWorld.x(),
-                                      closestResults.m_hitNormalWorld.y(),
-                                      closestResults.m_hitNormalWorld.z());
-                hit->point = Vector3 (closestResults.m_hitPointWorld.x(),
-                                      closestResults.m_hitPointWorld.y(),
-                                      closestResults.m_hitPointWorld.z());
-            }
-            return true;
-        }
+        return BulletQueryTask::rayTest(it->second, ray.pos, ray.dir, distance, hit);
     }
     return false;
 }
+/*!
+    \internal
+    Splits the \a batch into the tasks and starts them on the worker threads.
+    This method can be called from any thread, the tasks are guaranteed to be finished before the next simulation step.
+*/
+bool BulletSystem::queryBatch(System *system, World *world, QueryBatch *batch) {
+    BulletSystem *bullet = static_cast<BulletSystem *>(system);
+    auto it = bullet->m_worlds.find(world->uuid());
+    if(it == bullet->m_worlds.end() || batch->size() == 0) {
+        batch->begin(0);
+        return false;
+    }
+
+    uint32_t size = batch->size();
+    uint32_t tasks = (size + QUERY_GRAIN - 1) / QUERY_GRAIN;
+    batch->begin(tasks);
+
+    unique_lock<recursive_mutex> locker(bullet->m_queryMutex);
+    if(bullet->m_queryPool == nullptr) {
+        bullet->m_queryPool = new ThreadPool;
+        bullet->m_queryPool->setMaxThreads(MAX(ThreadPool::optimalThreadCount() - 1, 1));
+    }
+
+    for(uint32_t i = 0; i < tasks; i++) {
+        BulletQueryTask *task = new BulletQueryTask(it->second, batch, i * QUERY_GRAIN, MIN((i + 1) * QUERY_GRAIN, size));
+        bullet->m_queryTasks.push_back(task);
+        bullet->m_queryPool->start(*task);
+    }
+
+    return true;
+}
+
+/*!
+    \internal
+    Puts the new colliders to the list of colliders waiting for the dynamics world.
+*/
+void BulletSystem::addObject(Object *object) {
+    System::addObject(object);
+
+    Collider *collider = dynamic_cast<Collider *>(object);
+    if(collider) {
+        m_detached.push_back(collider);
+    }
+}
+/*!
+    \internal
+    Removes the \a object from all lists used by the simulation step.
+*/
+void BulletSystem::removeObject(Object *object) {
+    System::removeObject(object);
+
+    Collider *collider = static_cast<Collider *>(object);
+    for(auto list : {&m_detached, &m_updates, &m_touching}) {
+        list->erase(std::remove(list->begin(), list->end(), collider), list->end());
+    }
+}
+
+/*!
+    \internal
+    Blocks until all submitted queries are finished.
+    Returns the locker which keeps the new queries from being started, the dynamics world can be safely modified while it's held.
+*/
+unique_lock<recursive_mutex> BulletSystem::waitQueries() {
+    unique_lock<recursive_mutex> locker(m_queryMutex);
+    if(m_queryPool) {
+        m_queryPool->waitForDone();
+    }
+    for(auto it : m_queryTasks) {
+        delete it;
+    }
+    m_queryTasks.clear();
+
+    return locker;
+}
@@ -0,0 +1,151 @@
+#include "bullettaskscheduler.h"
+
+#include <algorithm>
+
+#include <object.h>
+
+class BulletTask : public Object {
+public:
+    explicit BulletTask(BulletTaskScheduler *scheduler) :
+            m_scheduler(scheduler),
+            m_sum(0.0f) {
+
+    }
+
+    void processEvents() override {
+        BulletTaskScheduler *s = m_scheduler;
+        while(true) {
+            int begin = s->m_next.fetch_add(s->m_grainSize);
+            if(begin >= s->m_end) {
+                break;
+            }
+            int end = std::min(begin + s->m_grainSize, s->m_end);
+            if(s->m_forBody) {
+                s->m_forBody->forLoop(begin, end);
+            } else {
+                m_sum += s->m_sumBody->sumLoop(begin, end);
+            }
+        }
+    }
+
+    BulletTaskScheduler *m_scheduler;
+
+    btScalar m_sum;
+
+};
+
+/*!
+    \class BulletTaskScheduler
+    \brief The BulletTaskScheduler class runs Bullet parallel loops on the ThreadPool.
+    \inmodule Bullet
+
+    The loop range is split into the chunks of the requested grain size, worker tasks take the chunks from a shared counter until the range is exhausted.
+    The calling thread takes part in the loop as well, so the scheduler uses \a threads - 1 pool workers.
+*/
+
+BulletTaskScheduler::BulletTaskScheduler(int threads) :
+        btITaskScheduler("Thunder"),
+        m_forBody(nullptr),
+        m_sumBody(nullptr),
+        m_next(0),
+        m_end(0),
+        m_grainSize(1),
+        m_threads(0),
+        m_busy(false) {
+
+    setNumThreads(threads);
+}
+
+BulletTaskScheduler::~BulletTaskScheduler() {
+    m_pool.waitForDone();
+
+    for(auto it : m_tasks) {
+        delete it;
+    }
+}
+/*!
+    Returns the maximum number of threads supported by Bullet.
+*/
+int BulletTaskScheduler::getMaxNumThreads() const {
+    return BT_MAX_THREAD_COUNT;
+}
+/*!
+    Returns the number of threads, including the calling one, involved in a parallel loop.
+*/
+int BulletTaskScheduler::getNumThreads() const {
+    return m_threads;
+}
+/*!
+    Sets the number of \a threads, including the calling one, involved in a parallel loop.
+*/
+void BulletTaskScheduler::setNumThreads(int threads) {
+    m_threads = std::max(1, std::min(threads, int(BT_MAX_THREAD_COUNT)));
+
+    m_pool.waitForDone();
+    m_pool.setMaxThreads(m_threads - 1);
+
+    while(int(m_tasks.size()) < m_threads) {
+        m_tasks.push_back(new BulletTask(this));
+    }
+}
+/*!
+    Executes the \a body for the range [\a begin, \a end) split to chunks of \a grainSize.
+*/
+void BulletTaskScheduler::parallelFor(int begin, int end, int grainSize, const btIParallelForBody &body) {
+    dispatch(begin, end, grainSize, &body, nullptr);
+}
+/*!
+    Executes the \a body for the range [\a begin, \a end) split to chunks of \a grainSize and returns the sum of all chunk results.
+*/
+btScalar BulletTaskScheduler::parallelSum(int begin, int end, int grainSize, const btIParallelSumBody &body) {
+    return dispatch(begin, end, grainSize, nullptr, &body);
+}
+
+btScalar BulletTaskScheduler::dispatch(int begin, int end, int grainSize, const btIParallelForBody *forBody, const btIParallelSumBody *sumBody) {
+    if(begin >= end) {
+        return 0.0f;
+    }
+    grainSize = std::max(grainSize, 1);
+
+    int chunks = (end - begin + grainSize - 1) / grainSize;
+    int tasks = std::min(chunks, m_threads);
+
+    bool busy = false;
+    if(tasks <= 1 || !m_busy.compare_exchange_strong(busy, true)) {
+        // Small ranges and nested loops are executed on the calling thread
+        if(forBody) {
+            forBody->forLoop(begin, end);
+            return 0.0f;
+        }
+        return sumBody->sumLoop(begin, end);
+    }
+
+    m_forBody = forBody;
+    m_sumBody = sumBody;
+    m_end = end;
+    m_grainSize = grainSize;
+    m_next.store(begin);
+
+    for(int i = 0; i < tasks; i++) {
+        m_tasks[i]->m_sum = 0.0f;
+    }
+
+    for(int i = 1; i < tasks; i++) {
+        m_pool.start(*m_tasks[i]);
+    }
+    m_tasks[0]->processEvents();
+
+    m_pool.waitForDone();
+
+    btScalar result = 0.0f;
+    for(int i = 0; i < tasks; i++) {
+        result += m_tasks[i]->m_sum;
+    }
+
+    m_forBody = nullptr;
+    m_sumBody = nullptr;
+
+    m_busy.store(false);
+
+    return result;
+}
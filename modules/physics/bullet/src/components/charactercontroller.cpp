@@ -24,6 +24,8 @@ CharacterController::CharacterController() :
 }
 
 CharacterController::~CharacterController() {
+    unique_lock<recursive_mutex> locker = lockWorld();
+
     destroyCharacter();
     destroyShape();
 
@@ -45,6 +47,21 @@ void CharacterController::update() {
     }
 }
 
+bool CharacterController::isUpdatable() const {
+    return true;
+}
+
+void CharacterController::syncTransform() {
+    if(m_character) {
+        Vector3 p = transform()->worldPosition();
+        // Only the position is synchronized, the controller keeps the capsule upright
+        btTransform transform = m_ghostObject->getWorldTransform();
+        transform.setOrigin(btVector3(p.x + m_center.x, p.y + m_center.y, p.z + m_center.z));
+
+        moveCollisionObject(m_ghostObject, transform);
+    }
+}
+
 float CharacterController::height() const {
     return m_height;
 }
@@ -128,6 +145,8 @@ bool CharacterController::isGrounded() const {
 }
 
 void CharacterController::createCollider() {
+    unique_lock<recursive_mutex> locker = lockWorld();
+
     if(m_character == nullptr) {
         m_character = new btKinematicCharacterController(m_ghostObject, static_cast<btConvexShape *>(shape()), m_skin);
 
@@ -164,6 +183,8 @@ btCollisionShape *CharacterController::shape() {
 }
 
 void CharacterController::destroyCharacter() {
+    unique_lock<recursive_mutex> locker = lockWorld();
+
     if(m_character && m_world) {
         m_world->removeAction(m_character);
     }
@@ -5,15 +5,24 @@
 
 #include <btBulletDynamicsCommon.h>
 
+#include "bulletsystem.h"
+
+#define SYNC_EPSILON 1e-8f
+
 Collider::Collider() :
         m_collisionShape(nullptr),
         m_collisionObject(nullptr),
         m_world(nullptr),
-        m_rigidBody(nullptr) {
+        m_rigidBody(nullptr),
+        m_entered(0),
+        m_stay(0),
+        m_exited(0) {
 
 }
 
 Collider::~Collider() {
+    unique_lock<recursive_mutex> locker = lockWorld();
+
     destroyShape();
     destroyCollider();
 }
@@ -21,6 +30,14 @@ Collider::~Collider() {
 void Collider::update() {
 
 }
+/*!
+    \internal
+    Returns true if the collider must be updated on each simulation step; otherwise returns false.
+    Static colliders are updated only when their Transform is changed.
+*/
+bool Collider::isUpdatable() const {
+    return false;
+}
 
 RigidBody *Collider::attachedRigidBody() const {
     return m_rigidBody;
@@ -40,11 +57,14 @@ btDynamicsWorld *Collider::bulletWorld() const {
 void Collider::setBulletWorld(btDynamicsWorld *world) {
     m_world = world;
     if(m_world) {
+        transform()->setTracked(true);
         createCollider();
     }
 }
 
 void Collider::createCollider() {
+    unique_lock<recursive_mutex> locker = lockWorld();
+
     destroyCollider();
 
     if(m_rigidBody == nullptr) {
@@ -71,12 +91,58 @@ btCollisionShape *Collider::shape() {
     return m_collisionShape;
 }
 
+/*!
+    \internal
+    Moves the collision object to the current world position of the Transform.
+    This method is called by the BulletSystem only for the colliders which Transform was changed since the last simulation step.
+*/
+void Collider::syncTransform() {
+    if(m_collisionObject) {
+        Transform *t = transform();
+
+        Quaternion q = t->worldQuaternion();
+        Vector3 p = t->worldPosition();
+
+        moveCollisionObject(m_collisionObject, btTransform(btQuaternion(q.x, q.y, q.z, q.w),
+                                                           btVector3(p.x, p.y, p.z)));
+    }
+}
+/*!
+    \internal
+    Moves the collision \a object to the \a transform and updates its bounding box in the broadphase.
+    The changes which are produced by the simulation itself match the current state of the \a object and ignored.
+    Returns true if the \a object was moved; otherwise returns false.
+*/
+bool Collider::moveCollisionObject(btCollisionObject *object, const btTransform &transform) {
+    const btTransform &current = object->getWorldTransform();
+
+    const btMatrix3x3 &a = current.getBasis();
+    const btMatrix3x3 &b = transform.getBasis();
+    if((current.getOrigin() - transform.getOrigin()).length2() < SYNC_EPSILON &&
+       (a[0] - b[0]).length2() < SYNC_EPSILON &&
+       (a[1] - b[1]).length2() < SYNC_EPSILON &&
+       (a[2] - b[2]).length2() < SYNC_EPSILON) {
+        return false;
+    }
+
+    object->setWorldTransform(transform);
+    object->setInterpolationWorldTransform(transform);
+    if(m_world && object->getBroadphaseHandle()) {
+        m_world->updateSingleAabb(object);
+    }
+    return true;
+}
+
 void Collider::destroyShape() {
+    unique_lock<recursive_mutex> locker = lockWorld();
+
     delete m_collisionShape;
     m_collisionShape = nullptr;
 }
 
 void Collider::destroyCollider() {
+    unique_lock<recursive_mutex> locker = lockWorld();
+
     if(m_collisionObject && m_world) {
         m_world->removeCollisionObject(m_collisionObject);
         delete m_collisionObject;
@@ -84,43 +150,78 @@ void Collider::destroyCollider() {
     }
 }
 
-void Collider::dirtyContacts() {
+/*!
+    \internal
+    Waits for the asynchronous queries and locks the dynamics world for modification.
+    Collision objects and shapes must be added to or removed from the world only while the returned locker is held.
+*/
+unique_lock<recursive_mutex> Collider::lockWorld() {
+    BulletSystem *bullet = static_cast<BulletSystem *>(system());
+    if(m_world && bullet) {
+        return bullet->waitQueries();
+    }
+    return unique_lock<recursive_mutex>();
+}
+/*!
+    \internal
+    Registers a contact with the \a other collider for the current simulation step.
+*/
+void Collider::setContact(Collider *other) {
+    if(other == nullptr) {
+        return;
+    }
+    m_pending.push_back(other->uuid());
+}
+/*!
+    \internal
+    Matches the contacts registered for the current simulation step with the contacts from the previous one.
+    This method touches the collider data only, so it's safe to call it for different colliders in parallel.
+*/
+void Collider::resolveContacts() {
     for(auto &it : m_collisions) {
         it.second = true;
     }
-}
 
-void Collider::cleanContacts() {
+    for(auto it : m_pending) {
+        auto contact = m_collisions.find(it);
+        if(contact != m_collisions.end()) {
+            contact->second = false;
+            m_stay++;
+        } else {
+            m_collisions[it] = false;
+            m_entered++;
+        }
+    }
+    m_pending.clear();
+
     auto it = m_collisions.begin();
     while(it != m_collisions.end()) {
         if(it->second == true) {
-            emitSignal(_SIGNAL(exited()));
             it = m_collisions.erase(it);
-            if(m_collisionObject) {
-                m_collisionObject->activate(true);
-            }
+            m_exited++;
         } else {
             ++it;
         }
     }
 }
-
-void Collider::setContact(Collider *other) {
-    if(other == nullptr) {
-        return;
+/*!
+    \internal
+    Emits the contact signals collected by resolveContacts().
+*/
+void Collider::emitContacts() {
+    for(; m_entered > 0; m_entered--) {
+        emitSignal(_SIGNAL_ID(Collider, entered()));
     }
-    bool result = true;
-    for(auto &it : m_collisions) {
-        if(it.first == other->uuid()) {
-            emitSignal(_SIGNAL(stay()));
-            it.second = false;
-            result = false;
-            break;
-        }
+    for(; m_stay > 0; m_stay--) {
+        emitSignal(_SIGNAL_ID(Collider, stay()));
     }
-    if(result) {
-        emitSignal(_SIGNAL(entered()));
-        m_collisions[other->uuid()] = false;
+    if(m_exited > 0) {
+        if(m_collisionObject) {
+            m_collisionObject->activate(true);
+        }
+        for(; m_exited > 0; m_exited--) {
+            emitSignal(_SIGNAL_ID(Collider, exited()));
+        }
     }
 }
 
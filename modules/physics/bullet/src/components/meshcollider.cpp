@@ -5,6 +5,7 @@
 
 #include <resources/mesh.h>
 #include "resources/physicmaterial.h"
+#include "resources/collisionmesh.h"
 
 #include <BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h>
 #include <BulletCollision/CollisionShapes/btTriangleMesh.h>
@@ -12,14 +13,26 @@
 
 MeshCollider::MeshCollider() :
         m_mesh(nullptr),
+        m_collisionMesh(nullptr),
         m_material(nullptr) {
 
 }
 
 MeshCollider::~MeshCollider() {
+    unique_lock<recursive_mutex> locker = lockWorld();
+
+    if(m_collisionMesh) {
+        m_collisionMesh->unsubscribe(this);
+    }
+
     if(m_world && m_collisionObject) {
         m_world->removeCollisionObject(m_collisionObject);
     }
+
+    if(m_collisionMesh) {
+        CollisionMesh::releaseShape(m_collisionShape);
+        m_collisionShape = nullptr;
+    }
 }
 
 Mesh *MeshCollider::mesh() const {
@@ -27,14 +40,33 @@ Mesh *MeshCollider::mesh() const {
 }
 
 void MeshCollider::setMesh(Mesh *mesh) {
+    releaseShape();
+
     m_mesh = mesh;
 
-    if(m_world) {
-        m_world->removeCollisionObject(m_collisionObject);
+    createCollider();
+}
+/*!
+    Returns the collision mesh cooked by the editor.
+*/
+CollisionMesh *MeshCollider::collisionMesh() const {
+    return m_collisionMesh;
+}
+/*!
+    Sets the collision \a mesh cooked by the editor.
+    The cooked mesh takes precedence over the shared mesh and doesn't require to build the collision hierarchy at runtime.
+    The collision shape follows the state of the \a mesh, it's rebuilt on reloading and released on unloading.
+*/
+void MeshCollider::setCollisionMesh(CollisionMesh *mesh) {
+    releaseShape();
+
+    if(m_collisionMesh) {
+        m_collisionMesh->unsubscribe(this);
+    }
+    m_collisionMesh = mesh;
+    if(m_collisionMesh) {
+        m_collisionMesh->subscribe(this);
     }
-    destroyShape();
-
-    destroyCollider();
 
     createCollider();
 }
@@ -52,6 +84,8 @@ void MeshCollider::setMaterial(PhysicMaterial *material) {
 }
 
 void MeshCollider::setEnabled(bool enable) {
+    unique_lock<recursive_mutex> locker = lockWorld();
+
     if(m_collisionObject && m_world) {
         if(enable) {
             m_world->addCollisionObject(m_collisionObject);
@@ -61,7 +95,52 @@ void MeshCollider::setEnabled(bool enable) {
     }
 }
 
+void MeshCollider::releaseShape() {
+    unique_lock<recursive_mutex> locker = lockWorld();
+
+    if(m_world && m_collisionObject) {
+        m_world->removeCollisionObject(m_collisionObject);
+    }
+
+    if(m_collisionMesh) {
+        CollisionMesh::releaseShape(m_collisionShape);
+        m_collisionShape = nullptr;
+    } else {
+        destroyShape();
+    }
+
+    destroyCollider();
+}
+
+/*!
+    \internal
+    The scaled shapes share the hierarchy owned by the collision mesh, so they must be released before the mesh data is replaced or deleted.
+*/
+void MeshCollider::resourceUpdated(const Resource *resource, Resource::ResourceState state) {
+    if(resource == m_collisionMesh) {
+        switch(state) {
+            case Resource::Loading: {
+                releaseShape();
+            } break;
+            case Resource::Ready: {
+                if(m_world && m_collisionShape == nullptr) {
+                    createCollider();
+                }
+            } break;
+            case Resource::ToBeDeleted: {
+                releaseShape();
+                m_collisionMesh = nullptr;
+                createCollider();
+            } break;
+            default: break;
+        }
+    }
+}
+
 btCollisionShape *MeshCollider::shape() {
+    if(m_collisionShape == nullptr && m_collisionMesh != nullptr) {
+        m_collisionShape = m_collisionMesh->createShape(transform()->scale());
+    }
     if(m_collisionShape == nullptr && m_mesh != nullptr) {
         btTriangleMesh *triangleMesh = new btTriangleMesh();
 
@@ -31,6 +31,7 @@ public:
     }
 
     void setWorldTransform(const btTransform &worldTrans) override {
+        // Bullet calls it only for the active bodies
         Transform *t = m_body->transform();
         btQuaternion q = worldTrans.getRotation();
 
@@ -40,17 +41,15 @@ public:
         rot.z = q.getZ();
         rot.w = q.getW();
 
-        t->setQuaternion(rot);
-
         btVector3 p = worldTrans.getOrigin();
         Vector3 position(p.x(), p.y(), p.z());
 
         Transform *parent = t->parentTransform();
         if(parent) {
-            t->setPosition(parent->worldTransform().inverse() * position);
-        } else {
-            t->setPosition(position);
+            position = parent->worldTransform().inverse() * position;
         }
+
+        t->setPositionAndQuaternion(position, rot);
     }
 
 private:
@@ -69,6 +68,8 @@ RigidBody::RigidBody() :
 }
 
 RigidBody::~RigidBody() {
+    unique_lock<recursive_mutex> locker = lockWorld();
+
     if(m_world && m_collisionObject) {
         m_world->removeRigidBody(static_cast<btRigidBody *>(m_collisionObject));
     }
@@ -81,17 +82,21 @@ RigidBody::~RigidBody() {
     delete m_state;
 }
 
-void RigidBody::update() {
-    updateCollider(false);
-
-    if(m_collisionObject && m_kinematic) {
+/*!
+    \internal
+    Teleports the body to the current position of the Transform and wakes it up.
+*/
+void RigidBody::syncTransform() {
+    if(m_collisionObject) {
         Transform *t = transform();
 
         Quaternion q = t->worldQuaternion();
         Vector3 p = t->worldPosition();
 
-        static_cast<btRigidBody *>(m_collisionObject)->setWorldTransform(btTransform(btQuaternion(q.x, q.y, q.z, q.w),
-                                                                                      btVector3(p.x, p.y, p.z)));
+        if(moveCollisionObject(m_collisionObject, btTransform(btQuaternion(q.x, q.y, q.z, q.w),
+                                                              btVector3(p.x, p.y, p.z)))) {
+            m_collisionObject->activate(true);
+        }
     }
 }
 
@@ -116,6 +121,9 @@ bool RigidBody::kinematic() const {
 
 void RigidBody::setKinematic(bool kinematic) {
     m_kinematic = kinematic;
+    if(m_collisionObject) {
+        transform()->setInterpolate(!m_kinematic);
+    }
 }
 
 void RigidBody::applyForce(const Vector3 &force, const Vector3 &point) {
@@ -158,6 +166,8 @@ void RigidBody::setLockRotation(int flags) {
 }
 
 void RigidBody::createCollider() {
+    unique_lock<recursive_mutex> locker = lockWorld();
+
     updateCollider(true);
 
     btRigidBody *body = new btRigidBody(m_mass, m_state, m_collisionShape);
@@ -177,12 +187,19 @@ void RigidBody::createCollider() {
     }
     setMass(mass);
 
+    // Child colliders are collected from the hierarchy again on the next rebuild
+    m_colliders.clear();
+
     if(isEnabled() && m_collisionObject && m_world) {
         m_world->addRigidBody(static_cast<btRigidBody *>(m_collisionObject));
     }
+
+    transform()->setInterpolate(!m_kinematic);
 }
 
 void RigidBody::setEnabled(bool enable) {
+    unique_lock<recursive_mutex> locker = lockWorld();
+
     Collider::setEnabled(enable);
     if(m_collisionObject && m_world) {
         if(enable) {
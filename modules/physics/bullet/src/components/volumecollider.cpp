@@ -19,6 +19,8 @@ VolumeCollider::VolumeCollider() :
 }
 
 VolumeCollider::~VolumeCollider() {
+    unique_lock<recursive_mutex> locker = lockWorld();
+
     if(m_world && m_collisionObject) {
         m_world->removeCollisionObject(m_collisionObject);
     }
@@ -33,6 +35,24 @@ void VolumeCollider::update() {
     }
 }
 
+bool VolumeCollider::isUpdatable() const {
+    return m_trigger;
+}
+
+void VolumeCollider::syncTransform() {
+    if(m_collisionObject && m_trigger) {
+        Transform *t = transform();
+        const Quaternion &q = t->worldQuaternion();
+        Vector3 p = t->worldPosition();
+
+        moveCollisionObject(m_collisionObject, btTransform(btQuaternion(q.x, q.y, q.z, q.w),
+                                                           btVector3(p.x + m_center.x, p.y + m_center.y, p.z + m_center.z)));
+        return;
+    }
+
+    Collider::syncTransform();
+}
+
 bool VolumeCollider::trigger() const {
     return m_trigger;
 }
@@ -71,6 +91,8 @@ bool VolumeCollider::isDirty() const {
 
 void VolumeCollider::createCollider() {
     if(m_trigger) {
+        unique_lock<recursive_mutex> locker = lockWorld();
+
         if(m_collisionObject && m_world) {
             m_world->removeCollisionObject(m_collisionObject);
             delete m_collisionObject;
@@ -0,0 +1,449 @@
+#include "converters/collisionmeshconverter.h"
+
+#include <QFile>
+#include <QFileInfo>
+
+#include <algorithm>
+#include <cfloat>
+#include <map>
+#include <tuple>
+
+#include <json.h>
+#include <bson.h>
+#include <log.h>
+
+#include <resources/mesh.h>
+#include <systems/resourcesystem.h>
+#include <editor/projectmanager.h>
+
+#include <LinearMath/btConvexHullComputer.h>
+
+#define MESH "Mesh"
+
+#define FORMAT_VERSION 1
+
+namespace {
+    struct Part {
+        IndexVector triangles;
+
+        float concavity;
+
+        bool splittable;
+    };
+};
+
+static uint32_t findRoot(IndexVector &parents, uint32_t index) {
+    while(parents[index] != index) {
+        parents[index] = parents[parents[index]];
+        index = parents[index];
+    }
+    return index;
+}
+
+static void unite(IndexVector &parents, uint32_t a, uint32_t b) {
+    parents[findRoot(parents, a)] = findRoot(parents, b);
+}
+
+static Vector3 triangleCenter(const Vector3Vector &vertices, const IndexVector &indices, uint32_t triangle) {
+    return (vertices[indices[triangle * 3]] + vertices[indices[triangle * 3 + 1]] + vertices[indices[triangle * 3 + 2]]) / 3.0f;
+}
+
+static Vector3 partCenter(const Vector3Vector &vertices, const IndexVector &indices, const Part &part) {
+    Vector3 result;
+    for(auto it : part.triangles) {
+        result += triangleCenter(vertices, indices, it);
+    }
+    return result / static_cast<float>(MAX(part.triangles.size(), 1));
+}
+// Splits the mesh to the connected parts, coincident vertices are welded together
+static vector<Part> meshIslands(const Vector3Vector &vertices, const IndexVector &indices) {
+    IndexVector parents(vertices.size());
+    for(uint32_t i = 0; i < parents.size(); i++) {
+        parents[i] = i;
+    }
+
+    map<tuple<float, float, float>, uint32_t> welded;
+    for(uint32_t i = 0; i < vertices.size(); i++) {
+        auto key = make_tuple(vertices[i].x, vertices[i].y, vertices[i].z);
+        auto it = welded.find(key);
+        if(it != welded.end()) {
+            unite(parents, i, it->second);
+        } else {
+            welded[key] = i;
+        }
+    }
+
+    uint32_t count = indices.size() / 3;
+    for(uint32_t t = 0; t < count; t++) {
+        unite(parents, indices[t * 3], indices[t * 3 + 1]);
+        unite(parents, indices[t * 3], indices[t * 3 + 2]);
+    }
+
+    vector<Part> result;
+    map<uint32_t, uint32_t> islands;
+    for(uint32_t t = 0; t < count; t++) {
+        uint32_t root = findRoot(parents, indices[t * 3]);
+        auto it = islands.find(root);
+        if(it == islands.end()) {
+            it = islands.insert(make_pair(root, result.size())).first;
+            result.push_back({IndexVector(), 0.0f, true});
+        }
+        result[it->second].triangles.push_back(t);
+    }
+    return result;
+}
+
+static Vector3Vector partPoints(const Vector3Vector &vertices, const IndexVector &indices, const Part &part) {
+    Vector3Vector result;
+    result.reserve(part.triangles.size() * 3);
+    for(auto it : part.triangles) {
+        result.push_back(vertices[indices[it * 3]]);
+        result.push_back(vertices[indices[it * 3 + 1]]);
+        result.push_back(vertices[indices[it * 3 + 2]]);
+    }
+    return result;
+}
+// Returns the longest distance from the part surface to the convex hull along the surface normals related to the part size
+static float partConcavity(const Vector3Vector &vertices, const IndexVector &indices, const Part &part) {
+    Vector3Vector points = partPoints(vertices, indices, part);
+
+    btConvexHullComputer hull;
+    hull.compute(&points[0].x, sizeof(Vector3), points.size(), 0.0f, 0.0f);
+    if(hull.vertices.size() < 4) {
+        return 0.0f;
+    }
+
+    btVector3 center(0.0f, 0.0f, 0.0f);
+    btVector3 bbMin( FLT_MAX,  FLT_MAX,  FLT_MAX);
+    btVector3 bbMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for(int i = 0; i < hull.vertices.size(); i++) {
+        center += hull.vertices[i];
+        bbMin.setMin(hull.vertices[i]);
+        bbMax.setMax(hull.vertices[i]);
+    }
+    center /= static_cast<btScalar>(hull.vertices.size());
+
+    float size = (bbMax - bbMin).length();
+    if(size <= FLT_EPSILON) {
+        return 0.0f;
+    }
+
+    vector<btVector4> planes;
+    for(int f = 0; f < hull.faces.size(); f++) {
+        const btConvexHullComputer::Edge *edge = &hull.edges[hull.faces[f]];
+        const btVector3 &a = hull.vertices[edge->getSourceVertex()];
+        const btVector3 &b = hull.vertices[edge->getTargetVertex()];
+        const btVector3 &c = hull.vertices[edge->getNextEdgeOfFace()->getTargetVertex()];
+
+        btVector3 normal = (b - a).cross(c - a);
+        if(normal.length2() <= FLT_EPSILON * size * size) {
+            continue;
+        }
+        normal.normalize();
+        if(normal.dot(a - center) < 0.0f) {
+            normal = -normal;
+        }
+        planes.push_back(btVector4(normal.x(), normal.y(), normal.z(), -normal.dot(a)));
+    }
+
+    float result = 0.0f;
+    for(auto it : part.triangles) {
+        const Vector3 &a = vertices[indices[it * 3]];
+        const Vector3 &b = vertices[indices[it * 3 + 1]];
+        const Vector3 &c = vertices[indices[it * 3 + 2]];
+
+        Vector3 n = (b - a).cross(c - a);
+        if(n.sqrLength() <= FLT_EPSILON) {
+            continue;
+        }
+        n.normalize();
+        Vector3 p = (a + b + c) / 3.0f;
+
+        btVector3 origin(p.x, p.y, p.z);
+        btVector3 dir(n.x, n.y, n.z);
+
+        // Exit distance of the ray from the convex hull
+        float distance = FLT_MAX;
+        for(auto &plane : planes) {
+            btScalar cosine = plane.dot(dir);
+            if(cosine > FLT_EPSILON) {
+                distance = std::min(distance, std::max(-(plane.dot(origin) + plane.w()), 0.0f) / cosine);
+            }
+        }
+        if(distance < FLT_MAX) {
+            result = std::max(result, distance);
+        }
+    }
+    return result / size;
+}
+// Splits the part along the longest axis by the median of triangle centers
+static bool splitPart(const Vector3Vector &vertices, const IndexVector &indices, Part &part, Part &other) {
+    if(part.triangles.size() < 2) {
+        return false;
+    }
+
+    Vector3 bbMin( FLT_MAX);
+    Vector3 bbMax(-FLT_MAX);
+    for(auto it : part.triangles) {
+        Vector3 center = triangleCenter(vertices, indices, it);
+        bbMin = Vector3(MIN(bbMin.x, center.x), MIN(bbMin.y, center.y), MIN(bbMin.z, center.z));
+        bbMax = Vector3(MAX(bbMax.x, center.x), MAX(bbMax.y, center.y), MAX(bbMax.z, center.z));
+    }
+    Vector3 extent = bbMax - bbMin;
+    int axis = (extent.x > extent.y) ? ((extent.x > extent.z) ? 0 : 2) : ((extent.y > extent.z) ? 1 : 2);
+
+    auto middle = part.triangles.begin() + part.triangles.size() / 2;
+    std::nth_element(part.triangles.begin(), middle, part.triangles.end(), [&](uint32_t a, uint32_t b) {
+        return triangleCenter(vertices, indices, a)[axis] < triangleCenter(vertices, indices, b)[axis];
+    });
+
+    other.triangles.assign(middle, part.triangles.end());
+    other.concavity = 0.0f;
+    other.splittable = true;
+    part.triangles.erase(middle, part.triangles.end());
+
+    return true;
+}
+// Keeps the support points for evenly distributed directions only
+static Vector3Vector simplifyHull(const Vector3Vector &points, int maxVertices) {
+    Vector3Vector result;
+
+    btConvexHullComputer hull;
+    hull.compute(&points[0].x, sizeof(Vector3), points.size(), 0.0f, 0.0f);
+
+    int count = hull.vertices.size();
+    if(count <= maxVertices) {
+        for(int i = 0; i < count; i++) {
+            result.push_back(Vector3(hull.vertices[i].x(), hull.vertices[i].y(), hull.vertices[i].z()));
+        }
+        return result;
+    }
+
+    vector<bool> used(count, false);
+    for(int d = 0; d < maxVertices; d++) {
+        float y = 1.0f - (d + 0.5f) * 2.0f / maxVertices;
+        float r = sqrtf(MAX(1.0f - y * y, 0.0f));
+        float phi = d * 2.39996323f; // Golden angle
+        btVector3 dir(cosf(phi) * r, y, sinf(phi) * r);
+
+        int support = 0;
+        btScalar best = -FLT_MAX;
+        for(int i = 0; i < count; i++) {
+            btScalar dot = dir.dot(hull.vertices[i]);
+            if(dot > best) {
+                best = dot;
+                support = i;
+            }
+        }
+        if(!used[support]) {
+            used[support] = true;
+            result.push_back(Vector3(hull.vertices[support].x(), hull.vertices[support].y(), hull.vertices[support].z()));
+        }
+    }
+    return result;
+}
+// Approximates the mesh with the set of convex hulls
+static vector<Vector3Vector> decompose(const Vector3Vector &vertices, const IndexVector &indices, int maxHulls, int maxVertices, float concavity) {
+    vector<Part> parts = meshIslands(vertices, indices);
+
+    // Too many islands, merge the smallest ones to the nearest neighbours
+    if(parts.size() > static_cast<size_t>(maxHulls)) {
+        std::sort(parts.begin(), parts.end(), [](const Part &a, const Part &b) { return a.triangles.size() > b.triangles.size(); });
+
+        vector<Vector3> centers;
+        for(auto &it : parts) {
+            centers.push_back(partCenter(vertices, indices, it));
+        }
+
+        while(parts.size() > static_cast<size_t>(maxHulls)) {
+            Part &last = parts.back();
+
+            size_t nearest = 0;
+            float distance = FLT_MAX;
+            for(size_t i = 0; i < parts.size() - 1; i++) {
+                float d = (centers[i] - centers.back()).sqrLength();
+                if(d < distance) {
+                    distance = d;
+                    nearest = i;
+                }
+            }
+            parts[nearest].triangles.insert(parts[nearest].triangles.end(), last.triangles.begin(), last.triangles.end());
+            centers[nearest] = partCenter(vertices, indices, parts[nearest]);
+
+            parts.pop_back();
+            centers.pop_back();
+        }
+    }
+
+    for(auto &it : parts) {
+        it.concavity = partConcavity(vertices, indices, it);
+    }
+
+    // Split the most concave parts while hull budget allows
+    while(parts.size() < static_cast<size_t>(maxHulls)) {
+        Part *worst = nullptr;
+        for(auto &it : parts) {
+            if(it.splittable && it.concavity > concavity && (worst == nullptr || it.concavity > worst->concavity)) {
+                worst = &it;
+            }
+        }
+        if(worst == nullptr) {
+            break;
+        }
+
+        Part other;
+        if(!splitPart(vertices, indices, *worst, other)) {
+            worst->splittable = false;
+            continue;
+        }
+        worst->concavity = partConcavity(vertices, indices, *worst);
+        other.concavity = partConcavity(vertices, indices, other);
+        parts.push_back(other);
+    }
+
+    vector<Vector3Vector> result;
+    for(auto &it : parts) {
+        Vector3Vector hull = simplifyHull(partPoints(vertices, indices, it), maxVertices);
+        if(hull.size() >= 4) {
+            result.push_back(hull);
+        }
+    }
+    return result;
+}
+
+// Returns the source file of the mesh asset, the reference can be a path or an uuid of the sub item
+static QString meshSource(const string &ref) {
+    ResourceSystem::DictionaryMap &indices = Engine::resourceSystem()->indices();
+
+    string path;
+    if(indices.find(ref) != indices.end()) {
+        path = ref;
+    } else {
+        for(auto &it : indices) {
+            if(it.second.second == ref) {
+                path = it.first;
+                break;
+            }
+        }
+    }
+    if(path.empty()) {
+        return QString();
+    }
+
+    QFileInfo info(ProjectManager::instance()->contentPath() + "/" + path.c_str());
+    if(!info.isFile()) {
+        info = QFileInfo(info.path());
+    }
+    return info.isFile() ? info.absoluteFilePath() : QString();
+}
+
+CollisionMeshImportSettings::CollisionMeshImportSettings() :
+        m_type(MeshType::Static),
+        m_maxHulls(16),
+        m_maxVertices(32),
+        m_concavity(0.05f) {
+    setType(MetaType::type<CollisionMesh *>());
+    setVersion(FORMAT_VERSION);
+}
+
+CollisionMeshImportSettings::MeshType CollisionMeshImportSettings::meshType() const {
+    return m_type;
+}
+
+void CollisionMeshImportSettings::setMeshType(MeshType type) {
+    if(m_type != type) {
+        m_type = type;
+        setModified();
+    }
+}
+
+int CollisionMeshImportSettings::maxHulls() const {
+    return m_maxHulls;
+}
+
+void CollisionMeshImportSettings::setMaxHulls(int hulls) {
+    hulls = MAX(hulls, 1);
+    if(m_maxHulls != hulls) {
+        m_maxHulls = hulls;
+        setModified();
+    }
+}
+
+int CollisionMeshImportSettings::maxVertices() const {
+    return m_maxVertices;
+}
+
+void CollisionMeshImportSettings::setMaxVertices(int vertices) {
+    vertices = MAX(vertices, 4);
+    if(m_maxVertices != vertices) {
+        m_maxVertices = vertices;
+        setModified();
+    }
+}
+
+float CollisionMeshImportSettings::concavity() const {
+    return m_concavity;
+}
+
+void CollisionMeshImportSettings::setConcavity(float concavity) {
+    concavity = MAX(concavity, 0.0f);
+    if(m_concavity != concavity) {
+        m_concavity = concavity;
+        setModified();
+    }
+}
+
+QString CollisionMeshImportSettings::defaultIcon(QString) const {
+    return ":/Style/styles/dark/images/fixture.svg";
+}
+
+AssetConverterSettings *CollisionMeshConverter::createSettings() const {
+    return new CollisionMeshImportSettings();
+}
+/*!
+    Cooks the collision mesh for the source mesh referenced by the asset.
+    The source file of the mesh is recorded as a dependency, so the collision mesh is cooked again when the mesh has been changed.
+    Static meshes store the serialized bounding volume hierarchy, so it doesn't require to be built at runtime.
+    Convex meshes store the set of simplified convex hulls, which is suitable for the dynamic rigid bodies.
+*/
+AssetConverter::ReturnCode CollisionMeshConverter::convertFile(AssetConverterSettings *settings) {
+    CollisionMeshImportSettings *s = static_cast<CollisionMeshImportSettings *>(settings);
+
+    QFile src(settings->source());
+    if(src.open(QIODevice::ReadOnly)) {
+        VariantMap map = Json::load(src.readAll().toStdString()).toMap();
+        src.close();
+
+        string ref = map[MESH].toString();
+        Mesh *mesh = Engine::loadResource<Mesh>(ref);
+        if(mesh == nullptr || mesh->indices().empty()) {
+            Log(Log::ERR) << "Unable to load mesh for collision:" << ref.c_str();
+            return InternalError;
+        }
+
+        QString source = meshSource(ref);
+        if(!source.isEmpty()) {
+            settings->addDependency(source);
+        }
+
+        CollisionMesh collision;
+        if(s->meshType() == CollisionMeshImportSettings::MeshType::Convex) {
+            collision.setType(CollisionMesh::Convex);
+            collision.setHulls(decompose(mesh->vertices(), mesh->indices(), s->maxHulls(), s->maxVertices(), s->concavity()));
+        } else {
+            collision.setType(CollisionMesh::Static);
+            collision.setTriangles(mesh->vertices(), mesh->indices());
+            collision.bakeBvh();
+        }
+
+        QFile file(settings->absoluteDestination());
+        if(file.open(QIODevice::WriteOnly)) {
+            ByteArray data = Bson::save(Engine::toVariant(&collision));
+            file.write(reinterpret_cast<const char *>(&data[0]), data.size());
+            file.close();
+            return Success;
+        }
+    }
+
+    return InternalError;
+}
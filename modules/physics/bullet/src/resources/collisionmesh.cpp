@@ -0,0 +1,365 @@
+#include "resources/collisionmesh.h"
+
+#include <cstring>
+
+#include <log.h>
+
+#include <btBulletDynamicsCommon.h>
+#include <BulletCollision/CollisionShapes/btTriangleIndexVertexArray.h>
+#include <BulletCollision/CollisionShapes/btScaledBvhTriangleMeshShape.h>
+#include <BulletCollision/CollisionShapes/btOptimizedBvh.h>
+
+#define DATA  "Data"
+
+/*!
+    \class CollisionMesh
+    \brief The CollisionMesh class contains the collision geometry cooked by the editor.
+    \inmodule Bullet
+
+    A static collision mesh keeps the triangles and the quantized bounding volume hierarchy serialized by Bullet.
+    The hierarchy is restored in place on the first use, so the expensive build step doesn't happen at scene loading.
+    In case of the serialized data was produced by an incompatible platform, the hierarchy is rebuilt from the triangles.
+
+    A convex collision mesh keeps the set of simplified convex hulls produced by the convex decomposition.
+    This type of mesh can be used by the dynamic rigid bodies.
+*/
+
+CollisionMesh::CollisionMesh() :
+        m_type(Static),
+        m_meshInterface(nullptr),
+        m_shape(nullptr),
+        m_bvhBuffer(nullptr) {
+
+}
+
+CollisionMesh::~CollisionMesh() {
+    clearShape();
+}
+/*!
+    Returns the type of collision mesh.
+    For more details please see the CollisionMesh::MeshType enum.
+*/
+int CollisionMesh::type() const {
+    return m_type;
+}
+/*!
+    Sets the \a type of collision mesh.
+    For more details please see the CollisionMesh::MeshType enum.
+*/
+void CollisionMesh::setType(int type) {
+    m_type = type;
+}
+/*!
+    Returns the vertices of the triangle mesh.
+*/
+const Vector3Vector &CollisionMesh::vertices() const {
+    return m_vertices;
+}
+/*!
+    Returns the indices of the triangle mesh.
+*/
+const IndexVector &CollisionMesh::indices() const {
+    return m_indices;
+}
+/*!
+    Sets the triangle mesh with provided \a vertices and \a indices.
+    The serialized hierarchy is discarded.
+*/
+void CollisionMesh::setTriangles(const Vector3Vector &vertices, const IndexVector &indices) {
+    clearShape();
+
+    m_vertices = vertices;
+    m_indices = indices;
+    m_bvh.clear();
+}
+/*!
+    Returns the serialized bounding volume hierarchy.
+*/
+const ByteArray &CollisionMesh::bvh() const {
+    return m_bvh;
+}
+/*!
+    Sets the serialized bounding volume hierarchy \a data.
+    The hierarchy must be built for the triangles of this mesh.
+*/
+void CollisionMesh::setBvh(const ByteArray &data) {
+    clearShape();
+
+    m_bvh = data;
+}
+/*!
+    Builds the bounding volume hierarchy for the triangles and stores its serialized representation.
+*/
+void CollisionMesh::bakeBvh() {
+    clearShape();
+    m_bvh.clear();
+
+    btBvhTriangleMeshShape *shape = triangleShape();
+    if(shape) {
+        m_bvh = serializeBvh(shape->getOptimizedBvh());
+    }
+}
+/*!
+    Returns the list of convex hulls.
+*/
+const vector<Vector3Vector> &CollisionMesh::hulls() const {
+    return m_hulls;
+}
+/*!
+    Sets the list of convex \a hulls.
+*/
+void CollisionMesh::setHulls(const vector<Vector3Vector> &hulls) {
+    m_hulls = hulls;
+}
+/*!
+    Creates a new collision shape with the local \a scale.
+    The returned shape must be destroyed with CollisionMesh::releaseShape().
+*/
+btCollisionShape *CollisionMesh::createShape(const Vector3 &scale) {
+    btVector3 scaling(scale.x, scale.y, scale.z);
+
+    if(m_type == Convex) {
+        if(m_hulls.empty()) {
+            return nullptr;
+        }
+        btCompoundShape *compound = new btCompoundShape(true, m_hulls.size());
+        for(auto &hull : m_hulls) {
+            btConvexHullShape *shape = new btConvexHullShape;
+            for(auto &it : hull) {
+                shape->addPoint(btVector3(it.x, it.y, it.z), false);
+            }
+            shape->recalcLocalAabb();
+
+            btTransform transform;
+            transform.setIdentity();
+            compound->addChildShape(transform, shape);
+        }
+        compound->setLocalScaling(scaling);
+        return compound;
+    }
+
+    btBvhTriangleMeshShape *shape = triangleShape();
+    if(shape) {
+        return new btScaledBvhTriangleMeshShape(shape, scaling);
+    }
+    return nullptr;
+}
+/*!
+    Destroys the \a shape created by CollisionMesh::createShape().
+*/
+void CollisionMesh::releaseShape(btCollisionShape *shape) {
+    if(shape && shape->isCompound()) {
+        btCompoundShape *compound = static_cast<btCompoundShape *>(shape);
+        for(int i = compound->getNumChildShapes() - 1; i >= 0; i--) {
+            btCollisionShape *child = compound->getChildShape(i);
+            compound->removeChildShapeByIndex(i);
+            delete child;
+        }
+    }
+    delete shape;
+}
+/*!
+    \internal
+    Returns the serialized representation of the \a bvh.
+    The data starts from the signature of the current platform.
+*/
+ByteArray CollisionMesh::serializeBvh(btOptimizedBvh *bvh) {
+    ByteArray result;
+    if(bvh) {
+        int32_t signature = bvhSignature();
+        uint32_t size = bvh->calculateSerializeBufferSize();
+
+        void *buffer = btAlignedAlloc(size, 16);
+        if(bvh->serializeInPlace(buffer, size, false)) {
+            result.resize(sizeof(signature) + size);
+            memcpy(&result[0], &signature, sizeof(signature));
+            memcpy(&result[sizeof(signature)], buffer, size);
+        }
+        btAlignedFree(buffer);
+    }
+    return result;
+}
+/*!
+    \internal
+    Returns the signature of serialized hierarchy for the current platform.
+    The hierarchy is stored in the native memory layout, so it can be restored only with the same Bullet version, pointer size and floating point precision.
+*/
+int CollisionMesh::bvhSignature() {
+    return BT_BULLET_VERSION * 100 + static_cast<int>(sizeof(void *)) * 10 + static_cast<int>(sizeof(btScalar));
+}
+
+btBvhTriangleMeshShape *CollisionMesh::triangleShape() {
+    if(m_shape == nullptr && !m_indices.empty()) {
+        btIndexedMesh mesh;
+        mesh.m_numTriangles = m_indices.size() / 3;
+        mesh.m_triangleIndexBase = reinterpret_cast<const unsigned char *>(m_indices.data());
+        mesh.m_triangleIndexStride = 3 * sizeof(uint32_t);
+        mesh.m_numVertices = m_vertices.size();
+        mesh.m_vertexBase = reinterpret_cast<const unsigned char *>(m_vertices.data());
+        mesh.m_vertexStride = sizeof(Vector3);
+        mesh.m_vertexType = PHY_FLOAT;
+
+        m_meshInterface = new btTriangleIndexVertexArray;
+        m_meshInterface->addIndexedMesh(mesh, PHY_INTEGER);
+
+        btOptimizedBvh *bvh = nullptr;
+
+        int32_t signature = 0;
+        if(m_bvh.size() > sizeof(signature)) {
+            memcpy(&signature, &m_bvh[0], sizeof(signature));
+            if(signature == bvhSignature()) {
+                uint32_t size = m_bvh.size() - sizeof(signature);
+                m_bvhBuffer = btAlignedAlloc(size, 16);
+                memcpy(m_bvhBuffer, &m_bvh[sizeof(signature)], size);
+
+                bvh = btOptimizedBvh::deSerializeInPlace(m_bvhBuffer, size, false);
+            }
+            if(bvh == nullptr) {
+                Log(Log::WRN) << "Incompatible collision hierarchy, rebuilding:" << Engine::reference(this).c_str();
+            }
+        }
+
+        if(bvh) {
+            m_shape = new btBvhTriangleMeshShape(m_meshInterface, true, false);
+            m_shape->setOptimizedBvh(bvh);
+        } else {
+            if(m_bvhBuffer) {
+                btAlignedFree(m_bvhBuffer);
+                m_bvhBuffer = nullptr;
+            }
+            m_shape = new btBvhTriangleMeshShape(m_meshInterface, true, true);
+        }
+    }
+    return m_shape;
+}
+
+void CollisionMesh::clearShape() {
+    delete m_shape;
+    m_shape = nullptr;
+
+    delete m_meshInterface;
+    m_meshInterface = nullptr;
+
+    if(m_bvhBuffer) {
+        btAlignedFree(m_bvhBuffer);
+        m_bvhBuffer = nullptr;
+    }
+}
+/*!
+    \internal
+*/
+void CollisionMesh::loadUserData(const VariantMap &data) {
+    clearShape();
+
+    m_vertices.clear();
+    m_indices.clear();
+    m_bvh.clear();
+    m_hulls.clear();
+
+    auto section = data.find(DATA);
+    if(section != data.end()) {
+        VariantList list = (*section).second.value<VariantList>();
+        // Type, counts, vertices, indices, hierarchy and number of hulls
+        if(list.size() < 7) {
+            Log(Log::ERR) << "Corrupted collision mesh:" << Engine::reference(this).c_str();
+            return;
+        }
+        auto it = list.begin();
+
+        int type = it->toInt();
+        it++;
+
+        uint32_t vCount = it->toInt();
+        it++;
+        uint32_t iCount = it->toInt();
+        it++;
+
+        ByteArray vertices = it->toByteArray();
+        it++;
+        ByteArray indices = it->toByteArray();
+        it++;
+
+        if(vertices.size() != sizeof(Vector3) * vCount || indices.size() != sizeof(uint32_t) * iCount || (iCount % 3) != 0) {
+            Log(Log::ERR) << "Corrupted collision mesh:" << Engine::reference(this).c_str();
+            return;
+        }
+
+        IndexVector triangles(iCount);
+        if(iCount) {
+            memcpy(triangles.data(), indices.data(), indices.size());
+        }
+        for(auto index : triangles) {
+            if(index >= vCount) {
+                Log(Log::ERR) << "Corrupted collision mesh:" << Engine::reference(this).c_str();
+                return;
+            }
+        }
+
+        ByteArray bvh = it->toByteArray();
+        it++;
+
+        uint32_t hCount = it->toInt();
+        it++;
+        if(hCount > static_cast<uint32_t>(std::distance(it, list.end()))) {
+            Log(Log::ERR) << "Corrupted collision mesh:" << Engine::reference(this).c_str();
+            return;
+        }
+
+        m_type = type;
+
+        m_vertices.resize(vCount);
+        if(vCount) {
+            memcpy(m_vertices.data(), vertices.data(), vertices.size());
+        }
+        m_indices = triangles;
+        m_bvh = bvh;
+
+        m_hulls.resize(hCount);
+        for(auto &hull : m_hulls) {
+            ByteArray bytes = it->toByteArray();
+            it++;
+            hull.resize(bytes.size() / sizeof(Vector3));
+            if(!hull.empty()) {
+                memcpy(hull.data(), bytes.data(), sizeof(Vector3) * hull.size());
+            }
+        }
+    }
+}
+/*!
+    \internal
+*/
+VariantMap CollisionMesh::saveUserData() const {
+    VariantMap result;
+    VariantList data;
+
+    data.push_back(m_type);
+    data.push_back(static_cast<int32_t>(m_vertices.size()));
+    data.push_back(static_cast<int32_t>(m_indices.size()));
+
+    ByteArray bytes;
+    bytes.resize(sizeof(Vector3) * m_vertices.size());
+    if(!bytes.empty()) {
+        memcpy(&bytes[0], m_vertices.data(), bytes.size());
+    }
+    data.push_back(bytes);
+
+    bytes.resize(sizeof(uint32_t) * m_indices.size());
+    if(!bytes.empty()) {
+        memcpy(&bytes[0], m_indices.data(), bytes.size());
+    }
+    data.push_back(bytes);
+
+    data.push_back(m_bvh);
+
+    data.push_back(static_cast<int32_t>(m_hulls.size()));
+    for(auto &hull : m_hulls) {
+        bytes.resize(sizeof(Vector3) * hull.size());
+        if(!bytes.empty()) {
+            memcpy(&bytes[0], hull.data(), bytes.size());
+        }
+        data.push_back(bytes);
+    }
+
+    result[DATA] = data;
+    return result;
+}
@@ -0,0 +1,159 @@
+#include "tst_common.h"
+
+#include "resources/collisionmesh.h"
+
+#include "systems/resourcesystem.h"
+
+#include <bson.h>
+
+#include <BulletCollision/CollisionShapes/btScaledBvhTriangleMeshShape.h>
+#include <BulletCollision/NarrowPhaseCollision/btRaycastCallback.h>
+
+class RayHits : public btTriangleRaycastCallback {
+public:
+    RayHits(const btVector3 &from, const btVector3 &to) :
+            btTriangleRaycastCallback(from, to) {
+
+    }
+
+    btScalar reportHit(const btVector3 &normal, btScalar fraction, int part, int triangle) override {
+        A_UNUSED(normal);
+        A_UNUSED(part);
+        A_UNUSED(triangle);
+
+        hits++;
+        return fraction;
+    }
+
+    int hits = 0;
+};
+
+// Casts a vertical ray through the mesh and returns the number of triangles hit
+static int castRay(CollisionMesh *mesh, float x, float z) {
+    btCollisionShape *shape = mesh->createShape(Vector3(1.0f));
+    if(shape == nullptr) {
+        return -1;
+    }
+
+    btBvhTriangleMeshShape *child = static_cast<btScaledBvhTriangleMeshShape *>(shape)->getChildShape();
+
+    btVector3 from(x, 10.0f, z);
+    btVector3 to(x,-10.0f, z);
+    RayHits callback(from, to);
+    child->performRaycast(&callback, from, to);
+
+    CollisionMesh::releaseShape(shape);
+    return callback.hits;
+}
+
+// The flat grid of size x size quads in the XZ plane
+static void createGrid(CollisionMesh *mesh, uint32_t size) {
+    Vector3Vector vertices;
+    for(uint32_t z = 0; z <= size; z++) {
+        for(uint32_t x = 0; x <= size; x++) {
+            vertices.push_back(Vector3(x, 0.0f, z));
+        }
+    }
+
+    IndexVector indices;
+    for(uint32_t z = 0; z < size; z++) {
+        for(uint32_t x = 0; x < size; x++) {
+            uint32_t index = z * (size + 1) + x;
+            indices.insert(indices.end(), {index, index + size + 1, index + 1});
+            indices.insert(indices.end(), {index + 1, index + size + 1, index + size + 2});
+        }
+    }
+
+    mesh->setTriangles(vertices, indices);
+}
+
+class CollisionMeshTest : public QObject {
+    Q_OBJECT
+private slots:
+
+void Serialize_bvh() {
+    Engine system(nullptr, "");
+    CollisionMesh::registerClassFactory(Engine::resourceSystem());
+
+    CollisionMesh *mesh = Engine::objectCreate<CollisionMesh>();
+    createGrid(mesh, 8);
+    QVERIFY(mesh->bvh().empty());
+
+    mesh->bakeBvh();
+    QVERIFY(!mesh->bvh().empty());
+
+    ByteArray data = Bson::save(ObjectSystem::toVariant(mesh));
+    CollisionMesh *result = dynamic_cast<CollisionMesh *>(ObjectSystem::toObject(Bson::load(data)));
+    QVERIFY(result != nullptr);
+
+    QCOMPARE(result->type(), static_cast<int>(CollisionMesh::Static));
+    QCOMPARE(result->vertices().size(), mesh->vertices().size());
+    QCOMPARE(result->indices() == mesh->indices(), true);
+    QCOMPARE(result->bvh() == mesh->bvh(), true);
+
+    // The restored hierarchy must find exactly one triangle under the ray
+    QCOMPARE(castRay(result, 2.3f, 5.1f), 1);
+    QCOMPARE(castRay(result, 9.5f, 5.1f), 0);
+
+    // The hierarchy from the other platform is rebuilt from the triangles
+    ByteArray bvh = result->bvh();
+    bvh[0] = ~bvh[0];
+    result->setBvh(bvh);
+    QCOMPARE(castRay(result, 2.3f, 5.1f), 1);
+
+    delete result;
+    delete mesh;
+}
+
+void Load_corrupted_data() {
+    Engine system(nullptr, "");
+
+    CollisionMesh mesh;
+    createGrid(&mesh, 2);
+    mesh.bakeBvh();
+
+    // The user data goes last in the serialized object
+    VariantList objects = ObjectSystem::toVariant(&mesh).toList();
+    QCOMPARE(objects.size(), 1);
+    VariantMap data = objects.front().toList().back().toMap();
+    VariantList fields = data["Data"].toList();
+    QCOMPARE(fields.size(), 7);
+
+    Object &object = mesh;
+
+    // The list is truncated
+    VariantList truncated = fields;
+    truncated.pop_back();
+    object.loadUserData({{"Data", truncated}});
+    QVERIFY(mesh.vertices().empty());
+    QVERIFY(mesh.createShape(Vector3(1.0f)) == nullptr);
+
+    // The number of indices doesn't match the data
+    VariantList counts = fields;
+    *std::next(counts.begin(), 2) = 300;
+    object.loadUserData({{"Data", counts}});
+    QVERIFY(mesh.indices().empty());
+
+    // The index refers outside of the vertices
+    VariantList indices = fields;
+    ByteArray bytes = std::next(indices.begin(), 4)->toByteArray();
+    uint32_t index = 100;
+    memcpy(bytes.data(), &index, sizeof(index));
+    *std::next(indices.begin(), 4) = bytes;
+    object.loadUserData({{"Data", indices}});
+    QVERIFY(mesh.indices().empty());
+
+    // The number of hulls is bigger than the list
+    VariantList hulls = fields;
+    hulls.back() = 5;
+    object.loadUserData({{"Data", hulls}});
+    QVERIFY(mesh.hulls().empty());
+
+    object.loadUserData({{"Data", fields}});
+    QCOMPARE(mesh.indices().size(), 24);
+    QCOMPARE(castRay(&mesh, 0.5f, 0.7f), 1);
+}
+
+} REGISTER(CollisionMeshTest)
+
+#include "tst_collisionmesh.moc"
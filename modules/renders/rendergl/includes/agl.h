@@ -10,9 +10,6 @@
     #include <GLFW/glfw3.h>
 #endif
 
-#define POLYGONS    "Polygons"
-#define DRAWCALLS   "Draw Calls"
-
 void _CheckGLError(const char *file, int line);
 #define CheckGLError()// _CheckGLError(__FILE__, __LINE__)
 
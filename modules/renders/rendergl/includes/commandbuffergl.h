@@ -32,6 +32,8 @@ public:
 
     void drawMeshInstanced(const Matrix4 *models, uint32_t count, Mesh *mesh, uint32_t sub, uint32_t layer = CommandBuffer::DEFAULT, MaterialInstance *material = nullptr) override;
 
+    void drawMeshIndirect(ComputeBuffer *models, ComputeBuffer *arguments, Mesh *mesh, uint32_t sub, uint32_t layer = CommandBuffer::DEFAULT, MaterialInstance *material = nullptr) override;
+
     void setRenderTarget(RenderTarget *target, uint32_t level = 0) override;
 
     void resetViewProjection() override;
@@ -30,6 +30,8 @@ public:
 
     uint32_t instance() const;
 
+    void bindInstances(uint32_t buffer);
+
 protected:
     void updateVao();
     void updateVbo(CommandBufferGL *buffer);
@@ -8,6 +8,7 @@
 #include "resources/materialgl.h"
 #include "resources/rendertargetgl.h"
 #include "resources/computeshadergl.h"
+#include "resources/computebuffergl.h"
 
 #include <log.h>
 #include <timer.h>
@@ -77,7 +78,8 @@ void CommandBufferGL::dispatchCompute(ComputeInstance *shader, int32_t groupsX,
         if(instance->bind(this)) {
             glDispatchCompute(groupsX, groupsY, groupsZ);
 
-            glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+            glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT |
+                            GL_COMMAND_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
         }
     }
 #endif
@@ -142,7 +144,7 @@ void CommandBufferGL::drawMeshInstanced(const Matrix4 *models, uint32_t count, M
                 int32_t glMode = (material->material()->wireframe()) ? GL_LINE_STRIP : GL_TRIANGLE_STRIP;
                 uint32_t vert = m->vertices().size();
                 glDrawArraysInstanced(glMode, 0, vert, count);
-                PROFILER_STAT(POLYGONS, index - 2 * count);
+                PROFILER_STAT(POLYGONS, (vert - 2) * count);
             } else {
                 uint32_t index = m->indices().size();
                 int32_t glMode = (material->material()->wireframe()) ? GL_LINES : GL_TRIANGLES;
@@ -156,6 +158,46 @@ void CommandBufferGL::drawMeshInstanced(const Matrix4 *models, uint32_t count, M
     }
 }
 
+void CommandBufferGL::drawMeshIndirect(ComputeBuffer *models, ComputeBuffer *arguments, Mesh *mesh, uint32_t sub, uint32_t layer, MaterialInstance *material) {
+#ifndef THUNDER_MOBILE
+    PROFILE_FUNCTION();
+    A_UNUSED(sub);
+
+    if(models && arguments && mesh && material) {
+        MeshGL *m = static_cast<MeshGL *>(mesh);
+
+        m_local.model.identity();
+
+        glBindBuffer(GL_UNIFORM_BUFFER, m_localUbo);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Local), &m_local);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+        MaterialInstanceGL *instance = static_cast<MaterialInstanceGL *>(material);
+        if(instance->bind(this, layer)) {
+            m->bindVao(this);
+
+            // Instance matrices are read from the compute buffer directly, the mesh instance buffer is restored after the draw
+            m->bindInstances(static_cast<ComputeBufferGL *>(models)->nativeHandle());
+
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, static_cast<ComputeBufferGL *>(arguments)->nativeHandle());
+            if(m->indices().empty()) {
+                int32_t glMode = (material->material()->wireframe()) ? GL_LINE_STRIP : GL_TRIANGLE_STRIP;
+                glDrawArraysIndirect(glMode, nullptr);
+            } else {
+                int32_t glMode = (material->material()->wireframe()) ? GL_LINES : GL_TRIANGLES;
+                glDrawElementsIndirect(glMode, GL_UNSIGNED_INT, nullptr);
+            }
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+            PROFILER_STAT(DRAWCALLS, 1);
+
+            m->bindInstances(m->instance());
+
+            glBindVertexArray(0);
+        }
+    }
+#endif
+}
+
 void CommandBufferGL::setRenderTarget(RenderTarget *target, uint32_t level) {
     PROFILE_FUNCTION();
 
@@ -95,6 +95,9 @@ bool RenderGLSystem::init() {
     }
     glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
     CheckGLError();
+
+    CommandBufferGL::setComputeSupported(GLAD_GL_ARB_compute_shader && GLAD_GL_ARB_shader_storage_buffer_object &&
+                                         GLAD_GL_ARB_draw_indirect);
 #endif
     bool result = RenderSystem::init();
 
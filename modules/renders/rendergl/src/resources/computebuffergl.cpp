@@ -3,7 +3,8 @@
 #include "agl.h"
 
 ComputeBufferGL::ComputeBufferGL() :
-        m_ssbo(0) {
+        m_ssbo(0),
+        m_size(0) {
 
 }
 
@@ -12,6 +13,7 @@ uint32_t ComputeBufferGL::nativeHandle() {
         case Unloading: {
             glDeleteBuffers(1, &m_ssbo);
             m_ssbo = 0;
+            m_size = 0;
 
             switchState(ToBeDeleted);
         } break;
@@ -29,9 +31,14 @@ void ComputeBufferGL::updateBuffer() {
 #ifndef THUNDER_MOBILE
     if(m_ssbo == 0) {
         glGenBuffers(1, &m_ssbo);
+    }
+
+    if(m_size != m_buffer.size()) {
+        m_size = m_buffer.size();
         glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_ssbo);
-        glBufferData(GL_SHADER_STORAGE_BUFFER, m_buffer.size(), m_buffer.data(), GL_DYNAMIC_DRAW);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, m_size, m_buffer.data(), GL_DYNAMIC_DRAW);
         glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        m_bufferDirty = false;
     }
 
     if(m_bufferDirty) {
@@ -100,15 +100,23 @@ void MeshGL::updateVao() {
         glVertexAttribPointer(WEIGHTS_ATRIB, 4, GL_FLOAT, GL_FALSE, 0, nullptr);
     }
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
     for(uint32_t i = 0; i < 4; i++) {
         glEnableVertexAttribArray(INSTANCE_ATRIB + i);
-        glVertexAttribPointer(INSTANCE_ATRIB + i, 4, GL_FLOAT, GL_FALSE, sizeof(Matrix4), reinterpret_cast<void *>(i * sizeof(Vector4)));
         glVertexAttribDivisor(INSTANCE_ATRIB + i, 1);
     }
+    bindInstances(m_instanceBuffer);
+}
+
+void MeshGL::bindInstances(uint32_t buffer) {
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    for(uint32_t i = 0; i < 4; i++) {
+        glVertexAttribPointer(INSTANCE_ATRIB + i, 4, GL_FLOAT, GL_FALSE, sizeof(Matrix4), reinterpret_cast<void *>(i * sizeof(Vector4)));
+    }
 }
 
 void MeshGL::updateVbo(CommandBufferGL *buffer) {
+    PROFILER_STAT(UPLOADS, 1);
+
     if(!m_instanceBuffer) {
         glGenBuffers(1, &m_instanceBuffer);
     }
@@ -4,6 +4,8 @@
 
 #include "agl.h"
 
+#include <commandbuffer.h>
+
 TextureGL::TextureGL() :
         m_ID(0) {
 
@@ -143,6 +145,8 @@ void TextureGL::destroyTexture() {
 }
 
 bool TextureGL::uploadTexture(const Sides *sides, uint32_t imageIndex, uint32_t target, uint32_t internal, uint32_t format, uint32_t type) {
+    PROFILER_STAT(UPLOADS, 1);
+
     int32_t w = width();
     int32_t h = height();
 
@@ -3,6 +3,10 @@
 
 #include <system.h>
 
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
 class asIScriptEngine;
 class asIScriptModule;
 class asIScriptContext;
@@ -16,6 +20,8 @@ class MetaObject;
 class Engine;
 
 class AngelScript;
+class AngelClass;
+class AngelTask;
 
 class AngelSystem : public System {
 public:
@@ -26,6 +32,8 @@ public:
 
     void update(World *) override;
 
+    void fixedUpdate(World *world) override;
+
     int threadPolicy() const override;
 
     void reload();
@@ -34,15 +42,25 @@ public:
 
     void *execute(asIScriptObject *object, asIScriptFunction *func);
 
+    static void *execute(asIScriptContext *context, asIScriptObject *object, asIScriptFunction *func);
+
     asIScriptModule *module() const;
 
     asIScriptContext *context() const;
 
+    const AngelClass *scriptClass(asITypeInfo *info);
+
 protected:
     bool isBehaviour(asITypeInfo *info) const;
 
     void unload();
 
+    void executeParallel();
+
+    void swapObjects();
+
+    void releaseClasses(bool all);
+
     void bindMetaType(asIScriptEngine *engine, const MetaType::Table &table);
     void bindMetaObject(asIScriptEngine *engine, const string &name, const MetaObject *meta);
 
@@ -56,7 +74,25 @@ protected:
 
     AngelScript *m_script;
 
+    unordered_map<asITypeInfo *, AngelClass *> m_classes;
+
+    vector<AngelTask *> m_tasks;
+
+    mutex m_tasksMutex;
+
+    condition_variable m_tasksCondition;
+
+    vector<pair<asIScriptObject *, asIScriptFunction *>> m_parallel;
+
+    atomic<uint32_t> m_next;
+
+    uint32_t m_hash;
+
     bool m_inited;
+
+private:
+    friend class AngelTask;
+
 };
 
 #endif // ANGELSYSTEM_H
@@ -5,6 +5,47 @@
 
 class asIScriptObject;
 class asIScriptFunction;
+class asITypeInfo;
+
+class AngelClass {
+public:
+    struct Property {
+        const char *name;
+
+        uint32_t index;
+
+        bool isObject;
+
+        bool isScript;
+    };
+
+public:
+    explicit AngelClass(asITypeInfo *type);
+    ~AngelClass();
+
+    asITypeInfo *type;
+
+    MetaObject *metaObject;
+
+    vector<MetaProperty::Table> propertyTable;
+
+    vector<MetaMethod::Table> methodTable;
+
+    vector<Property> properties;
+
+    vector<asIScriptFunction *> slots;
+
+    asIScriptFunction *start;
+
+    asIScriptFunction *update;
+
+    asIScriptFunction *fixedUpdate;
+
+    size_t layout;
+
+    bool parallel;
+
+};
 
 class AngelBehaviour : public NativeBehaviour {
     A_PROPERTIES(
@@ -24,6 +65,9 @@ public:
 
     asIScriptFunction *scriptStart() const;
     asIScriptFunction *scriptUpdate() const;
+    asIScriptFunction *scriptFixedUpdate() const;
+
+    bool isParallel() const;
 
     void createObject();
 
@@ -33,13 +77,13 @@ public:
 
 private:
     friend class AngelSystem;
+    friend class AngelClass;
 
     static Object *construct() { return new AngelBehaviour(); }
 
     void updateMeta();
 
-    void setScriptStart(asIScriptFunction *function);
-    void setScriptUpdate(asIScriptFunction *function);
+    void copyState(asIScriptObject *object, const unordered_map<asIScriptObject *, asIScriptObject *> &objects);
 
     const MetaObject *metaObject() const override;
 
@@ -82,8 +126,6 @@ protected:
     string m_Script;
 
     list<pair<AngelBehaviour *, void *>> m_obsevers;
-    vector<MetaProperty::Table> m_propertyTable;
-    vector<MetaMethod::Table> m_methodTable;
 
     struct PropertyFields {
         Object *object;
@@ -96,10 +138,7 @@ protected:
 
     asIScriptObject *m_object;
 
-    asIScriptFunction *m_start;
-    asIScriptFunction *m_update;
-
-    MetaObject *m_metaObject;
+    const AngelClass *m_class;
 };
 
 #endif // ANGELBEHAVIOUR_H
@@ -88,8 +88,6 @@ protected:
     QStringList suffixes() const Q_DECL_OVERRIDE { return {"as"}; }
     QAbstractItemModel *classMap() const Q_DECL_OVERRIDE;
 
-    ReturnCode convertFile(AssetConverterSettings *settings) Q_DECL_OVERRIDE;
-
     AssetConverterSettings *createSettings() const Q_DECL_OVERRIDE;
 
     const QString persistentAsset() const Q_DECL_OVERRIDE;
@@ -103,8 +101,6 @@ protected:
 
     asIScriptEngine *m_scriptEngine;
 
-    QString m_Destination;
-
     AngelClassMapModel *m_classModel;
 
 };
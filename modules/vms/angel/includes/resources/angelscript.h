@@ -7,11 +7,19 @@ class AngelScript : public Resource {
     A_REGISTER(AngelScript, Resource, Resources)
 
 public:
+    AngelScript();
+
     void loadUserData (const VariantMap &data) override;
     VariantMap saveUserData() const override;
 
+    static uint32_t bundleVersion();
+
     ByteArray m_Array;
 
+    uint32_t m_Version;
+
+    uint32_t m_Hash;
+
 };
 
 #endif // ANGELMODULE_H
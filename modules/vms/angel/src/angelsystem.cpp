@@ -3,6 +3,7 @@
 #include <assert.h>
 
 #include <log.h>
+#include <threadpool.h>
 
 #include <angelscript.h>
 
@@ -25,6 +26,7 @@
 
 #include <cstring>
 #include <algorithm>
+#include <unordered_set>
 
 #include "resources/angelscript.h"
 
@@ -32,6 +34,13 @@
 
 #define TEMPALTE "AngelBinary"
 #define URI "thor://Components/"
+#define PARALLEL "IParallel"
+
+#define GRAIN 16
+
+namespace {
+    const char *gThreads("angel.threads");
+};
 
 class AngelStream : public asIBinaryStream {
 public:
@@ -56,12 +65,76 @@ protected:
     uint32_t m_Offset;
 };
 
+class AngelTask : public Object {
+public:
+    enum State {
+        Idle,
+        Queued,
+        Running,
+        Cancelled
+    };
+
+    AngelTask(AngelSystem *system, asIScriptContext *context) :
+            m_system(system),
+            m_context(context),
+            m_state(Idle) {
+
+    }
+
+    ~AngelTask() {
+        m_context->Release();
+    }
+
+    void processEvents() override {
+        int expected = Queued;
+        if(m_state.compare_exchange_strong(expected, Running)) {
+            process();
+
+            // Pool threads aren't owned by the script engine, so the thread state must not outlive the task
+            asThreadCleanup();
+        }
+
+        {
+            unique_lock<mutex> locker(m_system->m_tasksMutex);
+            m_state = Idle;
+        }
+        m_system->m_tasksCondition.notify_all();
+    }
+
+    void process() {
+        PROFILE_FUNCTION();
+
+        AngelSystem *s = m_system;
+        uint32_t size = s->m_parallel.size();
+        while(true) {
+            uint32_t begin = s->m_next.fetch_add(GRAIN);
+            if(begin >= size) {
+                break;
+            }
+            uint32_t end = std::min(begin + GRAIN, size);
+            for(uint32_t i = begin; i < end; i++) {
+                auto &it = s->m_parallel[i];
+                AngelSystem::execute(m_context, it.first, it.second);
+            }
+        }
+    }
+
+    AngelSystem *m_system;
+
+    asIScriptContext *m_context;
+
+    atomic<int> m_state;
+
+};
+
 AngelSystem::AngelSystem(Engine *engine) :
         System(),
         m_scriptEngine(nullptr),
         m_scriptModule(nullptr),
         m_context(nullptr),
         m_script(nullptr),
+        m_next(0),
+        m_hash(0),
         m_inited(false) {
     PROFILE_FUNCTION();
 
@@ -77,6 +150,25 @@ AngelSystem::~AngelSystem() {
 
     deleteAllObjects();
 
+    // Cancelled tasks can be still queued, the engine pool is drained at the end of each frame
+    if(Engine::threadPool()) {
+        unique_lock<mutex> locker(m_tasksMutex);
+        m_tasksCondition.wait(locker, [this]() {
+            for(auto it : m_tasks) {
+                if(it->m_state != AngelTask::Idle) {
+                    return false;
+                }
+            }
+            return true;
+        });
+    }
+
+    for(auto it : m_tasks) {
+        delete it;
+    }
+
+    releaseClasses(true);
+
     if(m_context) {
         m_context->Release();
     }
@@ -92,15 +184,36 @@ AngelSystem::~AngelSystem() {
     AngelBehaviour::unregisterClassFactory(this);
 }
 
+/*!
+    Initializes the script engine.
+    Behaviours which implement the \c IParallel interface are updated on \c angel.threads threads (0 means the optimal thread count for the current system), each thread executes the scripts with its own context.
+    The work is shared with the engine thread pool, so the number of threads is also limited by the pool size.
+*/
 bool AngelSystem::init() {
     PROFILE_FUNCTION();
     if(!m_inited) {
+        asPrepareMultithread();
+
         m_scriptEngine = asCreateScriptEngine();
 
         int32_t r = m_scriptEngine->SetMessageCallback(asFUNCTION(messageCallback), nullptr, asCALL_CDECL);
         if(r >= 0) {
             m_context = m_scriptEngine->CreateContext();
 
+            int threads = Engine::value(gThreads, 0).toInt();
+            if(threads <= 0) {
+                threads = ThreadPool::optimalThreadCount();
+            }
+            ThreadPool *pool = Engine::threadPool();
+            if(pool) {
+                threads = std::min(threads, static_cast<int>(pool->maxThreads()) + 1);
+            }
+            if(pool && threads > 1) {
+                for(int i = 0; i < threads; i++) {
+                    m_tasks.push_back(new AngelTask(this, m_scriptEngine->CreateContext()));
+                }
+            }
+
             registerClasses(m_scriptEngine);
 
             reload();
@@ -127,6 +240,10 @@ void AngelSystem::update(World *world) {
                                 execute(object, component->scriptStart());
                                 component->setStarted(true);
                             }
+                            if(component->isParallel() && !m_tasks.empty()) {
+                                m_parallel.push_back(make_pair(object, component->scriptUpdate()));
+                                continue;
+                            }
                             execute(object, component->scriptUpdate());
                         }
                     }
@@ -134,6 +251,38 @@ void AngelSystem::update(World *world) {
                 object->Release();
             }
         }
+
+        executeParallel();
+    }
+}
+
+void AngelSystem::fixedUpdate(World *world) {
+    PROFILE_FUNCTION();
+
+    if(Engine::isGameMode()) {
+        for(auto it : m_objectList) {
+            AngelBehaviour *component = static_cast<AngelBehaviour *>(it);
+            if(component->scriptFixedUpdate() == nullptr || !component->isStarted() || !component->isEnabled()) {
+                continue;
+            }
+            asIScriptObject *object = component->scriptObject();
+            if(object) {
+                Actor *actor = component->actor();
+                if(actor) {
+                    Scene *scene = actor->scene();
+                    if(scene && scene->parent() == world) {
+                        if(component->isParallel() && !m_tasks.empty()) {
+                            m_parallel.push_back(make_pair(object, component->scriptFixedUpdate()));
+                            continue;
+                        }
+                        execute(object, component->scriptFixedUpdate());
+                    }
+                }
+                object->Release();
+            }
+        }
+
+        executeParallel();
     }
 }
 
@@ -141,25 +290,43 @@ int AngelSystem::threadPolicy() const {
     return Pool;
 }
 
+/*!
+    Loads the script bundle and replaces the script objects of all behaviours with the new versions.
+    Nothing happens if the bundle was not changed since the last load.
+*/
 void AngelSystem::reload() {
     PROFILE_FUNCTION();
 
-    unload();
-    m_scriptModule = m_scriptEngine->GetModule("AngelData", asGM_CREATE_IF_NOT_EXISTS);
-
-    if(Engine::isResourceExist(TEMPALTE)) {
+    bool exist = Engine::isResourceExist(TEMPALTE);
+    if(exist) {
         if(m_script) {
             Engine::reloadResource(TEMPALTE);
         } else {
             m_script = Engine::loadResource<AngelScript>(TEMPALTE);
         }
-    } else {
+
+        if(m_script && m_scriptModule && m_script->m_Hash != 0 && m_script->m_Hash == m_hash) {
+            return;
+        }
+    }
+
+    unload();
+    m_scriptModule = m_scriptEngine->GetModule("AngelData", asGM_CREATE_IF_NOT_EXISTS);
+    m_hash = 0;
+
+    if(!exist) {
         return;
     }
 
     if(m_script) {
+        if(m_script->m_Version != 0 && m_script->m_Version != AngelScript::bundleVersion()) {
+            Log(Log::ERR) << __FUNCTION__ << "Incompatible script bundle version" << m_script->m_Version << "the scripts must be rebuilt";
+            return;
+        }
+
         AngelStream stream(m_script->m_Array);
         m_scriptModule->LoadByteCode(&stream);
+        m_hash = m_script->m_Hash;
 
         for(uint32_t i = 0; i < m_scriptModule->GetObjectTypeCount(); i++) {
             asITypeInfo *info = m_scriptModule->GetObjectTypeByIndex(i);
@@ -214,34 +381,102 @@ void AngelSystem::reload() {
                 factoryAdd(info->GetName(), string(URI) + info->GetName(), AngelBehaviour::metaClass());
             }
         }
-        for(auto it : m_objectList) {
-            AngelBehaviour *behaviour = static_cast<AngelBehaviour *>(it);
-            VariantMap data = behaviour->saveUserData();
-            behaviour->createObject();
-            behaviour->loadUserData(data);
-        }
+        swapObjects();
     } else {
         Log(Log::ERR) << __FUNCTION__ << "Filed to load a script";
     }
 }
 
 void *AngelSystem::execute(asIScriptObject *object, asIScriptFunction *func) {
+    return execute(m_context, object, func);
+}
+/*!
+    Executes the script function \a func for the \a object within the script \a context.
+    Returns the address of the returned value.
+*/
+void *AngelSystem::execute(asIScriptContext *context, asIScriptObject *object, asIScriptFunction *func) {
     PROFILE_FUNCTION();
 
     if(func) {
-        m_context->Prepare(func);
+        context->Prepare(func);
         if(object) {
-            m_context->SetObject(object);
+            context->SetObject(object);
         }
-        if(m_context->Execute() == asEXECUTION_EXCEPTION) {
+        if(context->Execute() == asEXECUTION_EXCEPTION) {
             int column;
-            m_context->GetExceptionLineNumber(&column);
-            Log(Log::ERR) << __FUNCTION__ << "Unhandled Exception:" << m_context->GetExceptionString() << m_context->GetExceptionFunction()->GetName() << "Line:" << column;
+            context->GetExceptionLineNumber(&column);
+            Log(Log::ERR) << __FUNCTION__ << "Unhandled Exception:" << context->GetExceptionString() << context->GetExceptionFunction()->GetName() << "Line:" << column;
         }
     } else {
         return nullptr;
     }
-    return m_context->GetAddressOfReturnValue();
+    return context->GetAddressOfReturnValue();
+}
+/*!
+    \internal
+    Executes the collected calls of the parallel behaviours on the worker threads.
+    The calling thread takes part in the execution and returns only when all calls are done, so the behaviours never run concurrently with the rendering.
+    The helper tasks run on the engine thread pool, which may be occupied by the systems including this one.
+    The calling thread takes all the work which the helpers didn't pick up, so it never waits for the tasks which haven't started.
+*/
+void AngelSystem::executeParallel() {
+    PROFILE_FUNCTION();
+
+    if(m_parallel.empty()) {
+        return;
+    }
+
+    m_next = 0;
+
+    ThreadPool *pool = Engine::threadPool();
+    uint32_t tasks = std::min(static_cast<uint32_t>((m_parallel.size() + GRAIN - 1) / GRAIN), static_cast<uint32_t>(m_tasks.size()));
+    for(uint32_t i = 1; i < tasks && pool; i++) {
+        AngelTask *task = m_tasks[i];
+        // The task could be still in the pool queue after the previous cancellation
+        int expected = AngelTask::Idle;
+        if(task->m_state.compare_exchange_strong(expected, AngelTask::Queued)) {
+            pool->start(*task);
+        }
+    }
+    m_tasks[0]->process();
+
+    for(uint32_t i = 1; i < m_tasks.size(); i++) {
+        int expected = AngelTask::Queued;
+        m_tasks[i]->m_state.compare_exchange_strong(expected, AngelTask::Cancelled);
+    }
+    {
+        unique_lock<mutex> locker(m_tasksMutex);
+        m_tasksCondition.wait(locker, [this]() {
+            for(auto it : m_tasks) {
+                if(it->m_state == AngelTask::Running) {
+                    return false;
+                }
+            }
+            return true;
+        });
+    }
+
+    for(auto &it : m_parallel) {
+        it.first->Release();
+    }
+    m_parallel.clear();
+}
+
+/*!
+    Returns the shared reflection data for the script class \a info.
+    The data is collected on the first request and reused by all instances of the class.
+*/
+const AngelClass *AngelSystem::scriptClass(asITypeInfo *info) {
+    PROFILE_FUNCTION();
+
+    auto it = m_classes.find(info);
+    if(it != m_classes.end()) {
+        return it->second;
+    }
+
+    AngelClass *result = new AngelClass(info);
+    m_classes[info] = result;
+    return result;
 }
 
 asIScriptModule *AngelSystem::module() const {
@@ -256,6 +491,83 @@ asIScriptContext *AngelSystem::context() const {
     return m_context;
 }
 
+/*!
+    \internal
+    Replaces the script objects of all behaviours with the instances of the newly loaded classes.
+    The classes which keep the same property layout receive the full state of the previous objects, including the private properties.
+    The classes with a changed layout restore only the public properties by name.
+*/
+void AngelSystem::swapObjects() {
+    PROFILE_FUNCTION();
+
+    unordered_map<asIScriptObject *, asIScriptObject *> objects;
+    list<pair<AngelBehaviour *, asIScriptObject *>> copies;
+    list<asIScriptObject *> previous;
+
+    for(auto it : m_objectList) {
+        AngelBehaviour *behaviour = static_cast<AngelBehaviour *>(it);
+        asIScriptObject *object = behaviour->m_object;
+        if(object) {
+            object->AddRef();
+            previous.push_back(object);
+        }
+
+        const AngelClass *current = behaviour->m_class;
+        asITypeInfo *type = m_scriptModule->GetTypeInfoByDecl(behaviour->script().c_str());
+        if(object && current && type && scriptClass(type)->layout == current->layout) {
+            behaviour->createObject();
+            if(behaviour->m_object) {
+                copies.push_back(make_pair(behaviour, object));
+            }
+        } else {
+            VariantMap data = behaviour->saveUserData();
+            behaviour->createObject();
+            behaviour->loadUserData(data);
+        }
+
+        if(object && behaviour->m_object) {
+            objects[object] = behaviour->m_object;
+        }
+    }
+
+    // The handles can be redirected only when all objects are recreated
+    for(auto &it : copies) {
+        it.first->copyState(it.second, objects);
+    }
+
+    for(auto it : previous) {
+        it->Release();
+    }
+
+    releaseClasses(false);
+}
+/*!
+    \internal
+    Releases the cached script classes which are not used by any behaviour or \a all of them.
+    The lookups which are cached by the MetaObjects of the classes are invalidated first.
+*/
+void AngelSystem::releaseClasses(bool all) {
+    Actor::invalidateComponents();
+    World::hierarchyChanged();
+
+    unordered_set<const AngelClass *> used;
+    if(!all) {
+        for(auto it : m_objectList) {
+            used.insert(static_cast<AngelBehaviour *>(it)->m_class);
+        }
+    }
+
+    auto it = m_classes.begin();
+    while(it != m_classes.end()) {
+        if(used.find(it->second) == used.end()) {
+            delete it->second;
+            it = m_classes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 bool AngelSystem::isBehaviour(asITypeInfo *info) const {
     asITypeInfo *super = info->GetBaseType();
     if(super) {
@@ -325,6 +637,7 @@ void AngelSystem::registerClasses(asIScriptEngine *engine) {
     }
 
     engine->RegisterInterface("IBehaviour");
+    engine->RegisterInterface(PARALLEL);
     engine->RegisterObjectMethod("AngelBehaviour",
                                  "void setScriptObject(IBehaviour @)",
                                  asMETHOD(AngelBehaviour, setScriptObject),
@@ -348,10 +661,10 @@ void AngelSystem::bindMetaType(asIScriptEngine *engine, const MetaType::Table &t
     if(typeName[strlen(typeName) - 1] != '*') {
         const MetaObject *meta;
 
-        const MetaObject metaStruct (MetaObject(typeName, nullptr, nullptr,
-                                     reinterpret_cast<const MetaMethod::Table *>(table.methods),
-                                     reinterpret_cast<const MetaProperty::Table *>(table.properties),
-                                     reinterpret_cast<const MetaEnum::Table *>(table.enums)));
+        const MetaObject metaStruct(typeName, nullptr, nullptr,
+                                    reinterpret_cast<const MetaMethod::Table *>(table.methods),
+                                    reinterpret_cast<const MetaProperty::Table *>(table.properties),
+                                    reinterpret_cast<const MetaEnum::Table *>(table.enums));
 
         auto factory = System::metaFactory(typeName);
         if(factory) {
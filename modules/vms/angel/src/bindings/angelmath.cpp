@@ -1,6 +1,7 @@
 #include "bindings/angelbindings.h"
 
 #include <angelscript.h>
+#include <scriptarray/scriptarray.h>
 
 #include <amath.h>
 
@@ -8,10 +9,6 @@ static void vec2(Vector2 *dest) {
     new (dest) Vector2();
 }
 
-static void deleteVec2(Vector2 *dest) {
-    (reinterpret_cast<Vector2 *>(dest))->~Vector2();
-}
-
 static void new2Float2(float x, float y, Vector2 *dest) {
     new (dest) Vector2(x, y);
 }
@@ -20,33 +17,13 @@ static void new1Float2(float value, Vector2 *dest) {
     new (dest) Vector2(value);
 }
 
-static float vec2GetX(Vector2 *dest) {
-    return dest->x;
-}
-
-static void vec2SetX(float value, Vector2 *dest) {
-    dest->x = value;
-}
-
-static float vec2GetY(Vector2 *dest) {
-    return dest->y;
-}
-
-static void vec2SetY(float value, Vector2 *dest) {
-    dest->y = value;
-}
-
 void registerVector2(asIScriptEngine *engine) {
-    engine->RegisterObjectType("Vector2", sizeof(Vector2), asOBJ_VALUE | asOBJ_APP_CLASS_CDAK);
+    engine->RegisterObjectType("Vector2", sizeof(Vector2), asOBJ_VALUE | asOBJ_POD | asOBJ_APP_CLASS_ALLFLOATS | asGetTypeTraits<Vector2>());
 
     engine->RegisterObjectBehaviour("Vector2", asBEHAVE_CONSTRUCT, "void f()", asFUNCTION(vec2), asCALL_CDECL_OBJLAST);
     engine->RegisterObjectBehaviour("Vector2", asBEHAVE_CONSTRUCT, "void f(float)", asFUNCTION(new1Float2), asCALL_CDECL_OBJLAST);
     engine->RegisterObjectBehaviour("Vector2", asBEHAVE_CONSTRUCT, "void f(float, float)", asFUNCTION(new2Float2), asCALL_CDECL_OBJLAST);
 
-    engine->RegisterObjectBehaviour("Vector2", asBEHAVE_DESTRUCT,  "void f()", asFUNCTION(deleteVec2),  asCALL_CDECL_OBJLAST);
-
-    engine->RegisterObjectMethod("Vector2", "Vector2 &opAssign(const Vector2 &in)", asMETHODPR(Vector2, operator=, (const Vector2&), Vector2&), asCALL_THISCALL);
-
     engine->RegisterObjectMethod("Vector2", "bool opEquals(const Vector2 &in)", asMETHOD(Vector2, operator==), asCALL_THISCALL);
 
     engine->RegisterObjectMethod("Vector2", "bool opCmp(const Vector2 &in)", asMETHOD(Vector2, operator>), asCALL_THISCALL);
@@ -69,24 +46,17 @@ void registerVector2(asIScriptEngine *engine) {
     engine->RegisterObjectMethod("Vector2", "float length()", asMETHOD(Vector2, length), asCALL_THISCALL);
     engine->RegisterObjectMethod("Vector2", "float sqrLength()", asMETHOD(Vector2, sqrLength), asCALL_THISCALL);
     engine->RegisterObjectMethod("Vector2", "float normalize()", asMETHOD(Vector2, normalize), asCALL_THISCALL);
-    engine->RegisterObjectMethod("Vector2", "Vector2 &cross(const Vector2 &in)", asMETHOD(Vector2, cross), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Vector2", "float cross(const Vector2 &in)", asMETHOD(Vector2, cross), asCALL_THISCALL);
     engine->RegisterObjectMethod("Vector2", "float dot(const Vector2 &in)", asMETHOD(Vector2, dot), asCALL_THISCALL);
 
-    engine->RegisterObjectMethod("Vector2", "float get_x()", asFUNCTION(vec2GetX), asCALL_CDECL_OBJLAST);
-    engine->RegisterObjectMethod("Vector2", "void set_x(float)", asFUNCTION(vec2SetX), asCALL_CDECL_OBJLAST);
-
-    engine->RegisterObjectMethod("Vector2", "float get_y()", asFUNCTION(vec2GetY), asCALL_CDECL_OBJLAST);
-    engine->RegisterObjectMethod("Vector2", "void set_y(float)", asFUNCTION(vec2SetY), asCALL_CDECL_OBJLAST);
+    engine->RegisterObjectProperty("Vector2", "float x", asOFFSET(Vector2, x));
+    engine->RegisterObjectProperty("Vector2", "float y", asOFFSET(Vector2, y));
 }
 
 static void vec3(Vector3 *dest) {
     new (dest) Vector3();
 }
 
-static void deleteVec3(Vector3 *dest) {
-    (reinterpret_cast<Vector3 *>(dest))->~Vector3();
-}
-
 static void new3Float3(float x, float y, float z, Vector3 *dest) {
     new (dest) Vector3(x, y, z);
 }
@@ -99,41 +69,13 @@ static void newVec2Float3(const Vector2 &in, float z, Vector3 *dest) {
     new (dest) Vector3(in, z);
 }
 
-static float vec3GetX(Vector3 *dest) {
-    return dest->x;
-}
-
-static void vec3SetX(float value, Vector3 *dest) {
-    dest->x = value;
-}
-
-static float vec3GetY(Vector3 *dest) {
-    return dest->y;
-}
-
-static void vec3SetY(float value, Vector3 *dest) {
-    dest->y = value;
-}
-
-static float vec3GetZ(Vector3 *dest) {
-    return dest->z;
-}
-
-static void vec3SetZ(float value, Vector3 *dest) {
-    dest->z = value;
-}
-
 void registerVector3(asIScriptEngine *engine) {
-    engine->RegisterObjectType("Vector3", sizeof(Vector3), asOBJ_VALUE | asOBJ_APP_CLASS_CDAK);
+    engine->RegisterObjectType("Vector3", sizeof(Vector3), asOBJ_VALUE | asOBJ_POD | asOBJ_APP_CLASS_ALLFLOATS | asGetTypeTraits<Vector3>());
     engine->RegisterObjectBehaviour("Vector3", asBEHAVE_CONSTRUCT, "void f()", asFUNCTION(vec3), asCALL_CDECL_OBJLAST);
     engine->RegisterObjectBehaviour("Vector3", asBEHAVE_CONSTRUCT, "void f(float)", asFUNCTION(new1Float3), asCALL_CDECL_OBJLAST);
     engine->RegisterObjectBehaviour("Vector3", asBEHAVE_CONSTRUCT, "void f(float, float, float)", asFUNCTION(new3Float3), asCALL_CDECL_OBJLAST);
     engine->RegisterObjectBehaviour("Vector3", asBEHAVE_CONSTRUCT, "void f(const Vector2 &in, float)", asFUNCTION(newVec2Float3), asCALL_CDECL_OBJLAST);
 
-    engine->RegisterObjectBehaviour("Vector3", asBEHAVE_DESTRUCT,  "void f()", asFUNCTION(deleteVec3),  asCALL_CDECL_OBJLAST);
-
-    engine->RegisterObjectMethod("Vector3", "Vector3 &opAssign(const Vector3 &in)", asMETHODPR(Vector3, operator=, (const Vector3&), Vector3&), asCALL_THISCALL);
-
     engine->RegisterObjectMethod("Vector3", "bool opEquals(const Vector3 &in)", asMETHOD(Vector3, operator==), asCALL_THISCALL);
 
     engine->RegisterObjectMethod("Vector3", "bool opCmp(const Vector3 &in)", asMETHOD(Vector3, operator>), asCALL_THISCALL);
@@ -156,30 +98,21 @@ void registerVector3(asIScriptEngine *engine) {
     engine->RegisterObjectMethod("Vector3", "float length()", asMETHOD(Vector3, length), asCALL_THISCALL);
     engine->RegisterObjectMethod("Vector3", "float sqrLength()", asMETHOD(Vector3, sqrLength), asCALL_THISCALL);
     engine->RegisterObjectMethod("Vector3", "float normalize()", asMETHOD(Vector3, normalize), asCALL_THISCALL);
-    engine->RegisterObjectMethod("Vector3", "Vector3 &cross(const Vector3 &in)", asMETHOD(Vector3, cross), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Vector3", "Vector3 cross(const Vector3 &in)", asMETHOD(Vector3, cross), asCALL_THISCALL);
     engine->RegisterObjectMethod("Vector3", "float dot(const Vector3 &in)", asMETHOD(Vector3, dot), asCALL_THISCALL);
 
     engine->RegisterObjectMethod("Vector3", "float angle(const Vector3 &in)", asMETHOD(Vector3, angle), asCALL_THISCALL);
     engine->RegisterObjectMethod("Vector3", "float signedAngle(const Vector3 &in, const Vector3 &in)", asMETHOD(Vector3, signedAngle), asCALL_THISCALL);
 
-    engine->RegisterObjectMethod("Vector3", "float get_x()", asFUNCTION(vec3GetX), asCALL_CDECL_OBJLAST);
-    engine->RegisterObjectMethod("Vector3", "void set_x(float)", asFUNCTION(vec3SetX), asCALL_CDECL_OBJLAST);
-
-    engine->RegisterObjectMethod("Vector3", "float get_y()", asFUNCTION(vec3GetY), asCALL_CDECL_OBJLAST);
-    engine->RegisterObjectMethod("Vector3", "void set_y(float)", asFUNCTION(vec3SetY), asCALL_CDECL_OBJLAST);
-
-    engine->RegisterObjectMethod("Vector3", "float get_z()", asFUNCTION(vec3GetZ), asCALL_CDECL_OBJLAST);
-    engine->RegisterObjectMethod("Vector3", "void set_z(float)", asFUNCTION(vec3SetZ), asCALL_CDECL_OBJLAST);
+    engine->RegisterObjectProperty("Vector3", "float x", asOFFSET(Vector3, x));
+    engine->RegisterObjectProperty("Vector3", "float y", asOFFSET(Vector3, y));
+    engine->RegisterObjectProperty("Vector3", "float z", asOFFSET(Vector3, z));
 }
 
 static void vec4(Vector4 *dest) {
     new (dest) Vector4();
 }
 
-static void deleteVec4(Vector4 *dest) {
-    (reinterpret_cast<Vector4 *>(dest))->~Vector4();
-}
-
 static void new4Float4(float x, float y, float z, float w, Vector4 *dest) {
     new (dest) Vector4(x, y, z, w);
 }
@@ -196,50 +129,14 @@ static void newVec3Float4(const Vector3 &in, float w, Vector4 *dest) {
     new (dest) Vector4(in, w);
 }
 
-static float vec4GetX(Vector4 *dest) {
-    return dest->x;
-}
-
-static void vec4SetX(float value, Vector4 *dest) {
-    dest->x = value;
-}
-
-static float vec4GetY(Vector4 *dest) {
-    return dest->y;
-}
-
-static void vec4SetY(float value, Vector4 *dest) {
-    dest->y = value;
-}
-
-static float vec4GetZ(Vector4 *dest) {
-    return dest->z;
-}
-
-static void vec4SetZ(float value, Vector4 *dest) {
-    dest->z = value;
-}
-
-static float vec4GetW(Vector4 *dest) {
-    return dest->w;
-}
-
-static void vec4SetW(float value, Vector4 *dest) {
-    dest->w = value;
-}
-
 void registerVector4(asIScriptEngine *engine) {
-    engine->RegisterObjectType("Vector4", sizeof(Vector4), asOBJ_VALUE | asOBJ_APP_CLASS_CDAK);
+    engine->RegisterObjectType("Vector4", sizeof(Vector4), asOBJ_VALUE | asOBJ_POD | asOBJ_APP_CLASS_ALLFLOATS | asGetTypeTraits<Vector4>());
     engine->RegisterObjectBehaviour("Vector4", asBEHAVE_CONSTRUCT, "void f()", asFUNCTION(vec4), asCALL_CDECL_OBJLAST);
     engine->RegisterObjectBehaviour("Vector4", asBEHAVE_CONSTRUCT, "void f(float)", asFUNCTION(new1Float4), asCALL_CDECL_OBJLAST);
     engine->RegisterObjectBehaviour("Vector4", asBEHAVE_CONSTRUCT, "void f(float, float, float, float)", asFUNCTION(new4Float4), asCALL_CDECL_OBJLAST);
     engine->RegisterObjectBehaviour("Vector4", asBEHAVE_CONSTRUCT, "void f(const Vector2 &in, float, float)", asFUNCTION(newVec2Float4), asCALL_CDECL_OBJLAST);
     engine->RegisterObjectBehaviour("Vector4", asBEHAVE_CONSTRUCT, "void f(const Vector3 &in, float)", asFUNCTION(newVec3Float4), asCALL_CDECL_OBJLAST);
 
-    engine->RegisterObjectBehaviour("Vector4", asBEHAVE_DESTRUCT,  "void f()", asFUNCTION(deleteVec4),  asCALL_CDECL_OBJLAST);
-
-    engine->RegisterObjectMethod("Vector4", "Vector4 &opAssign(const Vector4 &in)", asMETHODPR(Vector4, operator=, (const Vector4&), Vector4&), asCALL_THISCALL);
-
     engine->RegisterObjectMethod("Vector4", "bool opEquals(const Vector4 &in)", asMETHOD(Vector4, operator==), asCALL_THISCALL);
 
     engine->RegisterObjectMethod("Vector4", "bool opCmp(const Vector4 &in)", asMETHOD(Vector4, operator>), asCALL_THISCALL);
@@ -264,35 +161,20 @@ void registerVector4(asIScriptEngine *engine) {
     engine->RegisterObjectMethod("Vector4", "float normalize()", asMETHOD(Vector4, normalize), asCALL_THISCALL);
     engine->RegisterObjectMethod("Vector4", "float dot(const Vector4 &in)", asMETHOD(Vector4, dot), asCALL_THISCALL);
 
-    engine->RegisterObjectMethod("Vector4", "float get_x()", asFUNCTION(vec4GetX), asCALL_CDECL_OBJLAST);
-    engine->RegisterObjectMethod("Vector4", "void set_x(float)", asFUNCTION(vec4SetX), asCALL_CDECL_OBJLAST);
-
-    engine->RegisterObjectMethod("Vector4", "float get_y()", asFUNCTION(vec4GetY), asCALL_CDECL_OBJLAST);
-    engine->RegisterObjectMethod("Vector4", "void set_y(float)", asFUNCTION(vec4SetY), asCALL_CDECL_OBJLAST);
-
-    engine->RegisterObjectMethod("Vector4", "float get_z()", asFUNCTION(vec4GetZ), asCALL_CDECL_OBJLAST);
-    engine->RegisterObjectMethod("Vector4", "void set_z(float)", asFUNCTION(vec4SetZ), asCALL_CDECL_OBJLAST);
-
-    engine->RegisterObjectMethod("Vector4", "float get_w()", asFUNCTION(vec4GetW), asCALL_CDECL_OBJLAST);
-    engine->RegisterObjectMethod("Vector4", "void set_w(float)", asFUNCTION(vec4SetW), asCALL_CDECL_OBJLAST);
+    engine->RegisterObjectProperty("Vector4", "float x", asOFFSET(Vector4, x));
+    engine->RegisterObjectProperty("Vector4", "float y", asOFFSET(Vector4, y));
+    engine->RegisterObjectProperty("Vector4", "float z", asOFFSET(Vector4, z));
+    engine->RegisterObjectProperty("Vector4", "float w", asOFFSET(Vector4, w));
 }
 
 static void mat3(Matrix3 *dest) {
     new (dest) Matrix3();
 }
 
-static void deleteMat3(Matrix3 *dest) {
-    (reinterpret_cast<Matrix3 *>(dest))->~Matrix3();
-}
-
 void registerMatrix3(asIScriptEngine *engine) {
-    engine->RegisterObjectType("Matrix3", sizeof(Matrix3), asOBJ_VALUE | asOBJ_APP_CLASS_CDAK);
+    engine->RegisterObjectType("Matrix3", sizeof(Matrix3), asOBJ_VALUE | asOBJ_POD | asOBJ_APP_CLASS_ALLFLOATS | asGetTypeTraits<Matrix3>());
 
     engine->RegisterObjectBehaviour("Matrix3", asBEHAVE_CONSTRUCT, "void f()", asFUNCTION(mat3), asCALL_CDECL_OBJLAST);
-    engine->RegisterObjectBehaviour("Matrix3", asBEHAVE_DESTRUCT,  "void f()", asFUNCTION(deleteMat3),  asCALL_CDECL_OBJLAST);
-
-    engine->RegisterObjectMethod("Matrix3", "Matrix3 &opAssign(const Matrix3 &in)", asMETHODPR(Matrix3, operator=, (const Matrix3&), Matrix3&), asCALL_THISCALL);
-
     engine->RegisterObjectMethod("Matrix3", "bool opEquals(const Matrix3 &in)", asMETHOD(Matrix3, operator==), asCALL_THISCALL);
 
     engine->RegisterObjectMethod("Matrix3", "Matrix3 opMul(float)", asMETHODPR(Matrix3, operator*, (areal) const, Matrix3), asCALL_THISCALL);
@@ -329,18 +211,10 @@ static void mat4(Matrix4 *dest) {
     new (dest) Matrix4();
 }
 
-static void deleteMat4(Matrix4 *dest) {
-    (reinterpret_cast<Matrix4 *>(dest))->~Matrix4();
-}
-
 void registerMatrix4(asIScriptEngine *engine) {
-    engine->RegisterObjectType("Matrix4", sizeof(Matrix4), asOBJ_VALUE | asOBJ_APP_CLASS_CDAK);
+    engine->RegisterObjectType("Matrix4", sizeof(Matrix4), asOBJ_VALUE | asOBJ_POD | asOBJ_APP_CLASS_ALLFLOATS | asGetTypeTraits<Matrix4>());
 
     engine->RegisterObjectBehaviour("Matrix4", asBEHAVE_CONSTRUCT, "void f()", asFUNCTION(mat4), asCALL_CDECL_OBJLAST);
-    engine->RegisterObjectBehaviour("Matrix4", asBEHAVE_DESTRUCT,  "void f()", asFUNCTION(deleteMat4),  asCALL_CDECL_OBJLAST);
-
-    engine->RegisterObjectMethod("Matrix4", "Matrix4 &opAssign(const Matrix4 &in)", asMETHODPR(Matrix4, operator=, (const Matrix4&), Matrix4&), asCALL_THISCALL);
-
     engine->RegisterObjectMethod("Matrix4", "bool opEquals(const Matrix4 &in)", asMETHOD(Matrix4, operator==), asCALL_THISCALL);
 
     engine->RegisterObjectMethod("Matrix4", "Matrix4 opMul(float)", asMETHODPR(Matrix4, operator*, (areal) const, Matrix4), asCALL_THISCALL);
@@ -383,10 +257,6 @@ static void quat(Quaternion *dest) {
     new (dest) Quaternion();
 }
 
-static void deleteQuat(Quaternion *dest) {
-    (reinterpret_cast<Quaternion *>(dest))->~Quaternion();
-}
-
 static void quatAxis(const Vector3 &dir, areal angle, Quaternion *dest) {
     new (dest) Quaternion(dir, angle);
 }
@@ -400,17 +270,13 @@ static void quatMat(const Matrix3 &matrix, Quaternion *dest) {
 }
 
 void registerQuaternion(asIScriptEngine *engine) {
-    engine->RegisterObjectType("Quaternion", sizeof(Quaternion), asOBJ_VALUE | asOBJ_APP_CLASS_CDAK);
+    engine->RegisterObjectType("Quaternion", sizeof(Quaternion), asOBJ_VALUE | asOBJ_POD | asOBJ_APP_CLASS_ALLFLOATS | asGetTypeTraits<Quaternion>());
 
     engine->RegisterObjectBehaviour("Quaternion", asBEHAVE_CONSTRUCT, "void f()", asFUNCTION(quat), asCALL_CDECL_OBJLAST);
     engine->RegisterObjectBehaviour("Quaternion", asBEHAVE_CONSTRUCT, "void f(const Vector3 &in, float)", asFUNCTION(quatAxis), asCALL_CDECL_OBJLAST);
     engine->RegisterObjectBehaviour("Quaternion", asBEHAVE_CONSTRUCT, "void f(const Vector3 &in)", asFUNCTION(quatEuler), asCALL_CDECL_OBJLAST);
     engine->RegisterObjectBehaviour("Quaternion", asBEHAVE_CONSTRUCT, "void f(const Matrix3 &in)", asFUNCTION(quatMat), asCALL_CDECL_OBJLAST);
 
-    engine->RegisterObjectBehaviour("Quaternion", asBEHAVE_DESTRUCT,  "void f()", asFUNCTION(deleteQuat),  asCALL_CDECL_OBJLAST);
-
-    engine->RegisterObjectMethod("Quaternion", "Quaternion &opAssign(const Quaternion &in)", asMETHODPR(Quaternion, operator=, (const Quaternion&), Quaternion&), asCALL_THISCALL);
-
     engine->RegisterObjectMethod("Quaternion", "bool opEquals(const Quaternion &in)", asMETHOD(Quaternion, operator==), asCALL_THISCALL);
 
     engine->RegisterObjectMethod("Quaternion", "Vector3 opMul(const Vector3 &in)", asMETHODPR(Quaternion, operator*, (const Vector3 &) const, Vector3), asCALL_THISCALL);
@@ -422,6 +288,11 @@ void registerQuaternion(asIScriptEngine *engine) {
     engine->RegisterObjectMethod("Quaternion", "void mix(const Quaternion &in, const Quaternion &in, float)", asMETHOD(Quaternion, mix), asCALL_THISCALL);
     engine->RegisterObjectMethod("Quaternion", "Matrix3 toMatrix()", asMETHOD(Quaternion, toMatrix), asCALL_THISCALL);
     engine->RegisterObjectMethod("Quaternion", "Vector3 euler()", asMETHOD(Quaternion, euler), asCALL_THISCALL);
+
+    engine->RegisterObjectProperty("Quaternion", "float x", asOFFSET(Quaternion, x));
+    engine->RegisterObjectProperty("Quaternion", "float y", asOFFSET(Quaternion, y));
+    engine->RegisterObjectProperty("Quaternion", "float z", asOFFSET(Quaternion, z));
+    engine->RegisterObjectProperty("Quaternion", "float w", asOFFSET(Quaternion, w));
 }
 
 static void aabb(AABBox *dest) {
@@ -555,6 +426,48 @@ void registerRay(asIScriptEngine *engine) {
     engine->RegisterObjectMethod("Ray", "Ray diffuse(const Vector3 &in, const Vector3 &in, float, float)", asMETHOD(Ray, diffuse), asCALL_THISCALL);
 }
 
+static void transformPoints(const Matrix4 &matrix, CScriptArray *points) {
+    for(asUINT i = 0; i < points->GetSize(); i++) {
+        Vector3 *point = static_cast<Vector3 *>(points->At(i));
+        *point = matrix * (*point);
+    }
+}
+
+static void rotateVectors(const Quaternion &rotation, CScriptArray *vectors) {
+    for(asUINT i = 0; i < vectors->GetSize(); i++) {
+        Vector3 *vector = static_cast<Vector3 *>(vectors->At(i));
+        *vector = rotation * (*vector);
+    }
+}
+
+static Vector3 lerpVec3(const Vector3 &a, const Vector3 &b, float factor) {
+    return MIX(a, b, factor);
+}
+
+static float lerpFloat(float a, float b, float factor) {
+    return MIX(a, b, factor);
+}
+
+static void lerpVec3Array(const CScriptArray *a, const CScriptArray *b, float factor, CScriptArray *result) {
+    asUINT size = MIN(a->GetSize(), b->GetSize());
+    result->Resize(size);
+    for(asUINT i = 0; i < size; i++) {
+        const Vector3 *from = static_cast<const Vector3 *>(a->At(i));
+        const Vector3 *to = static_cast<const Vector3 *>(b->At(i));
+        *static_cast<Vector3 *>(result->At(i)) = MIX(*from, *to, factor);
+    }
+}
+
+static void lerpFloatArray(const CScriptArray *a, const CScriptArray *b, float factor, CScriptArray *result) {
+    asUINT size = MIN(a->GetSize(), b->GetSize());
+    result->Resize(size);
+    for(asUINT i = 0; i < size; i++) {
+        const float from = *static_cast<const float *>(a->At(i));
+        const float to = *static_cast<const float *>(b->At(i));
+        *static_cast<float *>(result->At(i)) = MIX(from, to, factor);
+    }
+}
+
 int randomInt(int min, int max) {
     return min + (dist(mt) % (max - min + 1));
 }
@@ -583,4 +496,13 @@ void registerMath(asIScriptEngine *engine) {
     engine->RegisterGlobalFunction("void seed(int)", asFUNCTION(srand), asCALL_CDECL);
     engine->RegisterGlobalFunction("int irand(int, int)", asFUNCTION(randomInt), asCALL_CDECL);
     engine->RegisterGlobalFunction("float frand(float, float)", asFUNCTION(randomFloat), asCALL_CDECL);
+
+    engine->RegisterGlobalFunction("float lerp(float, float, float)", asFUNCTION(lerpFloat), asCALL_CDECL);
+    engine->RegisterGlobalFunction("Vector3 lerp(const Vector3 &in, const Vector3 &in, float)", asFUNCTION(lerpVec3), asCALL_CDECL);
+
+    // Batch helpers process the whole array with one native call
+    engine->RegisterGlobalFunction("void transformPoints(const Matrix4 &in, array<Vector3> &)", asFUNCTION(transformPoints), asCALL_CDECL);
+    engine->RegisterGlobalFunction("void rotateVectors(const Quaternion &in, array<Vector3> &)", asFUNCTION(rotateVectors), asCALL_CDECL);
+    engine->RegisterGlobalFunction("void lerp(const array<float> &, const array<float> &, float, array<float> &)", asFUNCTION(lerpFloatArray), asCALL_CDECL);
+    engine->RegisterGlobalFunction("void lerp(const array<Vector3> &, const array<Vector3> &, float, array<Vector3> &)", asFUNCTION(lerpVec3Array), asCALL_CDECL);
 }
@@ -4,12 +4,22 @@
 
 #include <timer.h>
 
+#include <chrono>
+
+static double clockTime() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 void registerTimer(asIScriptEngine *engine) {
     engine->SetDefaultNamespace("Timer");
 
     engine->RegisterGlobalFunction("float deltaTime()", asFUNCTION(Timer::deltaTime), asCALL_CDECL);
     engine->RegisterGlobalFunction("float scale()", asFUNCTION(Timer::scale), asCALL_CDECL);
     engine->RegisterGlobalFunction("void setScale(float)", asFUNCTION(Timer::setScale), asCALL_CDECL);
+    engine->RegisterGlobalFunction("float time()", asFUNCTION(Timer::time), asCALL_CDECL);
+    engine->RegisterGlobalFunction("float fixedDeltaTime()", asFUNCTION(Timer::fixedDeltaTime), asCALL_CDECL);
+    engine->RegisterGlobalFunction("float interpolation()", asFUNCTION(Timer::interpolation), asCALL_CDECL);
+    engine->RegisterGlobalFunction("double clock()", asFUNCTION(clockTime), asCALL_CDECL);
 
     engine->SetDefaultNamespace("");
 }
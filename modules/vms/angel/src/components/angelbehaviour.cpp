@@ -13,12 +13,136 @@
 
 #define RESOURCE "Resource"
 #define GENERAL "General"
+#define PARALLEL "IParallel"
+
+static hash<string> hash_str;
+
+/*!
+    \class AngelClass
+    \brief The AngelClass class contains the reflection data of a script class shared between all its instances.
+    \inmodule Angel
+
+    The meta object, property and method tables and the script functions are collected once per class, so creating a new script instance doesn't require the lookups by name.
+    The layout hash describes the names and types of all properties and allows to transfer the state between two versions of the same class on hot reload.
+*/
+
+AngelClass::AngelClass(asITypeInfo *info) :
+        type(info),
+        metaObject(nullptr),
+        start(nullptr),
+        update(nullptr),
+        fixedUpdate(nullptr),
+        layout(0),
+        parallel(false) {
+    PROFILE_FUNCTION();
+
+    type->AddRef();
+
+    asIScriptEngine *engine = type->GetEngine();
+
+    start = type->GetMethodByDecl("void start()");
+    update = type->GetMethodByDecl("void update()");
+
+    fixedUpdate = type->GetMethodByDecl("void fixedUpdate()");
+    if(fixedUpdate && strcmp(fixedUpdate->GetObjectName(), "Behaviour") == 0) {
+        fixedUpdate = nullptr; // Skip an empty base implementation
+    }
+
+    asITypeInfo *parallelInterface = engine->GetTypeInfoByName(PARALLEL);
+    parallel = (parallelInterface && type->Implements(parallelInterface));
+
+    string signature(type->GetName());
+
+    uint32_t count = type->GetPropertyCount();
+    for(uint32_t i = 0; i < count; i++) {
+        const char *name;
+        int typeId;
+        bool isPrivate;
+        bool isProtected;
+        type->GetProperty(i, &name, &typeId, &isPrivate, &isProtected);
+
+        signature += ';';
+        signature += engine->GetTypeDeclaration(typeId, true);
+        signature += ' ';
+        signature += name;
+
+        if(!isPrivate && !isProtected) {
+            uint32_t metaType = 0;
+            Property property = {name, i, false, false};
+            if(typeId > asTYPEID_DOUBLE) {
+                asITypeInfo *info = engine->GetTypeInfoById(typeId);
+                if(info) {
+                    metaType = MetaType::type(info->GetName());
+                    if(info->GetFlags() & asOBJ_REF) {
+                        metaType++;
+                    }
+
+                    auto factory = System::metaFactory(info->GetName());
+                    if(factory) {
+                        property.isObject = true;
+                    }
+
+                    if(info->GetFlags() & asOBJ_SCRIPT_OBJECT) {
+                        property.isScript = true;
+                    }
+                }
+            } else {
+                switch(typeId) {
+                case asTYPEID_VOID:   metaType = MetaType::INVALID; break;
+                case asTYPEID_BOOL:   metaType = MetaType::BOOLEAN; break;
+                case asTYPEID_INT8:
+                case asTYPEID_INT16:
+                case asTYPEID_INT32:
+                case asTYPEID_INT64:
+                case asTYPEID_UINT8:
+                case asTYPEID_UINT16:
+                case asTYPEID_UINT32:
+                case asTYPEID_UINT64: metaType = MetaType::INTEGER; break;
+                case asTYPEID_FLOAT:
+                case asTYPEID_DOUBLE: metaType = MetaType::FLOAT; break;
+                default: break;
+                }
+            }
+            MetaType::Table *table = MetaType::table(metaType);
+            if(table) {
+                properties.push_back(property);
+                propertyTable.push_back({name, table, nullptr, nullptr, nullptr, nullptr, nullptr,
+                                         &Reader<decltype(&AngelBehaviour::readProperty), &AngelBehaviour::readProperty>::read,
+                                         &Writer<decltype(&AngelBehaviour::writeProperty), &AngelBehaviour::writeProperty>::write});
+            }
+        }
+    }
+    propertyTable.push_back({nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr});
+
+    layout = hash_str(signature);
+
+    count = type->GetMethodCount();
+    for(uint32_t m = 0; m < count; m++) {
+        asIScriptFunction *method = type->GetMethodByIndex(m);
+        if(method) {
+            string name(method->GetName());
+            if(name.size() > 2 && name[0] == 'o' && name[1] == 'n') { // this is a slot
+                methodTable.push_back(A_SLOTEX(AngelBehaviour::scriptSlot, method->GetName()));
+                slots.push_back(type->GetMethodByDecl((string("void ") + name + "()").c_str()));
+            }
+        }
+    }
+    methodTable.push_back({MetaMethod::Method, nullptr, nullptr, nullptr, 0, nullptr});
+
+    metaObject = new MetaObject(type->GetName(),
+                                AngelBehaviour::metaClass(), &AngelBehaviour::construct,
+                                &methodTable[0], &propertyTable[0], nullptr);
+}
+
+AngelClass::~AngelClass() {
+    delete metaObject;
+
+    type->Release();
+}
 
 AngelBehaviour::AngelBehaviour() :
         m_object(nullptr),
-        m_start(nullptr),
-        m_update(nullptr),
-        m_metaObject(nullptr) {
+        m_class(nullptr) {
     PROFILE_FUNCTION();
 }
 
@@ -51,6 +175,7 @@ void AngelBehaviour::createObject() {
         m_object->Release();
         m_object = nullptr;
     }
+    m_class = nullptr;
 
     AngelSystem *ptr = static_cast<AngelSystem *>(system());
     asITypeInfo *type = ptr->module()->GetTypeInfoByDecl(m_Script.c_str());
@@ -101,123 +226,121 @@ void AngelBehaviour::setScriptObject(asIScriptObject *object) {
             if(m_Script.empty()) {
                 m_Script = info->GetName();
             }
-            m_start = info->GetMethodByDecl("void start()");
-            m_update = info->GetMethodByDecl("void update()");
+            m_class = static_cast<AngelSystem *>(system())->scriptClass(info);
 
             updateMeta();
         }
         notifyObservers();
     }
 }
-
+/*!
+    \internal
+    Binds the properties of the script object to the cached class tables.
+*/
 void AngelBehaviour::updateMeta() {
     PROFILE_FUNCTION();
-    delete m_metaObject;
-    m_propertyTable.clear();
-    m_methodTable.clear();
     m_propertyAdresses.clear();
 
-    const MetaObject *super = AngelBehaviour::metaClass();
-    asIScriptEngine *engine = m_object->GetEngine();
+    for(auto &it : m_class->properties) {
+        PropertyFields propertyFields;
+        propertyFields.isScript = it.isScript;
+        propertyFields.isObject = it.isObject;
+        propertyFields.object = nullptr;
+        propertyFields.address = m_object->GetAddressOfProperty(it.index);
+        m_propertyAdresses[it.name] = propertyFields;
+    }
+}
 
-    asITypeInfo *info = m_object->GetObjectType();
-    uint32_t count = info->GetPropertyCount();
-    for(uint32_t i = 0; i <= count; i++) {
-        if(i == count) {
-            m_propertyTable.push_back({nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr});
-        } else {
-            const char *name;
-            int typeId;
-            bool isPrivate;
-            bool isProtected;
-            info->GetProperty(i, &name, &typeId, &isPrivate, &isProtected);
-            if(!isPrivate && !isProtected) {
-                uint32_t metaType = 0;
-                PropertyFields propertyFields;
-                propertyFields.isScript = false;
-                propertyFields.isObject = false;
-                propertyFields.object = nullptr;
-                propertyFields.address = nullptr;
-                if(typeId > asTYPEID_DOUBLE) {
-                    asITypeInfo *type = engine->GetTypeInfoById(typeId);
-                    if(type) {
-                        metaType = MetaType::type(type->GetName());
-                        if(type->GetFlags() & asOBJ_REF) {
-                            metaType++;
-                        }
+/*!
+    \internal
+    Copies the state of all properties from the previous version of the script \a object with the same layout.
+    Handles to the script objects are redirected to the new versions of these objects from the \a objects map or reset if the target was not reloaded.
+*/
+void AngelBehaviour::copyState(asIScriptObject *object, const unordered_map<asIScriptObject *, asIScriptObject *> &objects) {
+    PROFILE_FUNCTION();
+    asIScriptEngine *engine = m_object->GetEngine();
 
-                        auto factory = System::metaFactory(type->GetName());
-                        if(factory) {
-                            propertyFields.isObject = true;
-                        }
+    // The first property is the reference to this component
+    for(uint32_t i = 1; i < m_object->GetPropertyCount(); i++) {
+        int typeId = m_object->GetPropertyTypeId(i);
+        void *src = object->GetAddressOfProperty(i);
+        void *dst = m_object->GetAddressOfProperty(i);
+
+        if(typeId & asTYPEID_OBJHANDLE) {
+            asITypeInfo *info = engine->GetTypeInfoById(typeId);
+            void *value = *reinterpret_cast<void **>(src);
+            if(value && (info->GetFlags() & asOBJ_SCRIPT_OBJECT)) {
+                auto it = objects.find(static_cast<asIScriptObject *>(value));
+                value = (it != objects.end()) ? it->second : nullptr;
+            }
 
-                        if(type->GetFlags() & asOBJ_SCRIPT_OBJECT) {
-                            propertyFields.isScript = true;
-                        }
-                    }
-                } else {
-                    switch(typeId) {
-                    case asTYPEID_VOID:   metaType = MetaType::INVALID; break;
-                    case asTYPEID_BOOL:   metaType = MetaType::BOOLEAN; break;
-                    case asTYPEID_INT8:
-                    case asTYPEID_INT16:
-                    case asTYPEID_INT32:
-                    case asTYPEID_INT64:
-                    case asTYPEID_UINT8:
-                    case asTYPEID_UINT16:
-                    case asTYPEID_UINT32:
-                    case asTYPEID_UINT64: metaType = MetaType::INTEGER; break;
-                    case asTYPEID_FLOAT:
-                    case asTYPEID_DOUBLE: metaType = MetaType::FLOAT; break;
-                    default: break;
-                    }
-                }
-                MetaType::Table *table = MetaType::table(metaType);
-                if(table) {
-                    propertyFields.address = m_object->GetAddressOfProperty(i);
-                    m_propertyAdresses[name] = propertyFields;
-                    m_propertyTable.push_back({name, table, nullptr, nullptr, nullptr, nullptr, nullptr,
-                                               &Reader<decltype(&AngelBehaviour::readProperty), &AngelBehaviour::readProperty>::read,
-                                               &Writer<decltype(&AngelBehaviour::writeProperty), &AngelBehaviour::writeProperty>::write});
-                }
+            void *current = *reinterpret_cast<void **>(dst);
+            if(current) {
+                engine->ReleaseScriptObject(current, info);
             }
+            if(value) {
+                engine->AddRefScriptObject(value, info);
+            }
+            memcpy(dst, &value, sizeof(value));
+        } else if(typeId & asTYPEID_MASK_OBJECT) {
+            asITypeInfo *info = engine->GetTypeInfoById(typeId);
+            // Values of the script types belong to the previous module and can't be copied
+            if(info && info->GetModule() == nullptr) {
+                engine->AssignScriptObject(dst, src, info);
+            }
+        } else {
+            memcpy(dst, src, engine->GetSizeOfPrimitiveType(typeId));
         }
     }
 
-    count = info->GetMethodCount();
-    for(uint32_t m = 0; m <= count; m++) {
-        if(m == count) {
-            m_methodTable.push_back({MetaMethod::Method, nullptr, nullptr, nullptr, 0, nullptr});
-        } else {
-            asIScriptFunction *method = info->GetMethodByIndex(m);
-            if(method) {
-                string name(method->GetName());
-                if(name.size() > 2 && name[0] == 'o' && name[1] == 'n') { // this is a slot
-                    m_methodTable.push_back(A_SLOTEX(AngelBehaviour::scriptSlot, method->GetName()));
-                }
+    for(auto &it : m_propertyAdresses) {
+        if(it.second.isObject) {
+            Object *reference = *reinterpret_cast<Object **>(it.second.address);
+            it.second.object = reference;
+            if(reference) {
+                disconnect(reference, _SIGNAL(destroyed()), this, _SLOT(onReferenceDestroyed()));
+                connect(reference, _SIGNAL(destroyed()), this, _SLOT(onReferenceDestroyed()));
+            }
+        } else if(it.second.isScript) {
+            asIScriptObject *reference = *reinterpret_cast<asIScriptObject **>(it.second.address);
+            AngelBehaviour *behaviour = (reference) ? reinterpret_cast<AngelBehaviour *>(reference->GetUserData()) : nullptr;
+            it.second.object = behaviour;
+            if(behaviour) {
+                behaviour->subscribe(this, it.second.address);
             }
         }
     }
-
-    m_metaObject = new MetaObject(m_Script.c_str(),
-                                   super, &AngelBehaviour::construct,
-                                   &m_methodTable[0], &m_propertyTable[0], nullptr);
 }
 
 asIScriptFunction *AngelBehaviour::scriptStart() const {
     PROFILE_FUNCTION();
-    return m_start;
+    return (m_class) ? m_class->start : nullptr;
 }
 
 asIScriptFunction *AngelBehaviour::scriptUpdate() const {
     PROFILE_FUNCTION();
-    return m_update;
+    return (m_class) ? m_class->update : nullptr;
+}
+
+asIScriptFunction *AngelBehaviour::scriptFixedUpdate() const {
+    PROFILE_FUNCTION();
+    return (m_class) ? m_class->fixedUpdate : nullptr;
+}
+
+/*!
+    Returns true if the script class implements the IParallel interface; otherwise returns false.
+    The update() and fixedUpdate() methods of such behaviours are executed on the worker threads in parallel with other parallel behaviours.
+    The script must only modify its own Actor and must not create or destroy objects in these methods.
+*/
+bool AngelBehaviour::isParallel() const {
+    PROFILE_FUNCTION();
+    return (m_class) ? m_class->parallel : false;
 }
 
 const MetaObject *AngelBehaviour::metaObject() const {
     PROFILE_FUNCTION();
-    if(m_metaObject) {
-        return m_metaObject;
+    if(m_class) {
+        return m_class->metaObject;
     }
     return AngelBehaviour::metaClass();
 }
@@ -245,7 +368,10 @@ void AngelBehaviour::loadData(const VariantList &data) {
 VariantMap AngelBehaviour::saveUserData() const {
     PROFILE_FUNCTION();
     VariantMap result;
-    for(auto it : m_propertyTable) {
+    if(m_class == nullptr) {
+        return result;
+    }
+    for(auto it : m_class->propertyTable) {
         if(it.name) {
             Variant value = MetaProperty(&it).read(this);
 
@@ -275,7 +401,10 @@ VariantMap AngelBehaviour::saveUserData() const {
 
 void AngelBehaviour::loadUserData(const VariantMap &data) {
     PROFILE_FUNCTION();
-    for(auto it : m_propertyTable) {
+    if(m_class == nullptr) {
+        return;
+    }
+    for(auto it : m_class->propertyTable) {
         if(it.name) {
             auto property = data.find(it.name);
             if(property != data.end()) {
@@ -386,19 +515,14 @@ void AngelBehaviour::writeProperty(const MetaProperty &property, const Variant v
 
 void AngelBehaviour::methodCallEvent(MethodCallEvent *event) {
     PROFILE_FUNCTION();
-    if(event && m_metaObject) {
-        MetaMethod method = m_metaObject->method(event->method());
-        if(method.isValid() && m_object) {
-            asITypeInfo *info = m_object->GetObjectType();
-            if(info) {
-                string signature("void ");
-                signature += method.signature();
-                asIScriptFunction *func = info->GetMethodByDecl(signature.c_str());
-                if(func) {
-                    AngelSystem *ptr = static_cast<AngelSystem *>(system());
-                    ptr->execute(m_object, func);
-                    return;
-                }
+    if(event && m_class) {
+        int32_t index = event->method() - m_class->metaObject->methodOffset();
+        if(index >= 0 && index < static_cast<int32_t>(m_class->slots.size()) && m_object) {
+            asIScriptFunction *func = m_class->slots[index];
+            if(func) {
+                AngelSystem *ptr = static_cast<AngelSystem *>(system());
+                ptr->execute(m_object, func);
+                return;
             }
         }
         Object::methodCallEvent(event);
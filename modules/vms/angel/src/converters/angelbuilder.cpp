@@ -5,6 +5,8 @@
 
 #include <angelscript.h>
 
+#include <editor/projectmanager.h>
+
 #include <QFile>
 #include <QFileInfo>
 #include <QImage>
@@ -16,6 +18,8 @@
 #define DATA    "Data"
 #define GET     "get_"
 
+static hash<string> hash_str;
+
 static QHash<uint32_t, QImage> itemIcons = {
     {AngelClassMapModel::AngelItem::Module,     QImage()},
     {AngelClassMapModel::AngelItem::Class,      QImage(":/Images/icons/class.png")},
@@ -106,13 +110,16 @@ bool AngelBuilder::buildProject() {
         }
 
         if(mod->Build() >= 0) {
-            QFile dst(m_Destination);
+            QFile dst(ProjectManager::instance()->importPath() + "/" + persistentUUID());
             if(dst.open( QIODevice::WriteOnly)) {
                 AngelScript serial;
                 serial.m_Array.clear();
                 CBytecodeStream stream(serial.m_Array);
                 mod->SaveByteCode(&stream);
 
+                serial.m_Version = AngelScript::bundleVersion();
+                serial.m_Hash = static_cast<uint32_t>(hash_str(string(serial.m_Array.begin(), serial.m_Array.end())));
+
                 ByteArray data = Bson::save( Engine::toVariant(&serial) );
                 dst.write(reinterpret_cast<const char *>(&data[0]), data.size());
                 dst.close();
@@ -134,15 +141,6 @@ QAbstractItemModel *AngelBuilder::classMap() const {
     return m_classModel;
 }
 
-AssetConverter::ReturnCode AngelBuilder::convertFile(AssetConverterSettings *settings) {
-    if(settings) {
-        QFileInfo info(settings->absoluteDestination());
-        m_Destination = info.absolutePath() + "/" + persistentUUID();
-    }
-
-    return CodeBuilder::convertFile(settings);
-}
-
 AssetConverterSettings *AngelBuilder::createSettings() const {
     return new AngelScriptImportSettings();
 }
@@ -1,12 +1,39 @@
 #include "resources/angelscript.h"
 
+#include <angelscript.h>
+
 #define DATA    "Data"
+#define VERSION "Version"
+#define HASH    "Hash"
+
+#define FORMAT_VERSION 2
+
+/*!
+    \class AngelScript
+    \brief The AngelScript resource contains the precompiled bytecode bundle of all project scripts.
+    \inmodule Angel
+
+    The bundle is stamped with the version of the format and the hash of the bytecode.
+    The version protects from loading a bundle produced by an incompatible script engine and the hash allows to skip the reload of the unchanged bundle.
+*/
+
+AngelScript::AngelScript() :
+        m_Version(0),
+        m_Hash(0) {
+
+}
 
 void AngelScript::loadUserData(const VariantMap &data) {
     auto it = data.find(DATA);
     if(it != data.end()) {
         m_Array = (*it).second.toByteArray();
     }
+    it = data.find(VERSION);
+    m_Version = (it != data.end()) ? static_cast<uint32_t>((*it).second.toInt()) : 0;
+
+    it = data.find(HASH);
+    m_Hash = (it != data.end()) ? static_cast<uint32_t>((*it).second.toInt()) : 0;
+
     setState(Ready);
 }
 
@@ -14,6 +41,14 @@ VariantMap AngelScript::saveUserData() const {
     VariantMap result;
 
     result[DATA] = m_Array;
+    result[VERSION] = static_cast<int32_t>(m_Version);
+    result[HASH] = static_cast<int32_t>(m_Hash);
 
     return result;
 }
+/*!
+    Returns the version of the bundle format supported by the current build.
+*/
+uint32_t AngelScript::bundleVersion() {
+    return ANGELSCRIPT_VERSION * 100 + FORMAT_VERSION;
+}
@@ -1,41 +1,62 @@
 #ifndef PROFILER
 #define PROFILER
 
-#ifdef PROFILING_ENABLED
+#include <stdint.h>
+#include <string>
+#include <vector>
 
-#include <thread>
-#include <unordered_map>
+#include "global.h"
 
-#include "engine.h"
-#include "timer.h"
+using namespace std;
 
 class NEXT_LIBRARY_EXPORT Profiler {
 public:
-    struct CallPoint {
+    enum EventType {
+        Scope,
+        Frame,
+        Counter
+    };
+
+    struct Event {
         const char *name;
 
-        TimePoint started;
+        uint64_t start;
+
+        uint64_t value;
+
+        uint32_t type;
 
-        TimePoint stoped;
+        uint32_t thread;
     };
 
 public:
-    Profiler(const char *name);
+    explicit Profiler(const char *name);
 
     ~Profiler();
 
+    static void frame();
+
     static uint32_t stat(const char *name);
 
     static void statAdd(const char *name, uint32_t value);
 
     static void statReset(const char *name);
 
+    static vector<Event> events();
+
+    static string traceJson();
+
+    static bool exportTrace(const string &path);
+
+    static string summary();
+
+    static uint64_t now();
+
 protected:
-    Profiler::CallPoint  m_current;
+    const char *m_name;
 
-};
+    uint64_t m_started;
 
-#endif
+};
 
 #endif // PROFILER
-
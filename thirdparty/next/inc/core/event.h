@@ -2,6 +2,7 @@
 #define EVENT_H
 
 #include <stdint.h>
+#include <cstddef>
 
 #include <global.h>
 
@@ -23,9 +24,17 @@ public:
 
     uint32_t type() const;
 
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr, size_t size);
+
 protected:
     uint32_t m_type;
 
+private:
+    friend class Object;
+
+    Event *m_next;
+
 };
 
 #endif // EVENT_H
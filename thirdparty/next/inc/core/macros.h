@@ -23,6 +23,12 @@
 #define _SIGNAL(a)  "1"#a
 #define _SLOT(a)    "2"#a
 
+#define _SIGNAL_ID(Class, a) \
+    []() { \
+        static const int32_t index = Class::metaClass()->indexOfSignal(#a); \
+        return index; \
+    }()
+
 #define REGISTER_META_TYPE(Class) \
     REGISTER_META_TYPE_IMPL(Class); \
     REGISTER_META_TYPE_IMPL(Class *);
@@ -151,6 +157,15 @@ public: \
     Invoker<decltype(&m)>::types(#r), \
 }
 
+#define A_METHODEX(r, m, s) { \
+    MetaMethod::Method, \
+    #m, \
+    (MetaMethod::Table::InvokeMem)&Invoker<s>::invoke<&m>, \
+    (MetaMethod::Table::AddressMem)&Invoker<s>::address<&m>, \
+    Invoker<s>::argCount(), \
+    Invoker<s>::types(#r), \
+}
+
 #define A_SIGNAL(m) { \
     MetaMethod::Signal, \
     #m, \
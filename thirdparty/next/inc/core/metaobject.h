@@ -2,6 +2,8 @@
 #define METAOBJECT_H
 
 #include <string>
+#include <mutex>
+#include <atomic>
 
 #include "metatype.h"
 #include "metaproperty.h"
@@ -18,10 +20,16 @@ public:
 
 public:
     explicit MetaObject(const char *, const MetaObject *, const Constructor, const MetaMethod::Table *, const MetaProperty::Table *, const MetaEnum::Table *);
+    ~MetaObject();
+
+    MetaObject(const MetaObject &) = delete;
+    MetaObject &operator=(const MetaObject &) = delete;
 
     const char *name() const;
     const MetaObject *super() const;
 
+    uint32_t index() const;
+
     Object *createInstance() const;
 
     int indexOfMethod(const char *) const;
@@ -45,6 +53,12 @@ public:
     int enumeratorOffset() const;
 
     bool canCastTo(const char *) const;
+    bool canCastTo(const MetaObject *) const;
+
+private:
+    struct Lookup;
+
+    const Lookup &lookup() const;
 
 private:
     Constructor m_constructor;
@@ -56,6 +70,13 @@ private:
     int m_methodCount;
     int m_propCount;
     int m_enumCount;
+    int m_methodOffset;
+    int m_propOffset;
+
+    mutable Lookup *m_lookup;
+    mutable once_flag m_lookupFlag;
+
+    mutable atomic<uint32_t> m_index;
 
 };
 
@@ -24,6 +24,9 @@
 #include <map>
 #include <queue>
 #include <list>
+#include <atomic>
+#include <memory>
+#include <type_traits>
 
 #include <global.h>
 
@@ -73,6 +76,9 @@ class NEXT_LIBRARY_EXPORT Object {
     A_METHODS(
         A_SIGNAL(Object::destroyed)
     )
+private:
+    class Liveness;
+
 public:
     struct Link {
         Link();
@@ -84,12 +90,16 @@ public:
         Object *receiver;
 
         int32_t method;
+
+        shared_ptr<Liveness> liveness;
     };
 
     typedef list<Object *> ObjectList;
 
     typedef list<Link> LinkList;
 
+    typedef shared_ptr<const LinkList> LinkListPtr;
+
 public:
     Object();
 
@@ -117,49 +127,51 @@ public:
 
     Object *find(const string &path) const;
 
-    template<typename T>
-    T findChild(bool recursive = true) {
+    template<typename Visitor>
+    bool visitChildren(Visitor &&visitor, bool recursive = true) {
         for(auto it : getChildren()) {
-            Object *object = it;
-            T result = dynamic_cast<T>(object);
-            if(result) {
-                return result;
-            } else if(recursive) {
-                T child = object->findChild<T>(recursive);
-                if(child) {
-                    return child;
-                }
+            if(!visitor(it)) {
+                return false;
+            }
+            if(recursive && !it->visitChildren(visitor, recursive)) {
+                return false;
             }
         }
-        return nullptr;
+        return true;
+    }
+
+    template<typename T>
+    T findChild(bool recursive = true) {
+        T result = nullptr;
+        visitChildren([&result](Object *object) {
+            result = objectCast<T>(object);
+            return (result == nullptr);
+        }, recursive);
+        return result;
     }
 
     template<typename T>
     list<T> findChildren(bool recursive = true) {
         list<T> result;
-        for(auto it : getChildren()) {
-            Object *child = it;
-            T object = dynamic_cast<T>(child);
-            if(object) {
-                result.push_back(object);
-            }
-
-            if(recursive) {
-                list<T> childs = child->findChildren<T>(recursive);
-                result.insert(result.end(), childs.begin(), childs.end());
+        visitChildren([&result](Object *object) {
+            T child = objectCast<T>(object);
+            if(child) {
+                result.push_back(child);
             }
-        }
+            return true;
+        }, recursive);
         return result;
     }
 
     void emitSignal(const char *signal, const Variant &args = Variant());
+    void emitSignal(int32_t signal, const Variant &args = Variant());
 
     static void enumObjects(Object *object, Object::ObjectList &list);
 
 // Virtual members
 public:
     virtual const ObjectList &getChildren() const;
-    virtual const LinkList &getReceivers() const;
+    virtual LinkListPtr getReceivers() const;
 
     virtual void setParent(Object *parent, int32_t position = -1, bool force = false);
     virtual string typeName() const;
@@ -198,7 +210,7 @@ protected:
     VariantList serializeData(const MetaObject *meta) const;
 
     virtual void addChild(Object *child, int32_t position = -1);
-    void removeChild(Object *child);
+    virtual void removeChild(Object *child);
 
     Object *sender() const;
 
@@ -207,21 +219,58 @@ protected:
 
     virtual void methodCallEvent(MethodCallEvent *event);
 
+private:
+    template<typename C>
+    static C *metaOwner(const MetaObject *(C::*)() const);
+
+    template<typename T>
+    static T objectCast(Object *object, true_type) {
+        return object->metaObject()->canCastTo(remove_pointer_t<T>::metaClass()) ? static_cast<T>(object) : nullptr;
+    }
+
+    template<typename T>
+    static T objectCast(Object *object, false_type) {
+        return dynamic_cast<T>(object);
+    }
+
+    template<typename T>
+    static T objectCast(Object *object) {
+        // Classes without own meta information are checked with RTTI
+        typedef remove_pointer_t<T> Type;
+        return objectCast<T>(object, is_same<decltype(metaOwner(&Type::metaObject)), Type *>());
+    }
+
+    class EventQueue {
+    public:
+        EventQueue();
+        EventQueue(const EventQueue &queue);
+
+        EventQueue &operator=(const EventQueue &queue);
+
+        atomic<Event *> head;
+
+        atomic<bool> pending;
+    };
+
 private:
     Object *m_parent;
 
     string m_name;
 
     Object::ObjectList m_children;
-    Object::LinkList m_recievers;
+    Object::LinkListPtr m_recievers;
     Object::LinkList m_senders;
 
     Object *m_currentSender;
 
-    queue<Event *> m_eventQueue;
+    Object::EventQueue m_eventQueue;
+
+    shared_ptr<Liveness> m_liveness;
 
     ObjectSystem *m_system;
 
+    Object *m_nextPending;
+
     uint32_t m_uuid;
     uint32_t m_cloned;
 
@@ -235,6 +284,16 @@ private:
 
     bool isLinkExist(const Object::Link &link) const;
 
+    LinkListPtr receivers() const;
+
+    void setReceivers(const LinkListPtr &list);
+
+    void schedulePending();
+
+    void resetPending();
+
+    bool isPending() const;
+
 };
 
 #endif // OBJECT_H
@@ -6,6 +6,9 @@
 #include <string>
 #include <memory>
 #include <thread>
+#include <atomic>
+#include <mutex>
+#include <vector>
 
 #include "object.h"
 
@@ -71,24 +74,39 @@ protected:
 
     virtual Object *instantiateObject(const MetaObject *meta, const string &name, Object *parent);
 
+    virtual void addObject(Object *object);
+
     virtual void removeObject(Object *object);
 
 private:
     friend class ObjectSystemTest;
     friend class Object;
 
-    void addObject(Object *object);
+    void schedule(Object *object);
+
+    void takePending();
+
+    static void indexUUID(Object *object, uint32_t previous);
 
-    void suspendObject(Object *object);
+    static void indexClone(Object *object, uint32_t previous);
+
+    static void unindexObject(Object *object);
 
 protected:
     Object::ObjectList m_objectList;
 
-    Object *m_suspendObject;
-
 
     thread::id m_threadId;
 
+private:
+    unordered_map<Object *, Object::ObjectList::iterator> m_objectIndex;
+
+    atomic<Object *> m_pendingObjects;
+
+    vector<Object *> m_activeObjects;
+
+    mutex m_activeMutex;
+
 };
 
 #endif // OBJECTSYSTEM_H
@@ -21,15 +21,19 @@
         #define PROFILE_STOP profiler::dumpBlocksToFile("profile.prof")
         #define PROFILER_STAT(x, y)
         #define PROFILER_RESET(label)
+        #define PROFILE_FRAME
+        #define PROFILER_SUMMARY ""
     #else
         #include <analytics/profiler.h>
 
-        #define PROFILE_BLOCK(name, ...)
-        #define PROFILE_FUNCTION(...) Profiler MARK(__FUNCTION__);
+        #define PROFILE_BLOCK(name, ...) Profiler _profilerBlock(name);
+        #define PROFILE_FUNCTION(...) Profiler _profilerFunction(__FUNCTION__);
         #define PROFILE_START
-        #define PROFILE_STOP
-        #define PROFILER_STAT(x, y)
-        #define PROFILER_RESET(label)
+        #define PROFILE_STOP Profiler::exportTrace("profile.json")
+        #define PROFILER_STAT(label, y) Profiler::statAdd(label, y)
+        #define PROFILER_RESET(label) Profiler::statReset(label)
+        #define PROFILE_FRAME Profiler::frame()
+        #define PROFILER_SUMMARY Profiler::summary().c_str()
     #endif
 #else
     #define PROFILE_BLOCK(name, ...)
@@ -38,6 +42,8 @@
     #define PROFILE_STOP
     #define PROFILER_STAT(label, y)
     #define PROFILER_RESET(label)
+    #define PROFILE_FRAME
+    #define PROFILER_SUMMARY ""
 #endif
 
 #define A_UNUSED(a) (void)a
@@ -1,34 +1,381 @@
 #include "analytics/profiler.h"
 
-#ifdef PROFILING_ENABLED
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <unordered_map>
+#include <algorithm>
 
-typedef list<Profiler::CallPoint>             CallsList;
-typedef unordered_map<thread::id, CallsList>  ThreadMap;
-typedef unordered_map<const char *, uint32_t> StatsMap;
+#define BUFFER_SIZE 16384 // Must be a power of two
+#define MAX_COUNTERS 256 // Must be a power of two
 
-static ThreadMap m_threads;
-static StatsMap  m_stats;
+#define TOP_SCOPES 20
+
+namespace {
+    const char *gFrame = "Frame";
+};
+
+/*
+    Single producer ring buffer, only the owning thread writes to it.
+    Each slot is guarded with a sequence number: the writer clears it before the update and publishes the event index after.
+    The readers copy the last BUFFER_SIZE events and drop the slots which were rewritten during the copy.
+*/
+class ThreadBuffer {
+public:
+    struct Slot {
+        std::atomic<uint64_t> sequence;
+
+        std::atomic<const char *> name;
+
+        std::atomic<uint64_t> start;
+
+        std::atomic<uint64_t> value;
+
+        std::atomic<uint32_t> type;
+
+        std::atomic<uint32_t> thread;
+    };
+
+    explicit ThreadBuffer(uint32_t id) :
+            m_head(0),
+            m_next(nullptr),
+            m_used(true),
+            m_id(id) {
+
+        for(auto &it : m_slots) {
+            it.sequence.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void push(const char *name, uint64_t start, uint64_t value, uint32_t type) {
+        uint64_t head = m_head.load(std::memory_order_relaxed);
+
+        Slot &slot = m_slots[head & (BUFFER_SIZE - 1)];
+        slot.sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.start.store(start, std::memory_order_relaxed);
+        slot.value.store(value, std::memory_order_relaxed);
+        slot.type.store(type, std::memory_order_relaxed);
+        slot.thread.store(m_id.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+        slot.sequence.store(head + 1, std::memory_order_release);
+        m_head.store(head + 1, std::memory_order_release);
+    }
+
+    void read(vector<Profiler::Event> &result) const {
+        uint64_t head = m_head.load(std::memory_order_acquire);
+        uint64_t first = (head > BUFFER_SIZE) ? head - BUFFER_SIZE : 0;
+
+        for(uint64_t i = first; i < head; i++) {
+            const Slot &slot = m_slots[i & (BUFFER_SIZE - 1)];
+            if(slot.sequence.load(std::memory_order_acquire) != i + 1) {
+                continue;
+            }
+
+            Profiler::Event event;
+            event.name = slot.name.load(std::memory_order_relaxed);
+            event.start = slot.start.load(std::memory_order_relaxed);
+            event.value = slot.value.load(std::memory_order_relaxed);
+            event.type = slot.type.load(std::memory_order_relaxed);
+            event.thread = slot.thread.load(std::memory_order_relaxed);
+
+            // The slot was taken by the writer during the copy
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if(slot.sequence.load(std::memory_order_relaxed) != i + 1) {
+                continue;
+            }
+
+            result.push_back(event);
+        }
+    }
+
+    Slot m_slots[BUFFER_SIZE];
+
+    std::atomic<uint64_t> m_head;
+
+    ThreadBuffer *m_next;
+
+    std::atomic<bool> m_used;
+
+    std::atomic<uint32_t> m_id;
+
+};
+
+/*
+    Releases the thread buffer on thread exit, so it can be taken by a new thread.
+    The buffer itself stays in the list because the readers can access it at any time.
+*/
+struct LocalBuffer {
+    ~LocalBuffer() {
+        if(buffer) {
+            buffer->m_used.store(false, std::memory_order_release);
+        }
+    }
+
+    ThreadBuffer *buffer = nullptr;
+
+};
+
+struct CounterSlot {
+    std::atomic<const char *> name;
+
+    std::atomic<uint32_t> value;
+};
+
+static std::atomic<ThreadBuffer *> s_threads(nullptr);
+static std::atomic<uint32_t> s_threadCount(0);
+
+static CounterSlot s_counters[MAX_COUNTERS];
+
+static std::atomic<uint64_t> s_lastFrame(0);
+static std::atomic<uint64_t> s_previousFrame(0);
+
+static ThreadBuffer *localBuffer() {
+    static thread_local LocalBuffer local;
+    if(local.buffer == nullptr) {
+        uint32_t id = s_threadCount.fetch_add(1);
+        // Reuse a buffer of the exited thread to keep the memory bounded by the number of alive threads
+        for(ThreadBuffer *it = s_threads.load(std::memory_order_acquire); it != nullptr; it = it->m_next) {
+            bool used = false;
+            if(it->m_used.compare_exchange_strong(used, true, std::memory_order_acq_rel)) {
+                it->m_id.store(id, std::memory_order_relaxed);
+                local.buffer = it;
+                return it;
+            }
+        }
+
+        ThreadBuffer *buffer = new ThreadBuffer(id);
+
+        // Buffers are never removed, so the lock-free push is enough
+        ThreadBuffer *head = s_threads.load(std::memory_order_relaxed);
+        do {
+            buffer->m_next = head;
+        } while(!s_threads.compare_exchange_weak(head, buffer, std::memory_order_release, std::memory_order_relaxed));
+
+        local.buffer = buffer;
+    }
+    return local.buffer;
+}
+
+static CounterSlot *findCounter(const char *name, bool create) {
+    uint32_t hash = 2166136261u;
+    for(const char *c = name; *c; c++) {
+        hash = (hash ^ static_cast<uint8_t>(*c)) * 16777619u;
+    }
+
+    for(uint32_t probe = 0; probe < MAX_COUNTERS; probe++) {
+        CounterSlot &slot = s_counters[(hash + probe) & (MAX_COUNTERS - 1)];
+
+        const char *current = slot.name.load(std::memory_order_acquire);
+        if(current == nullptr) {
+            if(!create) {
+                return nullptr;
+            }
+            if(slot.name.compare_exchange_strong(current, name, std::memory_order_acq_rel)) {
+                return &slot;
+            }
+        }
+        if(current == name || strcmp(current, name) == 0) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+static string escape(const char *name) {
+    string result;
+    for(const char *c = name; *c; c++) {
+        if(*c == '"' || *c == '\\') {
+            result.push_back('\\');
+        }
+        result.push_back(*c);
+    }
+    return result;
+}
+
+/*!
+    \class Profiler
+    \brief The Profiler class measures the execution time of the code scopes.
+    \since Next 1.0
+    \inmodule Analytics
+
+    Profiler object records the scope event from construction till destruction.
+    Usually it should be created with PROFILE_FUNCTION() or PROFILE_BLOCK() macros which do nothing without PROFILING_ENABLED definition.
+
+    Each thread writes events to the own lock-free ring buffer which keeps the last events only, so the profiling can stay enabled for the whole session.
+    Frame boundaries are marked with frame() call (PROFILE_FRAME macro), it also records the current values of the named counters.
+    Collected data can be exported in Chrome trace format with exportTrace() (chrome://tracing or Perfetto UI) or inspected with summary(), which the engine prints to the log every \c profiler.summary frames.
+*/
+
+/*!
+    Starts measurement of the scope with \a name.
+    \note The \a name must stay valid during the application lifetime, usually it's a string literal.
+*/
+Profiler::Profiler(const char *name) :
+        m_name(name),
+        m_started(now()) {
 
-Profiler::Profiler(const char *name) {
-    m_current.name = name;
-    m_current.started = std::chrono::high_resolution_clock::now();
 }
 
 Profiler::~Profiler() {
-    m_current.stoped = std::chrono::high_resolution_clock::now();
-    m_threads[this_thread::get_id()].push_back(m_current);
+    localBuffer()->push(m_name, m_started, now(), Scope);
 }
+/*!
+    Marks the beginning of a new frame and records the current values of all counters.
+*/
+void Profiler::frame() {
+    uint64_t time = now();
 
+    ThreadBuffer *buffer = localBuffer();
+    for(auto &it : s_counters) {
+        const char *name = it.name.load(std::memory_order_acquire);
+        if(name) {
+            buffer->push(name, time, it.value.load(std::memory_order_relaxed), Counter);
+        }
+    }
+    buffer->push(gFrame, time, 0, Frame);
+
+    s_previousFrame.store(s_lastFrame.exchange(time));
+}
+/*!
+    Returns the value of counter with \a name.
+*/
 uint32_t Profiler::stat(const char *name) {
-    return m_stats[name];
+    CounterSlot *slot = findCounter(name, false);
+    if(slot) {
+        return slot->value.load(std::memory_order_relaxed);
+    }
+    return 0;
 }
-
+/*!
+    Adds \a value to the counter with \a name.
+    This method is thread safe.
+*/
 void Profiler::statAdd(const char *name, uint32_t value) {
-    m_stats[name] += value;
+    CounterSlot *slot = findCounter(name, true);
+    if(slot) {
+        slot->value.fetch_add(value, std::memory_order_relaxed);
+    }
 }
-
+/*!
+    Resets the counter with \a name to zero.
+*/
 void Profiler::statReset(const char *name) {
-    m_stats[name] = 0;
+    CounterSlot *slot = findCounter(name, true);
+    if(slot) {
+        slot->value.store(0, std::memory_order_relaxed);
+    }
+}
+/*!
+    Returns a snapshot of recorded events for all threads.
+*/
+vector<Profiler::Event> Profiler::events() {
+    vector<Event> result;
+    for(ThreadBuffer *it = s_threads.load(std::memory_order_acquire); it != nullptr; it = it->m_next) {
+        it->read(result);
+    }
+    return result;
+}
+/*!
+    Returns recorded events in Chrome trace event JSON format.
+*/
+string Profiler::traceJson() {
+    string result("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    char buffer[64];
+    bool first = true;
+    for(auto &it : events()) {
+        result += (first) ? "\n" : ",\n";
+        first = false;
+
+        result += "{\"name\":\"" + escape(it.name) + "\",\"pid\":0,\"tid\":" + to_string(it.thread);
+        snprintf(buffer, sizeof(buffer), ",\"ts\":%.3f", it.start / 1000.0);
+        result += buffer;
+
+        switch(it.type) {
+        case Scope: {
+            snprintf(buffer, sizeof(buffer), ",\"ph\":\"X\",\"dur\":%.3f}", (it.value - it.start) / 1000.0);
+            result += buffer;
+        } break;
+        case Frame: {
+            result += ",\"ph\":\"i\",\"s\":\"g\"}";
+        } break;
+        default: {
+            result += ",\"ph\":\"C\",\"args\":{\"value\":" + to_string(it.value) + "}}";
+        } break;
+        }
+    }
+    result += "\n]}\n";
+
+    return result;
 }
+/*!
+    Writes recorded events in Chrome trace event format to the file with \a path.
+    Returns true on success; otherwise returns false.
+*/
+bool Profiler::exportTrace(const string &path) {
+    ofstream file(path, ios::out | ios::binary);
+    if(!file.is_open()) {
+        return false;
+    }
+    file << traceJson();
+    return file.good();
+}
+/*!
+    Returns a human readable statistic for the last complete frame.
+    It contains the most expensive scopes and values of the counters.
+*/
+string Profiler::summary() {
+    uint64_t begin = s_previousFrame.load();
+    uint64_t end = s_lastFrame.load();
+    if(begin == 0 || end <= begin) {
+        return string();
+    }
+
+    struct Total {
+        uint64_t time = 0;
+        uint32_t calls = 0;
+    };
+    unordered_map<string, Total> totals;
+    vector<pair<const char *, uint64_t>> counters;
+
+    for(auto &it : events()) {
+        if(it.type == Scope && it.start >= begin && it.start < end) {
+            Total &total = totals[it.name];
+            total.time += it.value - it.start;
+            total.calls++;
+        } else if(it.type == Counter && it.start == end) {
+            counters.push_back(make_pair(it.name, it.value));
+        }
+    }
+
+    vector<pair<string, Total>> sorted(totals.begin(), totals.end());
+    std::sort(sorted.begin(), sorted.end(), [](const pair<string, Total> &left, const pair<string, Total> &right) {
+        return left.second.time > right.second.time;
+    });
 
-#endif
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "Frame: %.3f ms\n", (end - begin) / 1000000.0);
+    string result(buffer);
+
+    for(size_t i = 0; i < sorted.size() && i < TOP_SCOPES; i++) {
+        snprintf(buffer, sizeof(buffer), "%10.3f ms %6u  %s\n", sorted[i].second.time / 1000000.0, sorted[i].second.calls, sorted[i].first.c_str());
+        result += buffer;
+    }
+    for(auto &it : counters) {
+        result += string(it.first) + ": " + to_string(it.second) + "\n";
+    }
+
+    return result;
+}
+/*!
+    Returns the number of nanoseconds since the first call of this method.
+*/
+uint64_t Profiler::now() {
+    static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count() + 1;
+}
@@ -1,4 +1,73 @@
 #include "core/event.h"
+
+#include <new>
+
+class EventPool {
+public:
+    enum {
+        Granularity = 32,
+        Classes = 8,
+        Capacity = 256
+    };
+
+    struct Block {
+        Block *next;
+    };
+
+    EventPool() {
+        for(int i = 0; i < Classes; i++) {
+            m_free[i] = nullptr;
+            m_count[i] = 0;
+        }
+    }
+
+    ~EventPool() {
+        for(int i = 0; i < Classes; i++) {
+            while(m_free[i]) {
+                Block *block = m_free[i];
+                m_free[i] = block->next;
+                ::operator delete(block);
+            }
+        }
+    }
+
+    void *allocate(size_t size) {
+        size_t index = (size - 1) / Granularity;
+        if(index >= Classes) {
+            return ::operator new(size);
+        }
+        Block *block = m_free[index];
+        if(block) {
+            m_free[index] = block->next;
+            m_count[index]--;
+            return block;
+        }
+        return ::operator new((index + 1) * Granularity);
+    }
+
+    void release(void *ptr, size_t size) {
+        size_t index = (size - 1) / Granularity;
+        if(index >= Classes || m_count[index] >= Capacity) {
+            ::operator delete(ptr);
+            return;
+        }
+        Block *block = static_cast<Block *>(ptr);
+        block->next = m_free[index];
+        m_free[index] = block;
+        m_count[index]++;
+    }
+
+    static EventPool &instance() {
+        static thread_local EventPool pool;
+        return pool;
+    }
+
+protected:
+    Block *m_free[Classes];
+
+    uint32_t m_count[Classes];
+
+};
 /*!
     \class Event
     \brief The Event class is the base calss for all event classes.
@@ -29,7 +98,8 @@
     Constructs an Event with \a type of event.
 */
 Event::Event(uint32_t type) :
-        m_type(type) {
+        m_type(type),
+        m_next(nullptr) {
     PROFILE_FUNCTION();
 }
 
@@ -44,3 +114,17 @@ uint32_t Event::type() const {
     PROFILE_FUNCTION();
     return m_type;
 }
+/*!
+    Allocates memory for an event of \a size bytes from the pool of the calling thread.
+    Events are posted at a high rate, the pool recycles the memory of processed events instead of the heap.
+    An event can be deleted on any thread, its memory is returned to the pool of the deleting thread.
+*/
+void *Event::operator new(size_t size) {
+    return EventPool::instance().allocate(size);
+}
+/*!
+    Returns the memory of an event of \a size bytes pointed by \a ptr to the pool of the calling thread.
+*/
+void Event::operator delete(void *ptr, size_t size) {
+    EventPool::instance().release(ptr, size);
+}
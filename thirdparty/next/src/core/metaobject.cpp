@@ -3,6 +3,59 @@
 #include "core/object.h"
 
 #include <cstring>
+#include <vector>
+#include <list>
+#include <algorithm>
+
+static inline uint32_t lookupHash(const char *key) {
+    uint32_t hash = 2166136261u;
+    for(const char *c = key; *c; c++) {
+        hash = (hash ^ static_cast<uint8_t>(*c)) * 16777619u;
+    }
+    return hash;
+}
+
+struct MetaObject::Lookup {
+    struct Entry {
+        uint32_t hash;
+
+        int32_t index;
+
+        const char *key;
+
+        int32_t type;
+    };
+
+    typedef vector<Entry> Entries;
+
+    static void add(Entries &entries, const char *key, int32_t index, int32_t type = -1) {
+        entries.push_back({lookupHash(key), index, key, type});
+    }
+
+    static void sort(Entries &entries) {
+        // Stable to keep the derived classes members before the overridden ones
+        stable_sort(entries.begin(), entries.end(), [](const Entry &left, const Entry &right) { return left.hash < right.hash; });
+    }
+
+    static int32_t find(const Entries &entries, const char *key, int32_t type = -1) {
+        uint32_t hash = lookupHash(key);
+        auto it = lower_bound(entries.begin(), entries.end(), hash, [](const Entry &entry, uint32_t value) { return entry.hash < value; });
+        for(; it != entries.end() && it->hash == hash; ++it) {
+            if((type == -1 || it->type == type) && strcmp(it->key, key) == 0) {
+                return it->index;
+            }
+        }
+        return -1;
+    }
+
+    Entries properties;
+
+    Entries methods;
+
+    Entries enums;
+
+    list<string> signatures;
+};
 /*!
     \class MetaObject
     \brief The MetaObject provides an interface to retrieve information about Object at runtime.
@@ -32,8 +85,16 @@ MetaObject::MetaObject(const char *name, const MetaObject *super, const Construc
         m_enums(enums),
         m_methodCount(0),
         m_propCount(0),
-        m_enumCount(0) {
+        m_enumCount(0),
+        m_methodOffset(0),
+        m_propOffset(0),
+        m_lookup(nullptr),
+        m_index(0) {
     PROFILE_FUNCTION();
+    if(m_super) {
+        m_methodOffset = m_super->m_methodOffset + m_super->m_methodCount;
+        m_propOffset = m_super->m_propOffset + m_super->m_propCount;
+    }
     while(methods && methods[m_methodCount].name) {
         m_methodCount++;
     }
@@ -44,6 +105,10 @@ MetaObject::MetaObject(const char *name, const MetaObject *super, const Construc
         m_enumCount++;
     }
 }
+
+MetaObject::~MetaObject() {
+    delete m_lookup;
+}
 /*!
     Returns the name of the object type.
 */
@@ -58,6 +123,23 @@ const MetaObject *MetaObject::super() const {
     PROFILE_FUNCTION();
     return m_super;
 }
+/*!
+    Returns the unique index of the object type.
+    The indices are assigned in the increasing order on the first request and never change, so only the requested types occupy the indices.
+    The index can be used as a key of the dense lookup tables.
+*/
+uint32_t MetaObject::index() const {
+    static atomic<uint32_t> s_next(1);
+
+    uint32_t result = m_index.load(memory_order_acquire);
+    if(result == 0) {
+        uint32_t next = s_next.fetch_add(1);
+        if(m_index.compare_exchange_strong(result, next, memory_order_acq_rel)) {
+            result = next;
+        }
+    }
+    return result - 1;
+}
 /*!
     Constructs and return a new instance of associated class.
 */
@@ -71,17 +153,7 @@ Object *MetaObject::createInstance() const {
 */
 int MetaObject::indexOfMethod(const char *signature) const {
     PROFILE_FUNCTION();
-    const MetaObject *s = this;
-
-    while(s) {
-        for(int i = 0; i < s->m_methodCount; ++i) {
-            if(MetaMethod(s->m_methods + i).signature() == signature) {
-                return i + s->methodOffset();
-            }
-        }
-        s = s->m_super;
-    }
-    return -1;
+    return Lookup::find(lookup().methods, signature);
 }
 /*!
     Returns index of class signal by provided \a signature; otherwise returns -1.
@@ -89,18 +161,7 @@ int MetaObject::indexOfMethod(const char *signature) const {
 */
 int MetaObject::indexOfSignal(const char *signature) const {
     PROFILE_FUNCTION();
-    const MetaObject *s = this;
-
-    while(s) {
-        for(int i = 0; i < s->m_methodCount; ++i) {
-            MetaMethod m(s->m_methods + i);
-            if(m.type() == MetaMethod::Signal && m.signature() == signature) {
-                return i + s->methodOffset();
-            }
-        }
-        s = s->m_super;
-    }
-    return -1;
+    return Lookup::find(lookup().methods, signature, MetaMethod::Signal);
 }
 /*!
     Returns index of class slot by provided \a signature; otherwise returns -1.
@@ -108,18 +169,7 @@ int MetaObject::indexOfSignal(const char *signature) const {
 */
 int MetaObject::indexOfSlot(const char *signature) const {
     PROFILE_FUNCTION();
-    const MetaObject *s = this;
-
-    while(s) {
-        for(int i = 0; i < s->m_methodCount; ++i) {
-            MetaMethod m(s->m_methods + i);
-            if(m.type() == MetaMethod::Slot && m.signature() == signature) {
-                return i + s->methodOffset();
-            }
-        }
-        s = s->m_super;
-    }
-    return -1;
+    return Lookup::find(lookup().methods, signature, MetaMethod::Slot);
 }
 /*!
     Returns MetaMethod object by provided \a index of method.
@@ -142,26 +192,14 @@ MetaMethod MetaObject::method(int index) const {
 */
 int MetaObject::methodCount() const {
     PROFILE_FUNCTION();
-    int count = m_methodCount;
-    const MetaObject *s = m_super;
-    while(s) {
-        count += s->m_methodCount;
-        s = s->m_super;
-    }
-    return count;
+    return m_methodOffset + m_methodCount;
 }
 /*!
     Returns the first index of method for current class. The offset is the sum of all methods in parent classes.
 */
 int MetaObject::methodOffset() const {
     PROFILE_FUNCTION();
-    int offset = 0;
-    const MetaObject *s = m_super;
-    while(s) {
-        offset += s->m_methodCount;
-        s = s->m_super;
-    }
-    return offset;
+    return m_methodOffset;
 }
 /*!
     Returns index of class property by provided \a name; otherwise returns -1.
@@ -169,17 +207,7 @@ int MetaObject::methodOffset() const {
 */
 int MetaObject::indexOfProperty(const char *name) const {
     PROFILE_FUNCTION();
-    const MetaObject *s = this;
-
-    while(s) {
-        for(int i = 0; i < s->m_propCount; ++i) {
-            if(strcmp(s->m_properties[i].name, name) == 0) {
-                return i + s->propertyOffset();
-            }
-        }
-        s = s->m_super;
-    }
-    return -1;
+    return Lookup::find(lookup().properties, name);
 }
 /*!
     Returns MetaProperty object by provided \a index of property.
@@ -201,26 +229,14 @@ MetaProperty MetaObject::property(int index) const {
 */
 int MetaObject::propertyCount() const {
     PROFILE_FUNCTION();
-    int count = m_propCount;
-    const MetaObject *s = m_super;
-    while(s) {
-        count  += s->m_propCount;
-        s = s->m_super;
-    }
-    return count;
+    return m_propOffset + m_propCount;
 }
 /*!
     Returns the first index of property for current class. The offset is the sum of all properties in parent classes.
 */
 int MetaObject::propertyOffset() const {
     PROFILE_FUNCTION();
-    int offset = 0;
-    const MetaObject *s = m_super;
-    while(s) {
-        offset += s->m_propCount;
-        s = s->m_super;
-    }
-    return offset;
+    return m_propOffset;
 }
 /*!
     Returns index of class enumerator by provided \a name; otherwise returns -1.
@@ -228,17 +244,7 @@ int MetaObject::propertyOffset() const {
 */
 int MetaObject::indexOfEnumerator(const char *name) const {
     PROFILE_FUNCTION();
-    const MetaObject *s = this;
-
-    while(s) {
-        for(int i = 0; i < s->m_enumCount; ++i) {
-            if(strcmp(s->m_enums[i].name, name) == 0) {
-                return i + s->enumeratorOffset();
-            }
-        }
-        s = s->m_super;
-    }
-    return -1;
+    return Lookup::find(lookup().enums, name);
 }
 /*!
     Returns MetaEnum object by provided \a index of enumerator.
@@ -284,3 +290,57 @@ bool MetaObject::canCastTo(const char *type) const {
     }
     return false;
 }
+/*!
+    Returns true in case of the object can be cast to the \a type described by the MetaObject; otherwise returns false.
+    This overload compares the class descriptions by the address without string operations.
+*/
+bool MetaObject::canCastTo(const MetaObject *type) const {
+    PROFILE_FUNCTION();
+    const MetaObject *s = this;
+
+    while(s) {
+        if(s == type) {
+            return true;
+        }
+        s = s->m_super;
+    }
+    return false;
+}
+/*!
+    \internal
+    Returns the lookup tables for the properties, methods and enumerators including the inherited ones.
+    The tables are built once on the first request and sorted by the name hash.
+    The members of the derived classes precede the members of the parent classes with the same name.
+*/
+const MetaObject::Lookup &MetaObject::lookup() const {
+    call_once(m_lookupFlag, [this]() {
+        Lookup *result = new Lookup;
+
+        const MetaObject *s = this;
+        while(s) {
+            int32_t methodOffset = s->methodOffset();
+            for(int i = 0; i < s->m_methodCount; ++i) {
+                MetaMethod method(s->m_methods + i);
+                result->signatures.push_back(method.signature());
+                Lookup::add(result->methods, result->signatures.back().c_str(), i + methodOffset, method.type());
+            }
+
+            int32_t propertyOffset = s->propertyOffset();
+            for(int i = 0; i < s->m_propCount; ++i) {
+                Lookup::add(result->properties, s->m_properties[i].name, i + propertyOffset);
+            }
+
+            for(int i = 0; i < s->m_enumCount; ++i) {
+                Lookup::add(result->enums, s->m_enums[i].name, i + s->enumeratorOffset());
+            }
+            s = s->m_super;
+        }
+
+        Lookup::sort(result->methods);
+        Lookup::sort(result->properties);
+        Lookup::sort(result->enums);
+
+        m_lookup = result;
+    });
+    return *m_lookup;
+}
@@ -2,11 +2,53 @@
 #include "core/uri.h"
 
 #include <mutex>
+#include <thread>
 
 static inline mutex &lockMutex(const Object *o) {
     static mutex s_mutexPool[131];
     return s_mutexPool[uint64_t(o) % sizeof(s_mutexPool) / sizeof(mutex)];
 }
+/*!
+    \internal
+    The liveness token of a receiver, it is shared by all links to the receiver and outlives it.
+    The senders from other threads acquire the token before posting a queued call, the receiver destructor waits until all acquired tokens are released.
+*/
+class Object::Liveness {
+public:
+    explicit Liveness(ObjectSystem *system) :
+            m_system(system),
+            m_posting(0),
+            m_alive(true) {
+
+    }
+
+    bool acquire() {
+        m_posting.fetch_add(1);
+        if(m_alive.load()) {
+            return true;
+        }
+        m_posting.fetch_sub(1);
+        return false;
+    }
+
+    void release() {
+        m_posting.fetch_sub(1);
+    }
+
+    void expire() {
+        m_alive.store(false);
+        while(m_posting.load() > 0) {
+            this_thread::yield();
+        }
+    }
+
+    atomic<ObjectSystem *> m_system;
+
+private:
+    atomic<int32_t> m_posting;
+
+    atomic<bool> m_alive;
+};
 
 /*!
     \module Core
@@ -28,6 +70,12 @@ static inline mutex &lockMutex(const Object *o) {
     Synonym for list<Link *>.
 */
 
+/*!
+    \typedef Object::LinkListPtr
+
+    Synonym for shared_ptr<const LinkList>.
+*/
+
 inline bool operator==(const Object::Link &left, const Object::Link &right) {
     bool result = true;
     result &= (left.sender == right.sender);
@@ -45,6 +93,25 @@ Object::Link::Link() :
 
 }
 
+Object::EventQueue::EventQueue() :
+    head(nullptr),
+    pending(false) {
+
+}
+/*!
+    \internal
+    Events are never shared between objects, the copy of an object starts with an empty queue.
+*/
+Object::EventQueue::EventQueue(const EventQueue &queue) :
+    EventQueue() {
+    A_UNUSED(queue);
+}
+
+Object::EventQueue &Object::EventQueue::operator=(const EventQueue &queue) {
+    A_UNUSED(queue);
+    return *this;
+}
+
 /*!
     \class Object
     \brief The Object class is the base calss for all object classes.
@@ -240,6 +307,7 @@ Object::Object() :
     m_parent(nullptr),
     m_currentSender(nullptr),
     m_system(nullptr),
+    m_nextPending(nullptr),
     m_uuid(0),
     m_cloned(0) {
     PROFILE_FUNCTION();
@@ -250,27 +318,25 @@ Object::Object() :
 Object::~Object() {
     PROFILE_FUNCTION();
 
-    emitSignal(_SIGNAL(destroyed()));
-
-    if(m_system) {
-         m_system->removeObject(this);
-    }
+    shared_ptr<Liveness> liveness;
     {
         lock_guard<mutex> locker(lockMutex(this));
-        while(!m_eventQueue.empty()) {
-            delete m_eventQueue.front();
-            m_eventQueue.pop();
-        }
+        liveness = m_liveness;
+    }
+    if(liveness) {
+        // No queued calls can be posted from other threads after this point
+        liveness->expire();
     }
 
+    emitSignal(_SIGNAL_ID(Object, destroyed()));
+
     for(auto it : m_senders) {
         lock_guard<mutex> locker(lockMutex(it.sender));
-        for(auto rcv = it.sender->m_recievers.begin(); rcv != it.sender->m_recievers.end(); ) {
-            if(*rcv == it) {
-                rcv = it.sender->m_recievers.erase(rcv);
-            } else {
-                rcv++;
-            }
+        LinkListPtr current = it.sender->receivers();
+        if(current) {
+            LinkList *list = new LinkList(*current);
+            list->remove(it);
+            it.sender->setReceivers(LinkListPtr(list));
         }
     }
     {
@@ -278,19 +344,28 @@ Object::~Object() {
         m_senders.clear();
     }
 
-    for(auto it : m_recievers) {
-        lock_guard<mutex> locker(lockMutex(it.receiver));
-        for(auto snd = it.receiver->m_senders.begin(); snd != it.receiver->m_senders.end(); ) {
-            if(*snd == it) {
-                snd = it.receiver->m_senders.erase(snd);
-            } else {
-                snd++;
-            }
+    ObjectSystem::unindexObject(this);
+
+    if(m_system) {
+         m_system->removeObject(this);
+    }
+    Event *e = m_eventQueue.head.exchange(nullptr, memory_order_acquire);
+    while(e) {
+        Event *next = e->m_next;
+        delete e;
+        e = next;
+    }
+
+    LinkListPtr current = receivers();
+    if(current) {
+        for(auto it : *current) {
+            lock_guard<mutex> locker(lockMutex(it.receiver));
+            it.receiver->m_senders.remove(it);
         }
     }
     {
         lock_guard<mutex> locker(lockMutex(this));
-        m_recievers.clear();
+        setReceivers(nullptr);
     }
 
     for(const auto &it : m_children) {
@@ -360,12 +435,12 @@ Object *Object::clone(Object *parent) {
     for(auto it : list) {
         const MetaObject *meta = it->metaObject();
         Object *result = meta->createInstance();
-        result->m_uuid = ObjectSystem::generateUUID();
 
         result->m_cloned = it->m_cloned;
         if(result->m_cloned == 0) {
             result->m_cloned = it->m_uuid;
         }
+        ObjectSystem::indexClone(result, 0);
 
         Object *p = parent;
         for(auto item : array) {
@@ -502,14 +577,26 @@ bool Object::connect(Object *sender, const char *signal, Object *receiver, const
             link.method = rcv;
 
             if(!sender->isLinkExist(link)) {
-                {
-                    lock_guard<mutex> locker(lockMutex(sender));
-                    sender->m_recievers.push_back(link);
-                }
                 {
                     lock_guard<mutex> locker(lockMutex(receiver));
+                    if(receiver->m_liveness == nullptr) {
+                        receiver->m_liveness = make_shared<Liveness>(receiver->m_system);
+                    }
+                    link.liveness = receiver->m_liveness;
                     receiver->m_senders.push_back(link);
                 }
+                {
+                    lock_guard<mutex> locker(lockMutex(sender));
+                    LinkListPtr current = sender->receivers();
+                    LinkList *list = current ? new LinkList(*current) : new LinkList;
+                    // Keep links grouped by the signal to skip unrelated links on emit
+                    auto it = list->begin();
+                    while(it != list->end() && it->signal <= snd) {
+                        ++it;
+                    }
+                    list->insert(it, link);
+                    sender->setReceivers(LinkListPtr(list));
+                }
                 return true;
             }
         }
@@ -542,27 +629,28 @@ void Object::disconnect(Object *sender, const char *signal, Object *receiver, co
     PROFILE_FUNCTION();
     if(sender) {
         lock_guard<mutex> slocker(lockMutex(sender));
-        for(auto snd = sender->m_recievers.begin(); snd != sender->m_recievers.end(); ) {
+        LinkListPtr current = sender->receivers();
+        if(current == nullptr) {
+            return;
+        }
+        LinkList *list = new LinkList(*current);
+        for(auto snd = list->begin(); snd != list->end(); ) {
             Link data = *snd;
             if(data.sender == sender) {
                 if(signal == nullptr || data.signal == sender->metaObject()->indexOfMethod(&signal[1])) {
                     if(receiver == nullptr || data.receiver == receiver) {
                         if(method == nullptr || (receiver && data.method == receiver->metaObject()->indexOfMethod(&method[1]))) {
-                            if(data.receiver != sender) {
+                            // Objects can share the same mutex from the pool
+                            bool lock = (&lockMutex(data.receiver) != &lockMutex(sender));
+                            if(lock) {
                                 lockMutex(data.receiver).lock();
                             }
-                            for(auto rcv = data.receiver->m_senders.begin(); rcv != data.receiver->m_senders.end(); ) {
-                                if(*rcv == data) {
-                                    rcv = data.receiver->m_senders.erase(rcv);
-                                } else {
-                                    rcv++;
-                                }
-                            }
-                            if(data.receiver != sender) {
+                            data.receiver->m_senders.remove(data);
+                            if(lock) {
                                 lockMutex(data.receiver).unlock();
                             }
 
-                            snd = sender->m_recievers.erase(snd);
+                            snd = list->erase(snd);
                             continue;
                         }
                     }
@@ -570,6 +658,7 @@ void Object::disconnect(Object *sender, const char *signal, Object *receiver, co
             }
             snd++;
         }
+        sender->setReceivers(LinkListPtr(list));
     }
 }
 /*!
@@ -589,10 +678,14 @@ const Object::ObjectList &Object::getChildren() const {
 }
 /*!
     Returns list of links to receivers objects for this object.
+    The returned list is an immutable snapshot, it stays valid while concurrent connect() and disconnect() calls replace the links.
 */
-const Object::LinkList &Object::getReceivers() const {
+Object::LinkListPtr Object::getReceivers() const {
     PROFILE_FUNCTION();
-    return m_recievers;
+    static const LinkListPtr empty = make_shared<const LinkList>();
+
+    LinkListPtr current = receivers();
+    return current ? current : empty;
 }
 
 /*!
@@ -723,25 +816,60 @@ void Object::removeChild(Object *child) {
 */
 void Object::emitSignal(const char *signal, const Variant &args) {
     PROFILE_FUNCTION();
-    int32_t index = metaObject()->indexOfSignal(&signal[1]);
-    lock_guard<mutex> locker(lockMutex(this));
-    for(auto &it : m_recievers) {
-        Link *link = &(it);
-        if(link->signal == index) {
+    LinkListPtr current = receivers();
+    if(current == nullptr || current->empty()) {
+        return;
+    }
+    emitSignal(metaObject()->indexOfSignal(&signal[1]), args);
+}
+/*!
+    Emits the \a signal with the \a args by the precomputed index of the signal.
+    This overload performs no string operations, the index can be resolved once with the _SIGNAL_ID() macro.
+    The receivers are taken from the immutable snapshot of connections, the emission takes no locks, so the concurrent connect() and disconnect() calls never block it.
+    Queued calls are posted only to the receivers which are still alive, so the receiver can be safely destroyed in another thread.
+    \code
+        emitSignal(_SIGNAL_ID(MyObject, signal(bool)), true);
+    \endcode
+*/
+void Object::emitSignal(int32_t signal, const Variant &args) {
+    PROFILE_FUNCTION();
+    if(signal < 0) {
+        return;
+    }
+    LinkListPtr current = receivers();
+    if(current == nullptr) {
+        return;
+    }
+    for(auto &it : *current) {
+        const Link *link = &(it);
+        if(link->signal > signal) {
+            break;
+        }
+        if(link->signal == signal) {
+            Liveness *liveness = link->liveness.get();
+            ObjectSystem *system = liveness ? liveness->m_system.load(memory_order_relaxed) : nullptr;
+            bool queued = (m_system && system && !m_system->compareTreads(system));
+            // The receiver could be destroyed in another thread, its destructor waits for the acquired tokens
+            if(queued && !liveness->acquire()) {
+                continue;
+            }
             const MetaMethod &method = link->receiver->metaObject()->method(link->method);
+            if(queued) {
+                bool post = method.isValid() && method.type() != MetaMethod::Signal;
+                if(post) { // Queued Connection
+                    link->receiver->postEvent(new MethodCallEvent(link->method, link->sender, args));
+                }
+                liveness->release();
+                if(post) {
+                    continue;
+                }
+            }
             if(method.isValid()) {
                 if(method.type() == MetaMethod::Signal) {
-                    link->receiver->emitSignal(string(char(method.type() + 0x30) + method.signature()).c_str(), args);
-                } else {
-                    if(m_system && link->receiver->m_system &&
-                       !m_system->compareTreads(link->receiver->m_system)) { // Queued Connection
-
-                        link->receiver->postEvent(new MethodCallEvent(link->method, link->sender, args));
-                    } else { // Direct call
-                        MethodCallEvent e(link->method, link->sender, args);
-                        link->receiver->methodCallEvent(&e);
-                    }
-                    link = nullptr;
+                    link->receiver->emitSignal(link->method, args);
+                } else { // Direct call
+                    MethodCallEvent e(link->method, link->sender, args);
+                    link->receiver->methodCallEvent(&e);
                 }
             }
         }
@@ -749,42 +877,60 @@ void Object::emitSignal(const char *signal, const Variant &args) {
 }
 /*!
     Place event to internal \a event queue to be processed in event loop.
+    The queue is lock-free, so events can be posted from any thread without contention.
+    The first posted event schedules the object in the pending queue of the ObjectSystem.
 */
 void Object::postEvent(Event *event) {
     PROFILE_FUNCTION();
-    lock_guard<mutex> locker(lockMutex(this));
-    m_eventQueue.push(event);
+    Event *head = m_eventQueue.head.load(memory_order_relaxed);
+    do {
+        event->m_next = head;
+    } while(!m_eventQueue.head.compare_exchange_weak(head, event, memory_order_release, memory_order_relaxed));
+
+    if(m_system && !m_eventQueue.pending.exchange(true)) {
+        m_system->schedule(this);
+    }
 }
 
 void Object::processEvents() {
     PROFILE_FUNCTION();
 
-    while(!m_eventQueue.empty()) {
+    Event *head = m_eventQueue.head.exchange(nullptr, memory_order_acquire);
+    while(head) {
+        // Events are stacked by postEvent, restore the posting order
         Event *e = nullptr;
-        {
-            lock_guard<mutex> locker(lockMutex(this));
-            e = m_eventQueue.front();
-            m_eventQueue.pop();
+        while(head) {
+            Event *next = head->m_next;
+            head->m_next = e;
+            e = head;
+            head = next;
         }
 
-        switch (e->type()) {
-            case Event::MethodCall: {
-                methodCallEvent(reinterpret_cast<MethodCallEvent *>(e));
-            } break;
-            case Event::Destroy: {
-                if(m_system) {
-                    m_system->suspendObject(this);
+        while(e) {
+            Event *next = e->m_next;
+            switch (e->type()) {
+                case Event::MethodCall: {
+                    methodCallEvent(reinterpret_cast<MethodCallEvent *>(e));
+                } break;
+                case Event::Destroy: {
+                    delete e;
+                    while(next) {
+                        e = next->m_next;
+                        delete next;
+                        next = e;
+                    }
+                    delete this;
+                    return;
                 }
-
-                delete e;
-                delete this;
-                return;
+                default: {
+                    event(e);
+                } break;
             }
-            default: {
-                event(e);
-            } break;
+            delete e;
+            e = next;
         }
-        delete e;
+
+        head = m_eventQueue.head.exchange(nullptr, memory_order_acquire);
     }
 }
 /*!
@@ -909,18 +1055,53 @@ void Object::methodCallEvent(MethodCallEvent *event) {
     \internal
 */
 void Object::clearCloneRef() {
+    uint32_t previous = m_cloned;
     m_cloned = 0;
+    ObjectSystem::indexClone(this, previous);
 }
 
 void Object::setUUID(uint32_t id) {
     PROFILE_FUNCTION();
+    uint32_t previous = m_uuid;
     m_uuid = id;
+    ObjectSystem::indexUUID(this, previous);
 }
 
 void Object::setSystem(ObjectSystem *system) {
     PROFILE_FUNCTION();
     m_system = system;
     m_system->addObject(this);
+    {
+        lock_guard<mutex> locker(lockMutex(this));
+        if(m_liveness) {
+            m_liveness->m_system.store(system);
+        }
+    }
+
+    schedulePending();
+}
+/*!
+    \internal
+    Schedules the object in the pending queue of the ObjectSystem in case of it has unprocessed events.
+*/
+void Object::schedulePending() {
+    if(m_system && m_eventQueue.head.load(memory_order_acquire) && !m_eventQueue.pending.exchange(true)) {
+        m_system->schedule(this);
+    }
+}
+/*!
+    \internal
+    Marks the object as taken from the pending queue of the ObjectSystem.
+*/
+void Object::resetPending() {
+    m_eventQueue.pending.store(false);
+}
+/*!
+    \internal
+    Returns true in case of the object is placed in the pending queue of the ObjectSystem; otherwise returns false.
+*/
+bool Object::isPending() const {
+    return m_eventQueue.pending.load();
 }
 /*!
     \internal
@@ -950,7 +1131,7 @@ VariantList Object::serializeData(const MetaObject *meta) const {
 
     // Save links
     VariantList links;
-    for(const auto &l : getReceivers()) {
+    for(const auto &l : *getReceivers()) {
         VariantList link;
 
         Object *receiver = l.receiver;
@@ -974,13 +1155,31 @@ VariantList Object::serializeData(const MetaObject *meta) const {
 
 bool Object::isLinkExist(const Object::Link &link) const {
     PROFILE_FUNCTION();
-    for(const auto &it : m_recievers) {
-        if(it == link) {
-            return true;
+    LinkListPtr current = receivers();
+    if(current) {
+        for(const auto &it : *current) {
+            if(it == link) {
+                return true;
+            }
         }
     }
     return false;
 }
+/*!
+    \internal
+    Returns the current snapshot of links to receivers.
+*/
+Object::LinkListPtr Object::receivers() const {
+    return atomic_load(&m_recievers);
+}
+/*!
+    \internal
+    Replaces the snapshot of links to receivers with the \a list.
+    This method must be called under the lock of this object, the list must not be modified after the call.
+*/
+void Object::setReceivers(const LinkListPtr &list) {
+    atomic_store(&m_recievers, list);
+}
 
 void Object::enumObjects(Object *object, Object::ObjectList &list) {
     list.push_back(object);
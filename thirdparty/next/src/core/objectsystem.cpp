@@ -8,9 +8,119 @@
 
 #include "math/amath.h"
 
+#include <algorithm>
+#include <mutex>
+
 static ObjectSystem::FactoryMap s_Factories;
 static ObjectSystem::GroupMap   s_Groups;
 
+struct ObjectIndex {
+    mutex lock;
+
+    // UUIDs are unique only inside a hierarchy, for example, a loaded copy of a prefab keeps the UUIDs of the original
+    unordered_multimap<uint32_t, Object *> uuids;
+
+    unordered_multimap<uint32_t, Object *> clones;
+};
+
+static ObjectIndex &objectIndex() {
+    // Never destroyed, objects can be deleted after the static destructors
+    static ObjectIndex *index = new ObjectIndex;
+    return *index;
+}
+
+static bool isInHierarchy(const Object *object, const Object *root) {
+    while(object) {
+        if(object == root) {
+            return true;
+        }
+        object = object->parent();
+    }
+    return false;
+}
+
+static uint32_t hierarchyDepth(const Object *object) {
+    uint32_t result = 0;
+    while(object) {
+        result++;
+        object = object->parent();
+    }
+    return result;
+}
+
+static bool isVisitedBefore(const Object *left, const Object *right) {
+    uint32_t leftDepth = hierarchyDepth(left);
+    uint32_t rightDepth = hierarchyDepth(right);
+
+    const Object *l = left;
+    const Object *r = right;
+    while(rightDepth > leftDepth) {
+        r = r->parent();
+        rightDepth--;
+        if(r == l) {
+            return true; // Left is an ancestor of right
+        }
+    }
+    while(leftDepth > rightDepth) {
+        l = l->parent();
+        leftDepth--;
+        if(l == r) {
+            return false; // Right is an ancestor of left
+        }
+    }
+    while(l->parent() != r->parent()) {
+        l = l->parent();
+        r = r->parent();
+    }
+
+    const Object *parent = l->parent();
+    if(parent) {
+        for(auto it : parent->getChildren()) {
+            if(it == l) {
+                return true;
+            }
+            if(it == r) {
+                return false;
+            }
+        }
+    }
+    return false;
+}
+
+static void eraseIndex(unordered_multimap<uint32_t, Object *> &map, uint32_t key, const Object *object) {
+    auto range = map.equal_range(key);
+    for(auto it = range.first; it != range.second; ++it) {
+        if(it->second == object) {
+            map.erase(it);
+            break;
+        }
+    }
+}
+
+static Object *findIndexed(const unordered_multimap<uint32_t, Object *> &map, uint32_t key, Object *root, Object *result) {
+    auto range = map.equal_range(key);
+    for(auto it = range.first; it != range.second; ++it) {
+        Object *object = it->second;
+        if(object != result && isInHierarchy(object, root) && (result == nullptr || isVisitedBefore(object, result))) {
+            result = object;
+        }
+    }
+    return result;
+}
+
+static Object *findObjectRecursive(uint32_t uuid, Object *root) {
+    if(root->clonedFrom() == uuid || root->uuid() == uuid) {
+        return root;
+    }
+    for(auto &it : root->getChildren()) {
+        Object *result = findObjectRecursive(uuid, it);
+        if(result) {
+            return result;
+        }
+    }
+    return nullptr;
+}
+
 /*!
     \class ObjectSystem
     \brief The ObjectSystem responds for object management.
@@ -62,7 +172,7 @@ static ObjectSystem::GroupMap   s_Groups;
     Constructs ObjectSystem.
 */
 ObjectSystem::ObjectSystem() :
-        m_suspendObject(nullptr) {
+        m_pendingObjects(nullptr) {
     PROFILE_FUNCTION();
 }
 /*!
@@ -85,11 +195,12 @@ ObjectSystem::~ObjectSystem() {
     }
     {
         deleteAllObjects();
-        m_suspendObject = nullptr;
     }
 }
 /*!
-    Updates all related objects.
+    Processes events of the related objects.
+    Only objects with pending events are visited, the objects are scheduled by Object::postEvent().
+    Events which are posted during this call will be processed on the next call.
 */
 void ObjectSystem::processEvents() {
     PROFILE_FUNCTION();
@@ -98,18 +209,19 @@ void ObjectSystem::processEvents() {
 
     Object::processEvents();
 
-    auto it = m_objectList.begin();
-    while(it != m_objectList.end()) {
-        Object *o = *it;
-        o->processEvents();
+    unique_lock<mutex> locker(m_activeMutex);
+    takePending();
+    for(size_t i = 0; i < m_activeObjects.size(); i++) {
+        Object *object = m_activeObjects[i];
+        if(object) {
+            object->resetPending();
 
-        if(m_suspendObject != nullptr) {
-            m_suspendObject = nullptr;
-            it = m_objectList.erase(it);
-        } else {
-            ++it;
+            locker.unlock();
+            object->processEvents();
+            locker.lock();
         }
     }
+    m_activeObjects.clear();
 }
 /*!
     Returns true in case of other \a system execues in the same thread with current system; otherwise returns false.
@@ -376,10 +488,12 @@ Object *ObjectSystem::toObject(const Variant &variant, Object *parent, const str
 }
 /*!
     Returns the new unique ID based on random number generator.
+    Each thread uses its own generator so objects can be created from several threads.
 */
 uint32_t ObjectSystem::generateUUID() {
     PROFILE_FUNCTION();
-    return dist(mt);
+    static thread_local std::mt19937 generator(std::random_device{}());
+    return std::uniform_int_distribution<uint32_t>(0, UINT32_MAX)(generator);
 }
 /*!
     Replaces current \a uuid of the \a object with the new one.
@@ -407,42 +521,117 @@ Object *ObjectSystem::findRoot(Object *object) {
 }
 /*!
     Returns object with \a uuid or which was clonned from this.
-    This algorithm recursively going down from the \a root object
+    Only objects in the hierarchy of the \a root object are considered, in case of several matches the first one in depth-first order is returned.
     If the object doesn't exist in the hierarchy this method returns nullptr.
+
+    All objects are indexed by the UUID and by the UUID of the original object, so the lookup doesn't depend on the size of the hierarchy.
+    Several objects can share the same UUID in different hierarchies, for example, when a copy of a prefab is loaded, only the matches inside the \a root hierarchy are returned.
 */
 Object *ObjectSystem::findObject(uint32_t uuid, Object *root) {
-    if(root->clonedFrom() == uuid || root->uuid() == uuid) {
-        return root;
+    PROFILE_FUNCTION();
+    if(uuid == 0) { // Zero is a clone reference of all original objects
+        return findObjectRecursive(uuid, root);
     }
-    for(auto &it : root->getChildren()) {
-        Object *result = findObject(uuid, it);
-        if(result) {
-            return result;
-        }
+
+    ObjectIndex &index = objectIndex();
+    unique_lock<mutex> locker(index.lock);
+
+    Object *result = findIndexed(index.uuids, uuid, root, nullptr);
+    return findIndexed(index.clones, uuid, root, result);
+}
+/*!
+    \internal
+    Updates the UUID index after the UUID change of the \a object from the \a previous one.
+*/
+void ObjectSystem::indexUUID(Object *object, uint32_t previous) {
+    ObjectIndex &index = objectIndex();
+    unique_lock<mutex> locker(index.lock);
+
+    if(previous != 0) {
+        eraseIndex(index.uuids, previous, object);
+    }
+    if(object->uuid() != 0) {
+        index.uuids.emplace(object->uuid(), object);
+    }
+}
+/*!
+    \internal
+    Updates the clone index after the change of the clone reference of the \a object from the \a previous one.
+*/
+void ObjectSystem::indexClone(Object *object, uint32_t previous) {
+    ObjectIndex &index = objectIndex();
+    unique_lock<mutex> locker(index.lock);
+
+    if(previous != 0) {
+        eraseIndex(index.clones, previous, object);
+    }
+    if(object->clonedFrom() != 0) {
+        index.clones.emplace(object->clonedFrom(), object);
+    }
+}
+/*!
+    \internal
+    Removes the \a object from the UUID and clone indices.
+*/
+void ObjectSystem::unindexObject(Object *object) {
+    ObjectIndex &index = objectIndex();
+    unique_lock<mutex> locker(index.lock);
+
+    eraseIndex(index.uuids, object->uuid(), object);
+    if(object->clonedFrom() != 0) {
+        eraseIndex(index.clones, object->clonedFrom(), object);
     }
-    return nullptr;
 }
 /*!
     Adds an \a object to main pull of objects in ObjectSystem
 */
 void ObjectSystem::addObject(Object *object) {
     PROFILE_FUNCTION();
-    m_objectList.push_back(object);
+    m_objectIndex[object] = m_objectList.insert(m_objectList.end(), object);
 }
 /*!
     \internal
 */
 void ObjectSystem::removeObject(Object *object) {
     PROFILE_FUNCTION();
-    if(m_suspendObject == nullptr) {
-        m_objectList.remove(object);
+    auto it = m_objectIndex.find(object);
+    if(it != m_objectIndex.end()) {
+        m_objectList.erase(it->second);
+        m_objectIndex.erase(it);
+    }
+
+    if(object->isPending()) {
+        // The object can be destroyed on any thread while the processEvents() walks the active objects
+        unique_lock<mutex> locker(m_activeMutex);
+        takePending();
+        replace(m_activeObjects.begin(), m_activeObjects.end(), object, static_cast<Object *>(nullptr));
     }
 }
 /*!
     \internal
+    Pushes the \a object to the lock-free pending queue.
+    Each object is pushed only once until the queue is taken by the processEvents(), this method can be called from any thread.
 */
-void ObjectSystem::suspendObject(Object *object) {
-    m_suspendObject = object;
+void ObjectSystem::schedule(Object *object) {
+    Object *head = m_pendingObjects.load(memory_order_relaxed);
+    do {
+        object->m_nextPending = head;
+    } while(!m_pendingObjects.compare_exchange_weak(head, object, memory_order_release, memory_order_relaxed));
+}
+/*!
+    \internal
+    Moves all scheduled objects to the list of active objects in the order of scheduling.
+    The caller must hold the m_activeMutex.
+*/
+void ObjectSystem::takePending() {
+    Object *head = m_pendingObjects.exchange(nullptr, memory_order_acquire);
+
+    size_t first = m_activeObjects.size();
+    while(head) {
+        m_activeObjects.push_back(head);
+        head = head->m_nextPending;
+    }
+    reverse(m_activeObjects.begin() + first, m_activeObjects.end());
 }
 /*!
     Returns a list of objects with specified \a type.
@@ -174,6 +174,17 @@ void Meta_enums() {
     QCOMPARE(enumerator.value(1), 2);
 }
 
+void Meta_index() {
+    const MetaObject *second = SecondObject::metaClass();
+    const MetaObject *test = TestObject::metaClass();
+
+    uint32_t index = second->index();
+    QCOMPARE(second->index(), index);
+    QCOMPARE(test->index() != index, true);
+    QCOMPARE(Object::metaClass()->index() != index, true);
+    QCOMPARE(Object::metaClass()->index() != test->index(), true);
+}
+
 } REGISTER(MetaObjectTest)
 
 #include "tst_metaobject.moc"
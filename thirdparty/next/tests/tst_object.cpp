@@ -19,6 +19,73 @@
 
 #include "tst_common.h"
 
+#include <thread>
+
+class OrderEvent : public Event {
+public:
+    OrderEvent(int producer, int index) :
+            Event(Event::UserType),
+            producer(producer),
+            index(index) {
+
+    }
+
+    int producer;
+    int index;
+};
+
+class EventObject : public TestObject {
+    A_REGISTER(EventObject, TestObject, Test)
+
+    A_NOMETHODS()
+    A_NOPROPERTIES()
+
+public:
+    EventObject() :
+            count(0),
+            ordered(true) {
+
+    }
+
+    bool event(Event *e) override {
+        if(e->type() == Event::UserType) {
+            OrderEvent *order = static_cast<OrderEvent *>(e);
+            int &last = indices.insert({order->producer, -1}).first->second;
+            ordered &= (order->index == last + 1);
+            last = order->index;
+            count++;
+            return true;
+        }
+        return false;
+    }
+
+    map<int, int> indices;
+    int count;
+    bool ordered;
+};
+
+class DisconnectObject : public TestObject {
+    A_REGISTER(DisconnectObject, TestObject, Test)
+
+    A_METHODS(
+        A_SLOT(DisconnectObject::onSignal)
+    )
+    A_NOPROPERTIES()
+
+public:
+    void onSignal(int value) {
+        setSlot(value);
+        Object::disconnect(sender(), nullptr, this, nullptr);
+    }
+};
+
+class PlainObject : public TestObject {
+public:
+    PlainObject() {
+
+    }
+};
+
 class ObjectTest : public QObject {
     Q_OBJECT
 private slots:
@@ -30,10 +97,10 @@ void Disconnect_base() {
 
     Object::connect(&obj1, _SIGNAL(signal(int)), &obj2, _SLOT(setSlot(int)));
     Object::connect(&obj1, _SIGNAL(signal(int)), &obj3, _SIGNAL(signal(int)));
-    QCOMPARE((int)obj1.getReceivers().size(), 2);
+    QCOMPARE((int)obj1.getReceivers()->size(), 2);
 
     Object::disconnect(&obj1, _SIGNAL(signal(int)), &obj3, _SIGNAL(signal(int)));
-    QCOMPARE((int)obj1.getReceivers().size(), 1);
+    QCOMPARE((int)obj1.getReceivers()->size(), 1);
 }
 
 void Disconnect_all() {
@@ -43,10 +110,10 @@ void Disconnect_all() {
 
     Object::connect(&obj1, _SIGNAL(signal(int)), &obj2, _SLOT(setSlot(int)));
     Object::connect(&obj1, _SIGNAL(signal(int)), &obj3, _SIGNAL(signal(int)));
-    QCOMPARE((int)obj1.getReceivers().size(), 2);
+    QCOMPARE((int)obj1.getReceivers()->size(), 2);
 
     Object::disconnect(&obj1, 0, 0, 0);
-    QCOMPARE((int)obj1.getReceivers().size(), 0);
+    QCOMPARE((int)obj1.getReceivers()->size(), 0);
 }
 
 void Disconnect_by_signal() {
@@ -56,10 +123,10 @@ void Disconnect_by_signal() {
 
     Object::connect(&obj1, _SIGNAL(signal(int)), &obj2, _SLOT(setSlot(int)));
     Object::connect(&obj1, _SIGNAL(signal(int)), &obj3, _SIGNAL(signal(int)));
-    QCOMPARE((int)obj1.getReceivers().size(), 2);
+    QCOMPARE((int)obj1.getReceivers()->size(), 2);
 
     Object::disconnect(&obj1, _SIGNAL(signal(int)), 0, 0);
-    QCOMPARE((int)obj1.getReceivers().size(), 0);
+    QCOMPARE((int)obj1.getReceivers()->size(), 0);
 }
 
 void Disconnect_by_receiver() {
@@ -69,10 +136,10 @@ void Disconnect_by_receiver() {
 
     Object::connect(&obj1, _SIGNAL(signal(int)), &obj2, _SLOT(setSlot(int)));
     Object::connect(&obj1, _SIGNAL(signal(int)), &obj3, _SIGNAL(signal(int)));
-    QCOMPARE((int)obj1.getReceivers().size(), 2);
+    QCOMPARE((int)obj1.getReceivers()->size(), 2);
 
     Object::disconnect(&obj1, 0, &obj3, 0);
-    QCOMPARE((int)obj1.getReceivers().size(), 1);
+    QCOMPARE((int)obj1.getReceivers()->size(), 1);
 }
 
 void Child_destructor() {
@@ -107,10 +174,10 @@ void Reciever_destructor() {
     TestObject *obj2 = new TestObject;
 
     Object::connect(obj1, _SIGNAL(signal(int)), obj2, _SIGNAL(signal(int)));
-    QCOMPARE((int)obj1->getReceivers().size(),  1);
+    QCOMPARE((int)obj1->getReceivers()->size(),  1);
 
     delete obj2;
-    QCOMPARE((int)obj1->getReceivers().size(),  0);
+    QCOMPARE((int)obj1->getReceivers()->size(),  0);
 
     delete obj1;
 }
@@ -145,6 +212,24 @@ void Emit_signal() {
     }
 }
 
+void Emit_signal_id() {
+    TestObject obj1;
+    TestObject obj2;
+    TestObject obj3;
+
+    Object::connect(&obj1, _SIGNAL(signal(int)), &obj2, _SIGNAL(signal(int)));
+    Object::connect(&obj1, _SIGNAL(destroyed()), &obj3, _SLOT(onDestroyed()));
+    Object::connect(&obj2, _SIGNAL(signal(int)), &obj3, _SLOT(setSlot(int)));
+
+    int32_t index = _SIGNAL_ID(TestObject, signal(int));
+    QCOMPARE(index, obj1.metaObject()->indexOfSignal("signal(int)"));
+    QCOMPARE(obj1.getReceivers()->front().signal, _SIGNAL_ID(Object, destroyed()));
+
+    QCOMPARE(obj3.m_bSlot, 0);
+    obj1.emitSignal(index, 1);
+    QCOMPARE(obj3.m_bSlot, 1);
+}
+
 void Find_object() {
     Object obj1;
     TestObject obj2;
@@ -171,6 +256,41 @@ void Find_object() {
         list<TestObject *> result   = obj1.findChildren<TestObject *>();
         QCOMPARE(int(result.size()), 2);
     }
+    {
+        int count = 0;
+        obj1.visitChildren([&count](Object *) {
+            count++;
+            return false;
+        });
+        QCOMPARE(count, 1);
+    }
+}
+
+void Object_cast() {
+    TestObject obj1;
+    TestObject obj2;
+    PlainObject obj3;
+
+    // PlainObject has no own meta information, metaClass() belongs to TestObject
+    QCOMPARE(PlainObject::metaClass() == TestObject::metaClass(), true);
+    QCOMPARE(Object::objectCast<PlainObject *>(&obj2) == nullptr, true);
+    QCOMPARE(Object::objectCast<PlainObject *>(&obj3) == &obj3, true);
+    QCOMPARE(Object::objectCast<TestObject *>(&obj3) == &obj3, true);
+
+    obj2.setParent(&obj1);
+    obj3.setParent(&obj1);
+    {
+        PlainObject *result = obj1.findChild<PlainObject *>();
+        QCOMPARE(result == &obj3, true);
+    }
+    {
+        list<PlainObject *> result = obj1.findChildren<PlainObject *>();
+        QCOMPARE(int(result.size()), 1);
+    }
+    {
+        list<TestObject *> result = obj1.findChildren<TestObject *>();
+        QCOMPARE(int(result.size()), 2);
+    }
 }
 
 void Clone_object() {
@@ -199,6 +319,101 @@ void Clone_object() {
     delete obj1;
 }
 
+void Receivers_snapshot() {
+    TestObject obj1;
+    TestObject obj2;
+
+    Object::connect(&obj1, _SIGNAL(signal(int)), &obj2, _SLOT(setSlot(int)));
+    Object::connect(&obj1, _SIGNAL(destroyed()), &obj2, _SLOT(onDestroyed()));
+
+    Object::LinkListPtr snapshot = obj1.getReceivers();
+    QCOMPARE((int)snapshot->size(), 2);
+
+    Object::disconnect(&obj1, _SIGNAL(signal(int)), &obj2, _SLOT(setSlot(int)));
+    QCOMPARE((int)snapshot->size(), 2);
+    QCOMPARE((int)obj1.getReceivers()->size(), 1);
+    QCOMPARE(snapshot != obj1.getReceivers(), true);
+}
+
+void Disconnect_on_emit() {
+    TestObject obj1;
+    DisconnectObject obj2;
+    DisconnectObject obj3;
+
+    Object::connect(&obj1, _SIGNAL(signal(int)), &obj2, _SLOT(onSignal(int)));
+    Object::connect(&obj1, _SIGNAL(signal(int)), &obj3, _SLOT(onSignal(int)));
+
+    // Both receivers are called from the snapshot taken on emit
+    obj1.emitSignal(_SIGNAL(signal(int)), 1);
+    QCOMPARE(obj2.getSlot(), true);
+    QCOMPARE(obj3.getSlot(), true);
+    QCOMPARE((int)obj1.getReceivers()->size(), 0);
+
+    obj2.setSlot(0);
+    obj1.emitSignal(_SIGNAL(signal(int)), 1);
+    QCOMPARE(obj2.getSlot(), false);
+}
+
+void Post_events_multithread() {
+    EventObject obj;
+
+    const int producers = 4;
+    const int events = 1000;
+
+    vector<thread> threads;
+    for(int p = 0; p < producers; p++) {
+        threads.push_back(thread([&obj, p]() {
+            for(int i = 0; i < events; i++) {
+                obj.postEvent(new OrderEvent(p, i));
+            }
+        }));
+    }
+    // Single consumer takes events while producers are still posting
+    while(obj.count < producers * events) {
+        obj.processEvents();
+    }
+    for(auto &it : threads) {
+        it.join();
+    }
+    obj.processEvents();
+
+    QCOMPARE(obj.count, producers * events);
+    QCOMPARE((int)obj.indices.size(), producers);
+    QCOMPARE(obj.ordered, true);
+}
+
+void Queued_receiver_destructor() {
+    ObjectSystem system1;
+    ObjectSystem system2;
+
+    // Bind the systems to different threads to make the connection queued
+    thread([&system2]() { system2.processEvents(); }).join();
+    system1.processEvents();
+
+    TestObject sender;
+    sender.setSystem(&system1);
+
+    TestObject *receiver = new TestObject;
+    receiver->setSystem(&system2);
+
+    Object::connect(&sender, _SIGNAL(signal(int)), receiver, _SLOT(setSlot(int)));
+
+    atomic<bool> stop(false);
+    thread emitter([&sender, &stop]() {
+        while(!stop) {
+            sender.emitSignal(_SIGNAL_ID(TestObject, signal(int)), 1);
+        }
+    });
+    this_thread::sleep_for(chrono::milliseconds(10));
+
+    delete receiver;
+
+    stop = true;
+    emitter.join();
+
+    QCOMPARE((int)sender.getReceivers()->size(), 0);
+}
+
 } REGISTER(ObjectTest)
 
 #include "tst_object.moc"
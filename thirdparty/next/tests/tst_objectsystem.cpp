@@ -81,6 +81,68 @@ void Override_Object() {
     delete object;
 }
 
+void Process_pending_events() {
+    ObjectSystem objectSystem;
+    TestObject::registerClassFactory(&objectSystem);
+
+    TestObject *obj1 = ObjectSystem::objectCreate<TestObject>();
+    TestObject *obj2 = ObjectSystem::objectCreate<TestObject>();
+    TestObject *obj3 = ObjectSystem::objectCreate<TestObject>();
+
+    Object::connect(obj2, _SIGNAL(destroyed()), obj1, _SLOT(onDestroyed()));
+
+    obj2->deleteLater();
+    obj3->deleteLater();
+    QCOMPARE(obj1->getSlot(), false);
+
+    delete obj3;
+
+    objectSystem.processEvents();
+    QCOMPARE(obj1->getSlot(), true);
+
+    delete obj1;
+}
+
+void Find_object_by_uuid() {
+    ObjectSystem objectSystem;
+    TestObject::registerClassFactory(&objectSystem);
+
+    TestObject *obj1 = ObjectSystem::objectCreate<TestObject>();
+    TestObject *obj2 = ObjectSystem::objectCreate<TestObject>();
+    obj2->setParent(obj1);
+
+    Object *clone = obj1->clone();
+    Object *child = clone->getChildren().front();
+
+    QCOMPARE(ObjectSystem::findObject(obj2->uuid(), obj1) == obj2, true);
+    QCOMPARE(ObjectSystem::findObject(obj2->uuid(), clone) == child, true);
+    QCOMPARE(ObjectSystem::findObject(child->uuid(), obj1) == nullptr, true);
+
+    ObjectSystem::replaceUUID(obj2, 100);
+    QCOMPARE(ObjectSystem::findObject(100, obj1) == obj2, true);
+
+    // The loaded copy of the hierarchy keeps the UUIDs of the original objects
+    TestObject *copy = ObjectSystem::objectCreate<TestObject>();
+    ObjectSystem::replaceUUID(copy, 100);
+    QCOMPARE(ObjectSystem::findObject(100, obj1) == obj2, true);
+    QCOMPARE(ObjectSystem::findObject(100, copy) == copy, true);
+
+    delete copy;
+    QCOMPARE(ObjectSystem::findObject(100, obj1) == obj2, true);
+
+    // Several clones in one hierarchy, the first one in depth-first order wins
+    Object *first = obj2->clone(clone);
+    Object *nested = obj2->clone(child);
+    QCOMPARE(ObjectSystem::findObject(100, clone) == nested, true);
+    delete nested;
+    QCOMPARE(ObjectSystem::findObject(100, clone) == first, true);
+
+    delete clone;
+    QCOMPARE(ObjectSystem::findObject(obj1->uuid(), obj1) == obj1, true);
+
+    delete obj1;
+}
+
 void Serialize_Desirialize_Object() {
     ObjectSystem objectSystem;
     TestObject::registerClassFactory(&objectSystem);
@@ -108,7 +170,7 @@ void Serialize_Desirialize_Object() {
     QCOMPARE((object != nullptr), true);
     QCOMPARE(compare(*object, *result), true);
 
-    QCOMPARE((object->getReceivers().size() == result->getReceivers().size()), true);
+    QCOMPARE((object->getReceivers()->size() == result->getReceivers()->size()), true);
 
     QCOMPARE((object->uuid() == result->uuid()), true);
 
@@ -0,0 +1,99 @@
+#include "tst_common.h"
+
+#include "analytics/profiler.h"
+
+#include <thread>
+#include <atomic>
+
+class ProfilerTest : public QObject {
+    Q_OBJECT
+private slots:
+
+void Counters() {
+    Profiler::statReset("Test Counter");
+    Profiler::statAdd("Test Counter", 2);
+    Profiler::statAdd(string("Test Counter").c_str(), 3);
+
+    QCOMPARE(Profiler::stat("Test Counter"), uint32_t(5));
+
+    Profiler::statReset("Test Counter");
+    QCOMPARE(Profiler::stat("Test Counter"), uint32_t(0));
+}
+
+void Multi_Thread_Scopes() {
+    Profiler::frame();
+
+    vector<thread> threads;
+    for(int i = 0; i < 4; i++) {
+        threads.push_back(thread([]() {
+            for(int j = 0; j < 100; j++) {
+                Profiler scope("Worker Scope");
+            }
+        }));
+    }
+    for(auto &it : threads) {
+        it.join();
+    }
+
+    Profiler::frame();
+
+    uint32_t scopes = 0;
+    for(auto &it : Profiler::events()) {
+        if(it.type == Profiler::Scope && string(it.name) == "Worker Scope") {
+            QVERIFY(it.value >= it.start);
+            scopes++;
+        }
+    }
+    QCOMPARE(scopes, uint32_t(400));
+
+    QVERIFY(Profiler::summary().find("Worker Scope") != string::npos);
+    QVERIFY(Profiler::traceJson().find("\"ph\":\"X\"") != string::npos);
+}
+
+void Read_While_Writing() {
+    atomic<bool> finished(false);
+    thread writer([&finished]() {
+        for(int j = 0; j < 100000; j++) {
+            Profiler scope("Race Scope");
+        }
+        finished = true;
+    });
+
+    // Each snapshot must contain complete events only
+    uint32_t broken = 0;
+    while(!finished) {
+        for(auto &it : Profiler::events()) {
+            if(it.name == nullptr || (it.type == Profiler::Scope && it.value < it.start)) {
+                broken++;
+            }
+        }
+    }
+    writer.join();
+
+    QCOMPARE(broken, uint32_t(0));
+}
+
+void Reuse_Thread_Buffers() {
+    // Each buffer keeps 16384 last events only, so without reuse all of the events would be still available
+    for(int i = 0; i < 16; i++) {
+        thread worker([]() {
+            for(int j = 0; j < 10000; j++) {
+                Profiler scope("Reuse Scope");
+            }
+        });
+        worker.join();
+    }
+
+    uint32_t scopes = 0;
+    for(auto &it : Profiler::events()) {
+        if(it.type == Profiler::Scope && string(it.name) == "Reuse Scope") {
+            scopes++;
+        }
+    }
+    QVERIFY(scopes >= uint32_t(10000));
+    QVERIFY(scopes < uint32_t(160000));
+}
+
+} REGISTER(ProfilerTest)
+
+#include "tst_profiler.moc"
@@ -0,0 +1,120 @@
+<Shader>
+    <Properties>
+        <Property name="clusters" type="vec4"/>
+        <Property name="normalsMap" type="texture2D" binding="1" target="true"/>
+        <Property name="diffuseMap" type="texture2D" binding="2" target="true"/>
+        <Property name="paramsMap" type="texture2D" binding="3" target="true"/>
+        <Property name="depthMap" type="texture2D" binding="4" target="true"/>
+        <Property name="lightsMap" type="texture2D" binding="5"/>
+        <Property name="clustersMap" type="texture2D" binding="6"/>
+        <Property name="indicesMap" type="texture2D" binding="7"/>
+    </Properties>
+    <Fragment>
+<![CDATA[
+#version 450 core
+
+#include "ShaderLayout.h"
+#include "BRDF.h"
+
+#define TILES_X 16
+#define TILES_Y 9
+#define SLICES 24
+
+#define INDEX_WIDTH 1024
+
+#define SPOT_LIGHT 1.0
+
+layout(binding = UNIFORM) uniform Uniforms {
+    vec4 clusters; // x - near plane, y - log(far / near)
+} uni;
+
+layout(binding = UNIFORM + 1) uniform sampler2D normalsMap;
+layout(binding = UNIFORM + 2) uniform sampler2D diffuseMap;
+layout(binding = UNIFORM + 3) uniform sampler2D paramsMap;
+layout(binding = UNIFORM + 4) uniform sampler2D depthMap;
+// Four texels per light: position and type; color and brightness; direction and cutoff; attenuation
+layout(binding = UNIFORM + 5) uniform sampler2D lightsMap;
+// Texel per cluster: offset in the index list and number of lights
+layout(binding = UNIFORM + 6) uniform sampler2D clustersMap;
+// Four light indices per texel
+layout(binding = UNIFORM + 7) uniform sampler2D indicesMap;
+
+layout(location = 0) in vec4 _vertex;
+
+layout(location = 0) out vec4 rgb;
+
+void main (void) {
+    vec2 proj = ((_vertex.xyz / _vertex.w) * 0.5 + 0.5).xy;
+
+    vec4 slice0 = texture(normalsMap, proj);
+
+    // Light model LIT
+    if(slice0.w > 0.33) {
+        float depth = texture(depthMap, proj).x;
+        vec3 world = getWorld(g.cameraScreenToWorld, proj, depth);
+
+        float z = -(g.cameraView * vec4(world, 1.0)).z;
+        int slice = int(clamp(log(z / uni.clusters.x) / uni.clusters.y * SLICES, 0.0, SLICES - 1.0));
+        ivec2 tile = ivec2(clamp(proj * vec2(TILES_X, TILES_Y), vec2(0.0), vec2(TILES_X - 1, TILES_Y - 1)));
+
+        vec4 cluster = texelFetch(clustersMap, ivec2(tile.y * TILES_X + tile.x, slice), 0);
+        int offset = int(cluster.x);
+        int count = int(cluster.y);
+        if(count > 0) {
+            vec4 slice1 = texture(paramsMap, proj);
+            float rough = slice1.x;
+            float metal = slice1.z;
+            float spec  = slice1.w;
+
+            vec4 slice2 = texture(diffuseMap, proj);
+            vec3 albedo = slice2.xyz;
+
+            vec3 v = normalize(g.cameraPosition.xyz - world);
+            vec3 n = normalize(slice0.xyz * 2.0 - 1.0);
+
+            vec3 sum = vec3(0.0);
+            for(int i = 0; i < count; i++) {
+                int index = offset + i;
+                int texel = index / 4;
+                int light = int(texelFetch(indicesMap, ivec2(texel % INDEX_WIDTH, texel / INDEX_WIDTH), 0)[index % 4]);
+
+                vec4 position = texelFetch(lightsMap, ivec2(light, 0), 0);
+                vec4 color = texelFetch(lightsMap, ivec2(light, 1), 0);
+                vec4 direction = texelFetch(lightsMap, ivec2(light, 2), 0);
+                float cutoff = texelFetch(lightsMap, ivec2(light, 3), 0).x;
+
+                vec3 dir = position.xyz - world;
+                float dist = length(dir);
+                vec3 l = dir / dist;
+
+                float cosTheta = clamp(dot(l, n), 0.0, 1.0);
+
+                vec3 h = normalize(l + v);
+                float refl = getCookTorrance(n, v, h, cosTheta, rough);
+                vec3 result = albedo * (1.0 - metal) + (mix(vec3(spec), albedo, metal) * refl);
+
+                float factor = 0.0;
+                if(position.w == SPOT_LIGHT) {
+                    float spot = dot(l, direction.xyz);
+                    if(spot > direction.w) {
+                        float fall = 1.0 - (1.0 - spot) / (1.0 - direction.w);
+                        fall = getAttenuation(dist, cutoff) * color.w * fall;
+                        factor = PI * getLambert(cosTheta, color.w) * fall;
+                    }
+                } else {
+                    factor = PI * cosTheta * getAttenuation(dist, cutoff) * color.w;
+                }
+
+                sum += color.xyz * result * max(factor, 0.0);
+            }
+
+            rgb = vec4(sum, 1.0);
+            return;
+        }
+    }
+    rgb = vec4(vec3(0.0), 1.0);
+}
+]]>
+    </Fragment>
+    <Pass type="LightFunction" blendMode="Additive" lightModel="Unlit" depthTest="false" depthWrite="false" twoSided="true"/>
+</Shader>
@@ -0,0 +1,26 @@
+<Shader>
+    <Properties>
+        <Property name="tile" type="vec4"/>
+        <Property name="depthMap" type="texture2D" binding="1" target="true"/>
+    </Properties>
+    <Fragment>
+<![CDATA[
+#version 450 core
+
+#include "ShaderLayout.h"
+
+layout(binding = UNIFORM) uniform Uniform {
+    vec4 tile;
+} uni;
+
+layout(binding = UNIFORM + 1) uniform sampler2D depthMap;
+
+layout(location = 1) in vec2 _uv0;
+
+void main(void) {
+    gl_FragDepth = texture(depthMap, uni.tile.xy + _uv0 * uni.tile.zw).x;
+}
+]]>
+    </Fragment>
+    <Pass type="PostProcess" blendMode="Opaque" lightModel="Unlit" depthTest="true" depthWrite="true" twoSided="true"/>
+</Shader>
@@ -27,6 +27,7 @@ signals:
 
 private slots:
     void onProcessed(const QString &path, const QString &type);
+    void onProgress(int value, int count);
 
     void onStarted(int count, const QString &action);
     void onImportFinished();